@@ -14,10 +14,13 @@
 
 #include "cinn/auto_schedule/auto_tuner.h"
 
+#include <absl/container/flat_hash_map.h>
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
@@ -35,38 +38,62 @@ AutoTuner::AutoTuner(const common::Target& target, hlir::framework::Graph* graph
 void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler) {
   // create builder, runner, and schedule measurer
   builder_           = std::make_unique<SimpleBuilder>(graph_compiler);
-  runner_            = std::make_unique<SimpleRunner>(config.runner_repeat_times);
-  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get());
+  runner_            = std::make_unique<SimpleRunner>(config.runner_options);
+  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get(), config.measure_options);
+  database_          = Database::Make(config.database_path);
+  cost_model_        = CostModel::Make(config.cost_model_type);
 
-  // create tasks
+  // create a task for each group, and merge the groups with the same serialized key into one task
   TaskCreator task_creator;
-  tasks_ = task_creator.CreateTuneTaskOpLevel(graph_);
-  for (TuneTask& task : tasks_) {
-    task.SetGraphCompiler(graph_compiler);
-    task.TaskGraphToUnoptLoweredFunc();
+  task_instances_ = task_creator.CreateTuneTaskOpLevel(graph_);
+  absl::flat_hash_map<std::string, int> key2task_id;
+  std::vector<float> task_weights;
+  tasks_.clear();
+  instance2task_id_.clear();
+  for (TuneTask& instance : task_instances_) {
+    instance.SetGraphCompiler(graph_compiler);
+    instance.TaskGraphToUnoptLoweredFunc();
+    auto it = key2task_id.emplace(instance.serialized_key, tasks_.size());
+    if (it.second) {
+      tasks_.push_back(instance);
+      task_weights.push_back(0.0f);
+    }
+    instance2task_id_.push_back(it.first->second);
+    task_weights[it.first->second] += 1.0f;
   }
+  VLOG(3) << "AutoTuner merges " << task_instances_.size() << " groups into " << tasks_.size() << " tasks";
 
   // create task optimizers
   task_optimizers_.resize(tasks_.size());
   std::transform(tasks_.begin(), tasks_.end(), task_optimizers_.begin(), [&](const TuneTask& task) {
-    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get());
+    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get(), database_.get(), cost_model_.get());
   });
 
-  // create task scheduler
-  task_scheduler_ = TaskScheduler::Make(tasks_, config.task_schedule_config, config.task_schedule_strategy);
+  // create task scheduler, the tasks are weighted by the numbers of their groups
+  TaskScheduler::Config task_schedule_config = config.task_schedule_config;
+  if (task_schedule_config.task_weights.empty()) {
+    task_schedule_config.task_weights = task_weights;
+  }
+  task_scheduler_ = TaskScheduler::Make(tasks_, task_schedule_config, config.task_schedule_strategy);
+}
+
+double AutoTuner::GetBestCost(const TuneTask& task) const {
+  std::vector<TuningRecord> records = database_->GetTopK(task.serialized_key, 1);
+  return records.empty() ? std::numeric_limits<double>::max() : records[0].execution_cost;
 }
 
 TuningResult AutoTuner::Tune(const TuningOptions& options) {
   CHECK_GT(options.num_tuning_rounds, 0) << "Invalid config";
 
+  // the results are of each group in order
   TuningResult result;
-  result.tuned_graph.resize(tasks_.size());
-  result.optimized_exprs.resize(tasks_.size());
+  result.tuned_graph.resize(task_instances_.size());
+  result.optimized_exprs.resize(task_instances_.size());
   // A task only tunes schedule now, so we populate its sub_graph
   // as default result of graph tuning, and that should be updated
   // once we support graph tuning.
-  for (auto i = 0; i < tasks_.size(); ++i) {
-    auto&& task                  = tasks_.at(i);
+  for (auto i = 0; i < task_instances_.size(); ++i) {
+    auto&& task                  = task_instances_.at(i);
     result.tuned_graph[i].groups = task.task_graph();
   }
 
@@ -77,8 +104,16 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
       VLOG(3) << "TaskScheduler returned TaskId = " << run_id << " as the task to be optimized";
       auto* opt           = task_optimizers_.at(run_id).get();
       auto optimized_expr = opt->Optimize(options);
-      // update the best schedules searched so far.
-      result.optimized_exprs.at(run_id) = std::move(optimized_expr);
+      // update the best schedules searched so far of all the groups of the task.
+      for (auto i = 0; i < task_instances_.size(); ++i) {
+        if (instance2task_id_[i] != run_id) continue;
+        auto& instance_expr = result.optimized_exprs.at(i);
+        instance_expr.lowered_funcs.clear();
+        for (const auto& funcs : optimized_expr.lowered_funcs) {
+          instance_expr.lowered_funcs.emplace_back(task_instances_[i].TransferTunedFuncs(tasks_.at(run_id), funcs));
+        }
+      }
+      task_scheduler_->UpdateTaskResult(run_id, GetBestCost(tasks_.at(run_id)));
     }
   }
 
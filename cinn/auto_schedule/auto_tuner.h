@@ -18,7 +18,10 @@
 #include <string>
 #include <vector>
 
+#include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
+#include "cinn/auto_schedule/measure/simple_runner.h"
 #include "cinn/auto_schedule/task/task_optimizer.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
@@ -41,7 +44,14 @@ class AutoTuner {
   struct Config {
     std::string task_schedule_strategy = "round_robin";
     TaskScheduler::Config task_schedule_config;
-    int runner_repeat_times = 1;
+    // the warm-up, repeats and cache flushing of running a measurement
+    SimpleRunner::Options runner_options;
+    // the concurrency of building, the cores of running and the timeout of a measurement
+    ScheduleMeasurer::Options measure_options;
+    // the file to load and append the tuning records, the records are only kept in memory if it is empty
+    std::string database_path = "";
+    // the cost model shared by the tasks to guide the search
+    CostModelType cost_model_type = CostModelType::GBDT;
   };
 
   AutoTuner(const common::Target& target, hlir::framework::Graph* graph);
@@ -53,16 +63,29 @@ class AutoTuner {
   TuningResult Tune(const TuningOptions& options);
 
  private:
+  // The best execution cost of the task recorded in the database
+  double GetBestCost(const TuneTask& task) const;
+
   const common::Target& target_;
   hlir::framework::Graph* graph_;
 
-  // Tasks to tune
+  // The task of each group of the graph
+  std::vector<TuneTask> task_instances_;
+  // The distinct tasks to tune, the groups with the same serialized key share a task
   std::vector<TuneTask> tasks_;
+  // The index in tasks_ of each task instance
+  std::vector<int> instance2task_id_;
   // Scheduler that select a task to tune at every turn.
   std::unique_ptr<TaskScheduler> task_scheduler_;
   // The actor to perform auto-tune, each optimizer take a task.
   std::vector<std::unique_ptr<TaskOptimizer>> task_optimizers_;
 
+  // The records of the measured schedules
+  std::unique_ptr<Database> database_;
+
+  // The cost model trained by the measured schedules of all the tasks
+  std::unique_ptr<CostModel> cost_model_;
+
   // Classes used to measure AutoTune samples
   std::unique_ptr<ScheduleBuilder> builder_;
   std::unique_ptr<ScheduleRunner> runner_;
@@ -24,6 +24,7 @@
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/structural_hash.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -127,5 +128,35 @@ TEST_F(TestAutoTuner, NonZeroMeasure) {
   ApplyTunedAndRun(result);
 }
 
+TEST_F(TestAutoTuner, MergeIdenticalGroups) {
+  // two relu groups of the same shape are tuned as one task
+  frontend::NetBuilder builder("test_merge");
+  auto a = builder.CreateInput(Float(32), {1, 64, 112, 112}, "A");
+  auto b = builder.Relu(a);
+  auto c = builder.Relu(b);
+  graph          = std::make_shared<Graph>(builder.Build(), target);
+  compiled_scope = BuildScope(target, graph);
+  graph_compiler = std::make_unique<GraphCompiler>(target, compiled_scope, graph);
+  tuner          = std::make_unique<AutoTuner>(target, graph.get());
+
+  AutoTuner::Config tuning_config;
+  tuning_config.task_schedule_strategy = "gradient_descent";
+  TuningOptions tuning_options;
+  tuning_options.num_measure_trials = 0;
+  auto result                       = InitializeAndTune(tuning_config, tuning_options);
+
+  // each group gets its own functions with the schedule of the shared task
+  ASSERT_EQ(result.optimized_exprs.size(), 2UL);
+  const auto& funcs1 = result.optimized_exprs[0].lowered_funcs;
+  const auto& funcs2 = result.optimized_exprs[1].lowered_funcs;
+  ASSERT_EQ(funcs1.size(), 1UL);
+  ASSERT_EQ(funcs2.size(), 1UL);
+  ASSERT_EQ(funcs1[0].size(), 1UL);
+  ASSERT_EQ(funcs2[0].size(), 1UL);
+  EXPECT_NE(funcs1[0][0]->name, funcs2[0][0]->name);
+  EXPECT_TRUE(ir::StructuralEqual(funcs1[0][0]->body, funcs2[0][0]->body));
+  ApplyTunedAndRun(result);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -12,49 +12,44 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#pragma once
 
-#include <pybind11/embed.h>
+#pragma once
 
-#include <mutex>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace cinn {
 namespace auto_schedule {
 
+enum class CostModelType {
+  // gradient boosted trees implemented in C++, see GbdtCostModel
+  GBDT,
+  // XGBoost called via the embedded Python interpreter, see XgbCostModel
+  XGB,
+};
+
 /**
- * A C++ cost model which calls Python cost model via pybind
- *
- * Note: this class doesn't handle Python interpreter lifttime, users should
- * manage scoped_interpreter/initialize_interpreter/finalize_interpreter by
- * themselves. For pybind interpreter lifetime management, see:
- *
- *   https://pybind11.readthedocs.io/en/stable/advanced/embedding.html#interpreter-lifetime
- *   https://pybind11.readthedocs.io/en/stable/reference.html#_CPPv422initialize_interpreterbiPPCKcb
+ * The interface of the cost models, which predict the costs of the samples.
+ * Each sample is a vector of features with the same size and the smaller the predicted value, the faster.
  */
 class CostModel {
-  // TODO(zhhsplendid): add CostModelType for C++ interface
  public:
-  CostModel();
-  ~CostModel();
-
-  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+  virtual ~CostModel() = default;
 
-  std::vector<float> Predict(const std::vector<std::vector<float>>& samples);
+  static std::unique_ptr<CostModel> Make(CostModelType type = CostModelType::GBDT);
 
-  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+  //! Train the model from scratch, the previous trained states are dropped.
+  virtual void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) = 0;
 
-  void Save(const std::string& path);
+  virtual std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const = 0;
 
-  void Load(const std::string& path);
+  //! Train the model incrementally with the new samples.
+  virtual void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) = 0;
 
- private:
-  // Object points to Python CostModel
-  pybind11::object python_member_;
+  virtual void Save(const std::string& path) = 0;
 
-  // Flag to call_once on python inititalization function
-  static std::once_flag init_once_flag_;
+  virtual void Load(const std::string& path) = 0;
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,484 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <string>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+using Index = FeatureExtractor::Index;
+
+constexpr int kCacheLineBytes = 64;
+// the stride of an access which is not linear in the innermost loop
+constexpr int kUnknownStrideBytes = 4096;
+// the coefficient of a variable the expr depends on non-linearly
+constexpr int64_t kNonLinear = std::numeric_limits<int64_t>::min();
+
+// the coefficients of the variables in a linear expr, the variables of zero coefficients are absent
+using LinearForm = absl::flat_hash_map<std::string, int64_t>;
+// the linear forms of the block iter vars in the loop variables
+using VarForms = absl::flat_hash_map<std::string, LinearForm>;
+
+void AddForm(const LinearForm& other, int64_t sign, LinearForm* form) {
+  if (sign == 0) return;
+  for (auto& item : other) {
+    auto it = form->find(item.first);
+    if (it == form->end()) {
+      (*form)[item.first] = item.second == kNonLinear ? kNonLinear : sign * item.second;
+    } else if (it->second == kNonLinear || item.second == kNonLinear) {
+      it->second = kNonLinear;
+    } else if ((it->second += sign * item.second) == 0) {
+      form->erase(it);
+    }
+  }
+}
+
+void MarkNonLinear(const Expr& expr, const VarForms& var_forms, LinearForm* form) {
+  ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+    auto* var = x->As<ir::_Var_>();
+    if (var) {
+      auto it = var_forms.find(var->name);
+      if (it == var_forms.end()) {
+        (*form)[var->name] = kNonLinear;
+      } else {
+        for (auto& item : it->second) {
+          (*form)[item.first] = kNonLinear;
+        }
+      }
+    }
+    return false;
+  });
+}
+
+bool GetIntConstant(const Expr& expr, int64_t* value) {
+  if (auto* imm = expr.As<ir::IntImm>()) {
+    *value = imm->value;
+    return true;
+  }
+  return false;
+}
+
+LinearForm Linearize(const Expr& expr, const VarForms& var_forms) {
+  LinearForm form;
+  int64_t constant = 0;
+  switch (expr.node_type()) {
+    case ir::IrNodeTy::IntImm:
+    case ir::IrNodeTy::UIntImm:
+    case ir::IrNodeTy::FloatImm:
+      break;
+    case ir::IrNodeTy::_Var_: {
+      auto& name = expr.As<ir::_Var_>()->name;
+      auto it    = var_forms.find(name);
+      if (it != var_forms.end()) return it->second;
+      form[name] = 1;
+      break;
+    }
+    case ir::IrNodeTy::Add:
+      form = Linearize(expr.As<ir::Add>()->a(), var_forms);
+      AddForm(Linearize(expr.As<ir::Add>()->b(), var_forms), 1, &form);
+      break;
+    case ir::IrNodeTy::Sub:
+      form = Linearize(expr.As<ir::Sub>()->a(), var_forms);
+      AddForm(Linearize(expr.As<ir::Sub>()->b(), var_forms), -1, &form);
+      break;
+    case ir::IrNodeTy::Mul: {
+      auto* mul = expr.As<ir::Mul>();
+      if (GetIntConstant(mul->a(), &constant)) {
+        AddForm(Linearize(mul->b(), var_forms), constant, &form);
+      } else if (GetIntConstant(mul->b(), &constant)) {
+        AddForm(Linearize(mul->a(), var_forms), constant, &form);
+      } else {
+        MarkNonLinear(expr, var_forms, &form);
+      }
+      break;
+    }
+    case ir::IrNodeTy::Cast:
+      return Linearize(expr.As<ir::Cast>()->v(), var_forms);
+    case ir::IrNodeTy::Ramp:
+      return Linearize(expr.As<ir::Ramp>()->base, var_forms);
+    default:
+      MarkNonLinear(expr, var_forms, &form);
+  }
+  return form;
+}
+
+struct LoopInfo {
+  std::string var_name;
+  // 1 if the extent is not a constant
+  int64_t extent;
+  ir::ForType for_type;
+  // the vectorize factor of a vectorized loop, non-positive if not set
+  int vectorize_factor;
+};
+
+bool HasForType(ir::ForType for_type, ir::ForType flag) {
+  return static_cast<int>(for_type) & static_cast<int>(flag);
+}
+
+struct BlockStats {
+  std::array<double, Index::kNumFeatures> values{};
+  std::set<std::string> read_buffers;
+  std::set<std::string> write_buffers;
+  double min_reuse_distance = std::numeric_limits<double>::infinity();
+};
+
+// collect the statistics of each schedule block in the exprs
+class BlockStatsCollector : public ir::IRMutator<const Expr*> {
+ public:
+  std::vector<BlockStats> Collect(const ir::ModuleExpr& mod_expr) {
+    for (auto& expr : mod_expr.GetExprs()) {
+      Visit(&expr, &expr);
+    }
+    std::vector<BlockStats> res;
+    for (auto& stats : blocks_) {
+      // the blocks only containing other blocks, such as the root block, are skipped
+      if (stats.write_buffers.empty()) continue;
+      auto& values                    = stats.values;
+      values[Index::kNumBlocks]       = 1;
+      values[Index::kNumReadBuffers]  = stats.read_buffers.size();
+      values[Index::kNumWriteBuffers] = stats.write_buffers.size();
+      if (!std::isinf(stats.min_reuse_distance)) {
+        values[Index::kMinReuseDistance] = stats.min_reuse_distance;
+      }
+      res.emplace_back(std::move(stats));
+    }
+    return res;
+  }
+
+ private:
+  void Visit(const Expr* expr, const Expr* op) override { IRMutator::Visit(expr, op); }
+
+  void Visit(const ir::For* op, const Expr* expr) override {
+    auto* node     = expr->As<ir::For>();
+    int64_t extent = 1;
+    GetIntConstant(node->extent, &extent);
+    loops_.push_back(
+        {node->loop_var->name, std::max<int64_t>(extent, 1), node->for_type(), node->vectorize_info().factor});
+    Visit(&node->body, &node->body);
+    loops_.pop_back();
+  }
+
+  void Visit(const ir::PolyFor* op, const Expr* expr) override {
+    auto* node = expr->As<ir::PolyFor>();
+    loops_.push_back({node->iterator->name, 1, node->for_type(), node->vectorize_info().factor});
+    Visit(&node->body, &node->body);
+    loops_.pop_back();
+  }
+
+  void Visit(const ir::ScheduleBlockRealize* op, const Expr* expr) override {
+    auto* realize = expr->As<ir::ScheduleBlockRealize>();
+    auto* block   = realize->schedule_block.As<ir::ScheduleBlock>();
+    CHECK(block);
+    CHECK_EQ(block->iter_vars.size(), realize->iter_values.size());
+
+    VarForms outer_var_forms = var_forms_;
+    bool is_reduction        = false;
+    for (size_t i = 0; i < block->iter_vars.size(); ++i) {
+      var_forms_[block->iter_vars[i]->name] = Linearize(realize->iter_values[i], outer_var_forms);
+      is_reduction |= block->iter_vars[i]->is_reduce_axis;
+    }
+
+    block_stack_.push_back(blocks_.size());
+    blocks_.emplace_back();
+    InitLoopFeatures(&blocks_.back().values);
+    blocks_.back().values[Index::kIsReduction] = is_reduction;
+    Visit(&block->body, &block->body);
+    block_stack_.pop_back();
+    var_forms_ = std::move(outer_var_forms);
+  }
+
+  void Visit(const ir::Load* op, const Expr* expr) override {
+    auto* node = expr->As<ir::Load>();
+    RecordAccess(node->tensor, node->indices, node->type(), false);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Store* op, const Expr* expr) override {
+    auto* node = expr->As<ir::Store>();
+    RecordAccess(node->tensor, node->indices, node->value.type(), true);
+    IRMutator::Visit(op, expr);
+  }
+
+#define VISIT_ARITH_OP(op__, float_index__, int_index__)                 \
+  void Visit(const ir::op__* op, const Expr* expr) override {            \
+    CountOp(op->a().type(), Index::float_index__, Index::int_index__); \
+    IRMutator::Visit(op, expr);                                          \
+  }
+  VISIT_ARITH_OP(Add, kFloatAddSub, kIntAddSub)
+  VISIT_ARITH_OP(Sub, kFloatAddSub, kIntAddSub)
+  VISIT_ARITH_OP(Mul, kFloatMul, kIntMul)
+  VISIT_ARITH_OP(Div, kFloatDivMod, kIntDivMod)
+  VISIT_ARITH_OP(Mod, kFloatDivMod, kIntDivMod)
+  VISIT_ARITH_OP(Min, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(Max, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(EQ, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(NE, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(LT, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(LE, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(GT, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(GE, kFloatCmpMinMax, kIntCmpMinMax)
+  VISIT_ARITH_OP(And, kBoolOps, kBoolOps)
+  VISIT_ARITH_OP(Or, kBoolOps, kBoolOps)
+#undef VISIT_ARITH_OP
+
+  void Visit(const ir::Not* op, const Expr* expr) override {
+    CountOp(op->type(), Index::kBoolOps, Index::kBoolOps);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Minus* op, const Expr* expr) override {
+    CountOp(op->type(), Index::kFloatAddSub, Index::kIntAddSub);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Select* op, const Expr* expr) override {
+    CountOp(op->type(), Index::kSelects, Index::kSelects);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Cast* op, const Expr* expr) override {
+    CountOp(op->type(), Index::kCasts, Index::kCasts);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Call* op, const Expr* expr) override {
+    CountOp(op->type(), Index::kCalls, Index::kCalls);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Ramp* op, const Expr* expr) override {
+    RecordLanes(op->lanes);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Broadcast* op, const Expr* expr) override {
+    RecordLanes(op->lanes);
+    IRMutator::Visit(op, expr);
+  }
+
+  BlockStats* CurrentBlock() { return block_stack_.empty() ? nullptr : &blocks_[block_stack_.back()]; }
+
+  double Iterations() const {
+    double res = 1;
+    for (auto& loop : loops_) {
+      res *= loop.extent;
+    }
+    return res;
+  }
+
+  void InitLoopFeatures(std::array<double, Index::kNumFeatures>* values) {
+    auto& res                     = *values;
+    res[Index::kLoopDepth]        = loops_.size();
+    res[Index::kIterations]       = Iterations();
+    res[Index::kVectorLanes]      = 1;
+    res[Index::kParallelExtent]   = 1;
+    res[Index::kVectorizedExtent] = 1;
+    res[Index::kUnrolledExtent]   = 1;
+    res[Index::kGpuBlockExtent]   = 1;
+    res[Index::kGpuThreadExtent]  = 1;
+    if (!loops_.empty()) {
+      res[Index::kInnermostExtent] = loops_.back().extent;
+      res[Index::kOutermostExtent] = loops_.front().extent;
+    }
+    auto record_loop = [&](const LoopInfo& loop, ir::ForType flag, Index num_index, Index extent_index) {
+      if (HasForType(loop.for_type, flag)) {
+        res[num_index] += 1;
+        res[extent_index] *= loop.extent;
+      }
+    };
+    for (auto& loop : loops_) {
+      if (HasForType(loop.for_type, ir::ForType::Vectorized)) {
+        double lanes             = loop.vectorize_factor > 0 ? loop.vectorize_factor : loop.extent;
+        res[Index::kVectorLanes] = std::max(res[Index::kVectorLanes], lanes);
+      }
+      record_loop(loop, ir::ForType::Parallel, Index::kNumParallelLoops, Index::kParallelExtent);
+      record_loop(loop, ir::ForType::Vectorized, Index::kNumVectorizedLoops, Index::kVectorizedExtent);
+      record_loop(loop, ir::ForType::Unrolled, Index::kNumUnrolledLoops, Index::kUnrolledExtent);
+      record_loop(loop, ir::ForType::GPUBlock, Index::kNumGpuBlockLoops, Index::kGpuBlockExtent);
+      record_loop(loop, ir::ForType::GPUThread, Index::kNumGpuThreadLoops, Index::kGpuThreadExtent);
+    }
+  }
+
+  void RecordLanes(int lanes) {
+    auto* block = CurrentBlock();
+    if (!block) return;
+    block->values[Index::kVectorLanes] = std::max<double>(block->values[Index::kVectorLanes], lanes);
+  }
+
+  void CountOp(const Type& type, Index float_index, Index int_index) {
+    auto* block = CurrentBlock();
+    if (!block) return;
+    Index index = type.is_float() ? float_index : int_index;
+    block->values[index] += Iterations() * std::max(type.lanes(), 1);
+    RecordLanes(type.lanes());
+  }
+
+  void RecordAccess(const Expr& tensor_expr, const std::vector<Expr>& indices, const Type& type, bool is_write) {
+    auto* block  = CurrentBlock();
+    auto* tensor = tensor_expr.as_tensor();
+    if (!block || !tensor) return;
+    auto& values = block->values;
+    (is_write ? block->write_buffers : block->read_buffers).insert(tensor->name);
+
+    // the linear form of the flattened address in the loop variables
+    LinearForm form;
+    bool static_shape = tensor->shape.size() == indices.size();
+    for (auto& dim : tensor->shape) {
+      static_shape &= dim.As<ir::IntImm>() != nullptr;
+    }
+    int64_t dim_stride = 1;
+    for (int i = static_cast<int>(indices.size()) - 1; i >= 0; --i) {
+      if (static_shape) {
+        AddForm(Linearize(indices[i], var_forms_), dim_stride, &form);
+        dim_stride *= tensor->shape[i].As<ir::IntImm>()->value;
+      } else {
+        MarkNonLinear(indices[i], var_forms_, &form);
+      }
+    }
+
+    double elem_bytes = std::max((type.bits() * std::max(type.lanes(), 1) + 7) / 8, 1);
+    double iterations = Iterations();
+    // the number of the distinct addresses is the product of the extents of the loops the address depends on
+    double touched = 1;
+    for (auto& loop : loops_) {
+      if (form.count(loop.var_name)) touched *= loop.extent;
+    }
+    values[is_write ? Index::kBytesWritten : Index::kBytesRead] += iterations * elem_bytes;
+    values[Index::kUniqueBytes] += touched * elem_bytes;
+
+    // the same address is accessed again after the iterations of the loops inside the innermost loop not used
+    for (int i = static_cast<int>(loops_.size()) - 1; i >= 0; --i) {
+      if (form.count(loops_[i].var_name)) continue;
+      double distance = 1;
+      for (size_t j = i + 1; j < loops_.size(); ++j) {
+        distance *= loops_[j].extent;
+      }
+      block->min_reuse_distance        = std::min(block->min_reuse_distance, distance);
+      values[Index::kMaxReuseDistance] = std::max(values[Index::kMaxReuseDistance], distance);
+      break;
+    }
+
+    // the stride along the innermost loop decides how many cache lines are touched
+    double stride_bytes = 0;
+    if (!loops_.empty()) {
+      auto it = form.find(loops_.back().var_name);
+      if (it == form.end()) {
+        values[Index::kNumBroadcastAccesses] += 1;
+      } else if (it->second == kNonLinear) {
+        values[Index::kNumStridedAccesses] += 1;
+        stride_bytes = kUnknownStrideBytes;
+      } else {
+        int64_t stride = std::abs(it->second);
+        values[stride == 1 ? Index::kNumContiguousAccesses : Index::kNumStridedAccesses] += 1;
+        stride_bytes = stride * elem_bytes;
+      }
+    } else {
+      values[Index::kNumBroadcastAccesses] += 1;
+    }
+    values[Index::kMaxInnermostStrideBytes] = std::max(values[Index::kMaxInnermostStrideBytes], stride_bytes);
+    double bytes_per_element = std::min<double>(std::max(stride_bytes, elem_bytes), kCacheLineBytes);
+    values[Index::kCacheLines] += std::max(1.0, touched * bytes_per_element / kCacheLineBytes);
+  }
+
+  std::vector<LoopInfo> loops_;
+  VarForms var_forms_;
+  std::vector<BlockStats> blocks_;
+  std::vector<int> block_stack_;
+};
+
+// compute the features derived from the others
+void FinalizeRatios(std::array<double, Index::kNumFeatures>* values) {
+  auto& res        = *values;
+  double bytes     = res[Index::kBytesRead] + res[Index::kBytesWritten];
+  double float_ops = res[Index::kFloatAddSub] + res[Index::kFloatMul] + res[Index::kFloatDivMod] +
+                     res[Index::kFloatCmpMinMax];
+  res[Index::kReuseRatio]          = res[Index::kUniqueBytes] > 0 ? bytes / res[Index::kUniqueBytes] : 0;
+  res[Index::kArithmeticIntensity] = bytes > 0 ? float_ops / bytes : 0;
+}
+
+std::vector<float> Normalize(const std::array<double, Index::kNumFeatures>& values) {
+  std::vector<float> res(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    res[i] = std::log2(1.0 + std::max(values[i], 0.0));
+  }
+  return res;
+}
+
+}  // namespace
+
+std::vector<std::vector<float>> FeatureExtractor::ExtractBlockFeatures(const ir::ModuleExpr& mod_expr) {
+  std::vector<std::vector<float>> res;
+  for (auto& stats : BlockStatsCollector().Collect(mod_expr)) {
+    FinalizeRatios(&stats.values);
+    res.emplace_back(Normalize(stats.values));
+  }
+  return res;
+}
+
+std::vector<float> FeatureExtractor::Extract(const ir::ModuleExpr& mod_expr) {
+  std::array<double, kNumFeatures> res{};
+  for (auto& stats : BlockStatsCollector().Collect(mod_expr)) {
+    auto& values = stats.values;
+    for (int i = 0; i < kNumFeatures; ++i) {
+      switch (i) {
+        // the structural features take the maximum of the blocks
+        case kLoopDepth:
+        case kInnermostExtent:
+        case kOutermostExtent:
+        case kParallelExtent:
+        case kVectorizedExtent:
+        case kUnrolledExtent:
+        case kGpuBlockExtent:
+        case kGpuThreadExtent:
+        case kVectorLanes:
+        case kIsReduction:
+        case kMaxReuseDistance:
+        case kMaxInnermostStrideBytes:
+          res[i] = std::max(res[i], values[i]);
+          break;
+        case kMinReuseDistance:
+          if (values[i] > 0) {
+            res[i] = res[i] > 0 ? std::min(res[i], values[i]) : values[i];
+          }
+          break;
+        // the counts are accumulated
+        default:
+          res[i] += values[i];
+      }
+    }
+  }
+  FinalizeRatios(&res);
+  return Normalize(res);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,101 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Extract the fixed-length feature vectors of the scheduled ModuleExpr for the cost model.
+ *
+ * Each ScheduleBlock writing a tensor gets a feature vector from its enclosing loops and body. The loop
+ * features describe the loop nest and its annotations, the arithmetic features count the dynamic executions
+ * of the operations by type, and the memory features describe the accesses of the buffers: the bytes touched,
+ * the reuse and the stride along the innermost loop, which is derived from the linear forms of the indices in
+ * the loop variables. The loops with non-constant extents are counted as 1 iteration.
+ *
+ * All the features are scaled by log2(1 + x). The functions are stateless and can be called from multiple
+ * threads.
+ */
+class FeatureExtractor {
+ public:
+  // the index of each feature in a feature vector
+  enum Index : int {
+    // the number of blocks, which is 1 for a block feature
+    kNumBlocks = 0,
+    // loop features
+    kLoopDepth,
+    kIterations,
+    kInnermostExtent,
+    kOutermostExtent,
+    kNumParallelLoops,
+    kParallelExtent,
+    kNumVectorizedLoops,
+    kVectorizedExtent,
+    kNumUnrolledLoops,
+    kUnrolledExtent,
+    kNumGpuBlockLoops,
+    kGpuBlockExtent,
+    kNumGpuThreadLoops,
+    kGpuThreadExtent,
+    kVectorLanes,
+    kIsReduction,
+    // arithmetic features, multiplied by the vector lanes
+    kFloatAddSub,
+    kFloatMul,
+    kFloatDivMod,
+    kFloatCmpMinMax,
+    kIntAddSub,
+    kIntMul,
+    kIntDivMod,
+    kIntCmpMinMax,
+    kBoolOps,
+    kSelects,
+    kCasts,
+    kCalls,
+    // memory features
+    kNumReadBuffers,
+    kNumWriteBuffers,
+    kBytesRead,
+    kBytesWritten,
+    kUniqueBytes,
+    kCacheLines,
+    // the bytes accessed divided by the unique bytes
+    kReuseRatio,
+    // the iterations between two accesses of the same address
+    kMinReuseDistance,
+    kMaxReuseDistance,
+    kNumContiguousAccesses,
+    kNumBroadcastAccesses,
+    kNumStridedAccesses,
+    kMaxInnermostStrideBytes,
+    // the float operations per byte accessed
+    kArithmeticIntensity,
+    kNumFeatures,
+  };
+
+  //! The features of the blocks writing tensors, in the order they appear in the exprs.
+  static std::vector<std::vector<float>> ExtractBlockFeatures(const ir::ModuleExpr& mod_expr);
+
+  //! The features of the whole ModuleExpr aggregated from the blocks, whose size is kNumFeatures.
+  static std::vector<float> Extract(const ir::ModuleExpr& mod_expr);
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
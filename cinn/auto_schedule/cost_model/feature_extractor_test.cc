@@ -0,0 +1,141 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/poly/stage.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+using Index = FeatureExtractor::Index;
+
+float Scale(double x) { return std::log2(1.0 + x); }
+
+ir::ModuleExpr LowerElementwiseAdd(const common::Target& target) {
+  Expr M(32);
+  Expr N(128);
+
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {N});
+
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(j); }, "C");
+
+  poly::StageMap stages = CreateStages({C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestFeatureExtractor_ElementwiseAdd", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  return ir::ModuleExpr({optim::IRCopy(funcs[0]->body)});
+}
+
+}  // namespace
+
+TEST(FeatureExtractor, ElementwiseAdd) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  ir::ModuleExpr mod_expr = LowerElementwiseAdd(target);
+  VLOG(6) << "Expr to extract features: " << mod_expr.GetExprs()[0];
+
+  std::vector<std::vector<float>> block_features = FeatureExtractor::ExtractBlockFeatures(mod_expr);
+  ASSERT_EQ(block_features.size(), 1UL);
+  const std::vector<float>& features = block_features[0];
+  ASSERT_EQ(features.size(), static_cast<size_t>(Index::kNumFeatures));
+
+  EXPECT_FLOAT_EQ(features[Index::kNumBlocks], Scale(1));
+  EXPECT_FLOAT_EQ(features[Index::kLoopDepth], Scale(2));
+  EXPECT_FLOAT_EQ(features[Index::kIterations], Scale(32 * 128));
+  EXPECT_FLOAT_EQ(features[Index::kInnermostExtent], Scale(128));
+  EXPECT_FLOAT_EQ(features[Index::kFloatAddSub], Scale(32 * 128));
+  EXPECT_FLOAT_EQ(features[Index::kFloatMul], Scale(0));
+  EXPECT_FLOAT_EQ(features[Index::kNumReadBuffers], Scale(2));
+  EXPECT_FLOAT_EQ(features[Index::kNumWriteBuffers], Scale(1));
+  EXPECT_FLOAT_EQ(features[Index::kBytesRead], Scale(2 * 32 * 128 * 4));
+  EXPECT_FLOAT_EQ(features[Index::kBytesWritten], Scale(32 * 128 * 4));
+  // B is reused by each row
+  EXPECT_FLOAT_EQ(features[Index::kUniqueBytes], Scale(2 * 32 * 128 * 4 + 128 * 4));
+  EXPECT_FLOAT_EQ(features[Index::kMaxReuseDistance], Scale(128));
+  EXPECT_FLOAT_EQ(features[Index::kNumContiguousAccesses], Scale(3));
+  EXPECT_FLOAT_EQ(features[Index::kNumStridedAccesses], Scale(0));
+
+  // the ModuleExpr of a single block has the same features as the block
+  EXPECT_EQ(FeatureExtractor::Extract(mod_expr), features);
+}
+
+TEST(FeatureExtractor, ScheduledLoops) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  ir::ModuleExpr mod_expr = LowerElementwiseAdd(target);
+  std::vector<float> features_before = FeatureExtractor::Extract(mod_expr);
+
+  ir::IRSchedule ir_sch(mod_expr);
+  std::vector<Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 2UL);
+  ir_sch.Parallel(loops[0]);
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Vectorize(loops[1], 8);
+  std::vector<float> features_after = FeatureExtractor::Extract(ir_sch.GetModule());
+
+  EXPECT_FLOAT_EQ(features_before[Index::kNumParallelLoops], Scale(0));
+  EXPECT_FLOAT_EQ(features_after[Index::kNumParallelLoops], Scale(1));
+  EXPECT_FLOAT_EQ(features_after[Index::kParallelExtent], Scale(32));
+  EXPECT_FLOAT_EQ(features_before[Index::kVectorLanes], Scale(1));
+  EXPECT_FLOAT_EQ(features_after[Index::kVectorLanes], Scale(8));
+  // the annotations do not change the computation
+  EXPECT_FLOAT_EQ(features_after[Index::kFloatAddSub], features_before[Index::kFloatAddSub]);
+  EXPECT_FLOAT_EQ(features_after[Index::kBytesRead], features_before[Index::kBytesRead]);
+}
+
+TEST(FeatureExtractor, TransposedAccess) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Expr N(32);
+  Placeholder<float> A("A", {N, M});
+  ir::Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(j, i); }, "B");
+
+  poly::StageMap stages = CreateStages({B});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestFeatureExtractor_Transpose", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  std::vector<float> features = FeatureExtractor::Extract(mod_expr);
+  // A is read along the columns with the stride of a row
+  EXPECT_FLOAT_EQ(features[Index::kNumContiguousAccesses], Scale(1));
+  EXPECT_FLOAT_EQ(features[Index::kNumStridedAccesses], Scale(1));
+  EXPECT_FLOAT_EQ(features[Index::kMaxInnermostStrideBytes], Scale(64 * 4));
+  // each element of A lies in a different cache line
+  EXPECT_FLOAT_EQ(features[Index::kCacheLines], Scale(64 * 32 + 64 * 32 * 4 / 64));
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,377 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// the file format: magic, version, number of features, base score, number of trees,
+// then the number of nodes and the nodes of each tree
+constexpr char kFileMagic[8]    = {'C', 'I', 'N', 'N', 'G', 'B', 'D', 'T'};
+constexpr uint32_t kFileVersion = 1;
+
+// a split is made only if it reduces the loss by more than it
+constexpr double kMinSplitGain = 1e-6;
+// the minimum amount of work of a task in the thread pool, in the number of visited samples
+constexpr int kMinParallelWork = 4096;
+
+template <typename T>
+void WritePod(std::ofstream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadPod(std::ifstream& is, const std::string& path) {
+  T value;
+  CHECK(is.read(reinterpret_cast<char*>(&value), sizeof(T))) << "The cost model file " << path << " is truncated";
+  return value;
+}
+
+}  // namespace
+
+GbdtCostModel::GbdtCostModel() : GbdtCostModel(Options()) {}
+
+GbdtCostModel::GbdtCostModel(const Options& options) : options_(options) {
+  CHECK_GT(options_.num_train_rounds, 0);
+  CHECK_GE(options_.num_update_rounds, 0);
+  CHECK_GT(options_.max_depth, 0);
+  CHECK_GT(options_.min_samples_leaf, 0);
+  CHECK_GT(options_.max_buffered_samples, 0);
+  CHECK(options_.max_bins >= 2 && options_.max_bins <= 256) << "max_bins should be in [2, 256]";
+  int num_threads = options_.num_threads > 0 ? options_.num_threads : std::thread::hardware_concurrency();
+  if (num_threads > 1) {
+    thread_pool_.reset(new utils::ThreadPool(num_threads));
+  }
+}
+
+GbdtCostModel::~GbdtCostModel() = default;
+
+void GbdtCostModel::ParallelFor(int n, int min_chunk_size, const std::function<void(int, int)>& fn) const {
+  int num_chunks = 1;
+  if (thread_pool_) {
+    num_chunks = std::min(thread_pool_->num_threads(), (n + min_chunk_size - 1) / std::max(min_chunk_size, 1));
+  }
+  if (num_chunks <= 1) {
+    fn(0, n);
+    return;
+  }
+  int chunk_size = (n + num_chunks - 1) / num_chunks;
+  for (int begin = 0; begin < n; begin += chunk_size) {
+    int end = std::min(begin + chunk_size, n);
+    thread_pool_->Submit([&fn, begin, end]() { fn(begin, end); });
+  }
+  thread_pool_->Wait();
+}
+
+float GbdtCostModel::PredictTree(const Tree& tree, const float* sample) {
+  int node_id = 0;
+  while (tree[node_id].feature >= 0) {
+    auto& node = tree[node_id];
+    node_id    = sample[node.feature] < node.threshold ? node.left : node.right;
+  }
+  return tree[node_id].value;
+}
+
+float GbdtCostModel::PredictOne(const float* sample) const {
+  float res = base_score_;
+  for (auto& tree : trees_) {
+    res += PredictTree(tree, sample);
+  }
+  return res;
+}
+
+std::vector<float> GbdtCostModel::Predict(const std::vector<std::vector<float>>& samples) const {
+  std::vector<float> res(samples.size(), base_score_);
+  if (trees_.empty()) {
+    return res;
+  }
+  for (auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "The number of features does not match the model";
+  }
+  int min_chunk_size = std::max<int>(1, kMinParallelWork / trees_.size());
+  ParallelFor(samples.size(), min_chunk_size, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      res[i] = PredictOne(samples[i].data());
+    }
+  });
+  return res;
+}
+
+void GbdtCostModel::Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  CHECK(!samples.empty()) << "Can not train the cost model without samples";
+  CHECK_EQ(samples.size(), labels.size());
+  num_features_ = samples[0].size();
+  CHECK_GT(num_features_, 0);
+  trees_.clear();
+  samples_.clear();
+  labels_.clear();
+  preds_.clear();
+  base_score_ = std::accumulate(labels.begin(), labels.end(), 0.0) / labels.size();
+
+  AppendSamples(samples, labels);
+  Boost(options_.num_train_rounds);
+}
+
+void GbdtCostModel::Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  if (samples.empty()) {
+    return;
+  }
+  if (num_features_ == 0) {
+    Train(samples, labels);
+    return;
+  }
+  AppendSamples(samples, labels);
+  Boost(options_.num_update_rounds);
+}
+
+void GbdtCostModel::AppendSamples(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  CHECK_EQ(samples.size(), labels.size());
+  std::vector<float> preds = Predict(samples);
+  for (auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "The number of features does not match the model";
+    samples_.insert(samples_.end(), sample.begin(), sample.end());
+  }
+  labels_.insert(labels_.end(), labels.begin(), labels.end());
+  preds_.insert(preds_.end(), preds.begin(), preds.end());
+
+  if (labels_.size() > options_.max_buffered_samples) {
+    size_t num_dropped = labels_.size() - options_.max_buffered_samples;
+    samples_.erase(samples_.begin(), samples_.begin() + num_dropped * num_features_);
+    labels_.erase(labels_.begin(), labels_.begin() + num_dropped);
+    preds_.erase(preds_.begin(), preds_.begin() + num_dropped);
+  }
+}
+
+void GbdtCostModel::BuildBins() {
+  int num_samples = labels_.size();
+  cuts_.assign(num_features_, {});
+  bins_.resize(static_cast<size_t>(num_samples) * num_features_);
+  int min_chunk_size = std::max(1, kMinParallelWork / num_samples);
+  ParallelFor(num_features_, min_chunk_size, [&](int begin, int end) {
+    std::vector<float> values(num_samples);
+    for (int f = begin; f < end; ++f) {
+      for (int i = 0; i < num_samples; ++i) {
+        values[i] = samples_[i * num_features_ + f];
+      }
+      std::sort(values.begin(), values.end());
+      int num_uniques = 1;
+      for (int i = 1; i < num_samples; ++i) {
+        num_uniques += values[i] != values[i - 1];
+      }
+      auto& cuts = cuts_[f];
+      if (num_uniques <= options_.max_bins) {
+        // one bin for each value
+        for (int i = 1; i < num_samples; ++i) {
+          if (values[i] != values[i - 1]) {
+            cuts.push_back(values[i - 1] + (values[i] - values[i - 1]) / 2);
+          }
+        }
+      } else {
+        // the bins hold about the same number of samples
+        for (int j = 1; j < options_.max_bins; ++j) {
+          float cut = values[static_cast<int64_t>(j) * num_samples / options_.max_bins];
+          if (cut > values.front()) {
+            cuts.push_back(cut);
+          }
+        }
+      }
+      cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+      uint8_t* feature_bins = &bins_[static_cast<size_t>(f) * num_samples];
+      for (int i = 0; i < num_samples; ++i) {
+        float value     = samples_[i * num_features_ + f];
+        feature_bins[i] = std::upper_bound(cuts.begin(), cuts.end(), value) - cuts.begin();
+      }
+    }
+  });
+}
+
+int GbdtCostModel::GrowTree(
+    const std::vector<float>& gradients, std::vector<int>* sample_ids, int begin, int end, int depth, Tree* tree) {
+  int node_id = tree->size();
+  tree->emplace_back();
+  // the hessian of the squared error is 1, so the sum of hessians is the number of samples
+  int num_samples = end - begin;
+  double sum_grad = 0;
+  for (int i = begin; i < end; ++i) {
+    sum_grad += gradients[(*sample_ids)[i]];
+  }
+  auto make_leaf = [&]() {
+    (*tree)[node_id].value = -sum_grad / (num_samples + options_.lambda) * options_.learning_rate;
+    return node_id;
+  };
+  if (depth >= options_.max_depth || num_samples < 2 * options_.min_samples_leaf) {
+    return make_leaf();
+  }
+
+  // search the best split of each feature on the histograms
+  struct Split {
+    double gain{kMinSplitGain};
+    int bin{-1};
+  };
+  std::vector<Split> best_splits(num_features_);
+  size_t num_buffered = labels_.size();
+  double parent_score = sum_grad * sum_grad / (num_samples + options_.lambda);
+  int min_chunk_size  = std::max(1, kMinParallelWork / num_samples);
+  ParallelFor(num_features_, min_chunk_size, [&](int feature_begin, int feature_end) {
+    std::vector<double> grad_hist;
+    std::vector<int> count_hist;
+    for (int f = feature_begin; f < feature_end; ++f) {
+      int num_bins = cuts_[f].size() + 1;
+      if (num_bins < 2) continue;
+      grad_hist.assign(num_bins, 0);
+      count_hist.assign(num_bins, 0);
+      const uint8_t* feature_bins = &bins_[f * num_buffered];
+      for (int i = begin; i < end; ++i) {
+        int id = (*sample_ids)[i];
+        grad_hist[feature_bins[id]] += gradients[id];
+        count_hist[feature_bins[id]]++;
+      }
+      double left_grad = 0;
+      int left_count   = 0;
+      for (int bin = 0; bin + 1 < num_bins; ++bin) {
+        left_grad += grad_hist[bin];
+        left_count += count_hist[bin];
+        int right_count = num_samples - left_count;
+        if (left_count < options_.min_samples_leaf) continue;
+        if (right_count < options_.min_samples_leaf) break;
+        double right_grad = sum_grad - left_grad;
+        double gain       = left_grad * left_grad / (left_count + options_.lambda) +
+                      right_grad * right_grad / (right_count + options_.lambda) - parent_score;
+        if (gain > best_splits[f].gain) {
+          best_splits[f].gain = gain;
+          best_splits[f].bin  = bin;
+        }
+      }
+    }
+  });
+  int best_feature = -1;
+  for (int f = 0; f < num_features_; ++f) {
+    if (best_splits[f].bin >= 0 && (best_feature < 0 || best_splits[f].gain > best_splits[best_feature].gain)) {
+      best_feature = f;
+    }
+  }
+  if (best_feature < 0) {
+    return make_leaf();
+  }
+
+  int best_bin                = best_splits[best_feature].bin;
+  const uint8_t* feature_bins = &bins_[best_feature * num_buffered];
+  auto mid_it                 = std::partition(sample_ids->begin() + begin,
+                                               sample_ids->begin() + end,
+                                               [&](int id) { return feature_bins[id] <= best_bin; });
+  int mid                     = mid_it - sample_ids->begin();
+  int left  = GrowTree(gradients, sample_ids, begin, mid, depth + 1, tree);
+  int right = GrowTree(gradients, sample_ids, mid, end, depth + 1, tree);
+  // the nodes may be reallocated by growing the children
+  auto& node     = (*tree)[node_id];
+  node.feature   = best_feature;
+  node.threshold = cuts_[best_feature][best_bin];
+  node.left      = left;
+  node.right     = right;
+  return node_id;
+}
+
+void GbdtCostModel::Boost(int num_rounds) {
+  if (num_rounds <= 0) return;
+  BuildBins();
+  int num_samples = labels_.size();
+  std::vector<float> gradients(num_samples);
+  std::vector<int> sample_ids(num_samples);
+  for (int round = 0; round < num_rounds; ++round) {
+    for (int i = 0; i < num_samples; ++i) {
+      gradients[i] = preds_[i] - labels_[i];
+    }
+    std::iota(sample_ids.begin(), sample_ids.end(), 0);
+    Tree tree;
+    GrowTree(gradients, &sample_ids, 0, num_samples, 0, &tree);
+    ParallelFor(num_samples, kMinParallelWork, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        preds_[i] += PredictTree(tree, &samples_[i * num_features_]);
+      }
+    });
+    trees_.emplace_back(std::move(tree));
+  }
+  VLOG(4) << "GbdtCostModel has " << trees_.size() << " trees trained on " << num_samples << " samples";
+}
+
+void GbdtCostModel::Save(const std::string& path) {
+  static_assert(sizeof(Node) == 20, "Node should be packed to be saved directly");
+  std::ofstream os(path, std::ios::binary);
+  CHECK(os.is_open()) << "Failed to open " << path << " to save the cost model";
+  os.write(kFileMagic, sizeof(kFileMagic));
+  WritePod(os, kFileVersion);
+  WritePod(os, static_cast<int32_t>(num_features_));
+  WritePod(os, base_score_);
+  WritePod(os, static_cast<uint32_t>(trees_.size()));
+  for (auto& tree : trees_) {
+    WritePod(os, static_cast<uint32_t>(tree.size()));
+    os.write(reinterpret_cast<const char*>(tree.data()), tree.size() * sizeof(Node));
+  }
+  os.flush();
+  CHECK(os.good()) << "Failed to save the cost model to " << path;
+}
+
+void GbdtCostModel::Load(const std::string& path) {
+  std::ifstream is(path, std::ios::binary);
+  CHECK(is.is_open()) << "Failed to open " << path << " to load the cost model";
+  char magic[sizeof(kFileMagic)];
+  CHECK(is.read(magic, sizeof(magic)) && std::memcmp(magic, kFileMagic, sizeof(magic)) == 0)
+      << path << " is not a GbdtCostModel file";
+  uint32_t version = ReadPod<uint32_t>(is, path);
+  CHECK_EQ(version, kFileVersion) << "Unsupported version of the cost model file " << path;
+  int num_features   = ReadPod<int32_t>(is, path);
+  float base_score   = ReadPod<float>(is, path);
+  uint32_t num_trees = ReadPod<uint32_t>(is, path);
+  std::vector<Tree> trees(num_trees);
+  for (auto& tree : trees) {
+    int num_nodes = ReadPod<uint32_t>(is, path);
+    CHECK_GT(num_nodes, 0) << "The cost model file " << path << " is corrupted";
+    tree.resize(num_nodes);
+    CHECK(is.read(reinterpret_cast<char*>(tree.data()), num_nodes * sizeof(Node)))
+        << "The cost model file " << path << " is truncated";
+    for (int i = 0; i < num_nodes; ++i) {
+      auto& node = tree[i];
+      if (node.feature < 0) continue;
+      // the children are always after the parent, so a valid tree has no cycle
+      CHECK(node.feature < num_features && node.left > i && node.left < num_nodes && node.right > i &&
+            node.right < num_nodes)
+          << "The cost model file " << path << " is corrupted";
+    }
+  }
+
+  num_features_ = num_features;
+  base_score_   = base_score;
+  trees_        = std::move(trees);
+  // the samples of the saved model are not kept, Update only trains on the new samples
+  samples_.clear();
+  labels_.clear();
+  preds_.clear();
+  cuts_.clear();
+  bins_.clear();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/utils/thread_pool.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * A cost model of gradient boosted regression trees implemented in C++, trained with the squared error.
+ *
+ * The split points of the trees are searched on histograms, each feature is quantized into at most
+ * Options::max_bins bins by the quantiles of the training samples. The training samples are buffered so
+ * Update can boost more trees on the residuals of both the old and the new samples, the buffer is not saved.
+ *
+ * Predict can be called from multiple threads concurrently, but not concurrently with Train, Update or Load.
+ */
+class GbdtCostModel : public CostModel {
+ public:
+  struct Options {
+    // the number of trees built by Train
+    int num_train_rounds{10};
+    // the number of trees appended by each Update
+    int num_update_rounds{2};
+    int max_depth{6};
+    float learning_rate{0.3f};
+    // the L2 regularization on the leaf values
+    float lambda{1.0f};
+    // the minimum number of samples in a leaf
+    int min_samples_leaf{1};
+    // the maximum number of histogram bins of a feature, in [2, 256]
+    int max_bins{64};
+    // the maximum number of samples buffered for Update, the oldest ones are dropped
+    int max_buffered_samples{1 << 16};
+    // the number of threads used by training and prediction, 0 means the hardware concurrency
+    int num_threads{0};
+  };
+
+  GbdtCostModel();
+  explicit GbdtCostModel(const Options& options);
+  ~GbdtCostModel();
+
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  //! Predict the samples in parallel, 0 is returned for each sample before the model is trained.
+  std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const override;
+
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  void Save(const std::string& path) override;
+
+  void Load(const std::string& path) override;
+
+  int num_trees() const { return trees_.size(); }
+
+ private:
+  struct Node {
+    // the feature to split on, -1 for a leaf
+    int32_t feature{-1};
+    // the samples whose feature is less than the threshold go to the left child
+    float threshold{0.f};
+    int32_t left{-1};
+    int32_t right{-1};
+    // the output of a leaf, which has been scaled by the learning rate
+    float value{0.f};
+  };
+  using Tree = std::vector<Node>;
+
+  static float PredictTree(const Tree& tree, const float* sample);
+  float PredictOne(const float* sample) const;
+  // append the samples to the buffer with the current predictions
+  void AppendSamples(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+  // quantize the buffered samples
+  void BuildBins();
+  // build the trees on the buffered samples one by one
+  void Boost(int num_rounds);
+  // grow the subtree of the samples, return the index of its root node in the tree
+  int GrowTree(
+      const std::vector<float>& gradients, std::vector<int>* sample_ids, int begin, int end, int depth, Tree* tree);
+  // run fn(begin, end) on the chunks of [0, n) in the thread pool
+  void ParallelFor(int n, int min_chunk_size, const std::function<void(int, int)>& fn) const;
+
+  Options options_;
+  int num_features_{0};
+  float base_score_{0.f};
+  std::vector<Tree> trees_;
+
+  // the buffered samples in row-major order
+  std::vector<float> samples_;
+  std::vector<float> labels_;
+  // the predictions of the buffered samples by the current trees
+  std::vector<float> preds_;
+  // the ascending split points of each feature
+  std::vector<std::vector<float>> cuts_;
+  // the bins of the buffered samples in column-major order
+  std::vector<uint8_t> bins_;
+
+  std::unique_ptr<utils::ThreadPool> thread_pool_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
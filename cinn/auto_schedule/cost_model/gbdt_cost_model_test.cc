@@ -0,0 +1,139 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// a piecewise function with an interaction between the features
+float TargetFunction(const std::vector<float>& sample) {
+  return 2.0f * sample[0] + (sample[1] > 5.0f ? 10.0f : 0.0f) * sample[2];
+}
+
+void GenerateSamples(int num_samples,
+                     int feature_size,
+                     std::mt19937* rng,
+                     std::vector<std::vector<float>>* samples,
+                     std::vector<float>* labels) {
+  std::uniform_real_distribution<float> dist(0.0f, 10.0f);
+  samples->assign(num_samples, std::vector<float>(feature_size));
+  labels->resize(num_samples);
+  for (int i = 0; i < num_samples; ++i) {
+    for (int j = 0; j < feature_size; ++j) {
+      (*samples)[i][j] = dist(*rng);
+    }
+    (*labels)[i] = TargetFunction((*samples)[i]);
+  }
+}
+
+float MeanSquaredError(const std::vector<float>& preds, const std::vector<float>& labels) {
+  float res = 0;
+  for (size_t i = 0; i < preds.size(); ++i) {
+    res += (preds[i] - labels[i]) * (preds[i] - labels[i]);
+  }
+  return res / preds.size();
+}
+
+}  // namespace
+
+TEST(GbdtCostModel, TrainAndPredict) {
+  std::mt19937 rng(0);
+  std::vector<std::vector<float>> samples, test_samples;
+  std::vector<float> labels, test_labels;
+  GenerateSamples(2048, 8, &rng, &samples, &labels);
+  GenerateSamples(512, 8, &rng, &test_samples, &test_labels);
+
+  GbdtCostModel::Options options;
+  options.num_train_rounds = 50;
+  options.num_threads      = 4;
+  GbdtCostModel cost_model(options);
+  ASSERT_EQ(cost_model.Predict(test_samples), std::vector<float>(test_samples.size(), 0.0f));
+
+  cost_model.Train(samples, labels);
+  ASSERT_EQ(cost_model.num_trees(), 50);
+  std::vector<float> preds = cost_model.Predict(test_samples);
+  ASSERT_EQ(preds.size(), test_samples.size());
+
+  // the model explains most of the variance of the labels
+  float mean     = std::accumulate(test_labels.begin(), test_labels.end(), 0.0f) / test_labels.size();
+  float mse      = MeanSquaredError(preds, test_labels);
+  float variance = MeanSquaredError(std::vector<float>(test_labels.size(), mean), test_labels);
+  VLOG(3) << "The mean squared error of GbdtCostModel is " << mse << ", the variance of the labels is " << variance;
+  ASSERT_LT(mse, 0.1f * variance);
+
+  // the prediction does not depend on the number of threads
+  options.num_threads = 1;
+  GbdtCostModel serial_cost_model(options);
+  serial_cost_model.Train(samples, labels);
+  ASSERT_EQ(serial_cost_model.Predict(test_samples), preds);
+}
+
+TEST(GbdtCostModel, Update) {
+  std::mt19937 rng(0);
+  std::vector<std::vector<float>> samples, new_samples;
+  std::vector<float> labels, new_labels;
+  GenerateSamples(256, 4, &rng, &samples, &labels);
+  GenerateSamples(1024, 4, &rng, &new_samples, &new_labels);
+
+  GbdtCostModel::Options options;
+  options.num_update_rounds = 10;
+  GbdtCostModel cost_model(options);
+  // the first Update trains the model
+  cost_model.Update(samples, labels);
+  ASSERT_EQ(cost_model.num_trees(), options.num_train_rounds);
+
+  float mse_before = MeanSquaredError(cost_model.Predict(new_samples), new_labels);
+  cost_model.Update(new_samples, new_labels);
+  ASSERT_EQ(cost_model.num_trees(), options.num_train_rounds + options.num_update_rounds);
+  float mse_after = MeanSquaredError(cost_model.Predict(new_samples), new_labels);
+  ASSERT_LT(mse_after, mse_before);
+}
+
+TEST(GbdtCostModel, SaveAndLoad) {
+  std::mt19937 rng(0);
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(128, 6, &rng, &samples, &labels);
+
+  GbdtCostModel cost_model;
+  cost_model.Train(samples, labels);
+  std::vector<float> preds = cost_model.Predict(samples);
+
+  std::string path = "./test_gbdt_cost_model.cpp_save_model";
+  cost_model.Save(path);
+
+  GbdtCostModel load_cost_model;
+  load_cost_model.Load(path);
+  ASSERT_EQ(load_cost_model.num_trees(), cost_model.num_trees());
+  ASSERT_EQ(load_cost_model.Predict(samples), preds);
+
+  // the loaded model can be updated with the new samples
+  load_cost_model.Update(samples, labels);
+  ASSERT_GT(load_cost_model.num_trees(), cost_model.num_trees());
+  std::remove(path.c_str());
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
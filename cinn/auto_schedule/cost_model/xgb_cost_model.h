@@ -0,0 +1,62 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <pybind11/embed.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/cost_model/cost_model.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * A C++ cost model which calls Python XGBoost cost model via pybind
+ *
+ * Note: this class doesn't handle Python interpreter lifttime, users should
+ * manage scoped_interpreter/initialize_interpreter/finalize_interpreter by
+ * themselves. For pybind interpreter lifetime management, see:
+ *
+ *   https://pybind11.readthedocs.io/en/stable/advanced/embedding.html#interpreter-lifetime
+ *   https://pybind11.readthedocs.io/en/stable/reference.html#_CPPv422initialize_interpreterbiPPCKcb
+ */
+class XgbCostModel : public CostModel {
+ public:
+  XgbCostModel();
+  ~XgbCostModel();
+
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const override;
+
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  void Save(const std::string& path) override;
+
+  void Load(const std::string& path) override;
+
+ private:
+  // Object points to Python CostModel
+  pybind11::object python_member_;
+
+  // Flag to call_once on python inititalization function
+  static std::once_flag init_once_flag_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -12,7 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/cost_model/xgb_cost_model.h"
 
 #include <gtest/gtest.h>
 #include <pybind11/embed.h>
@@ -25,9 +25,9 @@
 namespace cinn {
 namespace auto_schedule {
 
-TEST(CostModel, Basic) {
+TEST(XgbCostModel, Basic) {
   pybind11::scoped_interpreter guard{};
-  CostModel cost_model;
+  XgbCostModel cost_model;
 
   srand(time(NULL));
 
@@ -47,7 +47,7 @@ TEST(CostModel, Basic) {
   std::string path = "./test_cost_model.cpp_save_model";
   cost_model.Save(path);
 
-  CostModel load_cost_model;
+  XgbCostModel load_cost_model;
   load_cost_model.Load(path);
   std::vector<float> load_pred = cost_model.Predict(samples);
 
@@ -0,0 +1,346 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/database.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <set>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/structural_hash.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TuningRecord::TuningRecord(const std::string& task_key, double execution_cost, const ir::ModuleExpr& mod_expr)
+    : task_key(task_key), execution_cost(execution_cost), mod_expr(mod_expr) {
+  timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+                  .count();
+  schedule_ir   = utils::Join(mod_expr.GetExprs(), "\n");
+  schedule_hash = ir::StructuralHash(mod_expr.GetExprs());
+}
+
+TuningRecord::TuningRecord(const proto::TuningRecord& record)
+    : task_key(record.task_key()),
+      execution_cost(record.execution_cost()),
+      predicted_cost(record.predicted_cost()),
+      timestamp(record.timestamp()),
+      schedule_ir(record.schedule_ir()),
+      schedule_hash(record.schedule_hash()),
+      has_trace(record.has_trace()),
+      source_hash(record.source_hash()),
+      source_names(record.source_names().begin(), record.source_names().end()) {
+  if (has_trace) {
+    ir::proto::ScheduleDesc trace_proto;
+    CHECK(trace_proto.ParseFromString(record.trace())) << "Failed to parse the trace of the tuning record";
+    trace = ir::ScheduleDesc(trace_proto);
+  }
+}
+
+namespace {
+
+std::vector<ir::Expr> CopyBodies(const std::vector<ir::LoweredFunc>& funcs) {
+  std::vector<ir::Expr> bodies;
+  for (const ir::LoweredFunc& func : funcs) {
+    bodies.push_back(optim::IRCopy(func->body));
+  }
+  return bodies;
+}
+
+// The names of the tensors and schedule blocks in the order they first appear in the exprs, which correspond
+// to each other between structurally equal exprs
+std::vector<std::string> CollectNamesInOrder(const std::vector<ir::Expr>& exprs) {
+  std::vector<std::string> names;
+  std::set<std::string> visited;
+  for (const ir::Expr& expr : exprs) {
+    ir::CollectIRNodesWithoutTensor(expr, [&](const ir::Expr* x) {
+      if (x->as_tensor() && visited.insert(x->as_tensor()->name).second) {
+        names.push_back(x->as_tensor()->name);
+      } else if (x->As<ir::ScheduleBlock>() && visited.insert(x->As<ir::ScheduleBlock>()->name).second) {
+        names.push_back(x->As<ir::ScheduleBlock>()->name);
+      }
+      return false;
+    });
+  }
+  return names;
+}
+
+// Map a name of the source functions, the names derived from a source name by a suffix, such as the
+// cache block "C_local" of "C", are mapped by the longest source name they start with
+std::string MapName(const std::map<std::string, std::string>& name_map, const std::string& name) {
+  auto it = name_map.find(name);
+  if (it != name_map.end()) {
+    return it->second;
+  }
+  const std::pair<const std::string, std::string>* prefix = nullptr;
+  for (const auto& item : name_map) {
+    if (name.size() > item.first.size() + 1 && name.compare(0, item.first.size(), item.first) == 0 &&
+        name[item.first.size()] == '_' && (!prefix || item.first.size() > prefix->first.size())) {
+      prefix = &item;
+    }
+  }
+  return prefix ? prefix->second + name.substr(prefix->first.size()) : name;
+}
+
+// Replace the tensors of the source functions by the tensors of the same names and rename the blocks
+class NameReplacer : public ir::IRMutator<ir::Expr*> {
+ public:
+  NameReplacer(const std::map<std::string, std::string>& name_map,
+               const std::map<std::string, ir::Tensor>& tensor_map)
+      : name_map_(name_map), tensor_map_(tensor_map) {}
+
+  void operator()(ir::Expr* expr) { ir::IRMutator<ir::Expr*>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::_Tensor_* op, ir::Expr* expr) override {
+    auto it = name_map_.find(op->name);
+    if (it != name_map_.end() && tensor_map_.count(it->second)) {
+      *expr = ir::Expr(tensor_map_.at(it->second));
+      return;
+    }
+    ir::IRMutator<ir::Expr*>::Visit(op, expr);
+  }
+
+  void Visit(const ir::ScheduleBlock* op, ir::Expr* expr) override {
+    auto* node = expr->As<ir::ScheduleBlock>();
+    auto it    = name_map_.find(node->name);
+    if (it != name_map_.end()) {
+      node->name = it->second;
+    }
+    ir::IRMutator<ir::Expr*>::Visit(op, expr);
+  }
+
+  const std::map<std::string, std::string>& name_map_;
+  const std::map<std::string, ir::Tensor>& tensor_map_;
+};
+
+// the names of the source functions mapped to the corresponding names of the exprs
+std::map<std::string, std::string> MakeNameMap(const std::vector<std::string>& source_names,
+                                               const std::vector<std::string>& names) {
+  CHECK_EQ(source_names.size(), names.size()) << "The names of structurally equal functions should correspond";
+  std::map<std::string, std::string> name_map;
+  for (size_t i = 0; i < names.size(); ++i) {
+    name_map.emplace(source_names[i], names[i]);
+  }
+  return name_map;
+}
+
+}  // namespace
+
+void TuningRecord::SetSourceFuncs(const std::vector<ir::LoweredFunc>& funcs) {
+  std::vector<ir::Expr> bodies = CopyBodies(funcs);
+  source_hash                  = ir::StructuralHash(bodies);
+  source_names                 = CollectNamesInOrder(bodies);
+}
+
+bool TuningRecord::IsApplicableTo(const std::vector<ir::LoweredFunc>& funcs) const {
+  if ((!HasModuleExpr() && !has_trace) || source_hash == 0) return false;
+  std::vector<ir::Expr> bodies;
+  for (const ir::LoweredFunc& func : funcs) {
+    bodies.push_back(func->body);
+  }
+  return ir::StructuralHash(bodies) == source_hash && CollectNamesInOrder(bodies).size() == source_names.size();
+}
+
+ir::ScheduleDesc TuningRecord::MapTraceTo(const std::vector<ir::LoweredFunc>& funcs) const {
+  CHECK(IsApplicableTo(funcs)) << "The tuning record of task " << task_key << " is not applicable";
+  auto name_map           = MakeNameMap(source_names, CollectNamesInOrder(CopyBodies(funcs)));
+  ir::ScheduleDesc mapped = trace;
+  for (ir::ScheduleDesc::Step& step : *mapped.MutableSteps()) {
+    for (ir::ScheduleDesc::ExprRef& ref : step.inputs) {
+      ref.block_name = MapName(name_map, ref.block_name);
+    }
+  }
+  return mapped;
+}
+
+std::vector<ir::Expr> TuningRecord::ApplyTo(const std::vector<ir::LoweredFunc>& funcs) const {
+  CHECK(IsApplicableTo(funcs)) << "The tuning record of task " << task_key << " is not applicable";
+  std::vector<ir::Expr> bodies   = CopyBodies(funcs);
+  std::vector<std::string> names = CollectNamesInOrder(bodies);
+  if (HasModuleExpr() && names == source_names) {
+    return optim::IRCopy(mod_expr.GetExprs());
+  }
+  if (has_trace) {
+    ir::IRSchedule schedule(ir::ModuleExpr(bodies));
+    MapTraceTo(funcs).Replay(&schedule);
+    return schedule.GetModule().GetExprs();
+  }
+
+  // the tensors created by the schedule, such as the cache tensors, keep their names
+  std::map<std::string, ir::Tensor> tensor_map;
+  for (const ir::Expr& body : bodies) {
+    ir::CollectIRNodesWithoutTensor(body, [&](const ir::Expr* x) {
+      if (x->as_tensor()) {
+        tensor_map.emplace(x->as_tensor()->name, x->as_tensor_ref());
+      }
+      return false;
+    });
+  }
+  auto name_map = MakeNameMap(source_names, names);
+  NameReplacer replacer(name_map, tensor_map);
+  std::vector<ir::Expr> exprs = optim::IRCopy(mod_expr.GetExprs());
+  for (ir::Expr& expr : exprs) {
+    replacer(&expr);
+  }
+  return exprs;
+}
+
+proto::TuningRecord TuningRecord::ToProto() const {
+  proto::TuningRecord record;
+  record.set_task_key(task_key);
+  record.set_execution_cost(execution_cost);
+  record.set_predicted_cost(predicted_cost);
+  record.set_timestamp(timestamp);
+  record.set_schedule_ir(schedule_ir);
+  record.set_schedule_hash(schedule_hash);
+  record.set_has_trace(has_trace);
+  if (has_trace) {
+    CHECK(trace.ToProto().SerializeToString(record.mutable_trace())) << "Failed to serialize the trace";
+  }
+  record.set_source_hash(source_hash);
+  for (const std::string& name : source_names) {
+    record.add_source_names(name);
+  }
+  return record;
+}
+
+Database::Database(int capacity_per_task) : capacity_per_task_(capacity_per_task) {
+  CHECK_GT(capacity_per_task_, 0);
+}
+
+std::unique_ptr<Database> Database::Make(const std::string& path, int capacity_per_task) {
+  if (path.empty()) {
+    return std::make_unique<Database>(capacity_per_task);
+  }
+  return std::make_unique<FileDatabase>(path, capacity_per_task);
+}
+
+bool Database::Insert(const TuningRecord& record) {
+  std::lock_guard<std::mutex> lock(mu_);
+  // the records without hash, such as those saved by old versions, can not be deduplicated
+  if (record.schedule_hash != 0 && !key2schedule_hashes_[record.task_key].insert(record.schedule_hash).second) {
+    return false;
+  }
+  auto it = key2records_.try_emplace(record.task_key, capacity_per_task_).first;
+  it->second.Push(record);
+  return true;
+}
+
+bool Database::AddRecord(const TuningRecord& record) {
+  CHECK(!record.task_key.empty()) << "The task key of a record should not be empty";
+  if (!Insert(record)) {
+    VLOG(4) << "The schedule " << record.schedule_hash << " of task " << record.task_key << " has been recorded";
+    return false;
+  }
+  Commit(record);
+  return true;
+}
+
+bool Database::HasRecord(const std::string& task_key, uint64_t schedule_hash) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = key2schedule_hashes_.find(task_key);
+  return it != key2schedule_hashes_.end() && it->second.count(schedule_hash);
+}
+
+std::vector<TuningRecord> Database::GetRecords(const std::string& task_key) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = key2records_.find(task_key);
+  if (it == key2records_.end()) {
+    return {};
+  }
+  return it->second.ReturnAsContainer<std::vector<TuningRecord>>();
+}
+
+std::vector<TuningRecord> Database::GetTopK(const std::string& task_key, int k) const {
+  auto records = GetRecords(task_key);
+  if (records.size() > k) {
+    records.resize(std::max(k, 0));
+  }
+  return records;
+}
+
+size_t Database::Size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  size_t res = 0;
+  for (auto& item : key2records_) {
+    res += item.second.Size();
+  }
+  return res;
+}
+
+FileDatabase::FileDatabase(const std::string& path, int capacity_per_task)
+    : Database(capacity_per_task), path_(path) {
+  LoadFromFile();
+}
+
+void FileDatabase::LoadFromFile() {
+  std::ifstream is(path_, std::ios::binary);
+  if (!is.is_open()) {
+    VLOG(3) << "The tuning record file " << path_ << " does not exist, a new one will be created";
+    return;
+  }
+  is.seekg(0, std::ios::end);
+  uint64_t file_size = is.tellg();
+  is.seekg(0, std::ios::beg);
+  int num_records = 0;
+  while (true) {
+    uint64_t length = 0;
+    if (!is.read(reinterpret_cast<char*>(&length), sizeof(length))) break;
+    if (length > file_size - static_cast<uint64_t>(is.tellg())) {
+      LOG(WARNING) << "Ignore the truncated tuning record at the end of " << path_;
+      break;
+    }
+    std::string buffer(length, '\0');
+    if (!is.read(&buffer[0], length)) {
+      LOG(WARNING) << "Ignore the truncated tuning record at the end of " << path_;
+      break;
+    }
+    proto::TuningRecord record;
+    if (!record.ParseFromString(buffer)) {
+      LOG(WARNING) << "Failed to parse the " << num_records << "-th tuning record of " << path_ << ", stop loading";
+      break;
+    }
+    Insert(TuningRecord(record));
+    ++num_records;
+  }
+  VLOG(3) << "Load " << num_records << " tuning records from " << path_;
+}
+
+void FileDatabase::Commit(const TuningRecord& record) {
+  std::string buffer;
+  CHECK(record.ToProto().SerializeToString(&buffer)) << "Failed to serialize the tuning record";
+  uint64_t length = buffer.size();
+
+  std::lock_guard<std::mutex> lock(mu_);
+  std::ofstream os(path_, std::ios::binary | std::ios::app);
+  CHECK(os.is_open()) << "Failed to open the tuning record file " << path_;
+  os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  os.write(buffer.data(), buffer.size());
+  os.flush();
+  CHECK(os.good()) << "Failed to write the tuning record to " << path_;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,167 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/database/auto_schedule.pb.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/lowered_func.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/utils/sized_multi_set.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// A measured schedule of a task
+struct TuningRecord {
+  // the serialized task with the target, see TuneTask::SerializeToString
+  std::string task_key;
+  // the measured execution time, unit: us
+  double execution_cost;
+  // the execution time predicted by the cost model, unit: us, negative if not predicted
+  double predicted_cost = -1.0;
+  // the time the record is created, in seconds since epoch
+  int64_t timestamp = 0;
+  // the textual IR of the schedule result
+  std::string schedule_ir;
+  // the structural hash of the scheduled exprs, see ir::StructuralHash, 0 if unknown
+  uint64_t schedule_hash = 0;
+  // the scheduled exprs of the task, which are not persisted and only available
+  // for the records added by the current process
+  ir::ModuleExpr mod_expr;
+  // the schedule primitives applied to the lowered functions to get the mod_expr, which are
+  // persisted and replayed to reproduce the schedule in another process, only valid if has_trace
+  ir::ScheduleDesc trace;
+  bool has_trace = false;
+  // the structural hash of the unoptimized bodies of the lowered functions the schedule is applied to,
+  // see ir::StructuralHash, 0 if unknown
+  uint64_t source_hash = 0;
+  // the names of the tensors and blocks in the unoptimized bodies in the order they first appear, which the
+  // exprs and the trace refer to. They are mapped to the names of the structurally equal functions the record
+  // is applied to, so a record applies to the same subgraph of another model or process
+  std::vector<std::string> source_names;
+
+  TuningRecord() = default;
+  TuningRecord(const std::string& task_key, double execution_cost, const ir::ModuleExpr& mod_expr);
+  explicit TuningRecord(const proto::TuningRecord& record);
+
+  proto::TuningRecord ToProto() const;
+
+  // whether the schedule can be applied to the task directly
+  bool HasModuleExpr() const { return !mod_expr.GetExprs().empty(); }
+
+  // set the source_hash and source_names by the unoptimized lowered functions the schedule is applied to
+  void SetSourceFuncs(const std::vector<ir::LoweredFunc>& funcs);
+
+  // whether the schedule can be applied to the lowered functions, by the mod_expr or the trace, which
+  // requires the functions to be structurally equal to the source functions
+  bool IsApplicableTo(const std::vector<ir::LoweredFunc>& funcs) const;
+
+  // The scheduled exprs of the lowered functions, which are copied from the mod_expr if the functions are
+  // named the same as the source functions, or replayed from the trace renamed by MapTraceTo otherwise,
+  // e.g. for the records loaded from a file or tuned on another model. A record without trace falls back
+  // to the mod_expr with the tensors replaced. IsApplicableTo(funcs) should be true
+  std::vector<ir::Expr> ApplyTo(const std::vector<ir::LoweredFunc>& funcs) const;
+
+  // The trace with the blocks renamed after the corresponding ones of the lowered functions, including the
+  // blocks derived from them such as the cache blocks. IsApplicableTo(funcs) should be true
+  ir::ScheduleDesc MapTraceTo(const std::vector<ir::LoweredFunc>& funcs) const;
+
+  // compare by the execution cost, the faster the smaller
+  struct Compare {
+    bool operator()(const TuningRecord& lhs, const TuningRecord& rhs) const {
+      return lhs.execution_cost < rhs.execution_cost;
+    }
+  };
+};
+
+/**
+ * A database keeping the best records of each task in memory. It is thread-safe.
+ */
+class Database {
+ public:
+  /**
+   * Constructor.
+   * @param capacity_per_task The number of the fastest records kept for each task.
+   */
+  explicit Database(int capacity_per_task = 8);
+  virtual ~Database() = default;
+
+  /**
+   * Create a database from the path, an append-only file database is returned if the path is not empty,
+   * otherwise an in-memory one.
+   */
+  static std::unique_ptr<Database> Make(const std::string& path = "", int capacity_per_task = 8);
+
+  // Add a record, which is committed to the storage of the database. A record whose schedule
+  // has been recorded for the task is ignored, and false is returned
+  bool AddRecord(const TuningRecord& record);
+
+  // Whether a schedule of the structural hash has been recorded for the task
+  bool HasRecord(const std::string& task_key, uint64_t schedule_hash) const;
+
+  // The records of the task sorted by the execution cost in ascending order
+  std::vector<TuningRecord> GetRecords(const std::string& task_key) const;
+
+  // The k fastest records of the task, fewer records are returned if not enough
+  std::vector<TuningRecord> GetTopK(const std::string& task_key, int k) const;
+
+  // The number of the records kept in memory
+  size_t Size() const;
+
+ protected:
+  // Insert the record into memory without committing it, return false if the schedule is recorded
+  bool Insert(const TuningRecord& record);
+
+  // Commit the record to the storage, nothing to do for the in-memory database
+  virtual void Commit(const TuningRecord& record) {}
+
+  int capacity_per_task_;
+  mutable std::mutex mu_;
+  absl::flat_hash_map<std::string, utils::SizedMultiSet<TuningRecord, TuningRecord::Compare>> key2records_;
+  // the hashes of all the schedules recorded for each task, including those not kept in key2records_
+  absl::flat_hash_map<std::string, absl::flat_hash_set<uint64_t>> key2schedule_hashes_;
+};
+
+/**
+ * A database persisting all the records to an append-only log file, each record is a length-prefixed
+ * serialized proto::TuningRecord. The file is loaded on construction, so the records of the previous
+ * tuning runs are kept across processes. A truncated record at the tail, left by a crashed process,
+ * is ignored.
+ */
+class FileDatabase : public Database {
+ public:
+  FileDatabase(const std::string& path, int capacity_per_task = 8);
+
+  const std::string& path() const { return path_; }
+
+ protected:
+  void Commit(const TuningRecord& record) override;
+
+ private:
+  void LoadFromFile();
+
+  std::string path_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
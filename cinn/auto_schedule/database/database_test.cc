@@ -0,0 +1,203 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/database.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/structural_hash.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TuningRecord MakeRecord(const std::string& task_key, double cost) {
+  return TuningRecord(task_key, cost, ir::ModuleExpr({ir::Expr(static_cast<int>(cost))}));
+}
+
+TEST(Database, TopK) {
+  Database db(3);
+  for (double cost : {5.0, 1.0, 4.0, 2.0, 3.0}) {
+    db.AddRecord(MakeRecord("task_a", cost));
+  }
+  db.AddRecord(MakeRecord("task_b", 10.0));
+
+  // only the 3 fastest records of each task are kept
+  EXPECT_EQ(db.Size(), 4UL);
+  auto records = db.GetRecords("task_a");
+  ASSERT_EQ(records.size(), 3UL);
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  EXPECT_EQ(records[1].execution_cost, 2.0);
+  EXPECT_EQ(records[2].execution_cost, 3.0);
+  EXPECT_TRUE(records[0].HasModuleExpr());
+
+  auto top1 = db.GetTopK("task_a", 1);
+  ASSERT_EQ(top1.size(), 1UL);
+  EXPECT_EQ(top1[0].execution_cost, 1.0);
+  EXPECT_EQ(db.GetTopK("task_b", 8).size(), 1UL);
+  EXPECT_TRUE(db.GetTopK("task_c", 8).empty());
+}
+
+TEST(Database, Deduplicate) {
+  Database db(3);
+  EXPECT_TRUE(db.AddRecord(MakeRecord("task_a", 1.0)));
+  // the same schedule measured again is ignored
+  EXPECT_FALSE(db.AddRecord(MakeRecord("task_a", 1.0)));
+  EXPECT_TRUE(db.AddRecord(MakeRecord("task_b", 1.0)));
+  EXPECT_EQ(db.Size(), 2UL);
+
+  uint64_t schedule_hash = MakeRecord("task_a", 1.0).schedule_hash;
+  EXPECT_NE(schedule_hash, 0UL);
+  EXPECT_TRUE(db.HasRecord("task_a", schedule_hash));
+  EXPECT_FALSE(db.HasRecord("task_a", MakeRecord("task_a", 2.0).schedule_hash));
+  EXPECT_FALSE(db.HasRecord("task_c", schedule_hash));
+}
+
+TEST(FileDatabase, PersistAndReload) {
+  std::string path = "./test_file_database.log";
+  std::remove(path.c_str());
+  {
+    auto db = Database::Make(path, 2);
+    db->AddRecord(MakeRecord("task_a", 3.0));
+    db->AddRecord(MakeRecord("task_a", 1.0));
+    db->AddRecord(MakeRecord("task_b", 2.0));
+  }
+
+  FileDatabase reloaded(path, 2);
+  EXPECT_EQ(reloaded.Size(), 3UL);
+  auto records = reloaded.GetRecords("task_a");
+  ASSERT_EQ(records.size(), 2UL);
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  EXPECT_EQ(records[0].schedule_ir, "1");
+  EXPECT_EQ(records[0].schedule_hash, MakeRecord("task_a", 1.0).schedule_hash);
+  // the exprs are not persisted
+  EXPECT_FALSE(records[0].HasModuleExpr());
+
+  // a truncated record at the tail is ignored
+  {
+    std::ofstream os(path, std::ios::binary | std::ios::app);
+    uint64_t length = 100;
+    os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    os.write("broken", 6);
+  }
+  FileDatabase truncated(path, 2);
+  EXPECT_EQ(truncated.Size(), 3UL);
+  std::remove(path.c_str());
+}
+
+// lower out[i, j] = in[i, j] + 1, the names are the same every time it is lowered with the same arguments
+std::vector<ir::LoweredFunc> LowerAddOne(const std::string& in_name = "A",
+                                         const std::string& out_name = "B",
+                                         const std::string& func_name = "test_database_add_one",
+                                         int n = 64) {
+  Context::Global().ResetNameId();
+  Expr M(32);
+  Expr N(n);
+
+  Placeholder<float> A(in_name, {M, N});
+  auto B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + Expr(1.f); }, out_name);
+  auto stages = CreateStages({A, B});
+  return lang::LowerVec(func_name, stages, {A, B}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+}
+
+TuningRecord MakeTracedRecord(const std::vector<ir::LoweredFunc>& funcs, int factor, double cost) {
+  std::vector<ir::Expr> exprs;
+  for (const ir::LoweredFunc& func : funcs) {
+    exprs.push_back(optim::IRCopy(func->body));
+  }
+  ir::IRSchedule ir_sch(ir::ModuleExpr(exprs));
+  ir_sch.EnableTrace();
+  ir_sch.Split("B", 1, {factor, -1});
+
+  TuningRecord record("task_a", cost, ir_sch.GetModule());
+  record.trace     = ir_sch.GetTraceDesc();
+  record.has_trace = true;
+  record.SetSourceFuncs(funcs);
+  return record;
+}
+
+TEST(FileDatabase, ReplayReloadedRecord) {
+  std::string path = "./test_file_database_replay.log";
+  std::remove(path.c_str());
+  std::vector<ir::LoweredFunc> funcs = LowerAddOne();
+  TuningRecord best                  = MakeTracedRecord(funcs, 4, 1.0);
+  {
+    auto db = Database::Make(path, 2);
+    db->AddRecord(MakeTracedRecord(funcs, 8, 2.0));
+    db->AddRecord(best);
+  }
+
+  // a fresh database in another run only has the persisted trace, which is replayed on the newly lowered functions
+  FileDatabase reloaded(path, 2);
+  std::vector<ir::LoweredFunc> new_funcs = LowerAddOne();
+  auto records                           = reloaded.GetRecords("task_a");
+  ASSERT_EQ(records.size(), 2UL);
+  const TuningRecord& best_reloaded = records[0];
+  EXPECT_EQ(best_reloaded.execution_cost, 1.0);
+  EXPECT_FALSE(best_reloaded.HasModuleExpr());
+  ASSERT_TRUE(best_reloaded.has_trace);
+  ASSERT_TRUE(best_reloaded.IsApplicableTo(new_funcs));
+
+  std::vector<ir::Expr> applied = best_reloaded.ApplyTo(new_funcs);
+  ASSERT_EQ(applied.size(), best.mod_expr.GetExprs().size());
+  EXPECT_EQ(ir::StructuralHash(applied), best.schedule_hash);
+  EXPECT_EQ(utils::Join(applied, "\n"), best.schedule_ir);
+  // the lowered functions are not changed by the replay
+  EXPECT_EQ(utils::GetStreamCnt(new_funcs[0]->body), utils::GetStreamCnt(funcs[0]->body));
+
+  // the records of structurally different functions are not applicable
+  EXPECT_FALSE(best_reloaded.IsApplicableTo(LowerAddOne("A", "B", "test_database_add_one", 32)));
+  std::remove(path.c_str());
+}
+
+TEST(TuningRecord, ApplyToStructurallyEqualFuncs) {
+  std::vector<ir::LoweredFunc> funcs = LowerAddOne();
+  TuningRecord record                = MakeTracedRecord(funcs, 4, 1.0);
+  // the same subgraph in another model is lowered with other names
+  std::vector<ir::LoweredFunc> other_funcs = LowerAddOne("X", "Y", "test_database_other_add_one");
+  ASSERT_TRUE(record.IsApplicableTo(other_funcs));
+
+  // the trace of a reloaded record and the exprs of a record without trace are renamed as well
+  TuningRecord reloaded(record.ToProto());
+  TuningRecord untraced = record;
+  untraced.has_trace    = false;
+  for (const TuningRecord* applied_record : {&record, &reloaded, &untraced}) {
+    std::vector<ir::Expr> applied = applied_record->ApplyTo(other_funcs);
+    EXPECT_EQ(ir::StructuralHash(applied), record.schedule_hash);
+    std::string applied_ir = utils::Join(applied, "\n");
+    EXPECT_EQ(applied_ir.find("B["), std::string::npos) << applied_ir;
+    EXPECT_NE(applied_ir.find("Y["), std::string::npos) << applied_ir;
+    ir::IRSchedule ir_sch(ir::ModuleExpr(applied));
+    EXPECT_EQ(ir_sch.GetLoops("Y").size(), 3UL);
+  }
+  for (const auto& step : reloaded.MapTraceTo(other_funcs).Steps()) {
+    for (const auto& ref : step.inputs) {
+      EXPECT_EQ(ref.block_name, "Y");
+    }
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
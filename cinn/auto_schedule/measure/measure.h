@@ -16,6 +16,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/task/tune_task.h"
@@ -39,16 +40,27 @@ struct MeasureInput {
 
 // The result of a measurement
 struct MeasureResult {
-  // The time cost of execution in average of running
-  // with a specific repeated times.
+  // The time cost of execution, which is the median of the
+  // costs of the timed repeats by default.
   double execution_cost;  // unit: us
+  // The minimum of the costs of the timed repeats.
+  double min_execution_cost = 0;  // unit: us
+  // The number of the timed repeats.
+  int repeat_times = 0;
   // The time cost of the whole measurement process including
   // building and running
   double elapsed_time;  // unit: us
+  // The error raised by building or running, or the timeout of them.
+  // It is empty if the measurement succeeded, otherwise the
+  // execution_cost is the max value of double
+  std::string error_msg;
 };
 
 // The result of building with input schedule
 struct BuildResult {
+  // The compiler owning the compiled codes of runtime_program, so it
+  // should be released after runtime_program
+  std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
   // The scope that owns detail compilation infos of parameters in the runtime program
   const hlir::framework::Scope* compiled_scope;
   // The executable program
@@ -58,9 +70,12 @@ struct BuildResult {
 // This interface defines how to generate executable objects
 // with input schedule. A builer should not contain stateful data
 // releated to any task so it can be called parallelly among multiple
-// processes of task tuning.
+// processes of task tuning, and Build may be called from multiple
+// threads concurrently.
 class ScheduleBuilder {
  public:
+  virtual ~ScheduleBuilder() = default;
+
   virtual BuildResult Build(const MeasureInput& input) = 0;
 };
 
@@ -68,6 +83,8 @@ class ScheduleBuilder {
 // a runner shoule be implemented with not bound to a specific task.
 class ScheduleRunner {
  public:
+  virtual ~ScheduleRunner() = default;
+
   virtual MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) = 0;
 };
 
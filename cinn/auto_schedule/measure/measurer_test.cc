@@ -14,7 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
@@ -73,5 +77,93 @@ TEST(ScheduleMeasurer, Basic) {
   ASSERT_EQ(inputs.size(), results.size());
 }
 
+// A builder whose behavior is decided by the number of lowered_funcs of the input:
+// it throws for 1, sleeps for 2 and builds nothing otherwise
+class FakeBuilder : public ScheduleBuilder {
+ public:
+  BuildResult Build(const MeasureInput& input) override {
+    if (input.lowered_funcs.size() == 1) {
+      throw std::runtime_error("fake build error");
+    }
+    if (input.lowered_funcs.size() == 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    return BuildResult();
+  }
+};
+
+// A runner taking the number of lowered_funcs of the input as the execution cost
+class FakeRunner : public ScheduleRunner {
+ public:
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override {
+    MeasureResult result;
+    result.execution_cost = input.lowered_funcs.size();
+    return result;
+  }
+};
+
+TEST(ScheduleMeasurer, ErrorAndTimeout) {
+  FakeBuilder builder;
+  FakeRunner runner;
+  ScheduleMeasurer::Options options;
+  options.num_build_threads = 4;
+  options.timeout_ms        = 100;
+  ScheduleMeasurer measurer(&builder, &runner, options);
+
+  std::vector<MeasureInput> inputs(6);
+  for (int i = 0; i < inputs.size(); ++i) {
+    inputs[i].task = nullptr;
+    inputs[i].lowered_funcs.resize(i);
+  }
+  std::vector<MeasureResult> results = measurer.Measure(inputs);
+  ASSERT_EQ(inputs.size(), results.size());
+  // the failed builds do not stop the others
+  EXPECT_NE(results[1].error_msg.find("fake build error"), std::string::npos);
+  EXPECT_NE(results[2].error_msg.find("timed out"), std::string::npos);
+  for (int i : {0, 3, 4, 5}) {
+    EXPECT_TRUE(results[i].error_msg.empty()) << results[i].error_msg;
+    EXPECT_EQ(results[i].execution_cost, i);
+  }
+}
+
+// A runner like FakeRunner, but sleeping for the inputs of 3 lowered_funcs
+class SlowRunner : public FakeRunner {
+ public:
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override {
+    if (input.lowered_funcs.size() == 3) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    return FakeRunner::Run(input, build_result);
+  }
+};
+
+TEST(ScheduleMeasurer, RunTimeoutAcrossBatches) {
+  FakeBuilder builder;
+  SlowRunner runner;
+  ScheduleMeasurer::Options options;
+  options.num_build_threads = 2;
+  options.timeout_ms        = 100;
+  ScheduleMeasurer measurer(&builder, &runner, options);
+
+  // the runs after the timed out one, in the same batch or the next, are measured on a new runner thread
+  for (auto& sizes : std::vector<std::vector<int>>{{0, 3, 4}, {0, 4, 5}}) {
+    std::vector<MeasureInput> inputs(sizes.size());
+    for (int i = 0; i < inputs.size(); ++i) {
+      inputs[i].task = nullptr;
+      inputs[i].lowered_funcs.resize(sizes[i]);
+    }
+    std::vector<MeasureResult> results = measurer.Measure(inputs);
+    ASSERT_EQ(inputs.size(), results.size());
+    for (int i = 0; i < inputs.size(); ++i) {
+      if (sizes[i] == 3) {
+        EXPECT_NE(results[i].error_msg.find("Run timed out"), std::string::npos);
+      } else {
+        EXPECT_TRUE(results[i].error_msg.empty()) << results[i].error_msg;
+        EXPECT_EQ(results[i].execution_cost, sizes[i]);
+      }
+    }
+  }
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
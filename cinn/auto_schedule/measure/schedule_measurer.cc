@@ -14,29 +14,238 @@
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 
+#include <glog/logging.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "cinn/utils/string.h"
+
 namespace cinn {
 namespace auto_schedule {
 
-ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner)
-    : builder_(builder), runner_(runner) {}
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MicrosecondsSince(Clock::time_point start) {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+MeasureResult ErrorResult(const std::string& error_msg) {
+  MeasureResult result;
+  result.execution_cost     = std::numeric_limits<double>::max();
+  result.min_execution_cost = std::numeric_limits<double>::max();
+  result.elapsed_time       = 0;
+  result.error_msg          = error_msg;
+  return result;
+}
+
+// bind the calling thread to the cores, nothing is done if the cores are empty
+void BindCurrentThread(const std::vector<int>& cores) {
+  if (cores.empty()) return;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int core : cores) {
+    CPU_SET(core, &cpuset);
+  }
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (ret != 0) {
+    LOG(WARNING) << "Failed to bind a thread of ScheduleMeasurer to cores " << utils::Join(cores, ",") << ": "
+                 << strerror(ret);
+  }
+}
+
+}  // namespace
+
+// The states of measuring a batch of inputs shared with the builder and runner threads.
+// It is owned by those threads too, since an abandoned build or run may outlive Measure.
+struct ScheduleMeasurer::Batch {
+  struct Slot {
+    bool build_started = false;
+    Clock::time_point build_start;
+    bool built = false;
+    BuildResult build_result;
+    std::string build_error;
+    double build_time = 0;  // unit: us
+    bool ran          = false;
+    MeasureResult result;
+  };
+
+  explicit Batch(const std::vector<MeasureInput>& inputs) : inputs(inputs), slots(inputs.size()) {}
+
+  const std::vector<MeasureInput> inputs;
+  std::vector<Slot> slots;
+  // the index of the next input to build
+  std::atomic<int> next_build{0};
+  // stop building the remaining inputs
+  std::atomic<bool> cancelled{false};
+  // guard the slots
+  std::mutex mu;
+  std::condition_variable cv;
+};
+
+ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, const Options& options)
+    : builder_(builder), runner_(runner), options_(options) {
+  int num_cores = std::max<int>(std::thread::hardware_concurrency(), 1);
+  std::vector<int> build_cores;
+  if (!options_.runner_cores.empty()) {
+    for (int core = 0; core < num_cores; ++core) {
+      if (std::find(options_.runner_cores.begin(), options_.runner_cores.end(), core) == options_.runner_cores.end()) {
+        build_cores.push_back(core);
+      }
+    }
+  }
+  int num_build_threads = options_.num_build_threads;
+  if (num_build_threads <= 0) {
+    num_build_threads = build_cores.empty() ? num_cores : build_cores.size();
+  }
+  VLOG(3) << "ScheduleMeasurer builds with " << num_build_threads << " threads on cores ["
+          << utils::Join(build_cores, ",") << "] and runs on cores [" << utils::Join(options_.runner_cores, ",")
+          << "]";
+
+  build_pool_ =
+      std::make_unique<utils::ThreadPool>(num_build_threads, [build_cores](int) { BindCurrentThread(build_cores); });
+  run_pool_ = CreateRunPool();
+}
+
+std::unique_ptr<utils::ThreadPool> ScheduleMeasurer::CreateRunPool() const {
+  std::vector<int> runner_cores = options_.runner_cores;
+  return std::make_unique<utils::ThreadPool>(1, [runner_cores](int) { BindCurrentThread(runner_cores); });
+}
+
+ScheduleMeasurer::~ScheduleMeasurer() {}
 
 std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureInput>& inputs) {
-  std::vector<MeasureResult> results;
-  for (auto i = 0; i < inputs.size(); ++i) {
-    auto m_start = std::chrono::steady_clock::now();
-    auto&& input = inputs.at(i);
-
-    BuildResult build_res = builder_->Build(input);
-    MeasureResult res     = runner_->Run(input, build_res);
-
-    auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
-    // use the time span counted in measurer
-    res.elapsed_time = static_cast<double>(time_span.count());
-    VLOG(5) << "Measurement-" << i << " cost " << res.elapsed_time << "us";
-    results.emplace_back(std::move(res));
+  auto measure_start = Clock::now();
+  auto batch         = std::make_shared<Batch>(inputs);
+  const int num_inputs = inputs.size();
+
+  // each build task keeps taking the next input, so the inputs are built in the order they are run
+  ScheduleBuilder* builder = builder_;
+  auto build_fn            = [builder, batch, num_inputs]() {
+    int i = 0;
+    while (!batch->cancelled && (i = batch->next_build++) < num_inputs) {
+      auto& slot = batch->slots[i];
+      {
+        std::lock_guard<std::mutex> lock(batch->mu);
+        slot.build_started = true;
+        slot.build_start   = Clock::now();
+      }
+      batch->cv.notify_all();
+
+      BuildResult build_result;
+      std::string build_error;
+      try {
+        build_result = builder->Build(batch->inputs[i]);
+      } catch (const std::exception& e) {
+        build_error = e.what();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(batch->mu);
+        slot.build_result = std::move(build_result);
+        slot.build_error  = std::move(build_error);
+        slot.build_time   = MicrosecondsSince(slot.build_start);
+        slot.built        = true;
+      }
+      batch->cv.notify_all();
+    }
+  };
+  for (int t = 0; t < std::min(build_pool_->num_threads(), num_inputs); ++t) {
+    build_pool_->Submit(build_fn);
+  }
+
+  auto timeout = std::chrono::milliseconds(options_.timeout_ms);
+  // wait until the predicate is satisfied or the deadline returned by deadline_fn is reached
+  auto wait_until = [&](std::unique_lock<std::mutex>* lock, auto&& pred, auto&& deadline_fn) {
+    while (!pred()) {
+      if (options_.timeout_ms <= 0) {
+        batch->cv.wait(*lock);
+      } else if (batch->cv.wait_until(*lock, deadline_fn()) == std::cv_status::timeout && !pred() &&
+                 Clock::now() >= deadline_fn()) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::vector<MeasureResult> results(num_inputs);
+  ScheduleRunner* runner = runner_;
+  for (int i = 0; i < num_inputs; ++i) {
+    auto& slot = batch->slots[i];
+    std::unique_lock<std::mutex> lock(batch->mu);
+    // the timeout of a build counts from its start, or from now if it is still queued behind abandoned builds
+    auto wait_start = Clock::now();
+    bool built      = wait_until(
+        &lock,
+        [&]() { return slot.built; },
+        [&]() { return (slot.build_started ? slot.build_start : wait_start) + timeout; });
+    if (!built) {
+      results[i] = ErrorResult("Build timed out after " + std::to_string(options_.timeout_ms) + "ms");
+      LOG(WARNING) << "Measurement-" << i << ": " << results[i].error_msg;
+      continue;
+    }
+    if (!slot.build_error.empty()) {
+      results[i] = ErrorResult("Build failed: " + slot.build_error);
+      LOG(WARNING) << "Measurement-" << i << ": " << results[i].error_msg;
+      continue;
+    }
+    lock.unlock();
+
+    run_pool_->Submit([runner, batch, i]() {
+      auto& slot     = batch->slots[i];
+      auto run_start = Clock::now();
+      MeasureResult result;
+      try {
+        result = runner->Run(batch->inputs[i], slot.build_result);
+      } catch (const std::exception& e) {
+        result = ErrorResult(std::string("Run failed: ") + e.what());
+      }
+      // use the time span counted in measurer
+      result.elapsed_time = slot.build_time + MicrosecondsSince(run_start);
+      // release the compiled codes as soon as they are measured
+      slot.build_result.runtime_program.reset();
+      slot.build_result.graph_compiler.reset();
+      {
+        std::lock_guard<std::mutex> lock(batch->mu);
+        slot.result = std::move(result);
+        slot.ran    = true;
+      }
+      batch->cv.notify_all();
+    });
+
+    lock.lock();
+    auto run_start = Clock::now();
+    bool ran       = wait_until(
+        &lock, [&]() { return slot.ran; }, [&]() { return run_start + timeout; });
+    if (!ran) {
+      // the runner thread is occupied by the abandoned run, so the following runs go to a new one
+      abandoned_run_pools_.emplace_back(std::move(run_pool_));
+      run_pool_  = CreateRunPool();
+      results[i] = ErrorResult("Run timed out after " + std::to_string(options_.timeout_ms) + "ms");
+      LOG(WARNING) << "Measurement-" << i << ": " << results[i].error_msg;
+      continue;
+    }
+    results[i] = std::move(slot.result);
+    VLOG(5) << "Measurement-" << i << " cost " << results[i].elapsed_time << "us";
   }
+  batch->cancelled = true;
 
-  VLOG(4) << "Measure " << inputs.size() << " tests";
+  double measure_time = MicrosecondsSince(measure_start);
+  VLOG(4) << "Measure " << inputs.size() << " tests in " << measure_time << "us, "
+          << (measure_time > 0 ? inputs.size() * 6e7 / measure_time : 0) << " trials per minute";
   return results;
 }
 
@@ -14,27 +14,62 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "cinn/auto_schedule/measure/measure.h"
+#include "cinn/utils/thread_pool.h"
 
 namespace cinn {
 namespace auto_schedule {
 
 // Entrance of schedule measurement, it mainly includes two processes:
 // which are building the input schedules and running the generated codes.
+// The inputs are built concurrently on a pool of builder threads, and each
+// built input is run on a single runner thread as soon as it is ready, so
+// building is pipelined against running while the runs never overlap.
 class ScheduleMeasurer {
  public:
-  ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner);
+  struct Options {
+    // The number of threads building the inputs, a value <= 0 uses every core
+    // except the runner cores
+    int num_build_threads = 1;
+    // The cores the runner thread is bound to, and the builder threads are
+    // bound to the other cores. Nothing is bound if it is empty
+    std::vector<int> runner_cores;
+    // The timeout of building or running an input, a value <= 0 means no timeout.
+    // A timed out build or run can not be interrupted, it is abandoned and keeps
+    // occupying its thread until it finishes, and the runner thread occupied is
+    // replaced by a new one for the following runs
+    int timeout_ms = 0;
+  };
 
-  // Measure a batch of inputs and return all results once.
+  ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, const Options& options = Options());
+
+  ~ScheduleMeasurer();
+
+  // Measure a batch of inputs and return all results once. A failed or timed out
+  // input gets a result with the error message instead of stopping the others.
   std::vector<MeasureResult> Measure(const std::vector<MeasureInput>& inputs);
 
  private:
+  struct Batch;
+
   // The handle to implemented ScheduleBuilder
   ScheduleBuilder* builder_;
   // The handle to implemented ScheduleRunner
   ScheduleRunner* runner_;
+
+  Options options_;
+
+  // create a pool of the single runner thread bound to the runner cores
+  std::unique_ptr<utils::ThreadPool> CreateRunPool() const;
+
+  std::unique_ptr<utils::ThreadPool> build_pool_;
+  // a single thread so the runs do not disturb each other
+  std::unique_ptr<utils::ThreadPool> run_pool_;
+  // the runner threads occupied by the timed out runs, which are joined on destruction
+  std::vector<std::unique_ptr<utils::ThreadPool>> abandoned_run_pools_;
 };
 
 }  // namespace auto_schedule
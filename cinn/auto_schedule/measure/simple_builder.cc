@@ -19,21 +19,28 @@ namespace auto_schedule {
 
 using hlir::framework::GraphCompiler;
 
-SimpleBuilder::SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler) : graph_compiler_(graph_compiler) {}
+SimpleBuilder::SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler) {
+  CHECK_NE(graph_compiler, static_cast<GraphCompiler*>(nullptr)) << "empty hanlde to GraphCompiler";
+  target_ = graph_compiler->GetTarget();
+  graph_  = graph_compiler->GetGraph();
+}
 
 BuildResult SimpleBuilder::Build(const MeasureInput& input) {
-  CHECK_NE(graph_compiler_, static_cast<GraphCompiler*>(nullptr)) << "empty hanlde to GraphCompiler";
+  // the scope is created for each build since the compiler adds the temporary variables of functions into it
+  auto scope          = hlir::framework::BuildScope(target_, graph_);
+  auto graph_compiler = std::make_unique<GraphCompiler>(target_, scope, graph_);
   GraphCompiler::CompileOptions compile_options;
   compile_options.groups                  = input.task->task_graph();
   compile_options.lowered_funcs           = input.lowered_funcs;
   compile_options.remove_unused_variables = false;
   VLOG(5) << "call GraphCompiler to Build with " << compile_options.groups.size() << " groups, "
           << compile_options.lowered_funcs.size() << " lowered_funcs";
-  GraphCompiler::CompilationResult compiled_result = graph_compiler_->Build(compile_options);
+  GraphCompiler::CompilationResult compiled_result = graph_compiler->Build(compile_options);
 
   BuildResult build_result;
-  build_result.compiled_scope  = graph_compiler_->GetScope().get();
+  build_result.compiled_scope  = scope.get();
   build_result.runtime_program = std::move(compiled_result.runtime_program);
+  build_result.graph_compiler  = std::move(graph_compiler);
   return build_result;
 }
 
@@ -14,23 +14,28 @@
 
 #pragma once
 
+#include <memory>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-// This class utilize the GraphCompiler bound to the graph to build
-// the input schedule as executable objects
+// This class builds the input schedule as executable objects with
+// a new GraphCompiler and scope on the graph of the given GraphCompiler,
+// so it keeps no state between builds and can build concurrently.
 class SimpleBuilder : public ScheduleBuilder {
  public:
+  // The graph_compiler only provides the target and the graph, it is not used to build
   SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler);
 
   // Build and pack the result
   BuildResult Build(const MeasureInput& input) override;
 
  private:
-  hlir::framework::GraphCompiler* graph_compiler_;
+  common::Target target_;
+  std::shared_ptr<hlir::framework::Graph> graph_;
 };
 
 }  // namespace auto_schedule
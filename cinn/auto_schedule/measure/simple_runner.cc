@@ -14,17 +14,25 @@
 
 #include "cinn/auto_schedule/measure/simple_runner.h"
 
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <random>
 
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/buffer.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/framework/tensor.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -33,10 +41,23 @@ using hlir::framework::Buffer;
 using hlir::framework::Shape;
 using hlir::framework::Tensor;
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MicrosecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// The values are generated with a fixed seed so that the measurements of a
+// kernel are repeatable, and they are kept in small ranges like the real data:
+// the floats never become denormals, infs or NaNs which take slow paths, and the
+// integers used as indices stay in the range of the indexed dimensions.
+constexpr unsigned kRandomSeed = 2022;
+
 // Generate random value and populate them to the output address of memeory
-static void PopulateRandomValue(const common::Type& type, const int numel, void* raw_ptr) {
-  std::random_device seed;
-  std::default_random_engine engine(seed());
+void PopulateRandomValue(const common::Type& type, const int numel, void* raw_ptr) {
+  std::default_random_engine engine(kRandomSeed);
 
   if (type == common::Bool()) {
     auto* fmt_ptr = reinterpret_cast<bool*>(raw_ptr);
@@ -44,43 +65,160 @@ static void PopulateRandomValue(const common::Type& type, const int numel, void*
     std::generate_n(fmt_ptr, numel, [&engine, &dist]() { return dist(engine); });
   } else if (type == common::I32()) {
     auto* fmt_ptr = reinterpret_cast<int*>(raw_ptr);
-    std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    std::uniform_int_distribution<int> dist(0, 3);
+    std::generate_n(fmt_ptr, numel, [&engine, &dist]() { return dist(engine); });
+  } else if (type == common::I64()) {
+    auto* fmt_ptr = reinterpret_cast<int64_t*>(raw_ptr);
+    std::uniform_int_distribution<int64_t> dist(0, 3);
     std::generate_n(fmt_ptr, numel, [&engine, &dist]() { return dist(engine); });
   } else if (type == common::F32()) {
     auto* fmt_ptr = reinterpret_cast<float*>(raw_ptr);
-    std::uniform_real_distribution<float> dist(std::numeric_limits<float>::min(), std::numeric_limits<float>::max());
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::generate_n(fmt_ptr, numel, [&engine, &dist]() { return dist(engine); });
+  } else if (type == common::F64()) {
+    auto* fmt_ptr = reinterpret_cast<double*>(raw_ptr);
+    std::uniform_real_distribution<double> dist(-1., 1.);
     std::generate_n(fmt_ptr, numel, [&engine, &dist]() { return dist(engine); });
   } else {
-    LOG(FATAL) << "Unsupported type:" << type;
+    // zeros are valid values of any type
+    VLOG(6) << "Fill zeros for the unsupported type:" << type;
+    std::memset(raw_ptr, 0, numel * ((type.bits() + 7) / 8));
   }
 }
 
 // Alloc a new buffer in specificed target with initial infos.
-static std::shared_ptr<Buffer> AllocBuffer(const common::Target& target,
-                                           const common::Type& type,
-                                           const Shape& shape,
-                                           bool fill_random_value = true) {
+std::shared_ptr<Buffer> AllocBuffer(const common::Target& target,
+                                    const common::Type& type,
+                                    const Shape& shape,
+                                    bool fill_random_value = true) {
   static constexpr int default_alignment = 1024;
   auto buffer                            = std::make_shared<Buffer>(target);
 
-  const uint32_t bytes_of_ele = static_cast<uint32_t>(std::floor(static_cast<float>(type.bits() + 1) / 8.0));
+  const uint32_t bytes_of_ele = static_cast<uint32_t>((type.bits() + 7) / 8);
   CHECK_GT(bytes_of_ele, 0) << "The number bytes of each element is invalid";
   VLOG(6) << "AllocBuffer-target:" << target << ",type:" << type << ",numel:" << shape.numel()
           << ",fill_random_value:" << fill_random_value;
 
+  const uint32_t bytes = shape.numel() * bytes_of_ele;
   if (target == common::DefaultHostTarget()) {
-    buffer->ResizeLazy(default_alignment, shape.numel() * bytes_of_ele);
+    buffer->ResizeLazy(default_alignment, bytes);
   } else {
-    buffer->ResizeLazy(shape.numel() * bytes_of_ele);
+    buffer->ResizeLazy(bytes);
   }
 
+  if (fill_random_value) {
+    if (target.arch == common::Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+      std::vector<uint8_t> host_data(bytes);
+      PopulateRandomValue(type, shape.numel(), host_data.data());
+      CUDA_CALL(cudaMemcpy(buffer->data()->memory, host_data.data(), bytes, cudaMemcpyHostToDevice));
+#endif
+    } else {
+      PopulateRandomValue(type, shape.numel(), buffer->data()->memory);
+    }
+  }
   return buffer;
 }
 
-SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
-  CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
+// The bytes written to flush the last level cache. Twice the size of the cache is
+// written since its replacement policy is not exactly LRU.
+int64_t GetFlushCacheBytes() {
+  static constexpr int64_t kDefaultCacheBytes = 32L << 20;
+  int64_t cache_bytes                         = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  cache_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  if (cache_bytes <= 0) {
+    cache_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  }
+#endif
+  if (cache_bytes <= 0) {
+    cache_bytes = kDefaultCacheBytes;
+  }
+  return 2 * cache_bytes;
+}
+
+// Write a byte of every cache line of the buffer to evict the other data from the cache
+void FlushCache(std::vector<char>* buffer) {
+  static constexpr int kCacheLineBytes = 64;
+  volatile char* data                  = buffer->data();
+  for (size_t i = 0; i < buffer->size(); i += kCacheLineBytes) {
+    data[i] = data[i] + 1;
+  }
+}
+
+// The standard deviation of the values divided by their mean
+double RelativeStddev(const std::vector<double>& values) {
+  double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  if (mean <= 0) {
+    return 0;
+  }
+  double square_sum = 0;
+  for (double value : values) {
+    square_sum += (value - mean) * (value - mean);
+  }
+  return std::sqrt(square_sum / values.size()) / mean;
+}
+
+double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t mid = values.size() / 2;
+  return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+// Bind the calling thread to the cores in the scope and restore its affinity
+// when leaving, nothing is done if the cores are empty
+class ScopedThreadBinding {
+ public:
+  explicit ScopedThreadBinding(const std::vector<int>& cores) {
+    if (cores.empty()) return;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &origin_cpuset_) != 0) return;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int core : cores) {
+      CPU_SET(core, &cpuset);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    if (ret != 0) {
+      LOG(WARNING) << "Failed to bind SimpleRunner to cores " << utils::Join(cores, ",") << ": " << strerror(ret);
+      return;
+    }
+    bound_ = true;
+  }
+
+  ~ScopedThreadBinding() {
+    if (bound_) {
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &origin_cpuset_);
+    }
+  }
+
+ private:
+  cpu_set_t origin_cpuset_;
+  bool bound_ = false;
+};
+
+// The options to time the instructions exactly repeat_times times
+SimpleRunner::Options FixedRepeatOptions(int repeat_times) {
+  SimpleRunner::Options options;
+  options.min_repeat_times       = repeat_times;
+  options.max_repeat_times       = repeat_times;
+  options.target_relative_stddev = 0;
+  options.max_repeat_time_ms     = 0;
+  return options;
+}
+
+}  // namespace
+
+SimpleRunner::SimpleRunner(const Options& options) : options_(options) {
+  CHECK_GE(options_.warmup_times, 0) << "warmup_times can't less than 0";
+  CHECK_GT(options_.min_repeat_times, 0) << "min_repeat_times should be greater than 0";
+  CHECK_GE(options_.max_repeat_times, options_.min_repeat_times)
+      << "max_repeat_times can't less than min_repeat_times";
 }
 
+SimpleRunner::SimpleRunner(int repeat_times) : SimpleRunner(FixedRepeatOptions(repeat_times)) {}
+
 // Prepare execution arguments of all instructions to run, a argument
 // may be obtained from the input of measurement or allocating new buffer
 // with random value.
@@ -138,33 +276,67 @@ std::map<std::string, cinn_pod_value_t> SimpleRunner::PrepareArgs(const MeasureI
 
 MeasureResult SimpleRunner::Run(const MeasureInput& input, const BuildResult& build_result) {
   MeasureResult result;
-  auto t_start = std::chrono::steady_clock::now();
+  auto t_start = Clock::now();
+  ScopedThreadBinding thread_binding(options_.bind_cores);
   // prepare execution arguments
   VLOG(4) << "SimpleRunner prepare execution arguments";
   hlir::framework::Scope temp_scope;  // used for store temporary allocated data
   auto execution_args = PrepareArgs(input, build_result, &temp_scope);
 
-  // Execute each instruction repeatedly and take the average as cost.
-  result.execution_cost    = 0;
+  const auto& target       = input.task->tune_context().target;
   const auto& instructions = build_result.runtime_program->GetRunInstructions();
-  for (auto ct = 0; ct < instructions.size(); ++ct) {
-    auto&& instr = instructions.at(ct);
-    VLOG(5) << "Start running instruction-" << ct;
-    auto run_start = std::chrono::steady_clock::now();
-    for (int i = 0; i < repeat_times_; ++i) {
-      instr->Run(&execution_args);
+  auto run_instructions    = [&]() {
+    for (auto ct = 0; ct < instructions.size(); ++ct) {
+      VLOG(6) << "Start running instruction-" << ct;
+      instructions.at(ct)->Run(&execution_args);
+    }
+#ifdef CINN_WITH_CUDA
+    if (target.arch == common::Target::Arch::NVGPU) {
+      CUDA_CALL(cudaDeviceSynchronize());
+    }
+#endif
+  };
+
+  for (int i = 0; i < options_.warmup_times; ++i) {
+    run_instructions();
+  }
+
+  // the cache of device is not affected by writing the memory of host
+  std::vector<char> flush_buffer;
+  if (options_.flush_cache && target.arch != common::Target::Arch::NVGPU) {
+    flush_buffer.resize(options_.flush_cache_bytes > 0 ? options_.flush_cache_bytes : GetFlushCacheBytes());
+  }
+
+  // Time the instructions repeatedly until the costs are stable or the time limit is reached.
+  std::vector<double> costs;
+  auto repeat_start = Clock::now();
+  while (static_cast<int>(costs.size()) < options_.max_repeat_times) {
+    if (!flush_buffer.empty()) {
+      FlushCache(&flush_buffer);
+    }
+    auto run_start = Clock::now();
+    run_instructions();
+    costs.push_back(MicrosecondsSince(run_start));
+
+    if (static_cast<int>(costs.size()) < options_.min_repeat_times) {
+      continue;
+    }
+    if (options_.target_relative_stddev > 0 && RelativeStddev(costs) <= options_.target_relative_stddev) {
+      break;
+    }
+    if (options_.max_repeat_time_ms > 0 && MicrosecondsSince(repeat_start) >= options_.max_repeat_time_ms * 1000.0) {
+      break;
     }
-    auto time_span =
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - run_start);
-    auto cost_avg = static_cast<double>(time_span.count()) / repeat_times_;
-    result.execution_cost += cost_avg;
   }
 
-  auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start);
-  result.elapsed_time = static_cast<double>(time_span.count());
+  result.execution_cost     = Median(costs);
+  result.min_execution_cost = *std::min_element(costs.begin(), costs.end());
+  result.repeat_times       = costs.size();
+  result.elapsed_time       = MicrosecondsSince(t_start);
 
-  VLOG(4) << "A measurement done:repeat_times[" << repeat_times_ << "]total_elapsed_time[" << result.elapsed_time
-          << "]us,execution_cost[" << result.execution_cost << "]us";
+  VLOG(4) << "A measurement done:repeat_times[" << result.repeat_times << "]relative_stddev["
+          << RelativeStddev(costs) << "]total_elapsed_time[" << result.elapsed_time << "]us,execution_cost(median)["
+          << result.execution_cost << "]us,min_execution_cost[" << result.min_execution_cost << "]us";
   return result;
 }
 
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/instruction.h"
 
@@ -21,10 +25,41 @@ namespace cinn {
 namespace auto_schedule {
 
 // This class utilize the built instructions to execute the generated
-// kernels and count the elapsed time as the measurement of performance
+// kernels and count the elapsed time as the measurement of performance.
+// The instructions are run as a whole for several warm-up times, and then
+// timed repeatedly until the costs are stable or the time limit is reached,
+// the median of the costs is returned as the execution cost.
 class SimpleRunner : public ScheduleRunner {
  public:
-  SimpleRunner(int repeat_times);
+  struct Options {
+    // The times of running the instructions before timing them, to load the
+    // codes and data into caches and initialize the lazily created states
+    int warmup_times = 1;
+    // The minimum and maximum times of timing the instructions
+    int min_repeat_times = 3;
+    int max_repeat_times = 20;
+    // Stop repeating once the relative standard deviation of the costs is
+    // not greater than it, a value <= 0 always repeats max_repeat_times
+    double target_relative_stddev = 0.05;
+    // Stop repeating once the timed repeats take longer than it even if the
+    // costs are not stable yet, a value <= 0 means no limit
+    int max_repeat_time_ms = 500;
+    // Whether to flush the last level cache on host before each repeat,
+    // so that a repeat does not benefit from the data left by the previous one
+    bool flush_cache = false;
+    // The bytes written to flush the cache, a value <= 0 uses the detected
+    // size of the last level cache
+    int64_t flush_cache_bytes = 0;
+    // The cores the calling thread is bound to while running, nothing is bound
+    // if it is empty. Note that the runner thread of ScheduleMeasurer is already
+    // bound by ScheduleMeasurer::Options::runner_cores
+    std::vector<int> bind_cores;
+  };
+
+  explicit SimpleRunner(const Options& options);
+
+  // Time the instructions exactly repeat_times times
+  explicit SimpleRunner(int repeat_times);
 
   MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
 
@@ -34,9 +69,7 @@ class SimpleRunner : public ScheduleRunner {
                                                       hlir::framework::Scope* temp_scope);
 
  private:
-  // The repeat times of running instructions,
-  // this runner will return the average time
-  const int repeat_times_;
+  const Options options_;
 };
 
 }  // namespace auto_schedule
@@ -126,6 +126,31 @@ TEST_F(TestSimpleRunner, TimeMeasured) {
   // be greater than 100us and 200us (repeatedly running 2 times) respectively.
   ASSERT_GE(measure_result.execution_cost, 100);
   ASSERT_GE(measure_result.elapsed_time, 200);
+  ASSERT_EQ(measure_result.repeat_times, 2);
+  ASSERT_GE(measure_result.execution_cost, measure_result.min_execution_cost);
+}
+
+TEST_F(TestSimpleRunner, RepeatUntilStable) {
+  SimpleRunner::Options options;
+  options.warmup_times     = 1;
+  options.min_repeat_times = 3;
+  options.max_repeat_times = 1000;
+  options.flush_cache      = true;
+  options.bind_cores       = {0};
+
+  // any costs are stable enough under this target, so it stops at min_repeat_times
+  options.target_relative_stddev = 100;
+  options.max_repeat_time_ms     = 0;
+  MeasureResult measure_result   = SimpleRunner(options).Run(input, build_result);
+  ASSERT_EQ(measure_result.repeat_times, 3);
+  ASSERT_GE(measure_result.execution_cost, measure_result.min_execution_cost);
+
+  // the costs are never stable enough under this target, so it stops at the time limit
+  options.target_relative_stddev = 0;
+  options.max_repeat_time_ms     = 1;
+  measure_result                 = SimpleRunner(options).Run(input, build_result);
+  ASSERT_GE(measure_result.repeat_times, 3);
+  ASSERT_LT(measure_result.repeat_times, 1000);
 }
 
 }  // namespace auto_schedule
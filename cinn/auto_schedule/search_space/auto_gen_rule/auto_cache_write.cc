@@ -0,0 +1,122 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_cache_write.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// The tensors stored by the block
+std::vector<ir::Tensor> GetStoredTensors(const ir::Expr& block_realize) {
+  std::vector<ir::Tensor> tensors;
+  ir::CollectIRNodesWithoutTensor(block_realize, [&](const ir::Expr* x) {
+    if (x->As<ir::Store>() && x->As<ir::Store>()->tensor.as_tensor()) {
+      tensors.push_back(x->As<ir::Store>()->tensor.as_tensor_ref());
+    }
+    return false;
+  });
+  return tensors;
+}
+
+}  // namespace
+
+AutoCacheWrite::AutoCacheWrite(const common::Target& target) : AutoGenRule(target) {}
+
+bool AutoCacheWrite::MeetCondition(const ir::Expr& block_realize) const {
+  const ir::ScheduleBlock* block = block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+  bool has_reduce_axis           = false;
+  for (const ir::Var& iter_var : block->iter_vars) {
+    has_reduce_axis = has_reduce_axis || iter_var->is_reduce_axis;
+  }
+  if (!has_reduce_axis) {
+    return false;
+  }
+
+  std::vector<ir::Tensor> tensors = GetStoredTensors(block_realize);
+  return tensors.size() == 1 && tensors[0]->buffer.defined() &&
+         tensors[0]->buffer->memory_type == ir::MemoryType::Heap;
+}
+
+RuleApplyType AutoCacheWrite::Init(const ir::ModuleExpr& mod_expr) {
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (target_->arch != common::Target::Arch::X86) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  ir_schedule_->EnableTrace();
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (MeetCondition(block_realize)) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+
+  // it is applicable again on the other reductions, the cached block writes a local buffer
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoCacheWrite::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoCacheWrite::Apply without Init";
+  CHECK(index >= 0 && index < num_applicable_)
+      << "Invalid index for AutoCacheWrite::Apply, the index needs 0 <= index && index < NumberApplicable()";
+
+  const ir::Expr& block_realize = applicable_blocks_[index];
+  std::string output_name       = GetStoredTensors(block_realize)[0]->name;
+  ir::Expr cache_block          = ir_schedule_->CacheWrite(block_realize, 0, "local");
+
+  // the write-back block is the only one storing the output after caching
+  ir::Expr write_back_block;
+  for (const ir::Expr& block : ir_schedule_->GetAllBlocks()) {
+    std::vector<ir::Tensor> tensors = GetStoredTensors(block);
+    if (tensors.size() == 1 && tensors[0]->name == output_name) {
+      write_back_block = block;
+      break;
+    }
+  }
+  CHECK(write_back_block.defined()) << "The write-back block of " << output_name << " is not found";
+
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(write_back_block);
+  if (!loops.empty()) {
+    int level = rand() % loops.size();
+    VLOG(5) << "AutoCacheWrite computes the reduction of " << output_name << " at the loop " << level
+            << " of the write-back block";
+    ir_schedule_->ComputeAt(cache_block, loops[level]);
+  }
+  return ir_schedule_->GetModule();
+}
+
+std::string AutoCacheWrite::GetRuleName() const { return "AutoCacheWrite"; }
+
+AutoGenRule* AutoCacheWrite::NewPointer() const { return new AutoCacheWrite(*target_); }
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,57 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Accumulate a reduction block into a local cache buffer on CPU and write the
+// cache back to the output afterwards. The loop of the write-back block the
+// reduction is computed at is sampled, so the tuner decides how large the
+// partial results kept in the cache are.
+class AutoCacheWrite : public AutoGenRule {
+ public:
+  AutoCacheWrite(const common::Target& target);
+  ~AutoCacheWrite() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override;
+
+  AutoGenRule* NewPointer() const override;
+
+  const ir::ScheduleDesc& GetAppliedTrace() const override { return ir_schedule_->GetTraceDesc(); }
+
+  // Returns true if the block is a reduction writing a single tensor in global memory
+  bool MeetCondition(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
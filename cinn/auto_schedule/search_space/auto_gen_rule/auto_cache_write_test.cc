@@ -0,0 +1,162 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_cache_write.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/poly/stage.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Apply AutoCacheWrite to the only reduction of the function, and replace the body of it by the result
+void ApplyAutoCacheWrite(ir::LoweredFunc* func, const std::string& output_name, const Target& target) {
+  ir::Expr origin_expr = optim::IRCopy((*func)->body);
+
+  AutoCacheWrite auto_cache_write(target);
+  ir::ModuleExpr mod_expr_before(std::vector<ir::Expr>{(*func)->body});
+  ASSERT_EQ(auto_cache_write.Init(mod_expr_before), RuleApplyType::kApply);
+  ASSERT_EQ(auto_cache_write.NumberApplicable(), 1);
+  ir::ModuleExpr mod_expr_after = auto_cache_write.ApplyRandomly();
+  VLOG(6) << "Expr after AutoCacheWrite: ";
+  VLOG(6) << mod_expr_after.GetExprs()[0];
+
+  // the reduction and its init block write the local cache, and only the write-back block writes the output
+  std::string expr_str = utils::GetStreamCnt(mod_expr_after.GetExprs()[0]);
+  EXPECT_NE(expr_str.find(output_name + "_local["), std::string::npos);
+  EXPECT_NE(expr_str.find("ScheduleBlock(" + output_name + "_local__reduce_init)"), std::string::npos);
+  EXPECT_EQ(expr_str.find(output_name + "__reduce_init["), std::string::npos);
+  ir::IRSchedule ir_sch(mod_expr_after);
+  EXPECT_TRUE(ir_sch.GetBlock(output_name + "_local").As<ir::ScheduleBlockRealize>());
+
+  // the primitives applied are traced, replaying which reproduces the schedule
+  ir::IRSchedule replayed_sch(ir::ModuleExpr(std::vector<ir::Expr>{origin_expr}));
+  auto_cache_write.GetAppliedTrace().Replay(&replayed_sch);
+  EXPECT_EQ(utils::GetStreamCnt(replayed_sch.GetModule().GetExprs()[0]), expr_str);
+
+  (*func)->body = mod_expr_after.GetExprs()[0];
+  (*func)->PrepareTempBufsFromBody();
+}
+
+// Compile the function and run it on the buffers
+void RunFunction(const ir::LoweredFunc& func, const Target& target, const std::vector<cinn_buffer_t*>& buffers) {
+  Module::Builder builder("module_" + func->name, target);
+  builder.AddFunction(func);
+  auto engine = backends::ExecutionEngine::Create({});
+  engine->Link<backends::CodeGenX86>(builder.Build());
+  auto fn = reinterpret_cast<void (*)(void*, int32_t)>(engine->Lookup(func->name));
+  ASSERT_NE(fn, nullptr);
+
+  std::vector<cinn_pod_value_t> args;
+  for (cinn_buffer_t* buffer : buffers) {
+    args.emplace_back(buffer);
+  }
+  fn(args.data(), args.size());
+}
+
+TEST(AutoCacheWrite, Matmul) {
+  Target target = common::DefaultHostTarget();
+  const int M = 32, N = 24, K = 16;
+  // each seed samples a loop of the write-back block to compute the cached reduction at
+  for (int seed = 0; seed < 4; ++seed) {
+    srand(seed);
+    Context::Global().ResetNameId();
+    Placeholder<float> A("A", {Expr(M), Expr(K)});
+    Placeholder<float> B("B", {Expr(K), Expr(N)});
+    Var k(K, "k0");
+    ir::Tensor C = Compute(
+        {Expr(M), Expr(N)}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+    poly::StageMap stages = CreateStages({C});
+    std::vector<ir::LoweredFunc> funcs =
+        lang::LowerVec("TestAutoCacheWrite_Matmul", stages, {A, B, C}, {}, {}, nullptr, target, true);
+    ASSERT_EQ(funcs.size(), 1UL);
+    ApplyAutoCacheWrite(&funcs[0], "C", target);
+
+    auto* a_buf = common::BufferBuilder(Float(32), {M, K}).set_random().Build();
+    auto* b_buf = common::BufferBuilder(Float(32), {K, N}).set_random().Build();
+    // the output holds stale values, which the reduction must not accumulate
+    auto* c_buf = common::BufferBuilder(Float(32), {M, N}).set_val(100.f).Build();
+    RunFunction(funcs[0], target, {a_buf, b_buf, c_buf});
+
+    auto* a = reinterpret_cast<float*>(a_buf->memory);
+    auto* b = reinterpret_cast<float*>(b_buf->memory);
+    auto* c = reinterpret_cast<float*>(c_buf->memory);
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        float expected = 0.f;
+        for (int kk = 0; kk < K; ++kk) {
+          expected += a[i * K + kk] * b[kk * N + j];
+        }
+        ASSERT_NEAR(c[i * N + j], expected, 1e-4f) << "seed " << seed << " at (" << i << ", " << j << ")";
+      }
+    }
+  }
+}
+
+TEST(AutoCacheWrite, ReduceSum) {
+  Target target = common::DefaultHostTarget();
+  const int M = 16, N = 64;
+  for (int seed = 0; seed < 2; ++seed) {
+    srand(seed);
+    Context::Global().ResetNameId();
+    Placeholder<float> A("A", {Expr(M), Expr(N)});
+    Var j(N, "j0");
+    ir::Tensor B = Compute(
+        {Expr(M)}, [&](Var i) { return lang::ReduceSum(A(i, j), {j}); }, "B");
+
+    poly::StageMap stages = CreateStages({B});
+    std::vector<ir::LoweredFunc> funcs =
+        lang::LowerVec("TestAutoCacheWrite_ReduceSum", stages, {A, B}, {}, {}, nullptr, target, true);
+    ASSERT_EQ(funcs.size(), 1UL);
+    ApplyAutoCacheWrite(&funcs[0], "B", target);
+
+    auto* a_buf = common::BufferBuilder(Float(32), {M, N}).set_random().Build();
+    auto* b_buf = common::BufferBuilder(Float(32), {M}).set_val(100.f).Build();
+    RunFunction(funcs[0], target, {a_buf, b_buf});
+
+    auto* a = reinterpret_cast<float*>(a_buf->memory);
+    auto* b = reinterpret_cast<float*>(b_buf->memory);
+    for (int i = 0; i < M; ++i) {
+      float expected = 0.f;
+      for (int jj = 0; jj < N; ++jj) {
+        expected += a[i * N + jj];
+      }
+      ASSERT_NEAR(b[i], expected, 1e-4f) << "seed " << seed << " at " << i;
+    }
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -17,8 +17,11 @@
 #include <glog/logging.h>
 
 #include <cstdlib>
+#include <string>
 
+#include "cinn/common/ir_util.h"
 #include "cinn/common/target.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
@@ -37,5 +40,50 @@ ir::ModuleExpr AutoGenRule::ApplyRandomly() {
   return Apply(index);
 }
 
+const ir::ScheduleDesc& AutoGenRule::GetAppliedTrace() const {
+  static const ir::ScheduleDesc empty_trace;
+  return empty_trace;
+}
+
+bool IsConstantLoop(const ir::Expr& loop) {
+  const ir::For* for_node = loop.As<ir::For>();
+  CHECK(for_node) << "IsConstantLoop requires a For node";
+  return common::is_zero(for_node->min) && for_node->extent.is_constant();
+}
+
+bool IsSpatialLoop(const ir::Expr& loop) {
+  const ir::For* for_node = loop.As<ir::For>();
+  CHECK(for_node) << "IsSpatialLoop requires a For node";
+  const std::string& loop_var_name = for_node->loop_var->name;
+  auto uses_loop_var               = [&](const ir::Expr& expr) {
+    auto vars = ir::CollectIRNodesWithoutTensor(
+        expr, [&](const ir::Expr* x) { return x->as_var() && x->as_var()->name == loop_var_name; });
+    return !vars.empty();
+  };
+
+  auto block_realizes = ir::CollectIRNodesWithoutTensor(
+      for_node->body, [](const ir::Expr* x) { return x->As<ir::ScheduleBlockRealize>() != nullptr; });
+  for (const ir::Expr& block_realize : block_realizes) {
+    const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+    const ir::ScheduleBlock* block          = realize->schedule_block.As<ir::ScheduleBlock>();
+    for (size_t i = 0; i < realize->iter_values.size() && i < block->iter_vars.size(); ++i) {
+      if (block->iter_vars[i]->is_reduce_axis && uses_loop_var(realize->iter_values[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+ir::Expr GetOnlyChild(const ir::Expr& loop) {
+  const ir::For* for_node = loop.As<ir::For>();
+  CHECK(for_node) << "GetOnlyChild requires a For node";
+  const ir::Block* body = for_node->body.As<ir::Block>();
+  if (!body) {
+    return for_node->body;
+  }
+  return body->stmts.size() == 1 ? body->stmts[0] : ir::Expr();
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
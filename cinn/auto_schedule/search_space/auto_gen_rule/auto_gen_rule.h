@@ -18,6 +18,7 @@
 
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -69,6 +70,10 @@ class AutoGenRule {
   // pointer, caller should manage the life time of the pointer.
   virtual AutoGenRule* NewPointer() const = 0;
 
+  // Returns the schedule primitives applied by the last Apply since Init, which
+  // are empty if the rule changes nothing.
+  virtual const ir::ScheduleDesc& GetAppliedTrace() const;
+
  protected:
   // number of ScheduleBlock that can apply this auto gen rule
   int num_applicable_ = -1;
@@ -76,5 +81,16 @@ class AutoGenRule {
   const common::Target* target_;
 };
 
+// Returns whether the For node starts from 0 and has a constant extent
+bool IsConstantLoop(const ir::Expr& loop);
+
+// Returns whether the loop only iterates the spatial axes of the schedule blocks
+// under it, that is its loop var is not used by the values of any reduce axis
+bool IsSpatialLoop(const ir::Expr& loop);
+
+// Returns the only statement in the body of the For node, or an undefined Expr
+// if the body has more than one statement
+ir::Expr GetOnlyChild(const ir::Expr& loop);
+
 }  // namespace auto_schedule
 }  // namespace cinn
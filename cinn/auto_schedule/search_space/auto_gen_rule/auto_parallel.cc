@@ -0,0 +1,112 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+AutoParallel::AutoParallel(const common::Target& target) : AutoGenRule(target) {}
+
+std::vector<ir::Expr> AutoParallel::GetParallelizableLoops(const ir::Expr& block_realize) const {
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  for (const ir::Expr& loop : loops) {
+    if (loop.As<ir::For>()->is_parallel()) {
+      return {};
+    }
+  }
+
+  std::vector<ir::Expr> result;
+  for (size_t i = 0; i < loops.size(); ++i) {
+    if (!loops[i].As<ir::For>()->is_serial() || !IsConstantLoop(loops[i]) || !IsSpatialLoop(loops[i])) {
+      break;
+    }
+    result.push_back(loops[i]);
+    // the inner loops can not be fused with this one if it has other statements
+    if (i + 1 < loops.size() && !(GetOnlyChild(loops[i]) == loops[i + 1])) {
+      break;
+    }
+  }
+  return result;
+}
+
+RuleApplyType AutoParallel::Init(const ir::ModuleExpr& mod_expr) {
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (target_->arch != common::Target::Arch::X86) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  ir_schedule_->EnableTrace();
+  // the blocks under the same outermost loop share the decision
+  std::vector<ir::Expr> outer_loops;
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    std::vector<ir::Expr> loops = GetParallelizableLoops(block_realize);
+    if (loops.empty() || std::find(outer_loops.begin(), outer_loops.end(), loops[0]) != outer_loops.end()) {
+      continue;
+    }
+    int total_extent = 1;
+    for (const ir::Expr& loop : loops) {
+      total_extent *= ir::GetLoopExtent(loop);
+    }
+    if (total_extent <= 1) {
+      continue;
+    }
+    outer_loops.push_back(loops[0]);
+    applicable_blocks_.push_back(block_realize);
+  }
+  num_applicable_ = applicable_blocks_.size();
+
+  // it is applicable again on the other loop nests
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoParallel::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoParallel::Apply without Init";
+  CHECK(index >= 0 && index < num_applicable_)
+      << "Invalid index for AutoParallel::Apply, the index needs 0 <= index && index < NumberApplicable()";
+
+  std::vector<ir::Expr> loops = GetParallelizableLoops(applicable_blocks_[index]);
+  CHECK(!loops.empty());
+  int num_fused = rand() % loops.size() + 1;
+  VLOG(5) << "AutoParallel fuses " << num_fused << " outer loops of " << loops.size() << " into the parallel loop";
+
+  ir::Expr parallel_loop = loops[0];
+  if (num_fused > 1) {
+    parallel_loop = ir_schedule_->Fuse(std::vector<ir::Expr>(loops.begin(), loops.begin() + num_fused));
+  }
+  ir_schedule_->Parallel(parallel_loop);
+  return ir_schedule_->GetModule();
+}
+
+std::string AutoParallel::GetRuleName() const { return "AutoParallel"; }
+
+AutoGenRule* AutoParallel::NewPointer() const { return new AutoParallel(*target_); }
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,59 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Parallelize the outermost loops of a schedule block on CPU. The number of
+// the outer loops fused into the parallel loop is sampled, so the tuner can
+// trade the parallelism against the work of each thread.
+class AutoParallel : public AutoGenRule {
+ public:
+  AutoParallel(const common::Target& target);
+  ~AutoParallel() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override;
+
+  AutoGenRule* NewPointer() const override;
+
+  const ir::ScheduleDesc& GetAppliedTrace() const override { return ir_schedule_->GetTraceDesc(); }
+
+  // Returns the outermost loops of the block which are serial, spatial and
+  // perfectly nested, so they can be fused and parallelized. It is empty if
+  // any loop of the block has been parallelized.
+  std::vector<ir::Expr> GetParallelizableLoops(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  // The blocks whose outer loops can be parallelized, one block for each loop nest
+  std::vector<ir::Expr> applicable_blocks_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/poly/stage.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoParallel, Elementwise) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(128);
+
+  Placeholder<float> A("A", {M});
+  Placeholder<float> B("B", {N});
+
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i) + B(j); }, "C");
+
+  poly::StageMap stages = CreateStages({C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestAutoParallel_Elementwise", stages, {C}, {}, {}, nullptr, target, true);
+
+  ir::Expr ast_expr = funcs[0]->body;
+  VLOG(6) << "Expr before AutoParallel: ";
+  VLOG(6) << ast_expr;
+
+  AutoParallel auto_parallel(target);
+  ir::ModuleExpr mod_expr_before_parallel(std::vector<ir::Expr>{ast_expr});
+  EXPECT_EQ(auto_parallel.Init(mod_expr_before_parallel), RuleApplyType::kApply);
+  EXPECT_EQ(auto_parallel.NumberApplicable(), 1);
+
+  ir::ModuleExpr mod_expr_after_parallel = auto_parallel.ApplyRandomly();
+  VLOG(6) << "Expr after AutoParallel: ";
+  VLOG(6) << mod_expr_after_parallel.GetExprs()[0];
+
+  ir::IRSchedule ir_sch(mod_expr_after_parallel);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_FALSE(loops.empty());
+  EXPECT_TRUE(loops[0].As<ir::For>()->is_parallel());
+  int total_extent = 1;
+  for (const ir::Expr& loop : loops) {
+    total_extent *= ir::GetLoopExtent(loop);
+  }
+  EXPECT_EQ(total_extent, 32 * 128);
+
+  // the parallelized loop nest is not applicable any more
+  EXPECT_EQ(auto_parallel.Init(mod_expr_after_parallel), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoParallel, SkipReduceLoops) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(32);
+  Expr K(32);
+
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+
+  Var k(K.as_int32(), "reduce_axis_k");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  poly::StageMap stages = CreateStages({C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestAutoParallel_SkipReduceLoops", stages, {C}, {}, {}, nullptr, target, true);
+
+  AutoParallel auto_parallel(target);
+  ir::ModuleExpr mod_expr(std::vector<ir::Expr>{funcs[0]->body});
+  EXPECT_EQ(auto_parallel.Init(mod_expr), RuleApplyType::kApply);
+
+  ir::IRSchedule ir_sch(mod_expr);
+  std::vector<ir::Expr> loops = auto_parallel.GetParallelizableLoops(ir_sch.GetBlock("C"));
+  EXPECT_FALSE(loops.empty());
+  EXPECT_LE(loops.size(), 2UL);
+  for (const ir::Expr& loop : loops) {
+    EXPECT_TRUE(IsSpatialLoop(loop));
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
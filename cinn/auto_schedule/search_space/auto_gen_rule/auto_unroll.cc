@@ -0,0 +1,126 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+AutoUnroll::AutoUnroll(const common::Target& target) : AutoGenRule(target) {}
+
+std::vector<std::vector<ir::Expr>> AutoUnroll::GetUnrollCandidates(const ir::Expr& block_realize) const {
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  for (const ir::Expr& loop : loops) {
+    if (loop.As<ir::For>()->is_unrolled()) {
+      return {};
+    }
+  }
+  if (loops.empty() || !(GetOnlyChild(loops.back()) == block_realize)) {
+    return {};
+  }
+
+  // Collect the perfectly nested innermost loops from inside out, and the products
+  // of the extents of them. A vectorized innermost loop is not unrolled itself but
+  // its extent counts.
+  std::vector<ir::Expr> unrollable_loops;
+  std::vector<int> products;
+  int product = 1;
+  for (int i = loops.size() - 1; i >= 0; --i) {
+    const ir::For* for_node = loops[i].As<ir::For>();
+    if (!IsConstantLoop(loops[i])) {
+      break;
+    }
+    if (i + 1 < loops.size() && !(GetOnlyChild(loops[i]) == loops[i + 1])) {
+      break;
+    }
+    product *= ir::GetLoopExtent(loops[i]);
+    if (for_node->is_vectorized() && i + 1 == loops.size()) {
+      continue;
+    }
+    if (!for_node->is_serial()) {
+      break;
+    }
+    unrollable_loops.push_back(loops[i]);
+    products.push_back(product);
+  }
+
+  std::vector<std::vector<ir::Expr>> candidates;
+  size_t last_num_loops = 0;
+  for (int max_extent : max_unroll_extents_) {
+    size_t num_loops = 0;
+    while (num_loops < products.size() && products[num_loops] <= max_extent) {
+      ++num_loops;
+    }
+    if (num_loops > last_num_loops) {
+      candidates.emplace_back(unrollable_loops.begin(), unrollable_loops.begin() + num_loops);
+      last_num_loops = num_loops;
+    }
+  }
+  return candidates;
+}
+
+RuleApplyType AutoUnroll::Init(const ir::ModuleExpr& mod_expr) {
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (target_->arch != common::Target::Arch::X86) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  ir_schedule_->EnableTrace();
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (!GetUnrollCandidates(block_realize).empty()) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+
+  // it is applicable again on the other blocks
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoUnroll::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoUnroll::Apply without Init";
+  CHECK(index >= 0 && index < num_applicable_)
+      << "Invalid index for AutoUnroll::Apply, the index needs 0 <= index && index < NumberApplicable()";
+
+  std::vector<std::vector<ir::Expr>> candidates = GetUnrollCandidates(applicable_blocks_[index]);
+  CHECK(!candidates.empty());
+  const std::vector<ir::Expr>& loops = candidates[rand() % candidates.size()];
+  VLOG(5) << "AutoUnroll unrolls " << loops.size() << " innermost loops";
+  // the loops are unrolled from inside out, so the outer ones are not replaced by the previous unrolling
+  for (const ir::Expr& loop : loops) {
+    ir_schedule_->Unroll(loop);
+  }
+  return ir_schedule_->GetModule();
+}
+
+std::string AutoUnroll::GetRuleName() const { return "AutoUnroll"; }
+
+AutoGenRule* AutoUnroll::NewPointer() const { return new AutoUnroll(*target_); }
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,59 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Unroll the innermost loops of a schedule block on CPU. The limit of the
+// product of the extents of the unrolled loops is sampled from max_unroll_extents_,
+// and the innermost loops are unrolled from inside out within the limit.
+class AutoUnroll : public AutoGenRule {
+ public:
+  AutoUnroll(const common::Target& target);
+  ~AutoUnroll() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override;
+
+  AutoGenRule* NewPointer() const override;
+
+  const ir::ScheduleDesc& GetAppliedTrace() const override { return ir_schedule_->GetTraceDesc(); }
+
+  // Returns the distinct candidates of the loops to unroll of the block, one
+  // for each unroll limit. It is empty if any loop of the block has been unrolled.
+  std::vector<std::vector<ir::Expr>> GetUnrollCandidates(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+
+  std::vector<int> max_unroll_extents_ = {8, 32, 128};
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,96 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/poly/stage.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoUnroll, Elementwise) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(8);
+  Expr N(4);
+
+  Placeholder<float> A("A", {M, N});
+
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + Expr(1.f); }, "C");
+
+  poly::StageMap stages = CreateStages({C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestAutoUnroll_Elementwise", stages, {C}, {}, {}, nullptr, target, true);
+
+  ir::Expr ast_expr = funcs[0]->body;
+  // the schedule changes the expr in place, so a copy is kept to replay the trace on
+  ir::Expr origin_expr = optim::IRCopy(ast_expr);
+  VLOG(6) << "Expr before AutoUnroll: ";
+  VLOG(6) << ast_expr;
+
+  AutoUnroll auto_unroll(target);
+  ir::ModuleExpr mod_expr_before_unroll(std::vector<ir::Expr>{ast_expr});
+  EXPECT_EQ(auto_unroll.Init(mod_expr_before_unroll), RuleApplyType::kApply);
+  EXPECT_EQ(auto_unroll.NumberApplicable(), 1);
+
+  // the limit 8 only covers the loop j of extent 4, the limit 32 covers both loops, and the limit 128 adds nothing
+  ir::IRSchedule ir_sch_before(mod_expr_before_unroll);
+  std::vector<std::vector<ir::Expr>> candidates = auto_unroll.GetUnrollCandidates(ir_sch_before.GetBlock("C"));
+  ASSERT_EQ(candidates.size(), 2UL);
+  EXPECT_EQ(candidates[0].size(), 1UL);
+  EXPECT_EQ(ir::GetLoopExtent(candidates[0][0]), 4);
+  EXPECT_EQ(candidates[1].size(), 2UL);
+
+  ir::ModuleExpr mod_expr_after_unroll = auto_unroll.ApplyRandomly();
+  VLOG(6) << "Expr after AutoUnroll: ";
+  VLOG(6) << mod_expr_after_unroll.GetExprs()[0];
+
+  ir::IRSchedule ir_sch(mod_expr_after_unroll);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 2UL);
+  EXPECT_TRUE(loops[1].As<ir::For>()->is_unrolled());
+
+  // the primitives applied are traced, replaying which reproduces the schedule
+  const ir::ScheduleDesc& trace = auto_unroll.GetAppliedTrace();
+  ASSERT_FALSE(trace.Empty());
+  ir::IRSchedule replayed_sch(ir::ModuleExpr(std::vector<ir::Expr>{origin_expr}));
+  trace.Replay(&replayed_sch);
+  EXPECT_EQ(utils::GetStreamCnt(replayed_sch.GetModule().GetExprs()[0]),
+            utils::GetStreamCnt(mod_expr_after_unroll.GetExprs()[0]));
+
+  // the unrolled loops are not applicable any more
+  EXPECT_EQ(auto_unroll.Init(mod_expr_after_unroll), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
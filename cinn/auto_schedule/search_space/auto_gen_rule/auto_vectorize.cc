@@ -0,0 +1,102 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+AutoVectorize::AutoVectorize(const common::Target& target) : AutoGenRule(target) {}
+
+std::vector<int> AutoVectorize::GetVectorizeFactors(const ir::Expr& block_realize) const {
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  if (loops.empty()) {
+    return {};
+  }
+  // the innermost loop should contain nothing but the block
+  const ir::Expr& loop = loops.back();
+  if (!loop.As<ir::For>()->is_serial() || !IsConstantLoop(loop) || !IsSpatialLoop(loop) ||
+      !(GetOnlyChild(loop) == block_realize)) {
+    return {};
+  }
+
+  int extent     = ir::GetLoopExtent(loop);
+  int max_factor = 2 * hlir::pe::GetBasicFactor(ir::GetTensor(block_realize)->type(), *target_);
+  std::vector<int> factors;
+  for (int factor = 2; factor <= max_factor && factor <= extent; factor *= 2) {
+    if (extent % factor == 0) {
+      factors.push_back(factor);
+    }
+  }
+  return factors;
+}
+
+RuleApplyType AutoVectorize::Init(const ir::ModuleExpr& mod_expr) {
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (target_->arch != common::Target::Arch::X86) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  ir_schedule_->EnableTrace();
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (!GetVectorizeFactors(block_realize).empty()) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+
+  // it is applicable again on the other blocks
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoVectorize::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoVectorize::Apply without Init";
+  CHECK(index >= 0 && index < num_applicable_)
+      << "Invalid index for AutoVectorize::Apply, the index needs 0 <= index && index < NumberApplicable()";
+
+  const ir::Expr& block_realize = applicable_blocks_[index];
+  std::vector<int> factors      = GetVectorizeFactors(block_realize);
+  CHECK(!factors.empty());
+  int factor = factors[rand() % factors.size()];
+
+  ir::Expr loop = ir_schedule_->GetLoops(block_realize).back();
+  VLOG(5) << "AutoVectorize vectorizes a loop of extent " << ir::GetLoopExtent(loop) << " by " << factor;
+  if (ir::GetLoopExtent(loop) > factor) {
+    loop = ir_schedule_->Split(loop, {-1, factor}).back();
+  }
+  ir_schedule_->Vectorize(loop, factor);
+  return ir_schedule_->GetModule();
+}
+
+std::string AutoVectorize::GetRuleName() const { return "AutoVectorize"; }
+
+AutoGenRule* AutoVectorize::NewPointer() const { return new AutoVectorize(*target_); }
+
+}  // namespace auto_schedule
+}  // namespace cinn
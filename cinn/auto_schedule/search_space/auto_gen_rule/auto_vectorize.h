@@ -0,0 +1,58 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Vectorize the innermost spatial loop of a schedule block on CPU. The vector
+// length is sampled among the powers of 2 dividing the extent of the loop and
+// not exceeding twice the native vector width, and the loop is split by it
+// if its extent is larger.
+class AutoVectorize : public AutoGenRule {
+ public:
+  AutoVectorize(const common::Target& target);
+  ~AutoVectorize() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override;
+
+  AutoGenRule* NewPointer() const override;
+
+  const ir::ScheduleDesc& GetAppliedTrace() const override { return ir_schedule_->GetTraceDesc(); }
+
+  // Returns the candidate vector lengths of the innermost loop of the block,
+  // it is empty if the loop can not be vectorized.
+  std::vector<int> GetVectorizeFactors(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
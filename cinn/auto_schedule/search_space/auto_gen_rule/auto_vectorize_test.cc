@@ -0,0 +1,103 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/poly/stage.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoVectorize, Elementwise) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(128);
+
+  Placeholder<float> A("A", {M});
+  Placeholder<float> B("B", {N});
+
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i) + B(j); }, "C");
+
+  poly::StageMap stages = CreateStages({C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestAutoVectorize_Elementwise", stages, {C}, {}, {}, nullptr, target, true);
+
+  ir::Expr ast_expr = funcs[0]->body;
+  // the schedule changes the expr in place, so a copy is kept to replay the trace on
+  ir::Expr origin_expr = optim::IRCopy(ast_expr);
+  VLOG(6) << "Expr before AutoVectorize: ";
+  VLOG(6) << ast_expr;
+
+  AutoVectorize auto_vectorize(target);
+  ir::ModuleExpr mod_expr_before_vectorize(std::vector<ir::Expr>{ast_expr});
+  EXPECT_EQ(auto_vectorize.Init(mod_expr_before_vectorize), RuleApplyType::kApply);
+  EXPECT_EQ(auto_vectorize.NumberApplicable(), 1);
+
+  ir::IRSchedule ir_sch_before(mod_expr_before_vectorize);
+  std::vector<int> factors = auto_vectorize.GetVectorizeFactors(ir_sch_before.GetBlock("C"));
+  ASSERT_FALSE(factors.empty());
+  for (int factor : factors) {
+    EXPECT_EQ(128 % factor, 0);
+  }
+
+  ir::ModuleExpr mod_expr_after_vectorize = auto_vectorize.ApplyRandomly();
+  VLOG(6) << "Expr after AutoVectorize: ";
+  VLOG(6) << mod_expr_after_vectorize.GetExprs()[0];
+
+  ir::IRSchedule ir_sch(mod_expr_after_vectorize);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_GE(loops.size(), 2UL);
+  const ir::For* vectorized_loop = loops.back().As<ir::For>();
+  EXPECT_TRUE(vectorized_loop->is_vectorized());
+  EXPECT_EQ(vectorized_loop->vectorize_info().factor, ir::GetLoopExtent(loops.back()));
+  int inner_extent = 1;
+  for (size_t i = 1; i < loops.size(); ++i) {
+    inner_extent *= ir::GetLoopExtent(loops[i]);
+  }
+  EXPECT_EQ(inner_extent, 128);
+
+  // the primitives applied are traced, replaying which reproduces the schedule
+  const ir::ScheduleDesc& trace = auto_vectorize.GetAppliedTrace();
+  ASSERT_FALSE(trace.Empty());
+  ir::IRSchedule replayed_sch(ir::ModuleExpr(std::vector<ir::Expr>{origin_expr}));
+  trace.Replay(&replayed_sch);
+  EXPECT_EQ(utils::GetStreamCnt(replayed_sch.GetModule().GetExprs()[0]),
+            utils::GetStreamCnt(mod_expr_after_vectorize.GetExprs()[0]));
+
+  // the vectorized loop is not applicable any more
+  EXPECT_EQ(auto_vectorize.Init(mod_expr_after_vectorize), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -125,11 +125,17 @@ void MultiLevelTiling::AnalyzeScheduleBlockReadWriteBuffer(ir::ScheduleBlock* sc
 RuleApplyType MultiLevelTiling::Init(const ir::ModuleExpr& mod_expr) {
   ir_schedule_        = std::make_unique<ir::IRSchedule>(mod_expr);
   all_block_realizes_ = ir_schedule_->GetAllBlocks();
+  ir_schedule_->EnableTrace();
   applicable_indices_.clear();
   num_applicable_ = 0;
   for (size_t i = 0; i < all_block_realizes_.size(); ++i) {
     ir::ScheduleBlockRealize* sche_block_realize = all_block_realizes_[i].As<ir::ScheduleBlockRealize>();
-    AnalyzeScheduleBlockReadWriteBuffer(sche_block_realize->schedule_block.As<ir::ScheduleBlock>());
+    ir::ScheduleBlock* sche_block                = sche_block_realize->schedule_block.As<ir::ScheduleBlock>();
+    // the loops transformed by the other rules can not be tiled by the iter vars of the block
+    if (ir_schedule_->GetLoops(all_block_realizes_[i]).size() != sche_block->iter_vars.size()) {
+      continue;
+    }
+    AnalyzeScheduleBlockReadWriteBuffer(sche_block);
     if (MeetCondition(*sche_block_realize)) {
       ++num_applicable_;
       applicable_indices_.push_back(i);
@@ -53,6 +53,8 @@ class MultiLevelTiling : public AutoGenRule {
   // pointer, caller should manage the life time of the pointer.
   AutoGenRule* NewPointer() const override;
 
+  const ir::ScheduleDesc& GetAppliedTrace() const override { return ir_schedule_->GetTraceDesc(); }
+
   // Returns true if sche_block_realize is applicable by MultiLevelTiling
   bool MeetCondition(const ir::ScheduleBlockRealize& sche_block_realize) const;
 
@@ -14,17 +14,21 @@
 
 #include "cinn/auto_schedule/search_space/search_space.h"
 
+#include <absl/container/flat_hash_set.h>
 #include <glog/logging.h>
 
 #include <cstdlib>
+#include <iterator>
 #include <utility>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/task/tune_context.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/structural_hash.h"
 #include "cinn/optim/ir_copy.h"
 
 namespace cinn {
@@ -35,7 +39,8 @@ SearchSpace::SearchSpace(const TuneContext& tune_context) : tune_context_(tune_c
 std::vector<SearchState> SearchSpace::GetRandomInitialSketch(int num) {
   VLOG(4) << "Start SearchSpace::GetRandomInitialSketch";
   std::vector<SearchState> result;
-  while (result.size() < num) {
+  absl::flat_hash_set<uint64_t> sketch_hashes;
+  for (int trial = 0; result.size() < num && trial < num * max_sketch_trials_per_sketch_; ++trial) {
     std::vector<ir::Expr> body_exprs = tune_context_.GetLoweredFuncBodyExprs();
     std::vector<ir::Expr> copy_exprs;
     for (const ir::Expr& e : body_exprs) {
@@ -50,21 +55,21 @@ std::vector<SearchState> SearchSpace::GetRandomInitialSketch(int num) {
         break;
       }
     }
-    // TODO:(zhhsplendid): De-duplication on the result after we have Expr/ModuleExpr hash;
+    if (!sketch_hashes.insert(ir::StructuralHash(state.mod_expr.GetExprs())).second) {
+      VLOG(5) << "Drop a duplicated sketch";
+      continue;
+    }
     result.emplace_back(std::move(state));
   }
+  VLOG(4) << "Generated " << result.size() << " distinct sketches of " << num << " required";
   return result;
 }
 
 SearchState SearchSpace::GetScheduleMutate(const SearchState& state, const CostModel& cost_model) {
   VLOG(4) << "Start SearchSpace::GetScheduleMutate";
-  // TODO(zhhsplendid): cost model predict
   bool has_manual_schedule = false;
-  if (has_manual_schedule) {
-    SearchState ret = ManualScheduleMutate(state);
-    return ret;
-  }
-  SearchState ret = RandomScheduleMutate(state);
+  SearchState ret          = has_manual_schedule ? ManualScheduleMutate(state) : RandomScheduleMutate(state);
+  ret.predicted_cost       = cost_model.Predict({FeatureExtractor::Extract(ret.mod_expr)})[0];
   return ret;
 }
 
@@ -106,13 +111,17 @@ SearchState SearchSpace::RandomScheduleMutate(const SearchState& state) {
   }
 
   // 3. Sample a schedule on the distribution
+  // the key of each rule is the first index it covers, so the sampled rule is the last one not after the index
   int sample_index                         = rand() % cur_weight;
-  auto iter                                = weight_to_rule.lower_bound(sample_index);
+  auto iter                                = std::prev(weight_to_rule.upper_bound(sample_index));
   std::shared_ptr<AutoGenRule> sample_rule = iter->second;
   VLOG(6) << "Sample AutoGenRule " << sample_rule->GetRuleName();
 
   // 4. Apply the schedule change
   ret.mod_expr = sample_rule->Apply(sample_index - iter->first);
+  for (const ir::ScheduleDesc::Step& step : sample_rule->GetAppliedTrace().Steps()) {
+    ret.trace.Append(step);
+  }
   return ret;
 }
 
@@ -19,8 +19,12 @@
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_cache_write.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_inline.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/multi_level_tiling.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/skip_rule.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
@@ -38,13 +42,14 @@ namespace auto_schedule {
  * 1. Manual defined schedule
  * 2. Schedule generated by AutoGenRule
  *
- * TODO(zhhsplendid): de-duplication the generated ModuleExpr
+ * The generated ModuleExprs are de-duplicated by ir::StructuralHash.
  */
 class SearchSpace {
  public:
   SearchSpace(const TuneContext& tune_context);
 
-  // Generate sketch as initial population of evolutionary search
+  // Generate distinct sketches as initial population of evolutionary search, fewer sketches
+  // are returned if the distinct ones are not found in a limited number of trials
   virtual std::vector<SearchState> GetRandomInitialSketch(int num);
 
   // Evolutionary search mutate, returns the mutated ModuleExpr and estimited cost
@@ -59,6 +64,9 @@ class SearchSpace {
   const TuneContext& tune_context_;
 
   int init_sketch_random_depth_ = 6;
+
+  // the maximum number of sketches generated for each distinct sketch required
+  int max_sketch_trials_per_sketch_ = 4;
 };
 
 }  // namespace auto_schedule
@@ -18,8 +18,12 @@
 #include <utility>
 #include <vector>
 
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_cache_write.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_inline.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/multi_level_tiling.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/skip_rule.h"
 #include "cinn/common/target.h"
@@ -36,6 +40,8 @@ SearchState::SearchState(ir::ModuleExpr&& mod_expr) { this->mod_expr = std::move
 SearchState::SearchState(const SearchState& state) {
   mod_expr       = state.mod_expr;
   predicted_cost = state.predicted_cost;
+  trace          = state.trace;
+  has_trace      = state.has_trace;
   for (const std::shared_ptr<AutoGenRule>& rule : state.applicable_rules) {
     applicable_rules.emplace_back(std::shared_ptr<AutoGenRule>(rule->NewPointer()));
   }
@@ -44,6 +50,8 @@ SearchState::SearchState(const SearchState& state) {
 SearchState& SearchState::operator=(const SearchState& src) {
   this->mod_expr       = src.mod_expr;
   this->predicted_cost = src.predicted_cost;
+  this->trace          = src.trace;
+  this->has_trace      = src.has_trace;
   this->applicable_rules.clear();
   for (const std::shared_ptr<AutoGenRule>& rule : src.applicable_rules) {
     this->applicable_rules.emplace_back(std::shared_ptr<AutoGenRule>(rule->NewPointer()));
@@ -54,8 +62,13 @@ SearchState& SearchState::operator=(const SearchState& src) {
 bool operator<(const SearchState& left, const SearchState& right) { return left.predicted_cost < right.predicted_cost; }
 
 void SearchState::InitAutoGenRules(const common::Target& target) {
+  // the rules for CPU are not applicable on the other targets
   applicable_rules = {std::shared_ptr<AutoGenRule>(new AutoInline(target)),
                       std::shared_ptr<AutoGenRule>(new MultiLevelTiling(target)),
+                      std::shared_ptr<AutoGenRule>(new AutoCacheWrite(target)),
+                      std::shared_ptr<AutoGenRule>(new AutoParallel(target)),
+                      std::shared_ptr<AutoGenRule>(new AutoVectorize(target)),
+                      std::shared_ptr<AutoGenRule>(new AutoUnroll(target)),
                       std::shared_ptr<AutoGenRule>(new SkipRule(target))};
 }
 
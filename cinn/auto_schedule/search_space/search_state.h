@@ -22,6 +22,7 @@
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -38,9 +39,15 @@ class SearchState {
   // Initialized by list of all AutoGenRule
   std::vector<std::shared_ptr<AutoGenRule>> applicable_rules;
 
-  // Cost model predicted cost
+  // Cost model predicted cost, which is the log1p of the execution time in us
   float predicted_cost = NOT_INIT_COST;
 
+  // The schedule primitives applied to the lowered exprs to get the ModuleExpr, replaying
+  // which on the freshly lowered exprs reproduces the ModuleExpr. Only valid if has_trace,
+  // e.g. the states crossed over from different parents have no trace.
+  ir::ScheduleDesc trace;
+  bool has_trace = true;
+
   // Negative constant standing for a cost not being initialized
   static constexpr float NOT_INIT_COST = -1.0;
 
@@ -14,6 +14,7 @@
 
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
 
+#include <absl/container/flat_hash_set.h>
 #include <glog/logging.h>
 
 #include <algorithm>
@@ -22,18 +23,31 @@
 #include <memory>
 #include <utility>
 
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_context.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/ir/structural_hash.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/sized_multi_set.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-EvolutionarySearch::EvolutionarySearch(const TuneContext& tune_context) : tune_context_(tune_context) {
+EvolutionarySearch::EvolutionarySearch(const TuneContext& tune_context,
+                                       const Database* database,
+                                       const std::string& task_key,
+                                       const CostModel* cost_model)
+    : tune_context_(tune_context), cost_model_(cost_model), database_(database), task_key_(task_key) {
   search_space_ = std::make_unique<SearchSpace>(tune_context);
+  if (cost_model_ == nullptr) {
+    // an untrained model predicts the same cost for all the states, so no thread is needed
+    GbdtCostModel::Options options;
+    options.num_threads = 1;
+    default_cost_model_ = std::make_unique<GbdtCostModel>(options);
+    cost_model_         = default_cost_model_.get();
+  }
 }
 
 EvolutionarySearch::~EvolutionarySearch() {}
@@ -70,8 +84,25 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprEpsGreedy(const Tun
 }
 
 std::vector<SearchState> EvolutionarySearch::GetTopKCandidatesFromDatabase(int topk) {
-  // TODO(zhhsplendid): implement it after we have the database
-  return std::vector<SearchState>();
+  std::vector<SearchState> results;
+  if (database_ == nullptr || topk <= 0) {
+    return results;
+  }
+  for (const TuningRecord& record : database_->GetTopK(task_key_, topk)) {
+    // the records loaded from files or tuned on other models are replayed from their traces renamed after
+    // the lowered functions, the old ones without source hashes are skipped
+    if (!record.IsApplicableTo(tune_context_.lowered_funcs)) {
+      continue;
+    }
+    SearchState state(ir::ModuleExpr(record.ApplyTo(tune_context_.lowered_funcs)));
+    state.has_trace = record.has_trace;
+    if (record.has_trace) {
+      state.trace = record.MapTraceTo(tune_context_.lowered_funcs);
+    }
+    state.InitAutoGenRules(tune_context_.target);
+    results.emplace_back(std::move(state));
+  }
+  return results;
 }
 
 std::vector<SearchState> EvolutionarySearch::RandomInitSketch(int num) {
@@ -86,14 +117,27 @@ SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const Searc
   CHECK_EQ(father_exprs.size(), mother_exprs.size())
       << "CrossOver ModuleExpr in EvolutionarySearch must have same number of AST";
 
+  int num_from_father = 0;
   for (size_t i = 0; i < father_exprs.size(); ++i) {
     if (rand() % 2 == 0) {
       cross_over_exprs.push_back(optim::IRCopy(father_exprs[i]));
+      ++num_from_father;
     } else {
       cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
     }
   }
-  return SearchState(ir::ModuleExpr(cross_over_exprs));
+  SearchState child(ir::ModuleExpr(cross_over_exprs));
+  // the trace of a parent is kept if all the exprs come from it, the traces can not be mixed otherwise
+  if (num_from_father == father_exprs.size()) {
+    child.trace     = state1.trace;
+    child.has_trace = state1.has_trace;
+  } else if (num_from_father == 0) {
+    child.trace     = state2.trace;
+    child.has_trace = state2.has_trace;
+  } else {
+    child.has_trace = false;
+  }
+  return child;
 }
 
 std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchState>& population,
@@ -114,10 +158,22 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
     evolution.push_back(CrossOver(population[first_rand_idx], population[second_rand_idx]));
   }
 
+  // the same schedule may be reached by different crossovers and mutations, keep only one of them
+  absl::flat_hash_set<uint64_t> evolution_hashes;
+  absl::flat_hash_set<uint64_t> mutated_hashes;
   utils::SizedMultiSet<SearchState> evolution_with_cost(ret_num);
   for (size_t i = 0; i < evolution.size(); ++i) {
-    evolution_with_cost.Push(search_space_->GetScheduleMutate(evolution[i], *cost_model_));
+    if (!evolution_hashes.insert(ir::StructuralHash(evolution[i].mod_expr.GetExprs())).second) {
+      continue;
+    }
+    SearchState mutated = search_space_->GetScheduleMutate(evolution[i], *cost_model_);
+    if (!mutated_hashes.insert(ir::StructuralHash(mutated.mod_expr.GetExprs())).second) {
+      continue;
+    }
+    evolution_with_cost.Push(std::move(mutated));
   }
+  VLOG(5) << "EvolutionarySearch got " << mutated_hashes.size() << " distinct states from " << evolution.size()
+          << " evolutions";
 
   return evolution_with_cost.ReturnAsContainer<std::vector<SearchState>>();
 }
@@ -15,8 +15,11 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_context.h"
@@ -36,8 +39,16 @@ class EvolutionarySearch {
    *
    * @param tune_context: the TuneContext this class works on. This class doesn't
    *     take ownership of the pointer.
+   * @param database: the database to pick the best records of the task as a part
+   *     of the initial population, it can be nullptr. Not owned.
+   * @param task_key: the key of the task in the database.
+   * @param cost_model: the cost model to predict the costs of the mutated
+   *     states, it can be nullptr, then an untrained model is used. Not owned.
    */
-  EvolutionarySearch(const TuneContext& tune_context);
+  EvolutionarySearch(const TuneContext& tune_context,
+                     const Database* database    = nullptr,
+                     const std::string& task_key = "",
+                     const CostModel* cost_model = nullptr);
 
   /**
    * Destructor
@@ -100,7 +111,14 @@ class EvolutionarySearch {
 
   const TuneContext& tune_context_;
 
-  CostModel* cost_model_;  // not owned
+  const CostModel* cost_model_;  // not owned
+
+  // the model used when no cost model is given
+  std::unique_ptr<CostModel> default_cost_model_;
+
+  const Database* database_;  // not owned
+
+  std::string task_key_;
 };
 
 }  // namespace auto_schedule
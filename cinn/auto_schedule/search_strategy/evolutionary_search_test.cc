@@ -19,6 +19,7 @@
 #include <memory>
 #include <utility>
 
+#include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_context.h"
@@ -109,5 +110,24 @@ TEST(EvolutionarySearch, GetEpsGreedy) {
   }
 }
 
+TEST(EvolutionarySearch, PickFromDatabase) {
+  TuneTask mock_tune_task;
+  TuningOptions options;
+  Database database;
+  // a record better than all the random sketches of the mock search space
+  std::vector<ir::Expr> best_exprs(10, ir::Expr(-100));
+  database.AddRecord(TuningRecord("mock_task", 1.0, ir::ModuleExpr(best_exprs)));
+  EvolutionarySearch evolutionary_search(mock_tune_task.tune_context(), &database, "mock_task");
+
+  MockSearchSpace* mock_search_space = new MockSearchSpace(mock_tune_task.tune_context());
+  // Ownership is transferred so don't delete mock_search_space
+  evolutionary_search.SetSearchSpace(mock_search_space);
+
+  SearchState best_state = evolutionary_search.SearchModuleExpr(options);
+  for (const ir::Expr& e : best_state.mod_expr.GetExprs()) {
+    EXPECT_EQ(e.as_int32(), -100);
+  }
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -16,10 +16,17 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
+#include "cinn/ir/structural_hash.h"
 #include "cinn/optim/ir_copy.h"
 
 namespace cinn {
@@ -44,60 +51,96 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
   if (evolutionary_search_ == nullptr) {
     // TODO(zhhsplendid): check whether the options is same as previous,
     // if not, we should create new EvolutionarySearch
-    evolutionary_search_ = std::make_unique<EvolutionarySearch>(task_->tune_context());
+    evolutionary_search_ =
+        std::make_unique<EvolutionarySearch>(task_->tune_context(), database_, task_->serialized_key, cost_model_);
   }
 
+  // the best schedule measured before, which is applied directly when no measurement is required
+  std::unique_ptr<TuningRecord> best_record = GetBestRecord();
+
   if (options.num_measure_trials == 0) {
+    TuningResult::OptimizedComputeExpr result;
+    if (best_record) {
+      VLOG(4) << "TaskOptimizer applies the best known record with cost " << best_record->execution_cost;
+      result.lowered_funcs.emplace_back(ApplyExprs(best_record->ApplyTo(task_->tune_context().lowered_funcs)));
+      return result;
+    }
     std::vector<SearchState> states = evolutionary_search_->SearchModuleExprEpsGreedy(options);
     VLOG(4) << "TaskOptimizer run EvolutionarySearch with return size = " << states.size();
-    TuningResult::OptimizedComputeExpr result;
     // TODO(zhhsplendid): current a task only contains one Op or one Fused Op,
     // so we can take only first std::vector<ir::LoweredFunc>. Support the
     // TuneContext.lowered_funcs to be std::vector<std::vector<ir::LoweredFunc>>
     // in the future.
-
-    result.lowered_funcs.emplace_back(optim::IRCopy(task_->tune_context().lowered_funcs));
-
-    std::vector<ir::Expr> best_exprs = states[0].mod_expr.GetExprs();
-    CHECK_EQ(best_exprs.size(), result.lowered_funcs[0].size())
-        << "RuntimeError: Expr size is not equal to LoweredFunc size in TaskOptimizer";
-    for (size_t i = 0; i < best_exprs.size(); ++i) {
-      result.lowered_funcs[0][i]->body = best_exprs[i];
-      if (task_->tune_context().target == common::DefaultNVGPUTarget()) {
-        result.lowered_funcs[0][i]->PrepareCudaAxisInfoFromBody();
-      }
-    }
+    result.lowered_funcs.emplace_back(ApplyExprs(states[0].mod_expr.GetExprs()));
     return result;
   }
 
   int measured_count   = 0;
   double min_exec_time = std::numeric_limits<double>().max();
   TuningResult::OptimizedComputeExpr result;
-  result.lowered_funcs.push_back(optim::IRCopy(task_->tune_context().lowered_funcs));
+  if (best_record) {
+    min_exec_time = best_record->execution_cost;
+    result.lowered_funcs.emplace_back(ApplyExprs(best_record->ApplyTo(task_->tune_context().lowered_funcs)));
+  } else {
+    result.lowered_funcs.push_back(optim::IRCopy(task_->tune_context().lowered_funcs));
+  }
 
   while (measured_count < options.num_measure_trials) {
     std::vector<SearchState> states = evolutionary_search_->SearchModuleExprEpsGreedy(options);
     VLOG(4) << "TaskOptimizer run EvolutionarySearch with return size = " << states.size();
-    std::vector<MeasureInput> measure_inputs(states.size());
-    for (size_t i = 0; i < states.size(); ++i) {
-      measure_inputs[i].task           = task_;
-      std::vector<ir::Expr> best_exprs = states[i].mod_expr.GetExprs();
-      CHECK_EQ(best_exprs.size(), task_->tune_context().lowered_funcs.size())
-          << "RuntimeError: Expr size is not equal to LoweredFunc size in TaskOptimizer";
-
-      measure_inputs[i].lowered_funcs.emplace_back(optim::IRCopy(task_->tune_context().lowered_funcs));
-      for (size_t j = 0; j < best_exprs.size(); ++j) {
-        measure_inputs[i].lowered_funcs.front().at(j)->body = best_exprs[j];
-        if (task_->tune_context().target == common::DefaultNVGPUTarget()) {
-          measure_inputs[i].lowered_funcs.front().at(j)->PrepareCudaAxisInfoFromBody();
+    // the trials are counted even if the states have been measured, so the loop ends in any case
+    measured_count += states.size();
+    if (database_ != nullptr) {
+      // the schedules measured in the previous iterations or runs are not measured again
+      std::vector<SearchState> unmeasured_states;
+      for (SearchState& state : states) {
+        if (!database_->HasRecord(task_->serialized_key, ir::StructuralHash(state.mod_expr.GetExprs()))) {
+          unmeasured_states.emplace_back(std::move(state));
         }
       }
+      VLOG(4) << "TaskOptimizer skips " << states.size() - unmeasured_states.size() << " measured states";
+      states = std::move(unmeasured_states);
+      if (states.empty()) continue;
+    }
+    std::vector<MeasureInput> measure_inputs(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+      measure_inputs[i].task = task_;
+      measure_inputs[i].lowered_funcs.emplace_back(ApplyExprs(states[i].mod_expr.GetExprs()));
     }
     std::vector<MeasureResult> measure_outputs = schedule_measurer_->Measure(measure_inputs);
     CHECK_EQ(measure_outputs.size(), states.size())
         << "ScheduleMeasurer didn't output same number of MeasureOutput of states in TaskOptimizer";
 
-    // TODO(zhhsplendid): write measure record into cache.
+    if (database_ != nullptr) {
+      for (size_t i = 0; i < measure_outputs.size(); ++i) {
+        if (!measure_outputs[i].error_msg.empty()) continue;
+        TuningRecord record(
+            task_->serialized_key, measure_outputs[i].execution_cost, optim::IRCopy(states[i].mod_expr));
+        // the cost model predicts the log costs, which are converted back into us as the measured ones
+        if (states[i].predicted_cost != SearchState::NOT_INIT_COST) {
+          record.predicted_cost = std::max(0.0, std::expm1(static_cast<double>(states[i].predicted_cost)));
+        }
+        record.SetSourceFuncs(task_->tune_context().lowered_funcs);
+        record.trace     = states[i].trace;
+        record.has_trace = states[i].has_trace;
+        database_->AddRecord(record);
+      }
+    }
+
+    if (cost_model_ != nullptr) {
+      // the costs of different tasks differ by orders of magnitude, so the model learns the log costs
+      // the failed measurements are excluded
+      std::vector<std::vector<float>> samples;
+      std::vector<float> labels;
+      for (size_t i = 0; i < states.size(); ++i) {
+        if (!measure_outputs[i].error_msg.empty()) continue;
+        samples.emplace_back(FeatureExtractor::Extract(states[i].mod_expr));
+        labels.emplace_back(std::log1p(measure_outputs[i].execution_cost));
+      }
+      if (!samples.empty()) {
+        cost_model_->Update(samples, labels);
+      }
+    }
 
     for (size_t i = 0; i < measure_outputs.size(); ++i) {
       if (measure_outputs[i].execution_cost < min_exec_time) {
@@ -105,11 +148,36 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
         result.lowered_funcs = measure_inputs[i].lowered_funcs;
       }
     }
-
-    measured_count += states.size();
   }
   return result;
 }
 
+std::vector<ir::LoweredFunc> TaskOptimizer::ApplyExprs(const std::vector<ir::Expr>& exprs) const {
+  CHECK_EQ(exprs.size(), task_->tune_context().lowered_funcs.size())
+      << "RuntimeError: Expr size is not equal to LoweredFunc size in TaskOptimizer";
+  std::vector<ir::LoweredFunc> funcs = optim::IRCopy(task_->tune_context().lowered_funcs);
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    funcs[i]->body = exprs[i];
+    if (task_->tune_context().target == common::DefaultNVGPUTarget()) {
+      funcs[i]->PrepareCudaAxisInfoFromBody();
+    } else {
+      funcs[i]->PrepareTempBufsFromBody();
+    }
+  }
+  return funcs;
+}
+
+std::unique_ptr<TuningRecord> TaskOptimizer::GetBestRecord() const {
+  if (database_ == nullptr) {
+    return nullptr;
+  }
+  for (const TuningRecord& record : database_->GetRecords(task_->serialized_key)) {
+    if (record.IsApplicableTo(task_->tune_context().lowered_funcs)) {
+      return std::make_unique<TuningRecord>(record);
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -15,7 +15,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "cinn/auto_schedule/cost_model/cost_model.h"
+#include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
 #include "cinn/auto_schedule/task/tune_task.h"
@@ -29,18 +32,38 @@ namespace auto_schedule {
 // optimal schedule for the task.
 class TaskOptimizer {
  public:
-  TaskOptimizer(const TuneTask& task, ScheduleMeasurer* schedule_measurer)
-      : task_(&task), schedule_measurer_(schedule_measurer) {}
+  /**
+   * Constructor.
+   * @param database The database to seed the search with the best known records of the task and to
+   * save the measured records into, it can be nullptr. Not owned.
+   * @param cost_model The cost model guiding the search, which is updated by the measured schedules.
+   * It can be nullptr and it can be shared by the tasks. Not owned.
+   */
+  TaskOptimizer(const TuneTask& task,
+                ScheduleMeasurer* schedule_measurer,
+                Database* database    = nullptr,
+                CostModel* cost_model = nullptr)
+      : task_(&task), schedule_measurer_(schedule_measurer), database_(database), cost_model_(cost_model) {}
 
   TuningResult::OptimizedComputeExpr Optimize(const TuningOptions& options);
 
  private:
   TuningResult::OptimizedComputeExpr OptimizeByEvolution(const TuningOptions& options);
 
+  // The lowered functions of the task with the bodies replaced by the exprs
+  std::vector<ir::LoweredFunc> ApplyExprs(const std::vector<ir::Expr>& exprs) const;
+
+  // The fastest record in the database that can be applied to the task, nullptr if not found
+  std::unique_ptr<TuningRecord> GetBestRecord() const;
+
   const TuneTask* task_;
 
   ScheduleMeasurer* schedule_measurer_;
 
+  Database* database_;
+
+  CostModel* cost_model_;
+
   std::unique_ptr<EvolutionarySearch> evolutionary_search_ = nullptr;
 };
 
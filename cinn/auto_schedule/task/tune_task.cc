@@ -16,13 +16,24 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/node.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/lowered_func.h"
+#include "cinn/ir/structural_hash.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -36,6 +47,154 @@ void TuneTask::TaskGraphToUnoptLoweredFunc() {
   // tune_context_.lowered_funcs to be std::vector<std::vector<ir::LoweredFunc>>
   // in the future.
   tune_context_.lowered_funcs = graph_compiler_->FusedGraphToLoweredFunc(task_graph_)[0];
+  serialized_key              = SerializeToString();
+}
+
+namespace {
+
+template <typename T>
+void PrintAttr(std::ostream& os, const T& value) {
+  os << value;
+}
+
+template <typename T>
+void PrintAttr(std::ostream& os, const std::vector<T>& values) {
+  os << "[";
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0) os << ",";
+    os << values[i];
+  }
+  os << "]";
+}
+
+// The tensors in the order they first appear in the expr
+std::vector<ir::Tensor> CollectTensorsInOrder(const ir::Expr& expr) {
+  std::vector<ir::Tensor> tensors;
+  std::set<std::string> names;
+  ir::CollectIRNodesWithoutTensor(expr, [&](const ir::Expr* x) {
+    if (x->as_tensor() && names.insert(x->as_tensor()->name).second) {
+      tensors.push_back(x->as_tensor_ref());
+    }
+    return false;
+  });
+  return tensors;
+}
+
+// Replace the tensors and rename the schedule blocks by the names of the tensors
+class TensorReplacer : public ir::IRMutator<ir::Expr*> {
+ public:
+  explicit TensorReplacer(const std::map<std::string, ir::Tensor>& tensor_map) : tensor_map_(tensor_map) {}
+
+  void operator()(ir::Expr* expr) { ir::IRMutator<ir::Expr*>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::_Tensor_* op, ir::Expr* expr) override {
+    auto it = tensor_map_.find(op->name);
+    if (it != tensor_map_.end()) {
+      *expr = ir::Expr(it->second);
+      return;
+    }
+    ir::IRMutator<ir::Expr*>::Visit(op, expr);
+  }
+
+  void Visit(const ir::ScheduleBlock* op, ir::Expr* expr) override {
+    auto* node = expr->As<ir::ScheduleBlock>();
+    auto it    = tensor_map_.find(node->name);
+    if (it != tensor_map_.end()) {
+      node->name = it->second->name;
+    }
+    ir::IRMutator<ir::Expr*>::Visit(op, expr);
+  }
+
+  const std::map<std::string, ir::Tensor>& tensor_map_;
+};
+
+}  // namespace
+
+std::vector<ir::LoweredFunc> TuneTask::TransferTunedFuncs(const TuneTask& tuned_task,
+                                                          const std::vector<ir::LoweredFunc>& tuned_funcs) const {
+  CHECK_EQ(serialized_key, tuned_task.serialized_key) << "Only the tuning results of the same task can be transferred";
+  const auto& src_funcs = tuned_task.tune_context().lowered_funcs;
+  std::vector<ir::LoweredFunc> funcs = optim::IRCopy(tune_context_.lowered_funcs);
+  CHECK_EQ(src_funcs.size(), funcs.size());
+  CHECK_EQ(tuned_funcs.size(), funcs.size());
+
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    if (!ir::StructuralEqual(src_funcs[i]->body, funcs[i]->body)) {
+      LOG(WARNING) << "The lowered function " << funcs[i]->name << " differs from " << src_funcs[i]->name
+                   << " of the tuned task, it is not optimized";
+      return optim::IRCopy(tune_context_.lowered_funcs);
+    }
+    // the structurally equal bodies have the corresponding tensors in the same order
+    std::vector<ir::Tensor> src_tensors = CollectTensorsInOrder(src_funcs[i]->body);
+    std::vector<ir::Tensor> dst_tensors = CollectTensorsInOrder(funcs[i]->body);
+    CHECK_EQ(src_tensors.size(), dst_tensors.size());
+    std::map<std::string, ir::Tensor> tensor_map;
+    for (size_t j = 0; j < src_tensors.size(); ++j) {
+      tensor_map.emplace(src_tensors[j]->name, dst_tensors[j]);
+    }
+
+    ir::Expr body = optim::IRCopy(tuned_funcs[i]->body);
+    TensorReplacer replacer(tensor_map);
+    replacer(&body);
+    funcs[i]->body = body;
+    if (tune_context_.target == common::DefaultNVGPUTarget()) {
+      funcs[i]->PrepareCudaAxisInfoFromBody();
+    } else {
+      funcs[i]->PrepareTempBufsFromBody();
+    }
+  }
+  return funcs;
+}
+
+std::string TuneTask::SerializeToString() const {
+  std::stringstream ss;
+  ss << tune_context_.target << "\n";
+  for (const auto& group : task_graph_) {
+    ss << "Group {\n";
+    for (const auto* node : group) {
+      // the fusion structure: an input is either the output of a node in the group or an argument
+      ss << "  (";
+      const auto& inlinks = node->inlinks_in_order();
+      for (size_t i = 0; i < inlinks.size(); ++i) {
+        ss << (i > 0 ? ", " : "");
+        auto* data = inlinks[i]->source()->safe_as<hlir::framework::NodeData>();
+        auto it    = data ? std::find(group.begin(), group.end(), data->source_node.get()) : group.end();
+        if (it != group.end()) {
+          ss << "%" << (it - group.begin()) << "." << data->output_index;
+        } else {
+          ss << "arg";
+        }
+      }
+      ss << ") -> " << node->op()->name << "(";
+      // the attributes are sorted by name to make the string deterministic
+      std::map<std::string, hlir::framework::AttrType> attrs(node->attrs.attr_store.begin(),
+                                                             node->attrs.attr_store.end());
+      bool first = true;
+      for (const auto& attr : attrs) {
+        ss << (first ? "" : ", ") << attr.first << "=";
+        absl::visit([&ss](const auto& value) { PrintAttr(ss, value); }, attr.second);
+        first = false;
+      }
+      ss << ")\n";
+    }
+    ss << "}\n";
+  }
+  // the names of the arguments are generated, only their types and shapes are serialized
+  for (const auto& func : tune_context_.lowered_funcs) {
+    ss << "Func(";
+    for (size_t i = 0; i < func->args.size(); ++i) {
+      const auto& arg = func->args[i];
+      ss << (i > 0 ? ", " : "") << (arg.is_input() ? "in " : "out ");
+      if (arg.is_buffer()) {
+        ss << arg.buffer_arg()->dtype << "[" << utils::Join(arg.buffer_arg()->shape, ",") << "]";
+      } else {
+        ss << arg.type();
+      }
+    }
+    ss << ")\n";
+  }
+  return ss.str();
 }
 
 }  // namespace auto_schedule
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/task/tune_context.h"
@@ -43,8 +44,25 @@ class TuneTask {
 
   void SetGraphCompiler(hlir::framework::GraphCompiler* compiler);
 
+  // Lower the task graph and set the serialized_key
   void TaskGraphToUnoptLoweredFunc();
 
+  // Serialize the ops, their attributes, the arguments and the target of this task, the tasks
+  // with the same serialized string can share the tuning results.
+  std::string SerializeToString() const;
+
+  /**
+   * Transfer the tuned functions of another task to this task, the two tasks should have the same
+   * serialized_key. The tensors of the tuned task in the functions are replaced by the corresponding
+   * tensors of this task, and the unoptimized functions of this task are returned if the lowered
+   * functions of the two tasks don't correspond.
+   */
+  std::vector<ir::LoweredFunc> TransferTunedFuncs(const TuneTask& tuned_task,
+                                                  const std::vector<ir::LoweredFunc>& tuned_funcs) const;
+
+  // The serialized string of this task, it is used as the key of the tuning records
+  std::string serialized_key;
+
  private:
   // In CINN, we use std::vector<hlir::framework::Node*> to represent a fused
   // sub-graph (if an op won't be fused, it will be a vector with size=1). So
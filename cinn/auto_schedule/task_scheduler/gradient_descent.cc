@@ -0,0 +1,114 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/task_scheduler/gradient_descent.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// the failed measurements are recorded as the maximum cost
+bool IsValidCost(double cost) { return std::isfinite(cost) && cost < std::numeric_limits<double>::max(); }
+
+}  // namespace
+
+GradientDescent::GradientDescent(const std::vector<TuneTask>& tasks, const Config& config)
+    : TaskScheduler(tasks, config), num_trials_(tasks.size(), 0), best_costs_(tasks.size()) {
+  if (config_.task_weights.empty()) {
+    weights_.assign(tasks.size(), 1.0f);
+  } else {
+    CHECK_EQ(config_.task_weights.size(), tasks.size()) << "The number of task weights should equal to the tasks";
+    weights_ = config_.task_weights;
+  }
+}
+
+int GradientDescent::NextTaskId() {
+  if (cur_task_id_ >= static_cast<int>(tasks_->size())) {
+    return -1;
+  }
+  ++cur_task_id_;
+
+  // warm up by tuning each task once
+  for (int i = 0; i < num_trials_.size(); ++i) {
+    if (num_trials_[i] == 0) {
+      ++num_trials_[i];
+      return i;
+    }
+  }
+
+  int picked_id      = -1;
+  double picked_grad = 0;
+  for (int i = 0; i < num_trials_.size(); ++i) {
+    // the gradient can not be estimated without a successful measurement
+    if (best_costs_[i].empty() || !IsValidCost(best_costs_[i].back()) || IsEarlyStopped(i)) {
+      continue;
+    }
+    double grad = Gradient(i);
+    VLOG(5) << "GradientDescent estimates the gradient of task " << i << " as " << grad;
+    if (picked_id == -1 || grad < picked_grad) {
+      picked_id   = i;
+      picked_grad = grad;
+    }
+  }
+  if (picked_id == -1) {
+    VLOG(3) << "GradientDescent stops since no task is expected to improve";
+    return -1;
+  }
+  VLOG(4) << "GradientDescent picks task " << picked_id << " with gradient " << picked_grad;
+  ++num_trials_[picked_id];
+  return picked_id;
+}
+
+void GradientDescent::UpdateTaskResult(int task_id, double best_cost) {
+  CHECK_GE(task_id, 0);
+  CHECK_LT(task_id, best_costs_.size());
+  auto& costs = best_costs_[task_id];
+  costs.push_back(costs.empty() ? best_cost : std::min(costs.back(), best_cost));
+}
+
+double GradientDescent::Gradient(int task_id) const {
+  const auto& costs = best_costs_[task_id];
+  double best_cost  = costs.back();
+
+  // the improvement slope in the recent trials
+  double backward_grad = 0;
+  int window           = config_.backward_window_size;
+  if (window > 0 && costs.size() > window && IsValidCost(costs[costs.size() - 1 - window])) {
+    backward_grad = (best_cost - costs[costs.size() - 1 - window]) / window;
+  }
+  // optimistically, the next trial improves the cost as much as the average of the previous trials
+  double forward_grad = -best_cost / costs.size();
+
+  float alpha = config_.backward_grad_weight;
+  return weights_[task_id] * (alpha * backward_grad + (1 - alpha) * forward_grad);
+}
+
+bool GradientDescent::IsEarlyStopped(int task_id) const {
+  const auto& costs = best_costs_[task_id];
+  int num_trials    = config_.early_stop_trials;
+  if (num_trials <= 0 || costs.size() <= num_trials) {
+    return false;
+  }
+  return costs.back() >= costs[costs.size() - 1 - num_trials];
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
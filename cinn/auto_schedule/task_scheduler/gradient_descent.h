@@ -0,0 +1,59 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Schedule tasks with gradient_descent strategy, that is picking the task
+// expected to reduce the end-to-end latency the most. The latency is the sum of
+// the best costs of the tasks multiplied by their weights, and the expected
+// reduction of a task mixes its recent improvement slope and an optimistic
+// estimation that another trial improves its cost by best_cost / num_trials.
+//
+// Each round picks as many tasks as there are, the tasks are tuned once each
+// before any gradient is estimated, and a task stops being picked if its best
+// cost has not been improved in Config::early_stop_trials trials.
+class GradientDescent : public TaskScheduler {
+ public:
+  GradientDescent(const std::vector<TuneTask>& tasks, const Config& config);
+
+  const char* Name() const override { return "gradient_descent"; };
+
+  int NextTaskId() override;
+
+  void UpdateTaskResult(int task_id, double best_cost) override;
+
+ private:
+  // The expected change of the end-to-end latency by tuning the task once more, negative for a reduction
+  double Gradient(int task_id) const;
+
+  // Whether the best cost of the task is not improved in the recent trials
+  bool IsEarlyStopped(int task_id) const;
+
+  std::vector<float> weights_;
+  // The number of times each task is picked
+  std::vector<int> num_trials_;
+  // The best costs of each task after each of its trials
+  std::vector<std::vector<double>> best_costs_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
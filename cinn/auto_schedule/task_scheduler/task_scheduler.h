@@ -34,6 +34,16 @@ class TaskScheduler {
   struct Config {
     // The minimum threshold of earnings ratio, used by EfficiencyPriority
     float minimum_gain_threshold = 0.0;
+    // The weights of the tasks in the end-to-end latency, such as the numbers
+    // of their occurrences, all the weights are 1 if it is empty. Used by GradientDescent
+    std::vector<float> task_weights;
+    // The number of the recent trials of a task to estimate its improvement slope, used by GradientDescent
+    int backward_window_size = 3;
+    // The weight of the improvement slope against the optimistic expected improvement, used by GradientDescent
+    float backward_grad_weight = 0.2;
+    // A task stops being tuned if its best cost is not improved in this number of trials,
+    // 0 means never stop. Used by GradientDescent
+    int early_stop_trials = 5;
   };
 
   // Create a TaskScheduler with the specific strategy name
@@ -42,6 +52,8 @@ class TaskScheduler {
                                              const Config& config,
                                              const std::string& strategy = "round_robin");
 
+  virtual ~TaskScheduler() = default;
+
   // Reset associated states to schedule at the beginning
   void Reset();
 
@@ -51,6 +63,10 @@ class TaskScheduler {
   // Select a task to tune
   virtual int NextTaskId() = 0;
 
+  // Feed back the best execution cost of the task after it is tuned, the
+  // strategies guided by the tuning progress override it
+  virtual void UpdateTaskResult(int task_id, double best_cost) {}
+
  protected:
   // A taskScheduler object should be created with the static function Make
   TaskScheduler(const std::vector<TuneTask>& tasks, const Config& config);
@@ -19,6 +19,7 @@
 #include <type_traits>
 
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
+#include "cinn/auto_schedule/task_scheduler/gradient_descent.h"
 #include "cinn/auto_schedule/task_scheduler/round_robin.h"
 
 namespace cinn {
@@ -32,6 +33,8 @@ TEST(TaskScheduler, Make) {
   ASSERT_STREQ(round_robin->Name(), "round_robin");
   auto efficiency_priority = TaskScheduler::Make(tasks, config, "efficiency_priority");
   ASSERT_STREQ(efficiency_priority->Name(), "efficiency_priority");
+  auto gradient_descent = TaskScheduler::Make(tasks, config, "gradient_descent");
+  ASSERT_STREQ(gradient_descent->Name(), "gradient_descent");
 }
 
 TEST(RoundRobinScheduler, NextTaskId) {
@@ -52,5 +55,40 @@ TEST(EfficiencyPriorityScheduler, NextTaskId) {
   ASSERT_EQ(-1, efficiency_priority->NextTaskId());
 }
 
+TEST(GradientDescentScheduler, NextTaskId) {
+  std::vector<TuneTask> tasks(3);
+  TaskScheduler::Config config;
+  // the task 1 occurs 4 times in the model
+  config.task_weights      = {1.0f, 4.0f, 1.0f};
+  config.early_stop_trials = 2;
+  auto gradient_descent    = TaskScheduler::Make(tasks, config, "gradient_descent");
+
+  // warm up by tuning each task once
+  std::vector<double> costs = {10.0, 10.0, 60.0};
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(i, gradient_descent->NextTaskId());
+    gradient_descent->UpdateTaskResult(i, costs[i]);
+  }
+  ASSERT_EQ(-1, gradient_descent->NextTaskId());
+
+  // the task 2 contributes the most to the end-to-end latency
+  gradient_descent->Reset();
+  ASSERT_EQ(2, gradient_descent->NextTaskId());
+  gradient_descent->UpdateTaskResult(2, 60.0);
+  // the task 1 contributes more than the task 0 with the same cost
+  ASSERT_EQ(1, gradient_descent->NextTaskId());
+  gradient_descent->UpdateTaskResult(1, 10.0);
+  // the task 2 is not improved in 2 trials and stops
+  ASSERT_EQ(2, gradient_descent->NextTaskId());
+  gradient_descent->UpdateTaskResult(2, 60.0);
+
+  gradient_descent->Reset();
+  int task_id = -1;
+  while ((task_id = gradient_descent->NextTaskId()) != -1) {
+    ASSERT_NE(task_id, 2);
+    gradient_descent->UpdateTaskResult(task_id, 10.0);
+  }
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -17,6 +17,8 @@
 #include <fstream>
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
+#include "cinn/runtime/flags.h"
+#include "cinn/utils/string.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -27,6 +29,8 @@
 #endif
 
 DECLARE_string(cinn_source_code_save_path);
+DECLARE_bool(cinn_llvm_fast_math);
+DECLARE_string(cinn_x86_isa_levels);
 
 namespace cinn {
 namespace backends {
@@ -34,6 +38,35 @@ using ir::Module;
 
 static constexpr int DebugLogMaxLen = 30000;
 
+namespace {
+std::vector<cinn_x86_isa_level_t> ParseX86ISALevels(const std::string& levels) {
+  std::vector<cinn_x86_isa_level_t> isa_levels;
+  if (levels.empty()) return isa_levels;
+  for (auto& level : utils::Split(levels, ",")) {
+    if (level == "sse4.2") {
+      isa_levels.push_back(cinn_x86_isa_sse4_2);
+    } else if (level == "avx2") {
+      isa_levels.push_back(cinn_x86_isa_avx2);
+    } else if (level == "avx512") {
+      isa_levels.push_back(cinn_x86_isa_avx512);
+    } else {
+      LOG(FATAL) << "Unknown x86 instruction set level " << level << ", which should be sse4.2, avx2 or avx512";
+    }
+  }
+  return isa_levels;
+}
+}  // namespace
+
+Compiler::Compiler(const Target& target) : target_(target) {
+  ExecutionOptions options;
+  options.num_compile_threads = runtime::GetCinnParallelCompileThreadNum();
+  options.enable_fast_math    = FLAGS_cinn_llvm_fast_math;
+  if (target_.arch == Target::Arch::X86) {
+    options.isa_levels = ParseX86ISALevels(FLAGS_cinn_x86_isa_levels);
+  }
+  engine_ = ExecutionEngine::Create(options);
+}
+
 void Compiler::Build(const Module& module, const std::string& code, void* stream) {
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module, code, stream);
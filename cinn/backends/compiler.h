@@ -58,7 +58,7 @@ class Compiler final {
 
   void CompileX86Module(const ir::Module& module);
 
-  explicit Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(ExecutionOptions())) {}
+  explicit Compiler(const Target& target);
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Compiler);
 
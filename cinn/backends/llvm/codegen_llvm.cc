@@ -26,6 +26,7 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
 #include <numeric>
@@ -35,8 +36,10 @@
 
 #include "cinn/backends/extern_func_emitter.h"
 #include "cinn/backends/extern_func_emitter_builtin.h"
+#include "cinn/backends/llvm/llvm_math.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/common/cas.h"
+#include "cinn/common/ir_util.h"
 #include "cinn/common/type.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
@@ -771,9 +774,24 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Load *op) {
       CHECK(op->type().is_vector());
       return DenseVectorLoad(op);
     }
+    Type type     = op->type();
+    int alignment = std::max(type.ElementOf().bits() / 8, 1);
+#if LLVM_VERSION_MAJOR >= 11
+    // gather the elements through a vector of pointers
+    llvm::Value *ptrs = CreateBufferPtr(type.ElementOf(), buffer, Visit(&index));
+#if LLVM_VERSION_MAJOR >= 13
+    llvm::Instruction *gather_inst = b_->CreateMaskedGather(
+        CinnTypeToLLVMType(type, m_, true), ptrs, llvm::Align(alignment), nullptr, nullptr, "gather_vec");
+#else
+    llvm::Instruction *gather_inst =
+        b_->CreateMaskedGather(ptrs, llvm::Align(alignment), nullptr, nullptr, "gather_vec");
+#endif
+    if (auto *load_tensor = op->tensor.as_tensor()) {
+      AddTbaaMetadata(gather_inst, load_tensor->name, op->index());
+    }
+    return gather_inst;
+#else
     // scalarize load
-    Type type        = op->type();
-    int alignment    = type.bits() / 8;
     llvm::Value *ret = llvm::UndefValue::get(CinnTypeToLLVMType(type, m_, true));
     auto flambda     = [&](int i, llvm::Value *index) {
       auto *ptr                 = CreateBufferPtr(type.ElementOf(), buffer, index);
@@ -785,6 +803,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Load *op) {
     };
     Scalarize(op->index(), flambda);
     return ret;
+#endif
   }
 }
 
@@ -846,16 +865,23 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
         auto *vtype = llvm::VectorType::get(CinnTypeToLLVMType(op->type().ElementOf(), m_, true),
                                             llvm::ElementCount(lanes, false /*Scalable*/))
                           ->getPointerTo();
-        int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
+        int alignment = DenseVectorAlignment(op->tensor, base, op->type().ElementOf(), lanes);
         llvm::StoreInst *inst =
             b_->CreateAlignedStore(CreateVecSlice(value, offset, lanes), b_->CreatePointerCast(ptr, vtype), alignment);
         AddTbaaMetadata(inst, op->tensor.as_tensor()->name, base);
         return inst;
       }
     }
+    Type type     = op->type();
+    int alignment = std::max(type.ElementOf().bits() / 8, 1);
+#if LLVM_VERSION_MAJOR >= 11
+    // scatter the elements through a vector of pointers
+    llvm::Value *ptrs               = CreateBufferPtr(type.ElementOf(), buffer, Visit(&index));
+    llvm::Instruction *scatter_inst = b_->CreateMaskedScatter(value, ptrs, llvm::Align(alignment));
+    AddTbaaMetadata(scatter_inst, op->tensor.as_tensor()->name, op->index());
+    return scatter_inst;
+#else
     // scalarize store
-    Type type        = op->type();
-    int alignment    = type.bits() / 8;
     llvm::Value *ret = llvm::UndefValue::get(CinnTypeToLLVMType(type, m_, true));
     auto flambda     = [&](int i, llvm::Value *index) {
       auto *ptr = CreateBufferPtr(type.ElementOf(), buffer, index);
@@ -868,6 +894,7 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
     };
     Scalarize(op->index(), flambda);
     return ret;
+#endif
   }
   return nullptr;
 }
@@ -1006,9 +1033,21 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Let *op) {
   return GetVar(name);
 }
 
+// The Reduce nodes are lowered to forloops before codegen.
 llvm::Value *CodeGenLLVM::Visit(const ir::Reduce *op) { __IR_EMITTER_NOT_IMPLEMENTED(op); }
 
-llvm::Value *CodeGenLLVM::Visit(const ir::Ramp *op) { __IR_EMITTER_NOT_IMPLEMENTED(op); }
+llvm::Value *CodeGenLLVM::Visit(const ir::Ramp *op) {
+  // base + stride * <0, 1, ..., lanes - 1>
+  llvm::Value *base   = Visit(&op->base);
+  llvm::Value *stride = b_->CreateIntCast(Visit(&op->stride), base->getType(), true);
+  std::vector<llvm::Constant *> offsets;
+  for (int i = 0; i < op->lanes; ++i) {
+    offsets.push_back(llvm::ConstantInt::get(base->getType(), i));
+  }
+  llvm::Value *strides = b_->CreateMul(b_->CreateVectorSplat(op->lanes, stride, "ramp_stride"),
+                                       llvm::ConstantVector::get(offsets));
+  return b_->CreateAdd(b_->CreateVectorSplat(op->lanes, base, "ramp_base"), strides, "ramp");
+}
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Broadcast *op) {
 #if LLVM_VERSION_MAJOR >= 11
@@ -1026,7 +1065,17 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Broadcast *op) {
 
 llvm::Value *CodeGenLLVM::Visit(const ir::FracOp *op) { __IR_EMITTER_NOT_IMPLEMENTED(op); }
 
-llvm::Value *CodeGenLLVM::Visit(const ir::Power *op) { __IR_EMITTER_NOT_IMPLEMENTED(op); }
+llvm::Value *CodeGenLLVM::Visit(const ir::Power *op) {
+  CHECK(op->type().is_float()) << "Power only supports the float types, but get " << op->type();
+  llvm::Value *x = Visit(&op->a());
+  llvm::Value *y = Visit(&op->b());
+  // the inlined approximation loses precision with the magnitude of y * log(x), so it is only used in fast math
+  if (op->type().ElementOf() == Float(32) && b_->getFastMathFlags().approxFunc()) {
+    return EmitPowF32(b_, x, y);
+  }
+  llvm::Function *fn = GetIntrinsicDecl(llvm::Intrinsic::pow, x->getType(), {x->getType(), y->getType()});
+  return b_->CreateCall(fn, {x, y});
+}
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Product *op) {
   auto size = op->operands().size();
@@ -1155,7 +1204,7 @@ llvm::Value *CodeGenLLVM::DenseVectorLoad(const ir::Load *op) {
     llvm::Value *elt_ptr = CreateBufferPtr(op->type().ElementOf(), buffer, Visit(&slice_base));
     llvm::Value *vec_ptr = b_->CreatePointerCast(elt_ptr, slice_type->getPointerTo(), "get_vec_ptr");
 
-    int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
+    int alignment = DenseVectorAlignment(op->tensor, slice_base, op->type().ElementOf(), slice_lanes);
 
     llvm::Instruction *load_inst = b_->CreateAlignedLoad(vec_ptr, llvm::Align(alignment), "load_vec");
     AddTbaaMetadata(load_inst, op->tensor.as_tensor()->name, op->index());
@@ -1168,6 +1217,20 @@ llvm::Value *CodeGenLLVM::DenseVectorLoad(const ir::Load *op) {
   return slices[0];
 }
 
+int CodeGenLLVM::DenseVectorAlignment(const Expr &tensor, const Expr &base, Type elem_type, int lanes) {
+  int alignment     = std::max(elem_type.bits() / 8, 1);
+  auto *tensor_node = tensor.as_tensor();
+  if (!tensor_node || !tensor_node->buffer.defined()) return alignment;
+  int buffer_alignment = tensor_node->buffer->data_alignment;
+  // double the alignment while the base is a multiple of the doubled number of elements
+  for (int elems = 2; elems <= lanes && alignment * 2 <= buffer_alignment; elems *= 2) {
+    Expr rem = common::AutoSimplify(ir::Mod::Make(base, common::make_const(base.type(), elems)));
+    if (!common::is_zero(rem)) break;
+    alignment *= 2;
+  }
+  return alignment;
+}
+
 llvm::Value *CodeGenLLVM::CreateBufferVecPtr(Type t, llvm::Value *buffer, llvm::Value *index) {
   CHECK_GT(t.lanes(), 1) << "type is not a vector type: " << t;
   llvm::PointerType *btype = llvm::dyn_cast<llvm::PointerType>(buffer->getType());
@@ -1411,6 +1474,26 @@ llvm::Function *CodeGenLLVM::GetIntrinsicDecl(llvm::Intrinsic::ID id,
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
   std::string func_name = op->name;
+  // the float32 transcendental functions are emitted inline instead of the llvm intrinsics lowered to libm calls
+  if (op->type().ElementOf() == Float(32) && op->arg_nums == 1) {
+    CHECK_GE(op->args.size(), 1U);
+    switch (op->id) {
+      case llvm::Intrinsic::exp:
+        return EmitExpF32(b_, Visit(&op->args[0]));
+      case llvm::Intrinsic::log:
+        return EmitLogF32(b_, Visit(&op->args[0]));
+      case llvm::Intrinsic::log2: {
+        llvm::Value *log = EmitLogF32(b_, Visit(&op->args[0]));
+        return b_->CreateFMul(log, llvm::ConstantFP::get(log->getType(), M_LOG2E));
+      }
+      case llvm::Intrinsic::log10: {
+        llvm::Value *log = EmitLogF32(b_, Visit(&op->args[0]));
+        return b_->CreateFMul(log, llvm::ConstantFP::get(log->getType(), M_LOG10E));
+      }
+      default:
+        break;
+    }
+  }
   if (op->id == -1) {
     if (func_name == "bitwise_and") {
       CHECK_GE(op->args.size(), 2U);
@@ -1434,6 +1517,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
       } else {
         return b_->CreateLShr(Visit(&op->args[0]), Visit(&op->args[1]));
       }
+    } else if (func_name == "erf") {
+      CHECK_GE(op->args.size(), 1U);
+      return EmitErfF32(b_, Visit(&op->args[0]));
     } else if (func_name == "isnan") {
       CHECK_GE(op->args.size(), 1U);
       llvm::Value *v = Visit(&op->args[0]);
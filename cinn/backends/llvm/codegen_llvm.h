@@ -199,6 +199,9 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::Value *CreateVecSlice(llvm::Value *vec, int begin, int lanes);
 
   llvm::Value *DenseVectorLoad(const ir::Load *load);
+  //! The alignment in bytes of a dense vector access of \p lanes elements of \p elem_type starting from \p base,
+  //! which is the alignment of the buffer if \p base is provably a multiple of the lanes, else the element size.
+  int DenseVectorAlignment(const Expr &tensor, const Expr &base, Type elem_type, int lanes);
   llvm::Value *CreateSerialFor(const ir::For *op, int stride = 1);
 
   /**
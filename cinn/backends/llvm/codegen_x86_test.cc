@@ -16,6 +16,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "cinn/backends/llvm/execution_engine.h"
 #include "cinn/backends/llvm/simple_jit.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
@@ -68,5 +74,195 @@ TEST(Vectorize, basic) {
   }
 }
 
+TEST(Vectorize, StridedLoadAndTail) {
+  // the transposed load is strided, and the extent 100 is not divisible by the factor 16
+  Expr M(30);
+  Expr N(100);
+  Placeholder<float> A("A", {N, M});
+
+  auto C      = Compute({M, N}, [&](Expr i, Expr j) { return A(j, i) * Expr(2.f); });
+  auto stages = CreateStages({C});
+
+  stages[C]->Vectorize(1, 16);
+
+  auto fn = Lower("fn", stages, {A, C});
+
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  auto jit = SimpleJIT::Create();
+  jit->Link(builder.Build());
+
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+
+  auto* A_buf = common::BufferBuilder(Float(32), {100, 30}).set_random().Build();
+  auto* C_buf = common::BufferBuilder(Float(32), {30, 100}).set_zero().Build();
+
+  auto args = common::ArgsBuilder().Add(A_buf).Add(C_buf).Build();
+
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+  auto* C_data = reinterpret_cast<float*>(C_buf->memory);
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 100; j++) {
+      ASSERT_NEAR(A_data[j * 30 + i] * 2.f, C_data[i * 100 + j], 1e-5);
+    }
+  }
+}
+
+TEST(Vectorize, InlinedMathFunctions) {
+  Expr M(1000);
+  Placeholder<float> A("A", {M});
+
+  auto B      = Compute({M}, [&](Expr i) { return lang::Exp(A(i)); }, "B");
+  auto C      = Compute({M}, [&](Expr i) { return lang::Log(A(i) * A(i) + Expr(1.f)); }, "C");
+  auto D      = Compute({M}, [&](Expr i) { return lang::Erf(A(i)); }, "D");
+  auto E      = Compute({M}, [&](Expr i) { return lang::Tanh(A(i)); }, "E");
+  auto stages = CreateStages({B, C, D, E});
+  for (const auto& tensor : {B, C, D, E}) {
+    stages[tensor]->Vectorize(0, 8);
+  }
+
+  auto fn = Lower("fn", stages, {A, B, C, D, E});
+
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  auto jit = SimpleJIT::Create();
+  jit->Link(builder.Build());
+
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+
+  auto* A_buf  = common::BufferBuilder(Float(32), {1000}).set_zero().Build();
+  auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+  // cover the inputs from -82 to 82 with the denser ones near zero, exp of which is still finite
+  for (int i = 0; i < 1000; i++) {
+    float x   = (i - 500) / 55.f;
+    A_data[i] = x * std::fabs(x);
+  }
+  std::vector<cinn_buffer_t*> outputs;
+  for (int i = 0; i < 4; i++) {
+    outputs.push_back(common::BufferBuilder(Float(32), {1000}).set_zero().Build());
+  }
+
+  auto args = common::ArgsBuilder().Add(A_buf).Add(outputs[0]).Add(outputs[1]).Add(outputs[2]).Add(outputs[3]).Build();
+
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  auto check = [&](cinn_buffer_t* buf, float (*expect)(float)) {
+    auto* data = reinterpret_cast<float*>(buf->memory);
+    for (int i = 0; i < 1000; i++) {
+      float expected = expect(A_data[i]);
+      ASSERT_NEAR(expected, data[i], 1e-6 * std::max(1.f, std::fabs(expected))) << "at input " << A_data[i];
+    }
+  };
+  check(outputs[0], [](float x) { return std::exp(x); });
+  check(outputs[1], [](float x) { return std::log(x * x + 1.f); });
+  check(outputs[2], [](float x) { return std::erf(x); });
+  check(outputs[3], [](float x) { return std::tanh(x); });
+}
+
+// Run exp(a) and tanh(a), log(x) and pow(x, y) vectorized, with or without the fast math flags
+std::vector<std::vector<float>> RunMathFunctions(const std::vector<float>& a,
+                                                 const std::vector<float>& x,
+                                                 const std::vector<float>& y,
+                                                 bool fast_math) {
+  Expr M(static_cast<int>(a.size()));
+  Placeholder<float> A("A", {M});
+  Placeholder<float> X("X", {M});
+  Placeholder<float> Y("Y", {M});
+
+  auto B      = Compute({M}, [&](Expr i) { return lang::Exp(A(i)); }, "B");
+  auto C      = Compute({M}, [&](Expr i) { return lang::Tanh(A(i)); }, "C");
+  auto D      = Compute({M}, [&](Expr i) { return lang::Log(X(i)); }, "D");
+  auto E      = Compute({M}, [&](Expr i) { return ir::Power::Make(X(i), Y(i)); }, "E");
+  auto stages = CreateStages({B, C, D, E});
+  for (const auto& tensor : {B, C, D, E}) {
+    stages[tensor]->Vectorize(0, 8);
+  }
+
+  auto fn = Lower("fn", stages, {A, X, Y, B, C, D, E});
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  ExecutionOptions options;
+  options.enable_fast_math = fast_math;
+  auto engine              = ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(builder.Build());
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(engine->Lookup("fn"));
+  CHECK(fn_ptr);
+
+  std::vector<cinn_buffer_t*> inputs;
+  for (const std::vector<float>* data : {&a, &x, &y}) {
+    inputs.push_back(common::BufferBuilder(Float(32), {M.as_int32()}).set_zero().Build());
+    std::copy(data->begin(), data->end(), reinterpret_cast<float*>(inputs.back()->memory));
+  }
+  std::vector<cinn_buffer_t*> outputs;
+  for (int i = 0; i < 4; i++) {
+    outputs.push_back(common::BufferBuilder(Float(32), {M.as_int32()}).set_zero().Build());
+  }
+  auto args = common::ArgsBuilder()
+                  .Add(inputs[0])
+                  .Add(inputs[1])
+                  .Add(inputs[2])
+                  .Add(outputs[0])
+                  .Add(outputs[1])
+                  .Add(outputs[2])
+                  .Add(outputs[3])
+                  .Build();
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  std::vector<std::vector<float>> results;
+  for (cinn_buffer_t* buf : outputs) {
+    auto* data = reinterpret_cast<float*>(buf->memory);
+    results.emplace_back(data, data + a.size());
+  }
+  return results;
+}
+
+// Check the accuracy of the inlined math functions, the bounds are of the relative errors in FLT_EPSILON (2^-23),
+// which is 1 to 2 ulp.
+void CheckMathAccuracy(bool fast_math) {
+  // a covers the magnitudes from 1e-6 to 80 with both the signs, which includes the small ones where tanh cancels.
+  // x is from 1e-4 to 1e4 and y is from -8 to 8, so |y * log(x)| is at most 74 and pow never overflows
+  const int n = 1024;
+  std::vector<float> a(n), x(n), y(n);
+  for (int i = 0; i < n; i++) {
+    float t = static_cast<float>(i) / (n - 1);
+    a[i]    = (i % 2 ? -1.f : 1.f) * 1e-6f * std::pow(8e7f, t);
+    x[i]    = 1e-4f * std::pow(1e8f, t);
+    y[i]    = -8.f + 16.f * static_cast<float>((i * 37) % n) / (n - 1);
+  }
+  std::vector<std::vector<float>> results = RunMathFunctions(a, x, y, fast_math);
+
+  // the reassociation and reciprocal approximation of fast math cost a few more ulp
+  const double bound = fast_math ? 8.0 : 2.0;
+  for (int i = 0; i < n; i++) {
+    double expected = std::exp(static_cast<double>(a[i]));
+    ASSERT_LE(std::fabs(results[0][i] - expected), bound * FLT_EPSILON * expected) << "exp(" << a[i] << ")";
+
+    expected = std::tanh(static_cast<double>(a[i]));
+    ASSERT_LE(std::fabs(results[1][i] - expected), bound * FLT_EPSILON * std::fabs(expected))
+        << "tanh(" << a[i] << ")";
+
+    // the error of log is absolute for the results below 1 in magnitude, i.e. x in (1 / e, e)
+    expected = std::log(static_cast<double>(x[i]));
+    ASSERT_LE(std::fabs(results[2][i] - expected), bound * FLT_EPSILON * std::max(std::fabs(expected), 1.0))
+        << "log(" << x[i] << ")";
+
+    // pow is exp(y * log(x)), whose relative error grows by about 2 ulp with each unit of |y * log(x)|
+    expected         = std::pow(static_cast<double>(x[i]), static_cast<double>(y[i]));
+    double log_pow   = std::fabs(y[i] * std::log(static_cast<double>(x[i])));
+    double pow_bound = bound + 2.0 * log_pow;
+    ASSERT_LE(std::fabs(results[3][i] - expected), pow_bound * FLT_EPSILON * expected)
+        << "pow(" << x[i] << ", " << y[i] << ")";
+  }
+}
+
+TEST(Vectorize, InlinedMathAccuracy) { CheckMathAccuracy(false); }
+
+TEST(Vectorize, InlinedMathAccuracyFastMath) { CheckMathAccuracy(true); }
+
 }  // namespace backends
 }  // namespace cinn
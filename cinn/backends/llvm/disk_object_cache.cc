@@ -0,0 +1,158 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/disk_object_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <vector>
+
+DECLARE_string(cinn_llvm_object_cache_dir);
+DECLARE_int32(cinn_llvm_object_cache_size_mb);
+
+namespace cinn::backends {
+namespace {
+
+constexpr char kObjectSuffix[] = ".o";
+
+bool MakeDirectories(const std::string &dir) {
+  std::string path;
+  std::stringstream ss(dir);
+  std::string item;
+  if (!dir.empty() && dir[0] == '/') path = "/";
+  while (std::getline(ss, item, '/')) {
+    if (item.empty()) continue;
+    path += item + "/";
+    if (mkdir(path.c_str(), 0755) == -1 && errno != EEXIST) {
+      LOG(WARNING) << "Failed to create directory " << path << ": " << strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+DiskObjectCache::DiskObjectCache(const std::string &dir, uint64_t capacity) : dir_(dir), capacity_(capacity) {
+  CHECK(!dir_.empty()) << "The directory of DiskObjectCache should not be empty";
+  if (dir_.back() != '/') dir_ += '/';
+  MakeDirectories(dir_);
+}
+
+DiskObjectCache *DiskObjectCache::Global() {
+  static DiskObjectCache *cache = []() -> DiskObjectCache * {
+    if (FLAGS_cinn_llvm_object_cache_dir.empty()) return nullptr;
+    uint64_t capacity = static_cast<uint64_t>(std::max(FLAGS_cinn_llvm_object_cache_size_mb, 0)) << 20;
+    VLOG(1) << "Cache the LLVM objects in " << FLAGS_cinn_llvm_object_cache_dir << " with capacity "
+            << FLAGS_cinn_llvm_object_cache_size_mb << "MB";
+    return new DiskObjectCache(FLAGS_cinn_llvm_object_cache_dir, capacity);
+  }();
+  return cache;
+}
+
+std::string DiskObjectCache::PathOf(const std::string &key) const { return dir_ + key + kObjectSuffix; }
+
+bool DiskObjectCache::Load(const std::string &key, std::string *data) {
+  auto path = PathOf(key);
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) return false;
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  if (!ifs.good() && !ifs.eof()) {
+    LOG(WARNING) << "Failed to read the cached object " << path;
+    return false;
+  }
+  *data = ss.str();
+  // refresh the modification time as the access time for LRU eviction
+  utime(path.c_str(), nullptr);
+  VLOG(3) << "Load object " << key << " of " << data->size() << " bytes from " << dir_;
+  return true;
+}
+
+void DiskObjectCache::Store(const std::string &key, absl::string_view data) {
+  static std::atomic<uint64_t> tmp_id{0};
+  auto path = PathOf(key);
+  // the temporary name is unique among threads and processes sharing the directory
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << "."
+           << tmp_id++;
+  {
+    std::ofstream ofs(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    ofs.write(data.data(), data.size());
+    ofs.close();
+    if (!ofs) {
+      LOG(WARNING) << "Failed to write the object cache file " << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename " << tmp_path.str() << " to " << path << ": " << strerror(errno);
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+  VLOG(3) << "Store object " << key << " of " << data.size() << " bytes into " << dir_;
+  Evict();
+}
+
+void DiskObjectCache::Evict() {
+  std::lock_guard<std::mutex> lock(mu_);
+  DIR *dir = opendir(dir_.c_str());
+  if (!dir) return;
+  // (modification time, size, path) of the cached objects
+  std::vector<std::tuple<int64_t, uint64_t, std::string>> entries;
+  uint64_t total_size = 0;
+  for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (!EndsWith(name, kObjectSuffix)) continue;
+    struct stat st;
+    std::string path = dir_ + name;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+    entries.emplace_back(static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec,
+                         static_cast<uint64_t>(st.st_size), path);
+    total_size += st.st_size;
+  }
+  closedir(dir);
+  if (total_size <= capacity_) return;
+
+  std::sort(entries.begin(), entries.end());
+  for (auto &entry : entries) {
+    if (total_size <= capacity_) break;
+    if (std::remove(std::get<2>(entry).c_str()) == 0) {
+      VLOG(3) << "Evict the cached object " << std::get<2>(entry);
+    }
+    total_size -= std::get<1>(entry);
+  }
+}
+
+}  // namespace cinn::backends
@@ -0,0 +1,69 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/strings/string_view.h>
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+
+namespace cinn::backends {
+
+/**
+ * DiskObjectCache stores compiled object files in a directory so that they survive process restarts.
+ *
+ * The entries are content-addressed, the key is expected to be a hash of everything affecting the object,
+ * such as the IR, the target and the compiler versions. An entry is written to a temporary file and renamed
+ * to its final name, so readers, including other processes sharing the directory, never see a partial
+ * object. When the total size exceeds the capacity, the least recently used entries are removed, the last
+ * modification time of an entry is refreshed on every hit to track the recency.
+ */
+class DiskObjectCache {
+ public:
+  /**
+   * Constructor.
+   * @param dir The directory the objects are stored in, it is created if not exists.
+   * @param capacity The maximum total size in bytes of the stored objects.
+   */
+  DiskObjectCache(const std::string &dir, uint64_t capacity);
+
+  /**
+   * The cache configured by FLAGS_cinn_llvm_object_cache_dir and FLAGS_cinn_llvm_object_cache_size_mb,
+   * it is null if the directory is not specified.
+   */
+  static DiskObjectCache *Global();
+
+  //! Load the object of \p key into \p data, return false if it is not cached.
+  bool Load(const std::string &key, std::string *data);
+
+  //! Store the object of \p key, then evict the least recently used objects if it is too large.
+  void Store(const std::string &key, absl::string_view data);
+
+  //! Remove the least recently used objects until the total size fits the capacity.
+  void Evict();
+
+  const std::string &dir() const { return dir_; }
+  uint64_t capacity() const { return capacity_; }
+
+ private:
+  std::string PathOf(const std::string &key) const;
+
+  std::string dir_;
+  uint64_t capacity_;
+  std::mutex mu_;
+};
+
+}  // namespace cinn::backends
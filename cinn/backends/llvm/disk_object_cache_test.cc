@@ -0,0 +1,64 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/disk_object_cache.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+
+namespace cinn::backends {
+
+std::string TestCacheDir(const std::string &name) {
+  return "/tmp/cinn_disk_object_cache_test_" + std::to_string(getpid()) + "/" + name;
+}
+
+TEST(DiskObjectCache, StoreAndLoad) {
+  DiskObjectCache cache(TestCacheDir("store_and_load"), 1 << 20);
+  std::string data;
+  EXPECT_FALSE(cache.Load("module_a", &data));
+
+  std::string object("\x7f"
+                     "ELF\0binary",
+                     10);
+  cache.Store("module_a", object);
+  ASSERT_TRUE(cache.Load("module_a", &data));
+  EXPECT_EQ(data, object);
+
+  // another instance sharing the directory, e.g. a restarted process, sees the object
+  DiskObjectCache restarted(TestCacheDir("store_and_load"), 1 << 20);
+  ASSERT_TRUE(restarted.Load("module_a", &data));
+  EXPECT_EQ(data, object);
+}
+
+TEST(DiskObjectCache, EvictLeastRecentlyUsed) {
+  DiskObjectCache cache(TestCacheDir("evict"), 2500);
+  std::string data;
+  cache.Store("a", std::string(1000, 'a'));
+  usleep(10000);
+  cache.Store("b", std::string(1000, 'b'));
+  usleep(10000);
+  // a becomes more recently used than b
+  ASSERT_TRUE(cache.Load("a", &data));
+  usleep(10000);
+  cache.Store("c", std::string(1000, 'c'));
+
+  EXPECT_TRUE(cache.Load("a", &data));
+  EXPECT_FALSE(cache.Load("b", &data));
+  EXPECT_TRUE(cache.Load("c", &data));
+  EXPECT_EQ(data, std::string(1000, 'c'));
+}
+
+}  // namespace cinn::backends
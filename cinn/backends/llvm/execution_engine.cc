@@ -15,6 +15,7 @@
 #include "cinn/backends/llvm/execution_engine.h"
 
 #include <absl/strings/string_view.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/AsmParser/Parser.h>
 #include <llvm/Config/llvm-config.h>
@@ -25,17 +26,20 @@
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InlineAsm.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/InitializePasses.h>
+#include <llvm/MC/SubtargetFeature.h>
 #include <llvm/PassRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/Error.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
@@ -47,22 +51,29 @@
 #include <llvm/Transforms/Scalar/NewGVN.h>
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "cinn/backends/codegen_cuda_host.h"
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/disk_object_cache.h"
 #include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn::backends {
 namespace {
@@ -85,6 +96,239 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+// The key of the object compiled from the unoptimized module m, which covers everything affecting the object.
+std::string ObjectCacheKey(const llvm::Module &m,
+                           const llvm::TargetMachine &machine,
+                           int opt_level,
+                           bool enable_fast_math) {
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  m.print(os, nullptr);
+  os.flush();
+
+  llvm::SHA1 hasher;
+  hasher.update(ir);
+  hasher.update(machine.getTargetTriple().str());
+  hasher.update(machine.getTargetCPU());
+  hasher.update(machine.getTargetFeatureString());
+  hasher.update(LLVM_VERSION_STRING);
+  hasher.update(std::to_string(opt_level));
+  hasher.update(enable_fast_math ? "fast_math" : "");
+#ifdef CINN_VERSION_INTEGER
+  hasher.update(std::to_string(CINN_VERSION_INTEGER));
+#endif
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+// The target features of the x86 instruction set level, which should agree with the detection of cinn_x86_isa_level.
+const char *X86ISAFeatures(cinn_x86_isa_level_t level) {
+  switch (level) {
+    case cinn_x86_isa_sse4_2:
+      return "+sse4.2";
+    case cinn_x86_isa_avx2:
+      return "+sse4.2,+avx,+avx2,+fma";
+    case cinn_x86_isa_avx512:
+      return "+sse4.2,+avx,+avx2,+fma,+avx512f,+avx512cd,+avx512bw,+avx512dq,+avx512vl";
+    default:
+      LOG(FATAL) << "Unknown x86 instruction set level " << level;
+  }
+  return "";
+}
+
+// The name of the version of the function compiled for the x86 instruction set level, e.g. fn.avx2
+std::string X86VersionName(const std::string &fn_name, cinn_x86_isa_level_t level) {
+  switch (level) {
+    case cinn_x86_isa_sse4_2:
+      return fn_name + ".sse4_2";
+    case cinn_x86_isa_avx2:
+      return fn_name + ".avx2";
+    case cinn_x86_isa_avx512:
+      return fn_name + ".avx512";
+    default:
+      LOG(FATAL) << "Unknown x86 instruction set level " << level;
+  }
+  return fn_name;
+}
+
+// The host CPU, which generates the object loadable by a shared library, e.g. the one embedded by Program::Export.
+std::unique_ptr<llvm::TargetMachine> CreateHostTargetMachine() {
+  auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  builder.setRelocationModel(llvm::Reloc::PIC_);
+  return llvm::cantFail(builder.createTargetMachine());
+}
+
+// The generic x86-64 CPU with the features of the level, which generates the object loadable by a shared library.
+std::unique_ptr<llvm::TargetMachine> CreateX86TargetMachine(cinn_x86_isa_level_t level) {
+  auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  builder.setCPU("x86-64");
+  builder.getFeatures() = llvm::SubtargetFeatures(X86ISAFeatures(level));
+  builder.setRelocationModel(llvm::Reloc::PIC_);
+  return llvm::cantFail(builder.createTargetMachine());
+}
+
+// The functions are optimized and compiled for the subtarget of their own attributes, which override the ones
+// the runtime functions are compiled with.
+void SetX86ISAAttributes(llvm::Function *f, cinn_x86_isa_level_t level) {
+  f->removeFnAttr("target-cpu");
+  f->removeFnAttr("target-features");
+  f->addFnAttr("target-cpu", "x86-64");
+  f->addFnAttr("target-features", X86ISAFeatures(level));
+}
+
+// Emit the internal function detecting the level like cinn_x86_isa_level, which the object carries itself so that
+// it is loadable without the CINN runtime, e.g. by the tiny runtime.
+llvm::Function *EmitX86ISADetection(llvm::Module *m) {
+  llvm::LLVMContext &ctx = m->getContext();
+  llvm::IRBuilder<> b(ctx);
+  llvm::Type *int_type = b.getInt32Ty();
+  auto *detect         = llvm::Function::Create(
+      llvm::FunctionType::get(int_type, false), llvm::GlobalValue::InternalLinkage, "__cinn_detect_x86_isa_level", m);
+  auto *entry  = llvm::BasicBlock::Create(ctx, "entry", detect);
+  auto *avx_bb = llvm::BasicBlock::Create(ctx, "avx", detect);
+  auto *ret_bb = llvm::BasicBlock::Create(ctx, "return", detect);
+
+  // {eax, ebx, ecx, edx} cpuid(leaf, subleaf)
+  auto *cpuid_type = llvm::StructType::get(ctx, {int_type, int_type, int_type, int_type});
+  auto *cpuid      = llvm::InlineAsm::get(llvm::FunctionType::get(cpuid_type, {int_type, int_type}, false),
+                                     "cpuid",
+                                     "={ax},={bx},={cx},={dx},{ax},{cx},~{dirflag},~{fpsr},~{flags}",
+                                     /*hasSideEffects=*/true);
+  // {eax, edx} xgetbv(ecx), which faults unless the OS enables it as told by OSXSAVE
+  auto *xgetbv = llvm::InlineAsm::get(
+      llvm::FunctionType::get(llvm::StructType::get(ctx, {int_type, int_type}), {int_type}, false),
+      "xgetbv",
+      "={ax},={dx},{cx},~{dirflag},~{fpsr},~{flags}",
+      /*hasSideEffects=*/true);
+  auto has_bits = [&](llvm::Value *reg, uint32_t bits) {
+    return b.CreateICmpEQ(b.CreateAnd(reg, b.getInt32(bits)), b.getInt32(bits));
+  };
+
+  // the bits of cpuid.h
+  const uint32_t sse4_2 = 1u << 20, osxsave = 1u << 27, avx = 1u << 28, fma = 1u << 12, avx2 = 1u << 5;
+  const uint32_t avx512 = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);  // F, DQ, CD, BW and VL
+
+  b.SetInsertPoint(entry);
+  llvm::Value *max_leaf = b.CreateExtractValue(b.CreateCall(cpuid, {b.getInt32(0), b.getInt32(0)}), 0);
+  llvm::Value *ecx1     = b.CreateExtractValue(b.CreateCall(cpuid, {b.getInt32(1), b.getInt32(0)}), 2);
+  llvm::Value *base =
+      b.CreateSelect(has_bits(ecx1, sse4_2), b.getInt32(cinn_x86_isa_sse4_2), b.getInt32(cinn_x86_isa_unk));
+  b.CreateCondBr(has_bits(ecx1, osxsave | avx | fma), avx_bb, ret_bb);
+
+  b.SetInsertPoint(avx_bb);
+  llvm::Value *xcr0 = b.CreateExtractValue(b.CreateCall(xgetbv, {b.getInt32(0)}), 0);
+  // the leaf 7 is read only if supported
+  llvm::Value *ebx7 = b.CreateSelect(b.CreateICmpUGE(max_leaf, b.getInt32(7)),
+                                     b.CreateExtractValue(b.CreateCall(cpuid, {b.getInt32(7), b.getInt32(0)}), 1),
+                                     b.getInt32(0));
+  // the XMM and YMM states, then the opmask and the ZMM states
+  llvm::Value *avx2_level   = b.CreateAnd(has_bits(xcr0, 0x6), has_bits(ebx7, avx2));
+  llvm::Value *avx512_level = b.CreateAnd(has_bits(xcr0, 0xe6), has_bits(ebx7, avx512));
+  llvm::Value *level =
+      b.CreateSelect(avx2_level,
+                     b.CreateSelect(avx512_level, b.getInt32(cinn_x86_isa_avx512), b.getInt32(cinn_x86_isa_avx2)),
+                     b.getInt32(cinn_x86_isa_sse4_2));
+  level = b.CreateSelect(has_bits(ecx1, sse4_2), level, b.getInt32(cinn_x86_isa_unk));
+  b.CreateBr(ret_bb);
+
+  b.SetInsertPoint(ret_bb);
+  auto *result = b.CreatePHI(int_type, 2);
+  result->addIncoming(base, entry);
+  result->addIncoming(level, avx_bb);
+  b.CreateRet(result);
+  return detect;
+}
+
+// Emit the functions named as the kernels, which call the version of the highest level not above the one detected
+// by EmitX86ISADetection, and the lowest level as the fallback. The level is detected once by a global constructor
+// when the object is loaded, or by the first call if the constructors are not run, e.g. in the JIT.
+void EmitX86Dispatchers(const std::vector<std::string> &fn_names,
+                        const std::vector<cinn_x86_isa_level_t> &isa_levels,
+                        llvm::Module *m) {
+  llvm::LLVMContext &ctx = m->getContext();
+  llvm::IRBuilder<> b(ctx);
+  llvm::Type *int_type = b.getInt32Ty();
+  auto *detect         = EmitX86ISADetection(m);
+
+  constexpr int kUndetected = -2;
+
+  auto *cached_level = new llvm::GlobalVariable(*m,
+                                                int_type,
+                                                /*isConstant=*/false,
+                                                llvm::GlobalValue::InternalLinkage,
+                                                b.getInt32(kUndetected),
+                                                "__cinn_x86_isa_level");
+
+  // int get_level() { if (cached_level == kUndetected) cached_level = detect(); return cached_level; }
+  auto *get_level = llvm::Function::Create(
+      llvm::FunctionType::get(int_type, false), llvm::GlobalValue::InternalLinkage, "__cinn_get_x86_isa_level", m);
+  {
+    auto *entry     = llvm::BasicBlock::Create(ctx, "entry", get_level);
+    auto *detect_bb = llvm::BasicBlock::Create(ctx, "detect", get_level);
+    auto *ret_bb    = llvm::BasicBlock::Create(ctx, "return", get_level);
+    b.SetInsertPoint(entry);
+    // the racing detections store the same level
+    auto *level = b.CreateLoad(int_type, cached_level);
+    level->setAlignment(llvm::Align(4));
+    level->setAtomic(llvm::AtomicOrdering::Monotonic);
+    b.CreateCondBr(b.CreateICmpEQ(level, b.getInt32(kUndetected)), detect_bb, ret_bb);
+
+    b.SetInsertPoint(detect_bb);
+    llvm::Value *detected = b.CreateCall(detect);
+    auto *store           = b.CreateStore(detected, cached_level);
+    store->setAlignment(llvm::Align(4));
+    store->setAtomic(llvm::AtomicOrdering::Monotonic);
+    b.CreateBr(ret_bb);
+
+    b.SetInsertPoint(ret_bb);
+    auto *result = b.CreatePHI(int_type, 2);
+    result->addIncoming(level, entry);
+    result->addIncoming(detected, detect_bb);
+    b.CreateRet(result);
+  }
+
+  auto *init = llvm::Function::Create(
+      llvm::FunctionType::get(b.getVoidTy(), false), llvm::GlobalValue::InternalLinkage, "__cinn_x86_isa_init", m);
+  b.SetInsertPoint(llvm::BasicBlock::Create(ctx, "entry", init));
+  b.CreateCall(get_level);
+  b.CreateRetVoid();
+  llvm::appendToGlobalCtors(*m, init, /*Priority=*/65535);
+
+  for (auto &fn_name : fn_names) {
+    llvm::Function *fallback = m->getFunction(X86VersionName(fn_name, isa_levels.front()));
+    CHECK(fallback) << "The version of " << fn_name << " is not found";
+    auto *dispatcher =
+        llvm::Function::Create(fallback->getFunctionType(), llvm::GlobalValue::ExternalLinkage, fn_name, m);
+    dispatcher->setCallingConv(llvm::CallingConv::C);
+    std::vector<llvm::Value *> args;
+    for (auto &arg : dispatcher->args()) {
+      args.push_back(&arg);
+    }
+    auto emit_call = [&](llvm::Function *version) {
+      auto *call = b.CreateCall(version, args);
+      call->setTailCall();
+      if (version->getReturnType()->isVoidTy()) {
+        b.CreateRetVoid();
+      } else {
+        b.CreateRet(call);
+      }
+    };
+
+    b.SetInsertPoint(llvm::BasicBlock::Create(ctx, "entry", dispatcher));
+    llvm::Value *level = b.CreateCall(get_level);
+    for (int i = isa_levels.size() - 1; i > 0; --i) {
+      llvm::Function *version = m->getFunction(X86VersionName(fn_name, isa_levels[i]));
+      CHECK(version) << "The version of " << fn_name << " is not found";
+      auto *call_bb = llvm::BasicBlock::Create(ctx, "call", dispatcher);
+      auto *next_bb = llvm::BasicBlock::Create(ctx, "next", dispatcher);
+      b.CreateCondBr(b.CreateICmpSGE(level, b.getInt32(isa_levels[i])), call_bb, next_bb);
+      b.SetInsertPoint(call_bb);
+      emit_call(version);
+      b.SetInsertPoint(next_bb);
+    }
+    emit_call(fallback);
+  }
+}
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
   cached_objects_[m->getModuleIdentifier()] =
@@ -111,7 +355,8 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   llvm::InitializeNativeTargetAsmPrinter();
   InitializeLLVMPasses();
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  auto engine      = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  engine->options_ = config;
 
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
@@ -148,22 +393,62 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   return engine;
 }
 
+llvm::FastMathFlags ExecutionEngine::GetFastMathFlags() const {
+  llvm::FastMathFlags flags;
+  if (options_.enable_fast_math) {
+    flags.setFast();
+  }
+  return flags;
+}
+
 template <typename CodeGenT>
 void ExecutionEngine::Link(const ir::Module &module) {
+  if (!options_.isa_levels.empty()) {
+    LinkMultiVersion<CodeGenT>(module);
+    return;
+  }
+  if (options_.num_compile_threads > 1 && module.functions().size() > 1) {
+    LinkInParallel<CodeGenT>(module);
+    return;
+  }
+
   llvm::SMDiagnostic error;
   auto ctx        = std::make_unique<llvm::LLVMContext>();
   auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
   auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
+  b->setFastMathFlags(GetFastMathFlags());
   auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
   VLOG(3) << "ir_emitter->Compile(module) Begin";
-  ir_emitter->Compile(module);
+  {
+    utils::RecordEvent record_emit("LLVM IR Emission", utils::EventType::kCompilePhase);
+    ir_emitter->Compile(module);
+  }
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
-  optimize(m.get());
+  auto machine = CreateHostTargetMachine();
+  buffer_.clear();
+  compile_exported_object_ = nullptr;
+
+  // the object compiled by a previous process skips both optimization and code generation
+  auto *disk_cache = DiskObjectCache::Global();
+  std::string cache_key;
+  if (disk_cache) {
+    cache_key = ObjectCacheKey(*m, *machine, 3, options_.enable_fast_math);
+    std::string object;
+    if (disk_cache->Load(cache_key, &object)) {
+      VLOG(1) << "Load the object of module " << module.name() << " from the disk cache";
+      buffer_.append(object.begin(), object.end());
+      llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(object, cache_key)));
+      return;
+    }
+  }
+
+  {
+    utils::RecordEvent record_optimize("LLVM Optimization", utils::EventType::kCompilePhase);
+    LLVMModuleOptimizer optimize(machine.get(), 3, GetFastMathFlags(), true);
+    optimize(m.get());
+  }
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
     VLOG(5) << "function: " << DumpToString(f);
@@ -172,7 +457,14 @@ void ExecutionEngine::Link(const ir::Module &module) {
   llvm::raw_svector_ostream rawstream(buffer_);
   llvm::legacy::PassManager pass_manager;
   machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
-  pass_manager.run(*m);
+  {
+    utils::RecordEvent record_codegen("LLVM CodeGen", utils::EventType::kCompilePhase);
+    pass_manager.run(*m);
+  }
+
+  if (disk_cache) {
+    disk_cache->Store(cache_key, absl::string_view(buffer_.data(), buffer_.size()));
+  }
 
   CHECK(AddModule(std::move(m), std::move(ctx)));
 
@@ -187,6 +479,190 @@ void ExecutionEngine::Link(const ir::Module &module) {
   }
 }
 
+template <typename CodeGenT>
+std::string ExecutionEngine::CompileObject(const ir::Module &module, bool internalize_runtime) {
+  llvm::SMDiagnostic error;
+  llvm::LLVMContext ctx;
+  auto m = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, ctx);
+  if (internalize_runtime) {
+    // each partition carries its own copy of the runtime functions, hide them to avoid duplicate definitions
+    for (auto &gv : m->global_values()) {
+      if (gv.isDeclaration() || gv.hasLocalLinkage()) continue;
+      gv.setLinkage(llvm::GlobalValue::InternalLinkage);
+      if (auto *go = llvm::dyn_cast<llvm::GlobalObject>(&gv)) go->setComdat(nullptr);
+    }
+  }
+  auto b          = std::make_unique<llvm::IRBuilder<>>(ctx);
+  b->setFastMathFlags(GetFastMathFlags());
+  auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+  {
+    utils::RecordEvent record_emit("LLVM IR Emission", utils::EventType::kCompilePhase);
+    ir_emitter->Compile(module);
+  }
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+
+  auto machine = CreateHostTargetMachine();
+  m->setDataLayout(machine->createDataLayout());
+  m->setTargetTriple(machine->getTargetTriple().str());
+
+  auto *disk_cache = DiskObjectCache::Global();
+  std::string cache_key;
+  std::string object;
+  if (disk_cache) {
+    cache_key = ObjectCacheKey(*m, *machine, 3, options_.enable_fast_math);
+    if (disk_cache->Load(cache_key, &object)) {
+      VLOG(1) << "Load the object of module " << module.name() << " from the disk cache";
+      return object;
+    }
+  }
+
+  {
+    utils::RecordEvent record_optimize("LLVM Optimization", utils::EventType::kCompilePhase);
+    LLVMModuleOptimizer optimize(machine.get(), 3, GetFastMathFlags(), true);
+    optimize(m.get());
+  }
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
+
+  llvm::SmallString<0> buffer;
+  llvm::raw_svector_ostream rawstream(buffer);
+  llvm::legacy::PassManager pass_manager;
+  machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
+  {
+    utils::RecordEvent record_codegen("LLVM CodeGen", utils::EventType::kCompilePhase);
+    pass_manager.run(*m);
+  }
+  object.assign(buffer.begin(), buffer.end());
+
+  if (disk_cache) {
+    disk_cache->Store(cache_key, object);
+  }
+  return object;
+}
+
+template <typename CodeGenT>
+void ExecutionEngine::LinkInParallel(const ir::Module &module) {
+  auto functions     = module.functions();
+  int num_partitions = std::min<int>(options_.num_compile_threads, functions.size());
+  std::vector<ir::Module> partitions;
+  for (int i = 0; i < num_partitions; ++i) {
+    partitions.emplace_back(ir::_Module_::Make(module.name() + "_part_" + std::to_string(i), module.target()));
+    partitions.back()->buffers = module->buffers;
+  }
+  // the module has been optimized, so the functions are distributed to the partitions directly
+  for (int i = 0; i < functions.size(); ++i) {
+    partitions[i % num_partitions]->functions.emplace_back(functions[i]);
+  }
+  VLOG(3) << "Compile " << functions.size() << " functions of module " << module.name() << " in " << num_partitions
+          << " partitions";
+
+  std::vector<std::string> objects(num_partitions);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_partitions; ++i) {
+    // only the first partition exposes the runtime functions
+    threads.emplace_back([this, &objects, &partitions, i]() {
+      objects[i] = CompileObject<CodeGenT>(partitions[i], /*internalize_runtime=*/i > 0);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mu_);
+  for (int i = 0; i < num_partitions; ++i) {
+    llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(objects[i], partitions[i].name())));
+  }
+  // the partition objects can not be merged into one, so the whole module is compiled again for ExportObject
+  buffer_.clear();
+  compile_exported_object_ = [this, module]() { return CompileObject<CodeGenT>(module, false); };
+}
+
+template <typename CodeGenT>
+void ExecutionEngine::LinkMultiVersion(const ir::Module &module) {
+  CHECK(module.target().arch == Target::Arch::X86) << "Only the X86 kernels can be compiled for multiple levels";
+  std::vector<cinn_x86_isa_level_t> isa_levels = options_.isa_levels;
+  std::sort(isa_levels.begin(), isa_levels.end());
+  isa_levels.erase(std::unique(isa_levels.begin(), isa_levels.end()), isa_levels.end());
+  std::vector<std::string> fn_names;
+  for (auto &fn : module.functions()) {
+    fn_names.push_back(fn->name);
+  }
+
+  llvm::SMDiagnostic error;
+  auto ctx = std::make_unique<llvm::LLVMContext>();
+  auto m   = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
+  auto b   = std::make_unique<llvm::IRBuilder<>>(*ctx);
+  b->setFastMathFlags(GetFastMathFlags());
+  // the runtime functions are compiled with AVX2, they should run on the lowest level as the dispatchers
+  for (auto &f : *m) {
+    if (!f.isDeclaration()) SetX86ISAAttributes(&f, isa_levels.front());
+  }
+  {
+    utils::RecordEvent record_emit("LLVM IR Emission", utils::EventType::kCompilePhase);
+    for (auto level : isa_levels) {
+      std::unordered_set<llvm::Function *> existing_functions;
+      for (auto &f : *m) {
+        existing_functions.insert(&f);
+      }
+      auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+      ir_emitter->Compile(module);
+      // the kernels and their helpers, e.g. the parallel lambdas, of this level
+      for (auto &f : *m) {
+        if (!f.isDeclaration() && !existing_functions.count(&f)) SetX86ISAAttributes(&f, level);
+      }
+      // free the names of the kernels for the next level and the dispatchers
+      for (auto &fn_name : fn_names) {
+        llvm::Function *f = m->getFunction(fn_name);
+        CHECK(f && !f->isDeclaration()) << "The function " << fn_name << " is not emitted";
+        f->setName(X86VersionName(fn_name, level));
+      }
+    }
+    EmitX86Dispatchers(fn_names, isa_levels, m.get());
+  }
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+
+  // the module is compiled for the lowest level, and each function for its own level by the attributes
+  auto machine = CreateX86TargetMachine(isa_levels.front());
+  m->setDataLayout(machine->createDataLayout());
+  m->setTargetTriple(machine->getTargetTriple().str());
+
+  auto *disk_cache = DiskObjectCache::Global();
+  std::string cache_key;
+  std::string object;
+  if (disk_cache) {
+    cache_key = ObjectCacheKey(*m, *machine, 3, options_.enable_fast_math);
+    if (disk_cache->Load(cache_key, &object)) {
+      VLOG(1) << "Load the object of module " << module.name() << " from the disk cache";
+    }
+  }
+  if (object.empty()) {
+    {
+      utils::RecordEvent record_optimize("LLVM Optimization", utils::EventType::kCompilePhase);
+      LLVMModuleOptimizer optimize(machine.get(), 3, GetFastMathFlags(), true);
+      optimize(m.get());
+    }
+    CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
+
+    llvm::SmallString<0> buffer;
+    llvm::raw_svector_ostream rawstream(buffer);
+    llvm::legacy::PassManager pass_manager;
+    machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
+    {
+      utils::RecordEvent record_codegen("LLVM CodeGen", utils::EventType::kCompilePhase);
+      pass_manager.run(*m);
+    }
+    object.assign(buffer.begin(), buffer.end());
+    if (disk_cache) {
+      disk_cache->Store(cache_key, object);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mu_);
+  llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(object, module.name())));
+  buffer_.clear();
+  buffer_.append(object.begin(), object.end());
+  compile_exported_object_ = nullptr;
+}
+
 bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context) {
   module->setDataLayout(jit_->getDataLayout());
   if (false) {
@@ -205,6 +681,11 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
 }
 
 void ExecutionEngine::ExportObject(const std::string &path) {
+  if (compile_exported_object_) {
+    std::string object       = compile_exported_object_();
+    compile_exported_object_ = nullptr;
+    buffer_.assign(object.begin(), object.end());
+  }
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
   fclose(of);
@@ -46,6 +46,7 @@
 #include "cinn/backends/llvm/codegen_x86.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/ir/module.h"
+#include "cinn/runtime/cinn_runtime.h"
 
 namespace cinn::backends {
 
@@ -61,9 +62,15 @@ class NaiveObjectCache : public llvm::ObjectCache {
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
-  // TODO(fc500110)
-  // int num_compile_threads{1};
-  // bool enable_fast_math;
+  // the functions of a module are split into at most num_compile_threads partitions compiled in parallel
+  int num_compile_threads{1};
+  // whether set all the fast math flags on the float instructions, which allows the inlined approximations of the
+  // math functions and the reassociation of the float operations, at the cost of the precision
+  bool enable_fast_math{false};
+  // the x86 instruction set levels each kernel is compiled for, and the kernel dispatches to the version of the highest
+  // level supported by the running CPU, so the exported object runs on all the CPUs supporting the lowest level.
+  // Empty to compile the kernels only for the host CPU
+  std::vector<cinn_x86_isa_level_t> isa_levels;
 };
 
 class ExecutionEngine {
@@ -84,15 +91,32 @@ class ExecutionEngine {
 
   void RegisterRuntimeSymbols();
 
+  llvm::FastMathFlags GetFastMathFlags() const;
+
   bool SetupTargetTriple(llvm::Module *module);
 
+  //! Compile a module to an object file in its own LLVMContext, which can be called by multiple threads.
+  template <typename CodeGenT>
+  std::string CompileObject(const ir::Module &module, bool internalize_runtime);
+
+  //! Split the functions of a module into at most num_compile_threads partitions and link them in parallel.
+  template <typename CodeGenT>
+  void LinkInParallel(const ir::Module &module);
+
+  //! Compile each function of a module for all the isa_levels and a dispatcher into one object, and link it.
+  template <typename CodeGenT>
+  void LinkMultiVersion(const ir::Module &module);
+
   friend std::unique_ptr<ExecutionEngine> std::make_unique<ExecutionEngine>(bool &&);
 
  private:
   mutable std::mutex mu_;
   llvm::SmallString<0> buffer_;
+  // compile the object of the last module linked in partitions, which is deferred until it is exported
+  std::function<std::string()> compile_exported_object_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
+  ExecutionOptions options_;
 };
 
 }  // namespace cinn::backends
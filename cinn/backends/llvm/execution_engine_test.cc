@@ -22,6 +22,7 @@
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Object/ObjectFile.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
@@ -32,6 +33,7 @@
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -325,5 +327,130 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, multi_version_kernels) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+
+  Placeholder<float> x("x", {M, N});
+  Placeholder<float> y("y", {M, N});
+  auto res = Compute(
+      {M, N}, [=](Var i, Var j) { return x(i, j) * y(i, j) + x(i, j); }, "res");
+
+  auto stages = CreateStages({res});
+  stages[res]->Vectorize(1, 8);
+  auto func = Lower("comp", stages, {x, y, res});
+
+  Module::Builder builder("module_multi_version", common::DefaultHostTarget());
+  builder.AddFunction(func);
+
+  ExecutionOptions options;
+  options.isa_levels = {cinn_x86_isa_avx512, cinn_x86_isa_sse4_2, cinn_x86_isa_avx2};
+  auto engine        = backends::ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(builder.Build());
+
+  auto _ab_bb_cb_ = CreateTestBuffer();  // NOLINT
+  auto &ab        = std::get<0>(_ab_bb_cb_);
+  auto &bb        = std::get<1>(_ab_bb_cb_);
+  auto &cb        = std::get<2>(_ab_bb_cb_);
+  cinn_pod_value_t a_arg(ab), b_arg(bb), c_arg(cb);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+
+  // the dispatcher and each version the host supports
+  std::vector<std::string> fn_names = {"comp"};
+  int host_level                    = cinn_x86_isa_level();
+  if (host_level >= cinn_x86_isa_sse4_2) fn_names.push_back("comp.sse4_2");
+  if (host_level >= cinn_x86_isa_avx2) fn_names.push_back("comp.avx2");
+  if (host_level >= cinn_x86_isa_avx512) fn_names.push_back("comp.avx512");
+
+  auto *ad = reinterpret_cast<float *>(ab->memory);
+  auto *bd = reinterpret_cast<float *>(bb->memory);
+  auto *cd = reinterpret_cast<float *>(cb->memory);
+  for (auto &fn_name : fn_names) {
+    auto comp = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup(fn_name));
+    ASSERT_TRUE(comp) << fn_name;
+    std::fill(cd, cd + kM * kN, 0.f);
+    comp(args, 3);
+    for (int i = 0; i < kM * kN; i++) {
+      ASSERT_NEAR(cd[i], ad[i] * bd[i] + ad[i], 1e-5) << fn_name;
+    }
+  }
+
+  // all the versions are in the exported object
+  std::string path = "./multi_version_kernels.o";
+  engine->ExportObject(path);
+  auto object = llvm::MemoryBuffer::getFile(path);
+  ASSERT_TRUE(static_cast<bool>(object));
+  for (auto *fn_name : {"comp.sse4_2", "comp.avx2", "comp.avx512"}) {
+    EXPECT_NE((*object)->getBuffer().find(fn_name), llvm::StringRef::npos) << fn_name;
+  }
+  // the object detects the level itself instead of calling the runtime, which the tiny runtime does not define
+  auto object_file = llvm::object::ObjectFile::createObjectFile((*object)->getMemBufferRef());
+  ASSERT_TRUE(static_cast<bool>(object_file));
+  for (auto &symbol : (*object_file)->symbols()) {
+    if (llvm::cantFail(symbol.getFlags()) & llvm::object::SymbolRef::SF_Undefined) {
+      EXPECT_EQ(llvm::cantFail(symbol.getName()).find("isa_level"), llvm::StringRef::npos);
+    }
+  }
+}
+
+TEST(ExecutionEngine, export_parallel_compiled_object) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+  Placeholder<float> x("x", {M, N});
+  Placeholder<float> y("y", {M, N});
+
+  Module::Builder builder("module_parallel", common::DefaultHostTarget());
+  std::vector<std::string> fn_names = {"add", "sub", "mul"};
+  for (auto &fn_name : fn_names) {
+    auto res = Compute(
+        {M, N},
+        [=](Var i, Var j) -> Expr {
+          if (fn_name == "add") return x(i, j) + y(i, j);
+          if (fn_name == "sub") return x(i, j) - y(i, j);
+          return x(i, j) * y(i, j);
+        },
+        fn_name + "_res");
+    auto stages = CreateStages({res});
+    builder.AddFunction(Lower(fn_name, stages, {x, y, res}));
+  }
+
+  ExecutionOptions options;
+  options.num_compile_threads = 3;
+  auto engine                 = backends::ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(builder.Build());
+  std::string path = "./parallel_compiled_kernels.o";
+  engine->ExportObject(path);
+
+  // the exported object is loaded alone, and each function compiled in any partition is defined in it
+  auto jit = llvm::cantFail(llvm::orc::LLJITBuilder().create());
+  jit->getMainJITDylib().addGenerator(llvm::cantFail(
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix())));
+  auto object = llvm::MemoryBuffer::getFile(path);
+  ASSERT_TRUE(static_cast<bool>(object));
+  llvm::cantFail(jit->addObjectFile(std::move(*object)));
+
+  auto _ab_bb_cb_ = CreateTestBuffer();  // NOLINT
+  auto &ab        = std::get<0>(_ab_bb_cb_);
+  auto &bb        = std::get<1>(_ab_bb_cb_);
+  auto &cb        = std::get<2>(_ab_bb_cb_);
+  cinn_pod_value_t a_arg(ab), b_arg(bb), c_arg(cb);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+
+  auto *ad = reinterpret_cast<float *>(ab->memory);
+  auto *bd = reinterpret_cast<float *>(bb->memory);
+  auto *cd = reinterpret_cast<float *>(cb->memory);
+  for (auto &fn_name : fn_names) {
+    auto symbol = jit->lookup(fn_name);
+    ASSERT_TRUE(static_cast<bool>(symbol)) << fn_name << " is not in the exported object";
+    auto fn = reinterpret_cast<void (*)(void *, int32_t)>(symbol->getAddress());
+    std::fill(cd, cd + kM * kN, 0.f);
+    fn(args, 3);
+    for (int i = 0; i < kM * kN; i++) {
+      float expected = fn_name == "add" ? ad[i] + bd[i] : fn_name == "sub" ? ad[i] - bd[i] : ad[i] * bd[i];
+      ASSERT_NEAR(cd[i], expected, 1e-5) << fn_name;
+    }
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
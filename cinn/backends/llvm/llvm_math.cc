@@ -0,0 +1,218 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/llvm_math.h"
+
+#include <glog/logging.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Module.h>
+
+#include <initializer_list>
+#include <limits>
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+llvm::Value *FloatConst(llvm::Type *type, double value) { return llvm::ConstantFP::get(type, value); }
+
+llvm::Value *IntConst(llvm::Type *type, int64_t value) { return llvm::ConstantInt::get(type, value, true); }
+
+// The int32 type or vector type with the same lanes as the float32 type
+llvm::Type *IntTypeOf(llvm::IRBuilder<> *b, llvm::Type *type) {
+  if (auto *vec_type = llvm::dyn_cast<llvm::VectorType>(type)) {
+    return llvm::VectorType::getInteger(vec_type);
+  }
+  return b->getInt32Ty();
+}
+
+llvm::Value *CallIntrinsic(llvm::IRBuilder<> *b, llvm::Intrinsic::ID id, llvm::ArrayRef<llvm::Value *> args) {
+  llvm::Module *m    = b->GetInsertBlock()->getModule();
+  llvm::Function *fn = llvm::Intrinsic::getDeclaration(m, id, {args[0]->getType()});
+  return b->CreateCall(fn, args);
+}
+
+// x * y + z, which is fused if the target supports
+llvm::Value *MulAdd(llvm::IRBuilder<> *b, llvm::Value *x, llvm::Value *y, llvm::Value *z) {
+  return CallIntrinsic(b, llvm::Intrinsic::fmuladd, {x, y, z});
+}
+
+// Evaluate the polynomial by Horner's method, the coefficients are from the highest degree
+llvm::Value *Polynomial(llvm::IRBuilder<> *b, llvm::Value *x, std::initializer_list<double> coeffs) {
+  CHECK_GT(coeffs.size(), 1UL);
+  auto it           = coeffs.begin();
+  llvm::Value *poly = FloatConst(x->getType(), *it);
+  for (++it; it != coeffs.end(); ++it) {
+    poly = MulAdd(b, poly, x, FloatConst(x->getType(), *it));
+  }
+  return poly;
+}
+
+llvm::Value *Clamp(llvm::IRBuilder<> *b, llvm::Value *x, double low, double high) {
+  llvm::Value *low_value  = FloatConst(x->getType(), low);
+  llvm::Value *high_value = FloatConst(x->getType(), high);
+  x                       = b->CreateSelect(b->CreateFCmpOLT(x, low_value), low_value, x);
+  return b->CreateSelect(b->CreateFCmpOGT(x, high_value), high_value, x);
+}
+
+// floor(x) as int32, x should be in the range of int32
+llvm::Value *FloorToInt(llvm::IRBuilder<> *b, llvm::Value *x) {
+  llvm::Type *int_type = IntTypeOf(b, x->getType());
+  llvm::Value *n       = b->CreateFPToSI(x, int_type);
+  // the conversion truncates toward zero, which is one above the floor for the negative non-integral x
+  llvm::Value *above = b->CreateFCmpOGT(b->CreateSIToFP(n, x->getType()), x);
+  return b->CreateSelect(above, b->CreateSub(n, IntConst(int_type, 1)), n);
+}
+
+// 2^n for n in [-126, 127] by filling the exponent bits
+llvm::Value *Pow2(llvm::IRBuilder<> *b, llvm::Value *n, llvm::Type *type) {
+  llvm::Value *bits = b->CreateShl(b->CreateAdd(n, IntConst(n->getType(), 127)), 23);
+  return b->CreateBitCast(bits, type);
+}
+
+}  // namespace
+
+llvm::Value *EmitExpF32(llvm::IRBuilder<> *b, llvm::Value *x) {
+  llvm::Type *type   = x->getType();
+  llvm::Value *input = x;
+  x                  = Clamp(b, x, -104.0, 88.7228317261);
+
+  // exp(x) = 2^n * exp(r), where n = round(x / ln2) and r = x - n * ln2 in [-ln2 / 2, ln2 / 2]
+  llvm::Value *n  = FloorToInt(b, MulAdd(b, x, FloatConst(type, 1.44269504088896341), FloatConst(type, 0.5)));
+  llvm::Value *fn = b->CreateSIToFP(n, type);
+  // ln2 is split into 0.693359375 exact in float and the small rest, so n * ln2 is subtracted with little rounding
+  llvm::Value *r = MulAdd(b, fn, FloatConst(type, -0.693359375), x);
+  r              = MulAdd(b, fn, FloatConst(type, 2.12194440e-4), r);
+
+  llvm::Value *p = Polynomial(
+      b, r, {1.9875691500E-4, 1.3981999507E-3, 8.3334519073E-3, 4.1665795894E-2, 1.6666665459E-1, 5.0000001201E-1});
+  llvm::Value *y = b->CreateFAdd(MulAdd(b, p, b->CreateFMul(r, r), r), FloatConst(type, 1.0));
+
+  // scale by 2^n in two steps, so both the factors are normal for n in [-150, 128]
+  llvm::Value *n1 = b->CreateAShr(n, 1);
+  llvm::Value *n2 = b->CreateSub(n, n1);
+  y               = b->CreateFMul(b->CreateFMul(y, Pow2(b, n1, type)), Pow2(b, n2, type));
+
+  y = b->CreateSelect(b->CreateFCmpOGT(input, FloatConst(type, 88.7228317261)),
+                      FloatConst(type, std::numeric_limits<float>::infinity()),
+                      y);
+  return b->CreateSelect(b->CreateFCmpUNO(input, input), input, y);
+}
+
+llvm::Value *EmitLogF32(llvm::IRBuilder<> *b, llvm::Value *x) {
+  llvm::Type *type     = x->getType();
+  llvm::Type *int_type = IntTypeOf(b, type);
+  llvm::Value *input   = x;
+
+  // scale the subnormal x by 2^23 into the normal range
+  llvm::Value *is_subnormal = b->CreateFCmpOLT(x, FloatConst(type, std::numeric_limits<float>::min()));
+  x = b->CreateSelect(is_subnormal, b->CreateFMul(x, FloatConst(type, 8388608.0)), x);
+
+  // x = m * 2^e with m in [0.5, 1)
+  llvm::Value *bits = b->CreateBitCast(x, int_type);
+  llvm::Value *e    = b->CreateSub(b->CreateLShr(bits, 23), IntConst(int_type, 126));
+  e                 = b->CreateSub(e, b->CreateSelect(is_subnormal, IntConst(int_type, 23), IntConst(int_type, 0)));
+  llvm::Value *m    = b->CreateBitCast(
+      b->CreateOr(b->CreateAnd(bits, IntConst(int_type, 0x007fffff)), IntConst(int_type, 0x3f000000)), type);
+
+  // log(x) = e * ln2 + log(1 + f), where 1 + f is m shifted into [sqrt(0.5), sqrt(2))
+  llvm::Value *is_small = b->CreateFCmpOLT(m, FloatConst(type, 0.707106781186547524));
+  e                     = b->CreateSub(e, b->CreateZExt(is_small, int_type));
+  llvm::Value *f        = b->CreateFSub(b->CreateSelect(is_small, b->CreateFAdd(m, m), m), FloatConst(type, 1.0));
+  llvm::Value *fe       = b->CreateSIToFP(e, type);
+  llvm::Value *z        = b->CreateFMul(f, f);
+
+  llvm::Value *p = Polynomial(b,
+                              f,
+                              {7.0376836292E-2,
+                               -1.1514610310E-1,
+                               1.1676998740E-1,
+                               -1.2420140846E-1,
+                               1.4249322787E-1,
+                               -1.6668057665E-1,
+                               2.0000714765E-1,
+                               -2.4999993993E-1,
+                               3.3333331174E-1});
+  llvm::Value *y = b->CreateFMul(b->CreateFMul(p, f), z);
+  y              = MulAdd(b, fe, FloatConst(type, -2.12194440e-4), y);
+  y              = MulAdd(b, z, FloatConst(type, -0.5), y);
+  y              = MulAdd(b, fe, FloatConst(type, 0.693359375), b->CreateFAdd(f, y));
+
+  y = b->CreateSelect(b->CreateFCmpOEQ(input, FloatConst(type, std::numeric_limits<float>::infinity())), input, y);
+  y = b->CreateSelect(b->CreateFCmpOEQ(input, FloatConst(type, 0.0)),
+                      FloatConst(type, -std::numeric_limits<float>::infinity()),
+                      y);
+  // the unordered comparison is also true for NaN
+  return b->CreateSelect(b->CreateFCmpULT(input, FloatConst(type, 0.0)),
+                         FloatConst(type, std::numeric_limits<float>::quiet_NaN()),
+                         y);
+}
+
+llvm::Value *EmitErfF32(llvm::IRBuilder<> *b, llvm::Value *x) {
+  llvm::Type *type   = x->getType();
+  llvm::Value *input = x;
+  // erf(x) rounds to +-1 in float outside [-4, 4]
+  x               = Clamp(b, x, -4.0, 4.0);
+  llvm::Value *x2 = b->CreateFMul(x, x);
+
+  // erf(x) = x * p(x^2) / q(x^2)
+  llvm::Value *p = Polynomial(b,
+                              x2,
+                              {-2.72614225801306e-10,
+                               2.77068142495902e-08,
+                               -2.10102402082508e-06,
+                               -5.69250639462346e-05,
+                               -7.34990630326855e-04,
+                               -2.95459980854025e-03,
+                               -1.60960333262415e-02});
+  llvm::Value *q = Polynomial(b,
+                              x2,
+                              {-1.45660718464996e-05,
+                               -2.13374055278905e-04,
+                               -1.68282697438203e-03,
+                               -7.37332916720468e-03,
+                               -1.42647390514189e-02});
+  llvm::Value *y = b->CreateFDiv(b->CreateFMul(x, p), q);
+  return b->CreateSelect(b->CreateFCmpUNO(input, input), input, y);
+}
+
+llvm::Value *EmitPowF32(llvm::IRBuilder<> *b, llvm::Value *x, llvm::Value *y) {
+  llvm::Type *type     = x->getType();
+  llvm::Type *int_type = IntTypeOf(b, type);
+  llvm::Value *zero    = FloatConst(type, 0.0);
+
+  llvm::Value *abs_x  = CallIntrinsic(b, llvm::Intrinsic::fabs, {x});
+  llvm::Value *result = EmitExpF32(b, b->CreateFMul(y, EmitLogF32(b, abs_x)));
+
+  // the negative x is only defined for the integral y, and the result is negative for the odd y. The float y not
+  // less than 2^24 are all even integers, the others are checked by the conversion to int32
+  llvm::Value *abs_y      = CallIntrinsic(b, llvm::Intrinsic::fabs, {y});
+  llvm::Value *is_small_y = b->CreateFCmpOLT(abs_y, FloatConst(type, 16777216.0));
+  llvm::Value *n          = b->CreateFPToSI(b->CreateSelect(is_small_y, y, zero), int_type);
+  llvm::Value *is_integral =
+      b->CreateSelect(is_small_y, b->CreateFCmpOEQ(b->CreateSIToFP(n, type), y), b->CreateFCmpOEQ(y, y));
+  llvm::Value *is_odd_n   = b->CreateICmpNE(b->CreateAnd(n, IntConst(int_type, 1)), IntConst(int_type, 0));
+  llvm::Value *is_odd     = b->CreateAnd(b->CreateAnd(is_small_y, is_integral), is_odd_n);
+  llvm::Value *neg_result = b->CreateSelect(is_odd, b->CreateFNeg(result), result);
+  neg_result = b->CreateSelect(is_integral, neg_result, FloatConst(type, std::numeric_limits<float>::quiet_NaN()));
+
+  result = b->CreateSelect(b->CreateFCmpOLT(x, zero), neg_result, result);
+  return b->CreateSelect(b->CreateFCmpOEQ(y, zero), FloatConst(type, 1.0), result);
+}
+
+}  // namespace backends
+}  // namespace cinn
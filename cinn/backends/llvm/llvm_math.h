@@ -0,0 +1,48 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Value.h>
+
+/**
+ * The float32 math functions emitted inline as LLVM IR.
+ *
+ * The llvm intrinsics of the transcendental functions are lowered to the scalar libm calls, which can not be
+ * vectorized and break the fused loops. The functions here are built only by the arithmetic, comparison, select
+ * and bit operations, so they accept a float or a vector of float and are compiled to the SIMD instructions of
+ * the target in place.
+ *
+ * The error bounds are the ones of the approximations relative to the exact results, ulp is the unit in the last
+ * place of the result. NaN is propagated unless the no-NaNs fast math flag is set on the builder.
+ */
+namespace cinn {
+namespace backends {
+
+//! exp(x) by the Cephes polynomial, the relative error is within 2 ulp, +inf above 88.72 and 0 below -104.
+llvm::Value *EmitExpF32(llvm::IRBuilder<> *b, llvm::Value *x);
+
+//! log(x) by the Cephes polynomial, the relative error is within 2 ulp, NaN for the negative x and -inf for zero.
+llvm::Value *EmitLogF32(llvm::IRBuilder<> *b, llvm::Value *x);
+
+//! erf(x) by a rational approximation on [-4, 4] and +-1 outside, the error is within a few ulp.
+llvm::Value *EmitErfF32(llvm::IRBuilder<> *b, llvm::Value *x);
+
+//! pow(x, y) as exp(y * log(|x|)) with the sign of the negative x to the integral y, the relative error grows with
+//! |y * log(x)| by about 1 ulp per unit, so it is only used in the fast math mode.
+llvm::Value *EmitPowF32(llvm::IRBuilder<> *b, llvm::Value *x, llvm::Value *y);
+
+}  // namespace backends
+}  // namespace cinn
@@ -29,8 +29,10 @@
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Passes/PassBuilder.h>
@@ -113,15 +115,35 @@ class CustomPassManager : public PassManagerT {
 
 using CustomFunctionPassManager = CustomPassManager<llvm::legacy::FunctionPassManager>;
 using CustomModulePassManager   = CustomPassManager<llvm::legacy::PassManager>;
+
+// Set the fast math flags on all the float instructions, including the ones of the runtime functions, and the
+// function attributes read by the code generator of the target
+void ApplyFastMathFlags(llvm::Module *m, llvm::FastMathFlags flags) {
+  for (auto &fn : *m) {
+    if (fn.isDeclaration()) continue;
+    if (flags.isFast()) fn.addFnAttr("unsafe-fp-math", "true");
+    if (flags.noNaNs()) fn.addFnAttr("no-nans-fp-math", "true");
+    if (flags.noInfs()) fn.addFnAttr("no-infs-fp-math", "true");
+    if (flags.noSignedZeros()) fn.addFnAttr("no-signed-zeros-fp-math", "true");
+    for (auto &inst : llvm::instructions(fn)) {
+      if (llvm::isa<llvm::FPMathOperator>(&inst)) {
+        inst.setFastMathFlags(flags);
+      }
+    }
+  }
+}
 }  // namespace
 
 LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
                                          int opt_level,
                                          llvm::FastMathFlags fast_math_flags,
                                          bool print_passes)
-    : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
+    : opt_level_(opt_level), fast_math_flags_(fast_math_flags), print_passes_(print_passes), machine_(machine) {}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
+  if (fast_math_flags_.any()) {
+    ApplyFastMathFlags(m, fast_math_flags_);
+  }
   auto machine =
       std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
   auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
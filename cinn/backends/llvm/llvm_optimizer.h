@@ -15,6 +15,7 @@
 #pragma once
 
 #include <llvm/IR/Instruction.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
@@ -38,6 +39,8 @@ class LLVMModuleOptimizer final {
  private:
   llvm::TargetMachine *machine_;
   int opt_level_{};
+  // the flags set on the float instructions before the optimization, none by default
+  llvm::FastMathFlags fast_math_flags_;
   bool print_passes_{};
 };
 }  // namespace cinn::backends
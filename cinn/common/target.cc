@@ -16,9 +16,11 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <sstream>
 
 #include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cpu/host_intrinsics.h"
 
 namespace cinn {
 namespace common {
@@ -30,6 +32,10 @@ bool Target::operator==(const Target &other) const {
          features == other.features;
 }
 
+bool Target::has_feature(Feature feature) const {
+  return std::find(features.begin(), features.end(), feature) != features.end();
+}
+
 int Target::runtime_arch() const {
   switch (arch) {
     case Arch::Unk:
@@ -119,6 +125,18 @@ std::ostream &operator<<(std::ostream &os, const Target &target) {
   return os;
 }
 
+const Target &DetectedHostTarget() {
+  static Target target = []() {
+    std::vector<Target::Feature> features;
+    int level = cinn_x86_isa_level();
+    if (level >= cinn_x86_isa_sse4_2) features.push_back(Target::Feature::SSE4_2);
+    if (level >= cinn_x86_isa_avx2) features.push_back(Target::Feature::AVX2);
+    if (level >= cinn_x86_isa_avx512) features.push_back(Target::Feature::AVX512);
+    return Target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, features, {});
+  }();
+  return target;
+}
+
 std::ostream &operator<<(std::ostream &os, Target::Arch arch) {
   switch (arch) {
     case Target::Arch::Unk:
@@ -54,6 +54,10 @@ struct Target {
   enum class Feature : int {
     JIT = 0,
     Debug,
+    // The x86 instruction set extensions, see cinn_x86_isa_level_t
+    SSE4_2,
+    AVX2,
+    AVX512,
   };
 
   /**
@@ -75,6 +79,8 @@ struct Target {
 
   bool defined() const { return os != OS::Unk && arch != Arch::Unk && bits != Bit::Unk; }
 
+  bool has_feature(Feature feature) const;
+
   //! Get the Runtime architecture, it is casted to integer to avoid header file depending.
   int runtime_arch() const;
 
@@ -106,6 +112,9 @@ static const Target& DefaultNVGPUTarget() {
   return target;
 }
 
+//! The X86 host target with the instruction set features detected on the running CPU.
+const Target& DetectedHostTarget();
+
 std::ostream& operator<<(std::ostream& os, Target::Arch arch);
 
 }  // namespace common
@@ -62,6 +62,7 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
       hlir::framework::ApplyPass(ctx->graph.get(), "AlterLayout");
     }
 #endif
+    hlir::framework::ApplyPass(ctx->graph.get(), "WeightPrepack");
     hlir::framework::ApplyPass(ctx->graph.get(), "ConstPropagate");
     hlir::framework::ApplyPass(ctx->graph.get(), "OpFusion");
   }
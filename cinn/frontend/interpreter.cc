@@ -119,6 +119,7 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
     hlir::framework::ApplyPass(graph.get(), "AlterLayout");
   }
 #endif
+  hlir::framework::ApplyPass(graph.get(), "WeightPrepack");
   hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
   hlir::framework::ApplyPass(graph.get(), "OpFusion");
   // Target target = common::DefaultHostTarget();
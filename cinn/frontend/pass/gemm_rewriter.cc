@@ -16,6 +16,8 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "cinn/frontend/cinn_builder.h"
 #include "cinn/frontend/program_pass.h"
@@ -33,7 +35,17 @@ class GemmRewriterPass : public ProgramPass {
   void ApplyImpl(Program* prog,
                  const std::unordered_set<std::string>& fetch_ids,
                  const common::Target& target) override {
-    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+    if (!prog->size()) {
+      return;
+    }
+    if (target.arch == Target::Arch::X86) {
+#ifdef CINN_WITH_MKL_CBLAS
+      // without MKL, the scheduled matmul of CINN is faster than the product of cpu_gemm
+      RewriteCpuGemm(prog, fetch_ids);
+#endif
+      return;
+    }
+    if (target.arch != Target::Arch::NVGPU) {
       return;
     }
 
@@ -63,20 +75,23 @@ class GemmRewriterPass : public ProgramPass {
     // Use the cublas call instead of the single matmul
     RewriteSingleMatmul(prog);
 
-    // relink old outputs to new outputs
-    for (size_t i = 0; i < prog->size(); i++) {
-      auto& inputs = (*prog)[i]->inputs;
-      for (size_t j = 0; j < inputs.size(); j++) {
-        if (origin2new_.count(inputs[j].get())) {
-          inputs[j] = origin2new_.at(inputs[j].get());
-        }
-      }
-    }
+    RelinkOutputs(prog);
     VLOG(4) << "-- After rewriting: " << *prog;
     ClearResources();
   }
 
  private:
+  // The two-dim matmul and the epilogue fused into a cpu_gemm
+  struct CpuGemm {
+    // A, B, and the optional bias and residual
+    std::vector<Variable> inputs;
+    bool has_bias{false};
+    bool has_residual{false};
+    std::string activation;
+    // the matmul first, and the output of the last one is the output of the cpu_gemm
+    std::vector<_Instruction_*> instrs;
+  };
+
   void CollectInfo(const Program& prog) {
     for (size_t i = 0; i < prog.size(); i++) {
       auto& instr = prog[i];
@@ -85,8 +100,239 @@ class GemmRewriterPass : public ProgramPass {
       }
       for (auto& var : instr->inputs) {
         var_used_count_[var.get()]++;
+        var2consumer_.emplace(var.get(), instr);
+      }
+    }
+  }
+
+  // relink old outputs to new outputs
+  void RelinkOutputs(Program* prog) {
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& inputs = (*prog)[i]->inputs;
+      for (size_t j = 0; j < inputs.size(); j++) {
+        if (origin2new_.count(inputs[j].get())) {
+          inputs[j] = origin2new_.at(inputs[j].get());
+        }
+      }
+    }
+  }
+
+  // Rewrite the chains of `matmul|mul -> [elementwise_add(bias)] -> [activation] -> [elementwise_add(residual)]`
+  // into cpu_gemm, whose epilogue is applied to each block of the output while it is still in cache, instead of passing
+  // through the whole output once for each elementwise instruction.
+  void RewriteCpuGemm(Program* prog, const std::unordered_set<std::string>& fetch_ids) {
+    VLOG(4) << "-- Before rewriting: " << *prog;
+
+    CollectInfo(*prog);
+
+    // the fused instruction is placed at the last instruction of the chain, where the bias and residual are ready
+    std::unordered_map<_Instruction_*, CpuGemm> last2gemm;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      CpuGemm gemm;
+      if ((instr->op_type == "matmul" || instr->op_type == "mul") && MatchCpuGemm(instr, fetch_ids, &gemm)) {
+        removed_instrs_.insert(gemm.instrs.begin(), gemm.instrs.end());
+        last2gemm.emplace(gemm.instrs.back(), std::move(gemm));
+      }
+    }
+
+    if (!last2gemm.empty()) {
+      CinnBuilder builder("gemm_rewriter_builder");
+      for (auto& var : prog->GetInputs()) {
+        builder.CreateInput(var);
+      }
+      for (size_t i = 0; i < prog->size(); i++) {
+        auto& instr = (*prog)[i];
+        auto it     = last2gemm.find(instr.get());
+        if (it != last2gemm.end()) {
+          BuildCpuGemm(&builder, it->second);
+        } else if (!removed_instrs_.count(instr.get())) {
+          builder.AppendInstruction(instr);
+        }
+      }
+      *prog = builder.Build();
+      RelinkOutputs(prog);
+    }
+
+    VLOG(4) << "-- After rewriting: " << *prog;
+    ClearResources();
+  }
+
+  // The instruction consuming the var, or nullptr if the var is fetched or consumed by more than one instruction
+  const Instruction* SingleConsumer(const Variable& var, const std::unordered_set<std::string>& fetch_ids) const {
+    auto it = var_used_count_.find(var.get());
+    if (it == var_used_count_.end() || it->second != 1 || fetch_ids.count(var->id)) {
+      return nullptr;
+    }
+    return &var2consumer_.at(var.get());
+  }
+
+  const Instruction* Producer(const Variable& var) const {
+    auto it = output2instr_.find(var.get());
+    return it == output2instr_.end() ? nullptr : &it->second;
+  }
+
+  // Whether the shape is [N] or [1, N] for the output of [M, N]
+  static bool IsRowShape(const std::vector<int>& shape, const std::vector<int>& out_shape) {
+    return shape == std::vector<int>{out_shape[1]} || shape == std::vector<int>{1, out_shape[1]};
+  }
+
+  // Whether the num_col_dims attr of mul is 1, so the two-dim input is not flattened
+  static bool IsUnflattenedMul(const Instruction& mul, const std::string& attr) {
+    return !mul->attrs.count(attr) || absl::get<int>(mul->attrs.at(attr)) == 1;
+  }
+
+  // Match the chain from the matmul, or the mul which multiplies lhs by the transposed rhs
+  bool MatchCpuGemm(const Instruction& matmul, const std::unordered_set<std::string>& fetch_ids, CpuGemm* gemm) {
+    auto& lhs = matmul->inputs[0];
+    auto& rhs = matmul->inputs[1];
+    // the kernel only supports the two-dim matrix multiply of float32
+    if (lhs->shape.size() != 2 || rhs->shape.size() != 2 || lhs->type != common::Float(32) ||
+        rhs->type != common::Float(32)) {
+      return false;
+    }
+    if (matmul->op_type == "mul" &&
+        (!IsUnflattenedMul(matmul, "x_num_col_dims") || !IsUnflattenedMul(matmul, "y_num_col_dims"))) {
+      return false;
+    }
+    gemm->inputs = {lhs, rhs};
+    gemm->instrs = {matmul.get()};
+
+    auto consumer = [&](const Variable& var) -> const Instruction* {
+      auto* instr = SingleConsumer(var, fetch_ids);
+      // the instruction may have been fused into another cpu_gemm, which takes `var` as its bias or residual
+      return instr && !removed_instrs_.count(instr->get()) ? instr : nullptr;
+    };
+    Variable out             = matmul.GetOutput(0);
+    const Instruction* instr = consumer(out);
+    auto step                = [&](const Instruction* next) {
+      gemm->instrs.push_back(next->get());
+      out   = next->GetOutput(0);
+      instr = consumer(out);
+    };
+
+    Variable addend;
+    if (instr && (*instr)->op_type == "elementwise_add" && GetAddend(*instr, out, true, fetch_ids, &addend, gemm)) {
+      gemm->inputs.push_back(addend);
+      gemm->has_bias = true;
+      step(instr);
+    }
+    if (instr && GetActivation(*instr, out, fetch_ids, gemm)) {
+      step(instr);
+    }
+    if (instr && (*instr)->op_type == "elementwise_add" && GetAddend(*instr, out, false, fetch_ids, &addend, gemm)) {
+      gemm->inputs.push_back(addend);
+      gemm->has_residual = true;
+      step(instr);
+    }
+    // the single matmul is left to the matmul op
+    return gemm->instrs.size() > 1;
+  }
+
+  // Get the other input of the elementwise_add consuming `out`, which should be of the same shape as `out`, or a row
+  // broadcast to `out` if allow_row is true. The broadcast_to of the row is fused too.
+  bool GetAddend(const Instruction& add,
+                 const Variable& out,
+                 bool allow_row,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 Variable* addend,
+                 CpuGemm* gemm) {
+    auto& inputs = add->inputs;
+    if (inputs.size() != 2 || inputs[0].get() == inputs[1].get()) {
+      return false;
+    }
+    const Variable& other = inputs[0].get() == out.get() ? inputs[1] : inputs[0];
+    if (other->type != out->type) {
+      return false;
+    }
+    if (other->shape == out->shape) {
+      *addend       = other;
+      auto producer = Producer(other);
+      if (allow_row && producer && (*producer)->op_type == "broadcast_to" && SingleConsumer(other, fetch_ids)) {
+        auto& row  = (*producer)->inputs[0];
+        auto& axes = absl::get<std::vector<int>>((*producer)->attrs.at("broadcast_axes"));
+        if (IsRowShape(row->shape, out->shape) && axes.back() == 1) {
+          *addend = row;
+          gemm->instrs.push_back(producer->get());
+        }
       }
+      return true;
+    }
+    // the row broadcast by elementwise_add itself, which only broadcasts the second input aligned to the last axis
+    if (!allow_row || other.get() != inputs[1].get() || !IsRowShape(other->shape, out->shape)) {
+      return false;
+    }
+    int axis = -1;
+    if (add->attrs.count("axis")) {
+      axis = absl::get<int>(add->attrs.at("axis"));
+    }
+    if (axis >= 0 && axis + other->shape.size() != out->shape.size()) {
+      return false;
+    }
+    *addend = other;
+    return true;
+  }
+
+  // Get the activation consuming `out`, relu may have been decomposed into max(out, 0) by the Decomposer
+  bool GetActivation(const Instruction& instr,
+                     const Variable& out,
+                     const std::unordered_set<std::string>& fetch_ids,
+                     CpuGemm* gemm) {
+    static const std::unordered_set<std::string> activations{"relu", "sigmoid", "tanh"};
+    if (activations.count(instr->op_type)) {
+      gemm->activation = instr->op_type;
+      return true;
     }
+    if (instr->op_type != "max" || instr->inputs.size() != 2) {
+      return false;
+    }
+    const Variable& other = instr->inputs[0].get() == out.get() ? instr->inputs[1] : instr->inputs[0];
+    auto producer         = Producer(other);
+    if (!producer || (*producer)->op_type != "fill_constant" || other->shape != out->shape ||
+        other->type != out->type) {
+      return false;
+    }
+    auto& attrs = (*producer)->attrs;
+    if (!attrs.count("value") || absl::get<float>(attrs.at("value")) != 0.f) {
+      return false;
+    }
+    gemm->activation = "relu";
+    if (SingleConsumer(other, fetch_ids)) {
+      gemm->instrs.push_back(producer->get());
+    }
+    return true;
+  }
+
+  void BuildCpuGemm(CinnBuilder* builder, const CpuGemm& gemm) {
+    auto& matmul_attrs = gemm.instrs.front()->attrs;
+    bool trans_a       = false;
+    bool trans_b       = gemm.instrs.front()->op_type == "mul";  // mul takes rhs of [N, K]
+    float alpha        = 1.f;
+    if (matmul_attrs.count("trans_a")) {
+      trans_a = absl::get<bool>(matmul_attrs.at("trans_a"));
+    }
+    if (matmul_attrs.count("trans_b")) {
+      trans_b = absl::get<bool>(matmul_attrs.at("trans_b"));
+    }
+    if (matmul_attrs.count("alpha")) {
+      alpha = absl::get<float>(matmul_attrs.at("alpha"));
+    }
+    VLOG(4) << "-- Fuse " << gemm.instrs.size() - 1 << " instructions into the cpu_gemm of activation `"
+            << gemm.activation << "`, bias: " << std::boolalpha << gemm.has_bias << ", residual: " << gemm.has_residual;
+
+    const auto& new_outs = builder->CustomInstr("cpu_gemm",
+                                                gemm.inputs,
+                                                {{"trans_a", trans_a},
+                                                 {"trans_b", trans_b},
+                                                 {"alpha", alpha},
+                                                 {"beta", 1.f},
+                                                 {"activation", gemm.activation},
+                                                 {"has_bias", gemm.has_bias},
+                                                 {"has_residual", gemm.has_residual}});
+    auto new_out = new_outs[0];
+    auto old_out = gemm.instrs.back()->outputs[0];
+    new_out.set_id(old_out->id);
+    origin2new_.emplace(old_out.get(), new_out);
   }
 
   // Fuse the pattern of `matmul + add`
@@ -191,6 +437,7 @@ class GemmRewriterPass : public ProgramPass {
     origin2new_.clear();
     output2instr_.clear();
     var_used_count_.clear();
+    var2consumer_.clear();
   }
 
  private:
@@ -198,6 +445,7 @@ class GemmRewriterPass : public ProgramPass {
   std::unordered_map<_Variable_*, Variable> origin2new_;
   std::unordered_map<_Variable_*, Instruction> output2instr_;
   std::unordered_map<_Variable_*, int> var_used_count_;
+  std::unordered_map<_Variable_*, Instruction> var2consumer_;
 };
 
 }  // namespace pass
@@ -276,4 +276,75 @@ TEST(GemmRwriter, Complex) {
   CompareResult(&program, target, input_ids, {out->id}, 4, passes, 123, false);
 }
 
+TEST(GemmRwriter, CpuBiasReluResidual) {
+  if (!IsCompiledWithMKL()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a        = builder.CreateInput(Float(32), {8, 6}, "A");
+  auto b        = builder.CreateInput(Float(32), {6, 7}, "B");
+  auto c        = builder.Matmul(a, b);
+  auto bias     = builder.CreateInput(Float(32), {7}, "Bias");
+  auto d        = builder.Add(c, bias);
+  auto e        = builder.Relu(d);
+  auto residual = builder.CreateInput(Float(32), {8, 7}, "Residual");
+  auto out      = builder.Add(e, residual);
+  auto program  = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids;
+  absl::c_transform(std::vector<absl::string_view>{a.id(), b.id(), bias.id(), residual.id()},
+                    std::back_inserter(input_ids),
+                    [](absl::string_view id) { return std::string(id); });
+  // the broadcast_to of the bias and the fill_constant of relu decomposed are fused into the cpu_gemm too
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"GemmRewriter"}};
+  CompareResult(&program, target, input_ids, {out->id}, 5, passes, 123, false);
+}
+
+TEST(GemmRwriter, CpuTransRightBias) {
+  if (!IsCompiledWithMKL()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {8, 6}, "A");
+  auto b       = builder.CreateInput(Float(32), {7, 6}, "B");
+  auto c       = builder.Transpose(b, {1, 0});
+  auto d       = builder.Matmul(a, c);
+  auto bias    = builder.CreateInput(Float(32), {8, 7}, "Bias");
+  auto out     = builder.Add(bias, d);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids;
+  absl::c_transform(std::vector<absl::string_view>{a.id(), b.id(), bias.id()},
+                    std::back_inserter(input_ids),
+                    [](absl::string_view id) { return std::string(id); });
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer", "RemoveIdentity"},
+                                                                       {"TransposeFoldingInput", "GemmRewriter"}};
+  CompareResult(&program, target, input_ids, {out->id}, 2, passes, 123, false);
+}
+
+TEST(GemmRwriter, CpuMulBiasRelu) {
+  if (!IsCompiledWithMKL()) {
+    return;
+  }
+  NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {8, 6}, "A");
+  auto b       = builder.CreateInput(Float(32), {7, 6}, "B");
+  auto c       = builder.Mul(a, b);
+  auto bias    = builder.CreateInput(Float(32), {7}, "Bias");
+  auto d       = builder.Add(c, bias);
+  auto out     = builder.Relu(d);
+  auto program = builder.Build();
+
+  common::Target target = common::DefaultHostTarget();
+  std::vector<std::string> input_ids;
+  absl::c_transform(std::vector<absl::string_view>{a.id(), b.id(), bias.id()},
+                    std::back_inserter(input_ids),
+                    [](absl::string_view id) { return std::string(id); });
+  // mul multiplies A by the transposed B, the same as cpu_gemm of trans_b
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{"Decomposer"}, {"GemmRewriter"}};
+  CompareResult(&program, target, input_ids, {out->id}, 4, passes, 123, false);
+}
+
 }  // namespace cinn::frontend
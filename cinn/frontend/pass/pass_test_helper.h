@@ -53,6 +53,14 @@ bool IsCompiledWithCUDA() {
 #endif
 }
 
+bool IsCompiledWithMKL() {
+#if !defined(CINN_WITH_MKL_CBLAS)
+  return false;
+#else
+  return true;
+#endif
+}
+
 void PrintMatrix(const std::vector<float>& mat, int bs, int m, int n) {
   if (!VLOG_IS_ON(5)) {
     return;
@@ -16,6 +16,8 @@
 
 #include <unordered_set>
 
+#include "cinn/utils/profiler.h"
+
 namespace cinn {
 namespace frontend {
 
@@ -30,6 +32,7 @@ void ProgramPass::Apply(Program* prog,
   }
   int i = 0;
   for (const auto* pass : fpass) {
+    utils::RecordEvent record_pass("ProgramPass " + passes[i], utils::EventType::kCompilePhase);
     int before = prog->size();
     pass->ApplyImpl(prog, fetch_ids, target);
     int after = prog->size();
@@ -0,0 +1,332 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/shape_bucketed_program.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
+#include <utility>
+
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::Graph;
+using hlir::framework::Node;
+using hlir::framework::NodeData;
+using hlir::framework::Shape;
+using hlir::framework::shape_t;
+using hlir::framework::Tensor;
+
+namespace {
+
+template <typename T>
+T GetAttr(const utils::AttributeMap& attrs, const std::string& name, const T& default_value) {
+  auto it = attrs.find(name);
+  return it == attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+bool IsBatchAxis(int axis, int rank) { return axis == 0 || axis == -rank; }
+
+// The rule of an op whether it keeps the rows of the batch apart, by its attributes and the index and rank of the
+// input carrying the batch.
+using RowwiseRule = std::function<bool(const utils::AttributeMap&, int, int)>;
+
+// The ops keeping the rows apart besides the elementwise and broadcast ones, the others disable padding.
+const absl::flat_hash_map<std::string, RowwiseRule>& RowwiseOps() {
+  static const absl::flat_hash_map<std::string, RowwiseRule> ops = [] {
+    absl::flat_hash_map<std::string, RowwiseRule> ops;
+    auto reduce = [](const utils::AttributeMap& attrs, int index, int rank) {
+      // an empty list means all the axes
+      auto dims = GetAttr<std::vector<int>>(attrs, "dim", {});
+      return !dims.empty() &&
+             std::none_of(dims.begin(), dims.end(), [rank](int axis) { return IsBatchAxis(axis, rank); });
+    };
+    for (auto* op : {"reduce_sum", "reduce_prod", "reduce_max", "reduce_min"}) {
+      ops[op] = reduce;
+    }
+    ops["softmax"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      return !IsBatchAxis(GetAttr<int>(attrs, "axis", -1), rank);
+    };
+    ops["concat"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      return !IsBatchAxis(GetAttr<int>(attrs, "axis", 0), rank);
+    };
+    ops["slice"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      auto axes = GetAttr<std::vector<int>>(attrs, "axes", {});
+      return std::none_of(axes.begin(), axes.end(), [rank](int axis) { return IsBatchAxis(axis, rank); });
+    };
+    ops["transpose"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      auto perm = GetAttr<std::vector<int>>(attrs, "axis", {});
+      return !perm.empty() && perm[0] == 0;
+    };
+    // the batch is the rows of the left operand, which are transposed only when it is a 2-D matrix
+    ops["matmul"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      return index == 0 && (rank > 2 || !GetAttr<bool>(attrs, "trans_a", false));
+    };
+    ops["mul"] = [](const utils::AttributeMap& attrs, int index, int rank) { return index == 0; };
+    // the bias and residual follow the rows of the output too
+    ops["cpu_gemm"] = [](const utils::AttributeMap& attrs, int index, int rank) {
+      return index != 1 && !(index == 0 && GetAttr<bool>(attrs, "trans_a", false));
+    };
+    // the batch is the first dimension of the data in both NCHW and NHWC
+    for (auto* op : {"conv2d", "depthwise_conv2d", "pool2d"}) {
+      ops[op] = [](const utils::AttributeMap& attrs, int index, int rank) { return index == 0; };
+    }
+    return ops;
+  }();
+  return ops;
+}
+
+size_t RowBytes(Tensor tensor) {
+  auto& dims = tensor->shape().data();
+  CHECK(!dims.empty() && dims[0] > 0);
+  return static_cast<size_t>(tensor->shape().numel() / dims[0]) * ((tensor->type().bits() + 7) / 8);
+}
+
+}  // namespace
+
+ShapeBucketedProgram::ShapeBucketedProgram(const Program& program,
+                                           const std::vector<std::string>& dynamic_inputs,
+                                           const std::vector<std::string>& fetch_names,
+                                           const Target& target,
+                                           const Options& options)
+    : program_(program),
+      dynamic_inputs_(dynamic_inputs),
+      fetch_names_(fetch_names),
+      target_(target),
+      options_(options) {
+  CHECK(target_.arch == Target::Arch::X86) << "ShapeBucketedProgram only supports X86 now";
+  CHECK(!dynamic_inputs_.empty());
+  CHECK(!fetch_names_.empty());
+  std::sort(options_.buckets.begin(), options_.buckets.end());
+  for (auto& name : dynamic_inputs_) {
+    auto& inputs = program_.GetInputs();
+    CHECK(std::any_of(inputs.begin(), inputs.end(), [&name](const Variable& var) { return var->id == name; }))
+        << "The dynamic input " << name << " is not an input of the program";
+  }
+  if (options_.background_compile) {
+    background_pool_.reset(new utils::ThreadPool(1));
+  }
+}
+
+ShapeBucketedProgram::~ShapeBucketedProgram() { WaitBackgroundCompile(); }
+
+void ShapeBucketedProgram::SetParameter(const std::string& name, Tensor tensor) {
+  std::lock_guard<std::mutex> lock(mu_);
+  CHECK(buckets_.empty() && compiling_.empty()) << "The parameters should be set before any bucket is compiled";
+  parameters_[name] = tensor;
+}
+
+void ShapeBucketedProgram::Prepare(int batch_size) { GetOrCompileBucket(batch_size); }
+
+std::vector<int> ShapeBucketedProgram::CompiledBuckets() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::vector<int> res;
+  for (auto& item : buckets_) {
+    res.push_back(item.first);
+  }
+  return res;
+}
+
+void ShapeBucketedProgram::WaitBackgroundCompile() {
+  if (background_pool_) {
+    background_pool_->Wait();
+  }
+}
+
+bool ShapeBucketedProgram::IsPaddable(Graph* graph, int batch_size) const {
+  if (!options_.allow_padding) return false;
+  auto& shape_dict      = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& op_pattern_dict = hlir::framework::Operator::GetAttrs<hlir::framework::OpPatternKind>("OpPattern");
+  auto& rowwise_ops     = RowwiseOps();
+  // the variables whose first dimension is the batch
+  std::unordered_set<std::string> batched(dynamic_inputs_.begin(), dynamic_inputs_.end());
+  auto store_nodes = std::get<0>(graph->topological_order());
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node) continue;
+    bool consumes_batch = false;
+    auto inlinks        = node->inlinks_in_order();
+    for (int i = 0; i < inlinks.size(); ++i) {
+      auto* source = inlinks[i]->source()->safe_as<NodeData>();
+      if (!source || !batched.count(source->id())) continue;
+      consumes_batch = true;
+      int rank       = shape_dict.at(source->id()).size();
+      bool rowwise   = op_pattern_dict.Find(node->op()) && (op_pattern_dict[node->op()] == hlir::framework::kElemWise ||
+                                                           op_pattern_dict[node->op()] == hlir::framework::kBroadcast);
+      if (!rowwise && rowwise_ops.count(node->op()->name)) {
+        rowwise = rowwise_ops.at(node->op()->name)(node->attrs.attr_store, i, rank);
+      }
+      if (!rowwise) {
+        VLOG(3) << "Op " << node->id() << " may mix the rows of the batch, padding is disabled";
+        return false;
+      }
+    }
+    // the ops only consuming the parameters are not affected by padding
+    if (!consumes_batch) continue;
+    for (auto& out_edge : node->outlinks_in_order()) {
+      auto* sink  = out_edge->sink()->safe_as<NodeData>();
+      auto& shape = shape_dict.at(sink->id());
+      if (shape.empty() || shape[0] != batch_size) {
+        VLOG(3) << "Op " << node->id() << " does not keep the batch as the first dimension, padding is disabled";
+        return false;
+      }
+      batched.insert(sink->id());
+    }
+  }
+  return std::all_of(
+      fetch_names_.begin(), fetch_names_.end(), [&batched](const std::string& name) { return batched.count(name); });
+}
+
+std::shared_ptr<ShapeBucketedProgram::Bucket> ShapeBucketedProgram::CompileBucket(int batch_size) {
+  utils::RecordEvent record_compile("CompileBucket " + std::to_string(batch_size), utils::EventType::kCompilePhase);
+  VLOG(1) << "Compile the bucket of batch size " << batch_size;
+  auto bucket        = std::make_shared<Bucket>();
+  bucket->batch_size = batch_size;
+
+  // the batch size is set on the shapes of the graph, the variables are shared with the program of the caller
+  auto graph       = std::make_shared<Graph>(program_, target_);
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (auto& name : dynamic_inputs_) {
+    auto it = shape_dict.find(name);
+    if (it == shape_dict.end()) continue;
+    CHECK(!it->second.empty()) << "The dynamic input " << name << " should have the batch dimension";
+    it->second[0] = batch_size;
+  }
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  bucket->paddable = IsPaddable(graph.get(), batch_size);
+  hlir::framework::ApplyPasses(graph.get(), options_.graph_passes);
+
+  bucket->scope = hlir::framework::BuildScope(target_, graph);
+  for (auto& item : parameters_) {
+    auto* var = bucket->scope->FindVar(item.first);
+    CHECK(var) << "The parameter " << item.first << " is not used by the program";
+    auto& tensor = absl::get<Tensor>(*var);
+    CHECK_EQ(tensor->shape().numel(), item.second->shape().numel())
+        << "The shape of parameter " << item.first << " does not match the program";
+    tensor->set_buffer(item.second->get_buffer());
+  }
+
+  std::unordered_set<std::string> fetch_var_ids(fetch_names_.begin(), fetch_names_.end());
+  bucket->graph_compiler.reset(new hlir::framework::GraphCompiler(target_, bucket->scope, graph));
+  hlir::framework::GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  bucket->runtime_program = bucket->graph_compiler->Build(options, std::move(fetch_var_ids)).runtime_program;
+  bucket->runtime_program->PreRun();
+  return bucket;
+}
+
+std::shared_ptr<ShapeBucketedProgram::Bucket> ShapeBucketedProgram::GetOrCompileBucket(int batch_size) {
+  CHECK_GT(batch_size, 0);
+  std::lock_guard<std::mutex> compile_lock(compile_mu_);
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = buckets_.find(batch_size);
+    if (it != buckets_.end()) return it->second;
+  }
+  auto bucket = CompileBucket(batch_size);
+  std::lock_guard<std::mutex> lock(mu_);
+  buckets_[batch_size] = bucket;
+  return bucket;
+}
+
+std::shared_ptr<ShapeBucketedProgram::Bucket> ShapeBucketedProgram::Dispatch(int batch_size) {
+  int bucket_size = batch_size;
+  auto bucket_it  = std::lower_bound(options_.buckets.begin(), options_.buckets.end(), batch_size);
+  if (bucket_it != options_.buckets.end()) {
+    bucket_size = *bucket_it;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto exact = buckets_.find(batch_size);
+    if (exact != buckets_.end()) return exact->second;
+
+    auto it = buckets_.find(bucket_size);
+    if (it != buckets_.end() && it->second->paddable) return it->second;
+    if (it == buckets_.end() && background_pool_) {
+      // serve by the smallest compiled bucket the request fits in while the fitting one is being compiled
+      for (auto larger = buckets_.lower_bound(batch_size); larger != buckets_.end(); ++larger) {
+        if (!larger->second->paddable) continue;
+        if (!compiling_.count(bucket_size)) {
+          compiling_.insert(bucket_size);
+          background_pool_->Submit([this, bucket_size]() {
+            GetOrCompileBucket(bucket_size);
+            std::lock_guard<std::mutex> lock(mu_);
+            compiling_.erase(bucket_size);
+          });
+        }
+        VLOG(3) << "Run batch size " << batch_size << " by the bucket " << larger->first
+                << " while compiling the bucket " << bucket_size;
+        return larger->second;
+      }
+    }
+  }
+
+  auto bucket = GetOrCompileBucket(bucket_size);
+  if (bucket->batch_size == batch_size || bucket->paddable) return bucket;
+  return GetOrCompileBucket(batch_size);
+}
+
+std::map<std::string, Tensor> ShapeBucketedProgram::Run(const std::map<std::string, Tensor>& feeds) {
+  int batch_size = -1;
+  for (auto& name : dynamic_inputs_) {
+    CHECK(feeds.count(name)) << "The dynamic input " << name << " is not fed";
+    auto& dims = feeds.at(name)->shape().data();
+    CHECK(!dims.empty()) << "The dynamic input " << name << " should have the batch dimension";
+    if (batch_size < 0) batch_size = dims[0];
+    CHECK_EQ(dims[0], batch_size) << "The dynamic inputs should have the same batch size";
+  }
+
+  auto bucket = Dispatch(batch_size);
+  std::lock_guard<std::mutex> lock(bucket->run_mu);
+  for (auto& name : dynamic_inputs_) {
+    auto src = feeds.at(name);
+    auto dst = bucket->scope->GetTensor(name);
+    CHECK_EQ(src->shape().size(), dst->shape().size()) << "The rank of input " << name << " does not match the program";
+    CHECK(std::equal(src->shape().data().begin() + 1, src->shape().data().end(), dst->shape().data().begin() + 1))
+        << "The shape of input " << name << " does not match the program except the batch dimension";
+    size_t row_bytes = RowBytes(dst);
+    auto* dst_data   = reinterpret_cast<char*>(dst->buffer()->memory);
+    std::memcpy(dst_data, src->buffer()->memory, batch_size * row_bytes);
+    // the padded rows are zeros
+    std::memset(dst_data + batch_size * row_bytes, 0, (bucket->batch_size - batch_size) * row_bytes);
+  }
+
+  bucket->runtime_program->Execute();
+
+  std::map<std::string, Tensor> fetches;
+  for (auto& name : fetch_names_) {
+    auto src   = bucket->scope->GetTensor(name);
+    auto shape = src->shape().data();
+    CHECK_EQ(shape[0], bucket->batch_size);
+    shape[0] = batch_size;
+    Tensor dst;
+    dst->Resize(Shape(shape));
+    void* dst_data = dst->mutable_data(target_, src->type());
+    std::memcpy(dst_data, src->buffer()->memory, batch_size * RowBytes(src));
+    fetches[name] = dst;
+  }
+  return fetches;
+}
+
+}  // namespace frontend
+}  // namespace cinn
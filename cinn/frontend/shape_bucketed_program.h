@@ -0,0 +1,133 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/utils/thread_pool.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * ShapeBucketedProgram holds the programs compiled from the same frontend::Program for a set of batch sizes,
+ * so the variable batch size of the requests does not trigger a full compilation every time.
+ *
+ * The batch size is the first dimension of the dynamic inputs. A request of batch size n is dispatched to the
+ * smallest bucket not smaller than n, its inputs are padded with zeros and only the first n rows of the outputs
+ * are returned. Padding is only used when every op consuming the batch keeps it as the first dimension and does
+ * not mix the rows, otherwise a program of the exact batch size is compiled. The ops known not to mix the rows are
+ * the elementwise and broadcast ones, and an allowlist of the others checked by their attributes, e.g. the
+ * reductions, softmax or transposes not over the batch axis.
+ *
+ * The buckets are compiled lazily on the first request. When a larger bucket has been compiled and padding is
+ * allowed, it serves the request while the fitting bucket is compiled in the background. The ops whose attributes
+ * encode the batch size, such as reshape with an explicit shape, are not supported.
+ */
+class ShapeBucketedProgram {
+ public:
+  struct Options {
+    // the batch sizes to compile programs for, a larger batch size is compiled exactly when requested
+    std::vector<int> buckets;
+    // pad the inputs to a larger bucket when the ops allow it
+    bool allow_padding{true};
+    // compile a missing bucket in the background while a larger compiled bucket serves the requests
+    bool background_compile{true};
+    // the passes applied to the graph of each bucket after InferShape
+    std::vector<std::string> graph_passes{"OpFusion"};
+  };
+
+  /**
+   * Constructor.
+   * @param program The program, which is left unchanged, the batch size is set on the graph of each bucket.
+   * @param dynamic_inputs The ids of the input variables whose first dimension is the batch size.
+   * @param fetch_names The ids of the output variables, whose first dimension should be the batch size too.
+   */
+  ShapeBucketedProgram(const Program& program,
+                       const std::vector<std::string>& dynamic_inputs,
+                       const std::vector<std::string>& fetch_names,
+                       const Target& target,
+                       const Options& options);
+  ~ShapeBucketedProgram();
+
+  /**
+   * Bind a static input such as a weight, the buffer of the tensor is shared by all the buckets.
+   * It should be called before any bucket is compiled.
+   */
+  void SetParameter(const std::string& name, hlir::framework::Tensor tensor);
+
+  //! Compile the bucket of the batch size in the calling thread if it has not been compiled.
+  void Prepare(int batch_size);
+
+  /**
+   * Run a request, it is safe to call it from multiple threads and the requests dispatched to the same bucket
+   * are serialized.
+   * @param feeds The tensors of the dynamic inputs, all of which have the same batch size.
+   * @return The tensors of the fetched variables.
+   */
+  std::map<std::string, hlir::framework::Tensor> Run(const std::map<std::string, hlir::framework::Tensor>& feeds);
+
+  //! The batch sizes of the compiled buckets.
+  std::vector<int> CompiledBuckets() const;
+
+  //! Block until the background compilations finished.
+  void WaitBackgroundCompile();
+
+ private:
+  struct Bucket {
+    int batch_size;
+    // whether the program can run the requests of a smaller batch size with padding
+    bool paddable;
+    std::shared_ptr<hlir::framework::Scope> scope;
+    std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
+    std::unique_ptr<hlir::framework::Program> runtime_program;
+    std::mutex run_mu;
+  };
+
+  std::shared_ptr<Bucket> CompileBucket(int batch_size);
+  //! Compile the bucket and add it, nothing is done if it has been compiled.
+  std::shared_ptr<Bucket> GetOrCompileBucket(int batch_size);
+  //! Pick the bucket to run a request of the batch size, which may schedule a background compilation.
+  std::shared_ptr<Bucket> Dispatch(int batch_size);
+  bool IsPaddable(hlir::framework::Graph* graph, int batch_size) const;
+
+  Program program_;
+  std::vector<std::string> dynamic_inputs_;
+  std::vector<std::string> fetch_names_;
+  Target target_;
+  Options options_;
+  absl::flat_hash_map<std::string, hlir::framework::Tensor> parameters_;
+
+  mutable std::mutex mu_;
+  std::map<int, std::shared_ptr<Bucket>> buckets_;
+  std::set<int> compiling_;
+  // the compilations share the global states of the compiler, so they run one by one
+  std::mutex compile_mu_;
+  std::unique_ptr<utils::ThreadPool> background_pool_;
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,164 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/shape_bucketed_program.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::Shape;
+using hlir::framework::Tensor;
+
+namespace {
+
+constexpr int kWidth = 32;
+
+Tensor MakeTensor(const std::vector<int>& shape, float base) {
+  Tensor tensor;
+  tensor->Resize(Shape(shape));
+  auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < tensor->shape().numel(); ++i) {
+    data[i] = base + i % 7 - 3;
+  }
+  return tensor;
+}
+
+// out = relu(x + bias)
+Program BuildAddRelu(std::string* out_name) {
+  NetBuilder builder("add_relu");
+  auto x    = builder.CreateInput(Float(32), {1, kWidth}, "X");
+  auto bias = builder.CreateInput(Float(32), {kWidth}, "Bias");
+  auto out  = builder.Relu(builder.ElementwiseAdd(x, bias, 1));
+  *out_name = out->id;
+  return builder.Build();
+}
+
+void CheckAddRelu(const Tensor& x, const Tensor& bias, const Tensor& out) {
+  ASSERT_EQ(out->shape().data(), x->shape().data());
+  auto* x_data    = x->data<float>();
+  auto* bias_data = bias->data<float>();
+  auto* out_data  = out->data<float>();
+  for (int i = 0; i < x->shape().numel(); ++i) {
+    ASSERT_FLOAT_EQ(out_data[i], std::max(x_data[i] + bias_data[i % kWidth], 0.f));
+  }
+}
+
+}  // namespace
+
+TEST(ShapeBucketedProgram, PadToBucket) {
+  std::string out_name;
+  auto program = BuildAddRelu(&out_name);
+  ShapeBucketedProgram::Options options;
+  options.buckets            = {4, 8};
+  options.background_compile = false;
+  ShapeBucketedProgram bucketed(program, {"X"}, {out_name}, common::DefaultHostTarget(), options);
+  auto bias = MakeTensor({kWidth}, 1.f);
+  bucketed.SetParameter("Bias", bias);
+
+  for (int batch_size : {3, 4, 1, 6, 12, 2}) {
+    auto x       = MakeTensor({batch_size, kWidth}, batch_size);
+    auto fetches = bucketed.Run({{"X", x}});
+    CheckAddRelu(x, bias, fetches.at(out_name));
+  }
+  // the batch size larger than all the buckets is compiled exactly
+  EXPECT_EQ(bucketed.CompiledBuckets(), std::vector<int>({4, 8, 12}));
+  // the program of the caller is left unchanged
+  auto& inputs = program.GetInputs();
+  auto x_it    = std::find_if(inputs.begin(), inputs.end(), [](const Variable& var) { return var->id == "X"; });
+  ASSERT_NE(x_it, inputs.end());
+  EXPECT_EQ((*x_it)->shape, std::vector<int>({1, kWidth}));
+}
+
+TEST(ShapeBucketedProgram, BackgroundCompile) {
+  std::string out_name;
+  auto program = BuildAddRelu(&out_name);
+  ShapeBucketedProgram::Options options;
+  options.buckets = {2, 8};
+  ShapeBucketedProgram bucketed(program, {"X"}, {out_name}, common::DefaultHostTarget(), options);
+  auto bias = MakeTensor({kWidth}, -1.f);
+  bucketed.SetParameter("Bias", bias);
+  bucketed.Prepare(8);
+
+  // served by the bucket 8 while the bucket 2 is compiled
+  auto x = MakeTensor({2, kWidth}, 0.f);
+  CheckAddRelu(x, bias, bucketed.Run({{"X", x}}).at(out_name));
+  bucketed.WaitBackgroundCompile();
+  EXPECT_EQ(bucketed.CompiledBuckets(), std::vector<int>({2, 8}));
+  CheckAddRelu(x, bias, bucketed.Run({{"X", x}}).at(out_name));
+}
+
+TEST(ShapeBucketedProgram, ReduceOverBatch) {
+  // out = x + reduce_sum(x, 0), the padded rows would change the sum
+  NetBuilder builder("reduce_batch");
+  auto x   = builder.CreateInput(Float(32), {1, kWidth}, "X");
+  auto out = builder.ElementwiseAdd(x, builder.ReduceSum(x, {0}), 1);
+  ShapeBucketedProgram::Options options;
+  options.buckets = {4};
+  ShapeBucketedProgram bucketed(builder.Build(), {"X"}, {out->id}, common::DefaultHostTarget(), options);
+
+  auto input   = MakeTensor({3, kWidth}, 0.f);
+  auto fetched = bucketed.Run({{"X", input}}).at(out->id);
+  // padding is not allowed, so the exact batch size is compiled
+  EXPECT_EQ(bucketed.CompiledBuckets(), std::vector<int>({3, 4}));
+  auto* in_data  = input->data<float>();
+  auto* out_data = fetched->data<float>();
+  for (int j = 0; j < kWidth; ++j) {
+    float sum = in_data[j] + in_data[kWidth + j] + in_data[2 * kWidth + j];
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_FLOAT_EQ(out_data[i * kWidth + j], in_data[i * kWidth + j] + sum);
+    }
+  }
+}
+
+TEST(ShapeBucketedProgram, MulRows) {
+  // out = mul(x, w) computes each row of out from the same row of x, so the padded rows do not change the others
+  NetBuilder builder("mul_rows");
+  auto x      = builder.CreateInput(Float(32), {1, kWidth}, "X");
+  auto w      = builder.CreateInput(Float(32), {kWidth, kWidth}, "W");
+  auto out    = builder.Mul(x, w);
+  auto weight = MakeTensor({kWidth, kWidth}, 0.f);
+  ShapeBucketedProgram::Options options;
+  options.buckets            = {4};
+  options.background_compile = false;
+  ShapeBucketedProgram bucketed(builder.Build(), {"X"}, {out->id}, common::DefaultHostTarget(), options);
+  bucketed.SetParameter("W", weight);
+
+  auto input   = MakeTensor({3, kWidth}, 1.f);
+  auto fetched = bucketed.Run({{"X", input}}).at(out->id);
+  EXPECT_EQ(bucketed.CompiledBuckets(), std::vector<int>({4}));
+  auto* in_data  = input->data<float>();
+  auto* w_data   = weight->data<float>();
+  auto* out_data = fetched->data<float>();
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < kWidth; ++j) {
+      float expected = 0.f;
+      for (int k = 0; k < kWidth; ++k) {
+        expected += in_data[i * kWidth + k] * w_data[j * kWidth + k];
+      }
+      ASSERT_NEAR(out_data[i * kWidth + j], expected, 1e-3f);
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -14,11 +14,18 @@
 
 #include "cinn/hlir/framework/buffer.h"
 
+#include <atomic>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
 
-void Buffer::Resize(uint32_t size) {
+uint64_t Buffer::NextGeneration() {
+  static std::atomic<uint64_t> next_generation{1};
+  return next_generation++;
+}
+
+void Buffer::Resize(uint64_t size) {
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -31,7 +38,7 @@ void Buffer::Resize(uint32_t size) {
   }
 }
 
-void Buffer::Resize(uint32_t alignment, uint32_t size) {
+void Buffer::Resize(uint32_t alignment, uint64_t size) {
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -49,17 +56,28 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
-void Buffer::ResizeLazy(uint32_t size) {
+void Buffer::BindExternalMemory(uint8_t* memory, uint64_t size) {
+  CHECK(memory) << "Can not bind a buffer to null memory";
+  if (size_ > 0) {
+    Free();
+  }
+  data_.memory        = memory;
+  data_.memory_size   = size;
+  size_               = size;
+  is_external_memory_ = true;
+}
+
+void Buffer::ResizeLazy(uint64_t size) {
   if (size <= size_) return;
   Resize(size);
 }
 
-void Buffer::ResizeLazy(uint32_t alignment, uint32_t size) {
+void Buffer::ResizeLazy(uint32_t alignment, uint64_t size) {
   if (size <= size_) return;
   Resize(alignment, size);
 }
 
-void Buffer::Resize(uint32_t size, const common::Target& target) {
+void Buffer::Resize(uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -67,7 +85,7 @@ void Buffer::Resize(uint32_t size, const common::Target& target) {
   Resize(size);
 }
 
-void Buffer::Resize(uint32_t alignment, uint32_t size, const common::Target& target) {
+void Buffer::Resize(uint32_t alignment, uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -75,7 +93,7 @@ void Buffer::Resize(uint32_t alignment, uint32_t size, const common::Target& tar
   Resize(alignment, size);
 }
 
-void Buffer::ResizeLazy(uint32_t size, const common::Target& target) {
+void Buffer::ResizeLazy(uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
@@ -83,7 +101,7 @@ void Buffer::ResizeLazy(uint32_t size, const common::Target& target) {
   ResizeLazy(size);
 }
 
-void Buffer::ResizeLazy(uint32_t alignment, uint32_t size, const common::Target& target) {
+void Buffer::ResizeLazy(uint32_t alignment, uint64_t size, const common::Target& target) {
   if (target.arch != target_.arch) {
     Free();
     SetTarget(target);
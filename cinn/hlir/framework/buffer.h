@@ -36,39 +36,57 @@ struct Buffer final {
   explicit Buffer(const common::Target& target) { SetTarget(target); }
 
   //! Resize the memory hold by this buffer *exactlly* to \p size.
-  void Resize(uint32_t size);
-  void Resize(uint32_t alignment, uint32_t size);
+  void Resize(uint64_t size);
+  void Resize(uint32_t alignment, uint64_t size);
 
   //! Lazily resize the memory.
-  void ResizeLazy(uint32_t size);
-  void ResizeLazy(uint32_t alignment, uint32_t size);
+  void ResizeLazy(uint64_t size);
+  void ResizeLazy(uint32_t alignment, uint64_t size);
 
   //! Resize the memory to \p size in target \p target.
-  void Resize(uint32_t size, const common::Target& target);
-  void Resize(uint32_t alignment, uint32_t size, const common::Target& target);
+  void Resize(uint64_t size, const common::Target& target);
+  void Resize(uint32_t alignment, uint64_t size, const common::Target& target);
 
   //! Lazily resize the memory to \p size in target \p target.
-  void ResizeLazy(uint32_t size, const common::Target& target);
-  void ResizeLazy(uint32_t alignment, uint32_t size, const common::Target& target);
+  void ResizeLazy(uint64_t size, const common::Target& target);
+  void ResizeLazy(uint32_t alignment, uint64_t size, const common::Target& target);
 
   void SetTarget(const common::Target& target);
 
+  //! Bind this buffer to \p size bytes of \p memory owned by others, such as a slice of a planned workspace,
+  //! the memory will not be freed by this buffer.
+  void BindExternalMemory(uint8_t* memory, uint64_t size);
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
+  /**
+   * The generation of the data, which is unique in the process and renewed whenever the data may be written through
+   * Tensor::mutable_data, so the data computed from this buffer can be cached by the buffer and its generation.
+   */
+  uint64_t generation() const { return generation_; }
+  void NewGeneration() { generation_ = NextGeneration(); }
+
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
+    if (is_external_memory_) {
+      data_.memory        = nullptr;
+      is_external_memory_ = false;
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
   }
 
  private:
-  inline void* Malloc(uint32_t size) CINN_RESULT_SHOULD_USE {
+  static uint64_t NextGeneration();
+
+  inline void* Malloc(uint64_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->malloc(size);
   }
 
-  inline void* AlignedAlloc(uint32_t alignment, uint32_t size) CINN_RESULT_SHOULD_USE {
+  inline void* AlignedAlloc(uint32_t alignment, uint64_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->aligned_alloc(alignment, size);
   }
@@ -80,10 +98,15 @@ struct Buffer final {
   common::Target target_;
 
   //! Number of bytes of this buffer.
-  uint32_t size_{};
+  uint64_t size_{};
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Whether the memory is borrowed from others rather than allocated by this buffer.
+  bool is_external_memory_{false};
+
+  uint64_t generation_{NextGeneration()};
 };
 
 }  // namespace framework
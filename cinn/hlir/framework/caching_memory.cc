@@ -0,0 +1,262 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_memory.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+constexpr uint32_t kLargeSizeClass = static_cast<uint32_t>(-1);
+
+// The header stored just before the address handed out.
+struct BlockHeader {
+  // the address returned by the system allocator
+  void* base;
+  uint32_t size_class;
+  uint32_t alignment;
+  // the usable bytes of this block
+  size_t capacity;
+};
+static_assert(sizeof(BlockHeader) <= CachingMemoryMng::kMinAlignment, "The header should fit in the minimal alignment");
+
+inline BlockHeader* HeaderOf(void* data) {
+  return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(data) - sizeof(BlockHeader));
+}
+
+inline uint64_t CacheKey(uint32_t size_class, size_t alignment) {
+  return (static_cast<uint64_t>(alignment) << 32) | size_class;
+}
+
+// Round nbytes up to its size class, there are four classes between two adjacent powers of 2.
+inline size_t SmallSizeClass(size_t nbytes, uint32_t* size_class) {
+  if (nbytes <= CachingMemoryMng::kMinAlignment) {
+    *size_class = 0;
+    return CachingMemoryMng::kMinAlignment;
+  }
+  int k       = 63 - __builtin_clzll(nbytes - 1);  // 2^k < nbytes <= 2^(k+1)
+  size_t step = size_t(1) << (k - 2);
+  size_t j    = (nbytes - (size_t(1) << k) + step - 1) / step;
+  *size_class = (k - 6) * 4 + j;
+  return (size_t(1) << k) + j * step;
+}
+
+inline size_t RoundUp(size_t nbytes, size_t alignment) { return (nbytes + alignment - 1) / alignment * alignment; }
+
+void* AllocateBlock(size_t alignment, size_t capacity, uint32_t size_class) {
+  void* base = ::aligned_alloc(alignment, RoundUp(alignment + capacity, alignment));
+  CHECK(base) << "Failed to allocate " << capacity << " bytes with alignment " << alignment;
+  void* data           = static_cast<uint8_t*>(base) + alignment;
+  BlockHeader* header  = HeaderOf(data);
+  header->base         = base;
+  header->size_class   = size_class;
+  header->alignment    = alignment;
+  header->capacity     = capacity;
+  return data;
+}
+
+inline void ReleaseBlock(void* data) { ::free(HeaderOf(data)->base); }
+
+}  // namespace
+
+constexpr size_t CachingMemoryMng::kMinAlignment;
+constexpr size_t CachingMemoryMng::kMaxSmallSize;
+constexpr size_t CachingMemoryMng::kLargePageSize;
+constexpr size_t CachingMemoryMng::kThreadCacheLimit;
+
+struct CachingMemoryMng::Central {
+  ~Central() { ReleaseAll(); }
+
+  size_t ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mu);
+    size_t released = 0;
+    for (auto& key2blocks : small_blocks) {
+      for (void* data : key2blocks.second) {
+        released += HeaderOf(data)->capacity;
+        ReleaseBlock(data);
+      }
+    }
+    small_blocks.clear();
+    for (auto& item : large_blocks) {
+      released += HeaderOf(item.second)->capacity;
+      ReleaseBlock(item.second);
+    }
+    large_blocks.clear();
+    bytes_cached -= released;
+    return released;
+  }
+
+  void UpdateInUse(size_t nbytes) {
+    size_t in_use = bytes_in_use.fetch_add(nbytes) + nbytes;
+    size_t peak   = high_water_mark.load();
+    while (in_use > peak && !high_water_mark.compare_exchange_weak(peak, in_use)) {
+    }
+  }
+
+  std::mutex mu;
+  std::unordered_map<uint64_t, std::vector<void*>> small_blocks;
+  // large blocks ordered by (alignment, capacity)
+  std::multimap<std::pair<size_t, size_t>, void*> large_blocks;
+
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+  std::atomic<size_t> bytes_in_use{0};
+  std::atomic<size_t> bytes_cached{0};
+  std::atomic<size_t> high_water_mark{0};
+};
+
+struct CachingMemoryMng::ThreadCache {
+  explicit ThreadCache(const std::shared_ptr<Central>& central) : central(central) {}
+  // return all the blocks to the central cache when the thread exits,
+  // the central cache is kept alive even if the allocator has been destroyed
+  ~ThreadCache() { Flush(); }
+
+  void Flush() {
+    std::lock_guard<std::mutex> lock(central->mu);
+    for (auto& key2blocks : blocks) {
+      auto& dst = central->small_blocks[key2blocks.first];
+      dst.insert(dst.end(), key2blocks.second.begin(), key2blocks.second.end());
+    }
+    blocks.clear();
+  }
+
+  std::shared_ptr<Central> central;
+  std::unordered_map<uint64_t, std::vector<void*>> blocks;
+};
+
+CachingMemoryMng::CachingMemoryMng() : central_(std::make_shared<Central>()) {
+  static std::atomic<uint64_t> allocator_count{0};
+  id_ = allocator_count++;
+}
+
+CachingMemoryMng::~CachingMemoryMng() {
+  // blocks cached by other threads are released when those threads exit
+  Trim();
+}
+
+CachingMemoryMng::ThreadCache* CachingMemoryMng::GetThreadCache() {
+  thread_local std::unordered_map<uint64_t, std::unique_ptr<ThreadCache>> thread_caches;
+  auto& cache = thread_caches[id_];
+  if (!cache) {
+    cache.reset(new ThreadCache(central_));
+  }
+  return cache.get();
+}
+
+void* CachingMemoryMng::malloc(size_t nbytes) { return aligned_alloc(kMinAlignment, nbytes); }
+
+void* CachingMemoryMng::aligned_alloc(size_t alignment, size_t nbytes) {
+  alignment = std::max(alignment, kMinAlignment);
+  CHECK_EQ(alignment & (alignment - 1), 0UL) << "The alignment should be a power of 2, but got " << alignment;
+
+  void* data = nullptr;
+  if (nbytes <= kMaxSmallSize) {
+    uint32_t size_class;
+    size_t capacity = SmallSizeClass(nbytes, &size_class);
+    uint64_t key    = CacheKey(size_class, alignment);
+    // try the thread cache first, then the central cache
+    auto& local_blocks = GetThreadCache()->blocks[key];
+    if (!local_blocks.empty()) {
+      data = local_blocks.back();
+      local_blocks.pop_back();
+    } else {
+      std::lock_guard<std::mutex> lock(central_->mu);
+      auto it = central_->small_blocks.find(key);
+      if (it != central_->small_blocks.end() && !it->second.empty()) {
+        data = it->second.back();
+        it->second.pop_back();
+      }
+    }
+    if (!data) {
+      central_->misses++;
+      data = AllocateBlock(alignment, capacity, size_class);
+    } else {
+      central_->hits++;
+      central_->bytes_cached -= capacity;
+    }
+  } else {
+    size_t capacity = RoundUp(nbytes, kLargePageSize);
+    {
+      std::lock_guard<std::mutex> lock(central_->mu);
+      // reuse the smallest cached block which is large enough and not wasting more than a half
+      auto it = central_->large_blocks.lower_bound({alignment, capacity});
+      if (it != central_->large_blocks.end() && it->first.first == alignment && it->first.second <= 2 * capacity) {
+        data = it->second;
+        central_->large_blocks.erase(it);
+      }
+    }
+    if (!data) {
+      central_->misses++;
+      data = AllocateBlock(alignment, capacity, kLargeSizeClass);
+    } else {
+      central_->hits++;
+      central_->bytes_cached -= HeaderOf(data)->capacity;
+    }
+  }
+
+  central_->UpdateInUse(HeaderOf(data)->capacity);
+  return data;
+}
+
+void CachingMemoryMng::free(void* data) {
+  if (!data) return;
+  BlockHeader* header = HeaderOf(data);
+  central_->bytes_in_use -= header->capacity;
+  central_->bytes_cached += header->capacity;
+
+  if (header->size_class == kLargeSizeClass) {
+    std::lock_guard<std::mutex> lock(central_->mu);
+    central_->large_blocks.emplace(std::make_pair(size_t(header->alignment), header->capacity), data);
+    return;
+  }
+
+  auto& local_blocks = GetThreadCache()->blocks[CacheKey(header->size_class, header->alignment)];
+  local_blocks.push_back(data);
+  if (local_blocks.size() > kThreadCacheLimit) {
+    // move a half of the blocks to the central cache so other threads can reuse them
+    std::lock_guard<std::mutex> lock(central_->mu);
+    auto& central_blocks = central_->small_blocks[CacheKey(header->size_class, header->alignment)];
+    size_t keep          = kThreadCacheLimit / 2;
+    central_blocks.insert(central_blocks.end(), local_blocks.begin() + keep, local_blocks.end());
+    local_blocks.resize(keep);
+  }
+}
+
+size_t CachingMemoryMng::Trim() {
+  GetThreadCache()->Flush();
+  size_t released = central_->ReleaseAll();
+  VLOG(3) << "CachingMemoryMng releases " << released << " bytes to the system";
+  return released;
+}
+
+CachingMemoryStats CachingMemoryMng::GetStats() const {
+  CachingMemoryStats stats;
+  stats.hits            = central_->hits.load();
+  stats.misses          = central_->misses.load();
+  stats.bytes_in_use    = central_->bytes_in_use.load();
+  stats.bytes_cached    = central_->bytes_cached.load();
+  stats.high_water_mark = central_->high_water_mark.load();
+  return stats;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,100 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/memory.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The statistics of a CachingMemoryMng.
+ */
+struct CachingMemoryStats {
+  // number of allocations served from the cache
+  size_t hits = 0;
+  // number of allocations that fell through to the system allocator
+  size_t misses = 0;
+  // bytes of the blocks handed out and not returned yet
+  size_t bytes_in_use = 0;
+  // bytes of the blocks kept in the thread caches and the central cache
+  size_t bytes_cached = 0;
+  // the peak of bytes_in_use
+  size_t high_water_mark = 0;
+};
+
+/**
+ * CachingMemoryMng is a host memory allocator caching the freed blocks for reuse.
+ *
+ * Small requests are rounded up to size classes (four classes per power of two) and served from a
+ * thread-local free list first, then a central free list shared by all threads. Large requests are
+ * rounded up to pages and served by the best-fit cached block which wastes at most a half of it.
+ * Every block remembers its size class and alignment in a header just before the returned address,
+ * so `free` needs no lookup and blocks of different alignment are never mixed up.
+ *
+ * The cached memory is only returned to the system by `Trim` or on destruction.
+ */
+class CachingMemoryMng : public MemoryInterface {
+ public:
+  CachingMemoryMng();
+  ~CachingMemoryMng();
+
+  void* malloc(size_t nbytes) override;
+  void free(void* data) override;
+  void* aligned_alloc(size_t alignment, size_t nbytes) override;
+
+  //! Release the blocks cached by the calling thread and the central cache to the system, return the released bytes.
+  size_t Trim();
+
+  CachingMemoryStats GetStats() const;
+
+  //! The minimal alignment of all blocks, which also meets the requirement of malloc.
+  static constexpr size_t kMinAlignment = 64;
+  //! The requests larger than this are served as large blocks.
+  static constexpr size_t kMaxSmallSize = 1 << 20;
+  //! The capacity of large blocks are multiple of this.
+  static constexpr size_t kLargePageSize = 4096;
+  //! The maximal number of blocks of each size class kept by a thread.
+  static constexpr size_t kThreadCacheLimit = 32;
+
+  struct Central;
+  struct ThreadCache;
+
+ private:
+  //! Get the thread cache of this allocator for the calling thread.
+  ThreadCache* GetThreadCache();
+
+  std::shared_ptr<Central> central_;
+  // distinguish the thread caches of different allocators
+  uint64_t id_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CachingMemoryMng);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_memory.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(CachingMemoryMng, ReuseSmallBlocks) {
+  CachingMemoryMng allocator;
+  void* a = allocator.malloc(100);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % CachingMemoryMng::kMinAlignment, 0UL);
+  std::memset(a, 1, 100);
+  allocator.free(a);
+
+  // 110 bytes falls into the same size class as 100 bytes
+  void* b = allocator.malloc(110);
+  EXPECT_EQ(a, b);
+  auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.hits, 1UL);
+  EXPECT_EQ(stats.misses, 1UL);
+  EXPECT_GE(stats.bytes_in_use, 100UL);
+  allocator.free(b);
+  EXPECT_EQ(allocator.GetStats().bytes_in_use, 0UL);
+}
+
+TEST(CachingMemoryMng, AlignmentIsRespected) {
+  CachingMemoryMng allocator;
+  void* a = allocator.aligned_alloc(1024, 4000);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 1024, 0UL);
+  allocator.free(a);
+  // a block with smaller alignment is never served to a request with larger alignment
+  void* b = allocator.aligned_alloc(64, 4000);
+  void* c = allocator.aligned_alloc(1024, 4000);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 1024, 0UL);
+  EXPECT_EQ(a, c);
+  allocator.free(b);
+  allocator.free(c);
+}
+
+TEST(CachingMemoryMng, LargeBlocksAndTrim) {
+  CachingMemoryMng allocator;
+  const size_t nbytes = 8 << 20;
+  void* a             = allocator.aligned_alloc(1024, nbytes);
+  std::memset(a, 0, nbytes);
+  allocator.free(a);
+  // a slightly smaller request reuses the cached large block
+  void* b = allocator.aligned_alloc(1024, nbytes - 10000);
+  EXPECT_EQ(a, b);
+  allocator.free(b);
+  // a much smaller one does not waste it
+  void* c = allocator.aligned_alloc(1024, nbytes / 4);
+  EXPECT_NE(a, c);
+  allocator.free(c);
+
+  auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.bytes_in_use, 0UL);
+  EXPECT_GE(stats.high_water_mark, nbytes);
+  EXPECT_GE(stats.bytes_cached, nbytes);
+  EXPECT_EQ(allocator.Trim(), stats.bytes_cached);
+  EXPECT_EQ(allocator.GetStats().bytes_cached, 0UL);
+}
+
+TEST(CachingMemoryMng, MultiThreads) {
+  CachingMemoryMng allocator;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&allocator, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        size_t nbytes = 64 + (i * 37 + t) % 5000;
+        void* data    = allocator.malloc(nbytes);
+        std::memset(data, t, nbytes);
+        allocator.free(data);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = allocator.GetStats();
+  EXPECT_EQ(stats.bytes_in_use, 0UL);
+  EXPECT_EQ(stats.hits + stats.misses, 4000UL);
+  EXPECT_GT(stats.hits, stats.misses);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/execution_context.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+ExecutionContext::ExecutionContext(const Scope& scope,
+                                   const std::vector<std::unique_ptr<Instruction>>& instrs,
+                                   const std::vector<std::string>& input_names) {
+  std::unordered_set<std::string> private_vars(input_names.begin(), input_names.end());
+  for (auto& name : input_names) {
+    CHECK(scope.FindVar(name)) << "The input variable [" << name << "] is not found in the scope of the program";
+  }
+  for (auto& instr : instrs) {
+    CHECK(instr->target_.arch == Target::Arch::X86) << "ExecutionContext only supports X86 now";
+    // the outputs of a no_run instruction are not written, but alias the buffers of its inputs
+    if (instr->function_name() == "no_run") continue;
+    for (auto& out_args : instr->GetOutArgs()) {
+      private_vars.insert(out_args.begin(), out_args.end());
+    }
+  }
+
+  // the variables sharing one buffer in the program, such as the input and output of a reshape, share one
+  // private buffer in the context as well
+  std::unordered_set<Buffer*> private_buffers;
+  for (auto& name : private_vars) {
+    private_buffers.insert(absl::get<Tensor>(*scope.FindVar(name))->get_buffer().get());
+  }
+  std::unordered_map<Buffer*, std::shared_ptr<Buffer>> local_buffers;
+  for (auto& name : scope.var_names()) {
+    std::string var_name(name);
+    auto& origin       = absl::get<Tensor>(*scope.FindVar(var_name));
+    auto& tensor       = absl::get<Tensor>(*scope_.Var<Tensor>(var_name));
+    auto origin_buffer = origin->get_buffer();
+    if (private_buffers.count(origin_buffer.get())) {
+      auto it = local_buffers.find(origin_buffer.get());
+      if (it == local_buffers.end()) {
+        tensor->Resize(origin->shape());
+        local_buffers.emplace(origin_buffer.get(), tensor->get_buffer());
+      } else {
+        tensor->shape() = origin->shape();
+        tensor->set_buffer(it->second);
+      }
+      tensor->mutable_data(common::DefaultHostTarget(), origin->type());
+    } else {
+      // the shared variables are read-only during execution, reuse the memory of them
+      tensor->shape() = origin->shape();
+      tensor->set_type(origin->type());
+      tensor->set_buffer(origin_buffer);
+    }
+  }
+  VLOG(3) << "ExecutionContext allocates " << local_buffers.size() << " private buffers for "
+          << private_vars.size() << " private variables out of " << scope.var_names().size();
+
+  args_.reserve(instrs.size());
+  for (auto& instr : instrs) {
+    args_.emplace_back(instr->BuildArgs(scope_));
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
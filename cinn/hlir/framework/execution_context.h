@@ -0,0 +1,68 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * ExecutionContext holds the per-request state of running a Program, so that one compiled Program can
+ * serve several requests at the same time.
+ *
+ * The compiled functions and the persistent variables, such as parameters and the outputs of the pre-run
+ * instructions, are shared read-only with the Program. The variables written by the runtime instructions
+ * and the feed variables are private to each context, they are allocated in a local scope together with
+ * the arguments of the instructions bound to them. The variables sharing a buffer in the Program, such as
+ * the input and output of a no_run reshape, share one private buffer as well.
+ */
+class ExecutionContext {
+ public:
+  /**
+   * Constructor.
+   * @param scope The scope of the Program, where the shared variables reside.
+   * @param instrs The runtime instructions of the Program.
+   * @param input_names The names of the variables fed by the caller, which are private to this context.
+   */
+  ExecutionContext(const Scope& scope,
+                   const std::vector<std::unique_ptr<Instruction>>& instrs,
+                   const std::vector<std::string>& input_names);
+
+  //! The local scope, feed the inputs and fetch the outputs of a request here.
+  Scope* scope() { return &scope_; }
+
+  Tensor GetTensor(const std::string& name) const { return scope_.GetTensor(name); }
+
+  //! The arguments of the idx-th instruction bound to the local scope.
+  const std::vector<std::vector<cinn_pod_value_t>>& args(int idx) const { return args_.at(idx); }
+
+ private:
+  Scope scope_;
+  std::vector<std::vector<std::vector<cinn_pod_value_t>>> args_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ExecutionContext);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,156 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/execution_context.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// out = lhs + rhs, the arguments are (lhs, rhs, out)
+static void Add(void* args, int num_args) {
+  auto* pod_args = static_cast<cinn_pod_value_t*>(args);
+  auto* lhs      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[0])->memory);
+  auto* rhs      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[1])->memory);
+  auto* out      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[2])->memory);
+  for (int i = 0; i < 1024; ++i) {
+    out[i] = lhs[i] + rhs[i];
+  }
+}
+
+// Y = X + W, Z = Y + W, where W is a parameter
+std::unique_ptr<Program> BuildProgram() {
+  auto scope = std::make_shared<Scope>();
+  for (auto& name : std::vector<std::string>({"X", "W", "Y", "Z"})) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape{{1024}});
+    auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+    std::fill(data, data + 1024, name == "W" ? 1.f : 0.f);
+  }
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  for (auto& args : std::vector<std::vector<std::string>>({{"X", "W", "Y"}, {"Y", "W", "Z"}})) {
+    auto instr = std::make_unique<Instruction>(common::DefaultHostTarget(),
+                                               scope.get(),
+                                               std::vector<std::string>{args[0], args[1]},
+                                               std::vector<std::string>{args[2]},
+                                               "add");
+    instr->SetLoweredFunc(Add, "add");
+    instr->Finalize();
+    instrs.emplace_back(std::move(instr));
+  }
+  return std::make_unique<Program>(scope, std::move(instrs));
+}
+
+TEST(ExecutionContext, ShareParameters) {
+  auto program = BuildProgram();
+  auto context = program->CreateExecutionContext({"X"});
+  auto* scope  = context->scope();
+  // the parameter shares the memory among contexts, while the others do not
+  auto another = program->CreateExecutionContext({"X"});
+  EXPECT_EQ(scope->GetTensor("W")->data<float>(), another->GetTensor("W")->data<float>());
+  EXPECT_NE(scope->GetTensor("X")->data<float>(), another->GetTensor("X")->data<float>());
+  EXPECT_NE(scope->GetTensor("Y")->data<float>(), another->GetTensor("Y")->data<float>());
+  EXPECT_NE(scope->GetTensor("Z")->data<float>(), another->GetTensor("Z")->data<float>());
+  // the inputs must be variables of the program
+  ASSERT_DEATH(program->CreateExecutionContext({"Unknown"}), "");
+}
+
+// Y = X + W, R = reshape(Y), Z = R + W, where the reshape runs nothing but shares the buffer of Y with R
+std::unique_ptr<Program> BuildReshapeProgram() {
+  auto scope = std::make_shared<Scope>();
+  for (auto& name : std::vector<std::string>({"X", "W", "Y", "R", "Z"})) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(name == "R" ? Shape{{32, 32}} : Shape{{1024}});
+    if (name == "R") continue;
+    auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+    std::fill(data, data + 1024, name == "W" ? 1.f : 0.f);
+  }
+  scope->GetTensor("R")->set_buffer(scope->GetTensor("Y")->get_buffer());
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  for (auto& args : std::vector<std::vector<std::string>>({{"X", "W", "Y"}, {"Y", "R"}, {"R", "W", "Z"}})) {
+    bool is_reshape = args.size() == 2;
+    auto instr      = std::make_unique<Instruction>(common::DefaultHostTarget(),
+                                                    scope.get(),
+                                                    std::vector<std::string>(args.begin(), args.end() - 1),
+                                                    std::vector<std::string>{args.back()},
+                                                    is_reshape ? "no_run" : "add");
+    if (!is_reshape) {
+      instr->SetLoweredFunc(Add, "add");
+    }
+    instr->Finalize();
+    instrs.emplace_back(std::move(instr));
+  }
+  return std::make_unique<Program>(scope, std::move(instrs));
+}
+
+TEST(ExecutionContext, ReshapeSharesBuffer) {
+  auto program = BuildReshapeProgram();
+  auto context = program->CreateExecutionContext({"X"});
+  auto another = program->CreateExecutionContext({"X"});
+  // the reshape output aliases the private buffer of its input in each context
+  EXPECT_EQ(context->GetTensor("R")->data<float>(), context->GetTensor("Y")->data<float>());
+  EXPECT_NE(context->GetTensor("R")->data<float>(), another->GetTensor("R")->data<float>());
+
+  for (float value : {3.f, 5.f}) {
+    auto* x = context->scope()->GetTensor("X")->mutable_data<float>(common::DefaultHostTarget());
+    std::fill(x, x + 1024, value);
+    program->Execute(context.get());
+    auto* z = context->GetTensor("Z")->data<float>();
+    for (int i = 0; i < 1024; ++i) {
+      ASSERT_EQ(z[i], value + 2) << "at " << i;
+    }
+  }
+}
+
+TEST(ExecutionContext, ConcurrentRequests) {
+  auto program          = BuildProgram();
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  std::vector<int> num_errors(num_threads, 0);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&program, &num_errors, t]() {
+      auto context = program->CreateExecutionContext({"X"});
+      for (int round = 0; round < 100; ++round) {
+        float value = t * 1000 + round;
+        auto* x     = context->scope()->GetTensor("X")->mutable_data<float>(common::DefaultHostTarget());
+        std::fill(x, x + 1024, value);
+        program->Execute(context.get());
+        auto* z = context->GetTensor("Z")->data<float>();
+        if (z[0] != value + 2 || z[1023] != value + 2) num_errors[t]++;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < num_threads; ++t) {
+    EXPECT_EQ(num_errors[t], 0) << "thread " << t;
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -16,7 +16,14 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -27,6 +34,13 @@
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/lang/lower.h"
 #include "cinn/poly/stage.h"
+#include "cinn/runtime/flags.h"
+#include "cinn/runtime/tiny_runtime.h"
+#include "cinn/utils/profiler.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/thread_pool.h"
+
+DECLARE_int32(cinn_inter_op_concurrency);
 
 namespace cinn {
 namespace hlir {
@@ -55,6 +69,36 @@ void AddAttrs(const absl::flat_hash_map<std::string, AttrType>& attrs_store,
   }
 }
 
+namespace {
+// Run fn(i) for each i in [0, num) on the compiling threads.
+void ParallelCompile(int num, const std::function<void(int)>& fn) {
+  int num_threads = runtime::GetCinnParallelCompileThreadNum();
+  if (num_threads <= 1 || num <= 1) {
+    for (int i = 0; i < num; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  // the workers are never destroyed, because the isl objects created in lowering are bound to the
+  // thread-local isl context of the worker, so a pool is kept for each number of threads the flag is set to
+  static std::mutex mu;
+  static auto* pools = new std::unordered_map<int, utils::ThreadPool*>();
+  utils::ThreadPool* pool;
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    auto& cached = (*pools)[num_threads];
+    if (!cached) {
+      cached = new utils::ThreadPool(num_threads);
+    }
+    pool = cached;
+  }
+  for (int i = 0; i < num; ++i) {
+    pool->Submit([&fn, i]() { fn(i); });
+  }
+  pool->Wait();
+}
+}  // namespace
+
 Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs)
     : scope_(scope) {
   for (auto& ins : instrs) {
@@ -68,7 +112,33 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
 
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
   for (auto& ins : prerun_instrs_) {
+    std::vector<std::string> outputs;
+    for (auto& out_args : ins->GetOutArgs()) {
+      outputs.insert(outputs.end(), out_args.begin(), out_args.end());
+    }
+    std::vector<std::string> inputs;
+    for (auto& in_args : ins->GetInArgs()) {
+      inputs.insert(inputs.end(), in_args.begin(), in_args.end());
+    }
+    // the outputs in the scope computed from the inputs of the same data, by this program or another one built on
+    // the scope, are reused, and computed again once the inputs change
+    bool use_scope = !name2podargs && !outputs.empty();
+    auto version   = use_scope ? scope_->GetDataVersion(inputs) : Scope::DataVersion();
+    if (use_scope && std::all_of(outputs.begin(), outputs.end(), [&](const std::string& name) {
+          return scope_->IsPrepacked(name, version);
+        })) {
+      VLOG(3) << "Skip the pre-run instruction of " << utils::Join(ins->GetFnNames(), ", ")
+              << ", whose outputs are prepacked";
+      continue;
+    }
     ins->Run(name2podargs);
+    if (use_scope) {
+      for (auto& name : outputs) {
+        // the outputs may be the inputs of the following pre-run instructions, which are computed again as well
+        scope_->GetTensor(name)->get_buffer()->NewGeneration();
+        scope_->MarkPrepacked(name, version);
+      }
+    }
   }
   for (auto& ins : instrs_) {
     if (ins->size() == 4) {
@@ -77,130 +147,186 @@ void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs
   }
 }
 
-void Program::Export(const std::vector<std::string>& persistent_vars, const std::string& filename) {
-  auto writeplaceholder = [=](int s, int n, FILE* f) -> int {
-    int pos = ftell(f);
-    for (int i = 0; i < s * n; i++) {
-      fwrite("\0", 1, 1, f);
-    }
-    return pos;
-  };
-  auto setplaceholder = [=](int p, void* b, int s, int n, FILE* f) {
-    int cur = ftell(f);
-    fseek(f, p, SEEK_SET);
-    fwrite(b, s, n, f);
-    fseek(f, cur, SEEK_SET);
-  };
-  auto tellplaceholder = [=](int p, FILE* f) {
-    int cur = ftell(f);
-    setplaceholder(p, &cur, 4, 1, f);
-  };
-  auto padding = [=](int alignment, uint8_t value, FILE* f) {
-    int cur     = ftell(f);
-    int padding = (alignment - (cur % alignment)) % alignment;
-    for (int i = 0; i < padding; i++) {
-      fwrite(&value, 1, 1, f);
-    }
-  };
-  auto varnames = scope_->var_names();
+void Program::Export(const std::vector<std::string>& persistent_vars,
+                     const std::string& filename,
+                     const std::string& library_path) {
+  auto align_up = [](uint64_t size, uint64_t alignment) { return (size + alignment - 1) / alignment * alignment; };
+
+  std::vector<std::string> varnames;
   std::unordered_map<std::string, int> varindex;
-  for (int i = 0; i < varnames.size(); i++) {
-    varindex[(std::string)varnames[i]] = i;
-  }
-
-  FILE* f = fopen(filename.c_str(), "w+");
-
-  fwrite("CINN", 4, 1, f);
-  int major_v = 0;
-  int minor_v = 0;
-  fwrite(&major_v, 4, 1, f);
-  fwrite(&minor_v, 4, 1, f);
-  int unused_v = 0;
-  fwrite(&unused_v, 4, 1, f);
-
-  // varname list
-  int varnamesec = writeplaceholder(4, 1, f);
-  int namesnum   = varnames.size();
-  fwrite(&namesnum, 4, 1, f);
-  int nameoffset = writeplaceholder(4, namesnum, f);
-  for (int i = 0; i < namesnum; i++) {
-    int namelen = varnames[i].size();
-    fwrite(&namelen, 4, 1, f);
-    tellplaceholder(nameoffset + i * 4, f);
-    fwrite(varnames[i].data(), namelen, 1, f);
-    fwrite("\0", 1, 1, f);
-  }
-  padding(16, 0, f);
-  tellplaceholder(varnamesec, f);
-  // pod_values
-  int buffersec = writeplaceholder(4, 1, f);
-  int bufoffset = writeplaceholder(4, 1, f);
-  padding(alignof(cinn_buffer_t), 0, f);
-  tellplaceholder(bufoffset, f);
-  std::vector<std::pair<cinn_buffer_t*, int>> pvars;
-  for (auto& varname : varnames) {
-    std::string name     = (std::string)varname;
-    auto t               = scope_->GetTensor(name);
-    cinn_buffer_t buffer = *t->buffer();
-    buffer.memory        = (uint8_t*)0;
-    if (std::find(persistent_vars.begin(), persistent_vars.end(), name) != persistent_vars.end()) {
-      pvars.emplace_back(t->buffer(), ftell(f) + offsetof(cinn_buffer_t, memory));
+  for (auto& name : scope_->var_names()) {
+    varindex[std::string(name)] = varnames.size();
+    varnames.emplace_back(name);
+  }
+  std::unordered_set<std::string> persistent_set(persistent_vars.begin(), persistent_vars.end());
+  // the constants computed by the pre-run instructions are exported as the weights, so they are not computed again
+  // on loading, and the variables only accessed by the pre-run instructions are dropped
+  std::unordered_set<std::string> prerun_vars, prerun_outputs;
+  for (auto& ins : prerun_instrs_) {
+    for (auto& args : ins->GetInArgs()) {
+      prerun_vars.insert(args.begin(), args.end());
     }
-    fwrite(&buffer, sizeof(cinn_buffer_t), 1, f);
-  }
-  padding(16, 0, f);
-  tellplaceholder(buffersec, f);
-  // persistent_buffers
-  int pbuffer = writeplaceholder(4, 1, f);
-  for (auto& p : pvars) {
-    if (p.first->align) {
-      padding(p.first->align, 0, f);
+    for (auto& args : ins->GetOutArgs()) {
+      prerun_vars.insert(args.begin(), args.end());
+      prerun_outputs.insert(args.begin(), args.end());
     }
-    tellplaceholder(p.second, f);
-    fwrite(p.first->memory, p.first->memory_size, 1, f);
-  }
-  padding(16, 0, f);
-  tellplaceholder(pbuffer, f);
-  // instructions
-  int instsec = writeplaceholder(4, 1, f);
-  int insnum  = 0;
-  for (auto& ins : instrs_) {
-    ins->Run(nullptr, true);
-    insnum += ins->GetFnNames().size();
   }
-  fwrite(&insnum, 4, 1, f);
-  int instplaceholder = writeplaceholder(4 * 3, insnum, f);
-  int findex          = 0;
+
+  // the functions in the execution order, and the indices of their arguments
+  std::vector<std::pair<std::string, std::vector<int32_t>>> funcs;
+  // the first and the last step each variable is used, and whether they read or write it
+  std::vector<int> first_use(varnames.size(), -1), last_use(varnames.size(), -1);
+  std::vector<bool> first_is_read(varnames.size(), false), last_is_write(varnames.size(), false);
   for (auto& ins : instrs_) {
+    ins->Run(nullptr, true);
     auto in_args  = ins->GetInArgs();
     auto out_args = ins->GetOutArgs();
     auto fn_names = ins->GetFnNames();
-    for (int i = 0; i < fn_names.size(); i++, findex++) {
-      std::vector<std::string> all_args(in_args[i].begin(), in_args[i].end());
-      all_args.insert(std::end(all_args), out_args[i].begin(), out_args[i].end());
-      auto fname    = fn_names[i];
-      int fnamesize = fname.size();
-      fwrite(&fnamesize, 4, 1, f);
-      tellplaceholder(instplaceholder + findex * 12, f);
-      fwrite(fname.c_str(), fname.size(), 1, f);
-      fwrite("\0", 1, 1, f);
-      int argsize = all_args.size();
-      setplaceholder(instplaceholder + findex * 12 + 4, &argsize, 4, 1, f);
-      padding(alignof(cinn_pod_value_t), 0, f);
-      tellplaceholder(instplaceholder + findex * 12 + 8, f);
-      for (auto& arg : all_args) {
-        uintptr_t bufindex = varindex[arg];
-        cinn_pod_value_t v((cinn_buffer_t*)bufindex);
-        fwrite(&v, sizeof(cinn_pod_value_t), 1, f);
+    for (int i = 0; i < fn_names.size(); i++) {
+      int step = funcs.size();
+      funcs.emplace_back(fn_names[i], std::vector<int32_t>());
+      auto access = [&](const std::string& arg, bool is_write) {
+        int idx = varindex.at(arg);
+        funcs.back().second.push_back(idx);
+        if (first_use[idx] < 0) {
+          first_use[idx]     = step;
+          first_is_read[idx] = !is_write;
+        }
+        last_use[idx]      = step;
+        last_is_write[idx] = is_write;
+      };
+      // the duplicate inputs are passed once, the same as Instruction::BuildArgs
+      std::unordered_set<std::string> in_args_set;
+      for (auto& arg : in_args[i]) {
+        if (in_args_set.insert(arg).second) access(arg, false);
       }
+      for (auto& arg : out_args[i]) {
+        access(arg, true);
+      }
+    }
+  }
+
+  cinn_program_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CINN_PROGRAM_MAGIC, 4);
+  header.major_v             = CINN_PROGRAM_MAJOR_VERSION;
+  header.minor_v             = CINN_PROGRAM_MINOR_VERSION;
+  header.page_size           = CINN_PROGRAM_PAGE_SIZE;
+  header.num_vars            = varnames.size();
+  header.vars_offset         = align_up(sizeof(header), 16);
+  header.num_instructions    = funcs.size();
+  header.instructions_offset = align_up(header.vars_offset + header.num_vars * sizeof(cinn_program_var_t), 16);
+
+  std::string blob(header.instructions_offset + header.num_instructions * sizeof(cinn_program_instruction_t), '\0');
+  auto append = [&](const void* data, uint64_t size, uint64_t alignment) -> uint64_t {
+    blob.resize(align_up(blob.size(), alignment), '\0');
+    uint64_t offset = blob.size();
+    blob.append(static_cast<const char*>(data), size);
+    return offset;
+  };
+
+  std::vector<cinn_program_instruction_t> instrs(funcs.size());
+  for (int i = 0; i < funcs.size(); i++) {
+    instrs[i].name_offset = append(funcs[i].first.c_str(), funcs[i].first.size() + 1, 1);
+    instrs[i].args_offset = append(funcs[i].second.data(), funcs[i].second.size() * sizeof(int32_t), sizeof(int32_t));
+    instrs[i].num_args    = funcs[i].second.size();
+  }
+
+  // the temporaries are packed into one arena according to their lifetimes, the feeds and fetches live
+  // through the whole program since they are accessed by the caller
+  std::vector<cinn_program_var_t> vars(varnames.size());
+  StaticMemoryPlanner planner;
+  for (int i = 0; i < varnames.size(); i++) {
+    auto tensor                     = scope_->GetTensor(varnames[i]);
+    vars[i].name_offset             = append(varnames[i].c_str(), varnames[i].size() + 1, 1);
+    vars[i].buffer                  = *tensor->buffer();
+    vars[i].buffer.memory           = nullptr;
+    vars[i].buffer.device_interface = nullptr;
+    if (persistent_set.count(varnames[i]) || (first_use[i] >= 0 && prerun_outputs.count(varnames[i]))) {
+      CHECK(!machine_specific_vars_.count(varnames[i]))
+          << "The variable [" << varnames[i] << "] is prepacked into a format depending on the CPU, which can not be "
+          << "exported. Build the program with FLAGS_cinn_machine_specific_prepack=false to export it";
+      vars[i].kind = cinn_program_var_persistent;
+      CHECK(tensor->buffer()->memory) << "The persistent variable [" << varnames[i]
+                                      << "] has no data to export, PreRun should be called before exporting";
+      continue;
+    }
+    vars[i].kind = cinn_program_var_temporary;
+    if (first_use[i] < 0 && prerun_vars.count(varnames[i])) {
+      vars[i].buffer.memory_size = 0;
+      continue;
+    }
+    uint64_t nbytes =
+        std::max<uint64_t>(vars[i].buffer.memory_size,
+                           (static_cast<uint64_t>(tensor->shape().numel()) * tensor->type().bits() + 7) / 8);
+    vars[i].buffer.memory_size = nbytes;
+    int first                  = first_use[i] < 0 || first_is_read[i] ? 0 : first_use[i];
+    int last                   = last_use[i] < 0 || last_is_write[i] ? funcs.size() : last_use[i];
+    planner.AddVariable(varnames[i], nbytes, first, last);
+  }
+  auto plan              = planner.Plan();
+  header.arena_size      = plan.workspace_size;
+  header.arena_alignment = plan.alignment;
+  VLOG(3) << "Export " << planner.size() << " temporaries in an arena of " << plan.workspace_size
+          << " bytes, while they take " << plan.naive_size << " bytes separately";
+
+  // the weights are page aligned so that they can be used in place after mapping
+  blob.resize(align_up(blob.size(), CINN_PROGRAM_PAGE_SIZE), '\0');
+  header.weights_offset = blob.size();
+  for (int i = 0; i < varnames.size(); i++) {
+    if (vars[i].kind == cinn_program_var_temporary) {
+      vars[i].data_offset = plan.offsets.count(varnames[i]) ? plan.offsets.at(varnames[i]) : 0;
+    } else {
+      auto* buffer        = scope_->GetTensor(varnames[i])->buffer();
+      uint64_t alignment  = std::max<uint64_t>(buffer->align, 64);
+      vars[i].data_offset = append(buffer->memory, buffer->memory_size, alignment) - header.weights_offset;
     }
   }
-  padding(16, 0, f);
-  tellplaceholder(instsec, f);
-  fclose(f);
+  header.weights_size = blob.size() - header.weights_offset;
+
+  if (!library_path.empty()) {
+    std::ifstream ifs(library_path, std::ios::binary);
+    CHECK(ifs) << "Failed to open the library " << library_path;
+    std::string library((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    header.library_offset = append(library.data(), library.size(), CINN_PROGRAM_PAGE_SIZE);
+    header.library_size   = library.size();
+  }
+
+  header.file_size = blob.size();
+  memcpy(&blob[0], &header, sizeof(header));
+  memcpy(&blob[header.vars_offset], vars.data(), vars.size() * sizeof(cinn_program_var_t));
+  memcpy(&blob[header.instructions_offset], instrs.data(), instrs.size() * sizeof(cinn_program_instruction_t));
+
+  std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+  CHECK(ofs) << "Failed to open " << filename;
+  ofs.write(blob.data(), blob.size());
+  CHECK(ofs) << "Failed to write " << filename;
+}
+
+bool Program::ParallelExecutable() const {
+  // the statically planned variables share memory in a way invisible to the dependency analysis
+  return !instrs_.empty() && instrs_[0]->target_.arch == Target::Arch::X86 && !workspace_;
+}
+
+ParallelExecutor* Program::GetParallelExecutor(int concurrency) {
+  if (!parallel_executor_ || parallel_executor_->concurrency() != concurrency) {
+    // variables sharing the same buffer are regarded as one resource
+    auto resource_of = [this](const std::string& name) -> std::string {
+      auto* var = scope_->FindVar(name);
+      if (!var) return name;
+      return std::to_string(reinterpret_cast<uintptr_t>(absl::get<Tensor>(*var)->get_buffer().get()));
+    };
+    parallel_executor_.reset(
+        new ParallelExecutor(&instrs_, InstructionDependencies::Build(instrs_, resource_of), concurrency));
+  }
+  return parallel_executor_.get();
 }
 
 void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+  if (FLAGS_cinn_inter_op_concurrency > 1 && ParallelExecutable()) {
+    GetParallelExecutor(FLAGS_cinn_inter_op_concurrency)->Run(name2podargs, stream, use_cache);
+    return;
+  }
   for (auto& ins : instrs_) {
     ins->Run(name2podargs, false, stream, use_cache);
   }
@@ -212,6 +338,21 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
 }
 
+std::unique_ptr<ExecutionContext> Program::CreateExecutionContext(const std::vector<std::string>& input_names) const {
+  return std::make_unique<ExecutionContext>(*scope_, instrs_, input_names);
+}
+
+void Program::Execute(ExecutionContext* context, const std::map<std::string, cinn_pod_value_t>* name2podargs) const {
+  CHECK(context);
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (name2podargs) {
+      instrs_[i]->RunWithArgs(instrs_[i]->BuildArgs(*context->scope(), name2podargs));
+    } else {
+      instrs_[i]->RunWithArgs(context->args(i));
+    }
+  }
+}
+
 void Program::ExecuteTest(int repeat_) {
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
@@ -271,11 +412,15 @@ std::string GraphCompiler::GenSourceCode() {
   return compiler_->GetSourceCode(build_module);
 }
 
-const std::string& GraphCompiler::GetOrGenFullFuncName(const std::string& prefix) {
+std::string GraphCompiler::GetOrGenFullFuncName(const std::string& prefix) {
+  std::lock_guard<std::mutex> lock(name_mu_);
   // try_emplace only insert once, so the same function
   // can get a consistent name next time
-  prefix2full_namemap_.try_emplace(prefix, Context::Global().NewName(prefix));
-  return prefix2full_namemap_.at(prefix);
+  auto it = prefix2full_namemap_.find(prefix);
+  if (it == prefix2full_namemap_.end()) {
+    it = prefix2full_namemap_.emplace(prefix, Context::Global().NewName(prefix)).first;
+  }
+  return it->second;
 }
 
 std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
@@ -650,6 +795,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // if the input lowered_funcs is empty, we will use the defalut lowering process to generate
   std::vector<std::vector<ir::LoweredFunc>> local_lowered_funcs;
   if (options.lowered_funcs.empty()) {
+    utils::RecordEvent record_lowering("Lowering", utils::EventType::kCompilePhase);
     // lowering of new fusion pass is not compatible with the groups from the input options,
     // thus process it seperately
     if (!graph_->fusion_groups.empty()) {
@@ -673,20 +819,23 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
             }
           }
         }
-        local_lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
-        CHECK_EQ(local_lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
-        VLOG(3) << local_lowered_funcs.back()[0];
       }
+      // the groups are independent of each other, so they are lowered in parallel
+      local_lowered_funcs.resize(graph_->fusion_groups.size());
+      ParallelCompile(graph_->fusion_groups.size(), [&](int i) {
+        local_lowered_funcs[i] = op_lowerer.Lower(graph_->fusion_groups[i]);
+        CHECK_EQ(local_lowered_funcs[i].size(), 1) << "Lowerd Function Is Not Equal 1!";
+        VLOG(3) << local_lowered_funcs[i][0];
+      });
     } else {
-      for (int i = 0; i < groups.size(); i++) {
-        std::vector<ir::LoweredFunc> lowered_func;
+      local_lowered_funcs.resize(groups.size());
+      ParallelCompile(groups.size(), [&](int i) {
         if (groups[i].size() == 1) {
-          lowered_func = GetOpFunc(groups[i][0]);
+          local_lowered_funcs[i] = GetOpFunc(groups[i][0]);
         } else {
-          lowered_func = GetOpFunc(groups[i]);
+          local_lowered_funcs[i] = GetOpFunc(groups[i]);
         }
-        local_lowered_funcs.emplace_back(std::move(lowered_func));
-      }
+      });
     }
   }
 
@@ -712,20 +861,35 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     VLOG(3) << "[X86] C Code is:\n" << out;
   }
 
-  compiler_->Build(build_module, options.attached_code, stream);
+  {
+    utils::RecordEvent record_build("BuildModule", utils::EventType::kCompilePhase);
+    compiler_->Build(build_module, options.attached_code, stream);
+  }
   auto instructions = BuildInstructions(groups, graph_->fusion_groups);
   if (options.remove_unused_variables) {
     RemoveInvalidVariables(instructions);
   }
+  CHECK(!(options.with_buffer_handle_instruction_inserted && options.with_static_memory_plan))
+      << "with_buffer_handle_instruction_inserted and with_static_memory_plan can not be enabled at the same time";
   if (options.with_buffer_handle_instruction_inserted) {
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
     InsertBufferHandlers(&instructions);
   }
 
+  GraphCompiler::CompilationResult result;
+  std::shared_ptr<Buffer> workspace;
+  std::unordered_set<std::string> planned_vars;
+  if (options.with_static_memory_plan) {
+    VLOG(3) << "option.with_static_memory_plan enable";
+    workspace = PlanStaticMemory(instructions, &result.memory_plan, &planned_vars);
+  }
+
   if (options.with_instantiate_variables) {
     VLOG(3) << "Initantiate all variables on compile-time";
     // All variables reside in scope_, so traverse it to instantiate each one
     for (auto& name : scope_->var_names()) {
+      // the planned variables have been bound to the workspace
+      if (planned_vars.count(std::string(name))) continue;
       auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
       auto& tensor = absl::get<Tensor>(*var);
       if (reuse_vars_map_.count(name)) {
@@ -738,8 +902,14 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       }
     }
   }
-  GraphCompiler::CompilationResult result;
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  if (workspace) {
+    result.runtime_program->SetWorkspace(workspace);
+  }
+  if (graph_->HasAttr("machine_specific_vars")) {
+    result.runtime_program->SetMachineSpecificVars(
+        graph_->GetAttrs<std::unordered_set<std::string>>("machine_specific_vars"));
+  }
   return result;
 }
 
@@ -1126,28 +1296,35 @@ static void BufferFreeWithCallback(void* args, int num_args) {
   }
 }
 
-void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
-                                            std::unordered_map<int, std::vector<std::string>>* step2malloc,
-                                            std::unordered_map<int, std::vector<std::string>>* step2free) {
-  absl::flat_hash_map<std::string, int> variable_last_used, variable_first_used;
+// record the step of the first and the last instruction where each variable is used
+static void CollectVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                    absl::flat_hash_map<std::string, int>* variable_first_used,
+                                    absl::flat_hash_map<std::string, int>* variable_last_used) {
   for (auto step = 0; step < instructions.size(); ++step) {
     const auto& instr = instructions.at(step);
 
     for (const auto& args : instr->GetInArgs()) {
       for (const auto& var_name : args) {
         // use try_emplace to record the first time a variable appearance
-        variable_first_used.try_emplace(var_name, step);
+        variable_first_used->try_emplace(var_name, step);
         // will update until last time a variable used
-        variable_last_used[var_name] = step;
+        (*variable_last_used)[var_name] = step;
       }
     }
     for (const auto& args : instr->GetOutArgs()) {
       for (const auto& var_name : args) {
-        variable_first_used.try_emplace(var_name, step);
-        variable_last_used[var_name] = step;
+        variable_first_used->try_emplace(var_name, step);
+        (*variable_last_used)[var_name] = step;
       }
     }
   }
+}
+
+void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                            std::unordered_map<int, std::vector<std::string>>* step2malloc,
+                                            std::unordered_map<int, std::vector<std::string>>* step2free) {
+  absl::flat_hash_map<std::string, int> variable_last_used, variable_first_used;
+  CollectVariableLifeTime(instructions, &variable_first_used, &variable_last_used);
 
   for (const auto& var2first : variable_first_used) {
     (*step2malloc)[var2first.second].emplace_back(var2first.first);
@@ -1199,6 +1376,78 @@ void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction
   instructions->swap(results);
 }
 
+std::shared_ptr<Buffer> GraphCompiler::PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                                        MemoryPlan* plan,
+                                                        std::unordered_set<std::string>* planned_vars) {
+  if (target_.arch != Target::Arch::X86) {
+    LOG(WARNING) << "Static memory planning only supports X86 target now, skip it on target " << target_;
+    return nullptr;
+  }
+
+  absl::flat_hash_map<std::string, int> variable_last_used, variable_first_used;
+  CollectVariableLifeTime(instructions, &variable_first_used, &variable_last_used);
+
+  // the following variables live across executions and can not be planned:
+  // 1. variables read before written, such as feeds and parameters;
+  // 2. variables touched by the pre-run instructions, such as the results of constant propagation;
+  // 3. the fetched variables and variables sharing buffer with others.
+  std::unordered_set<std::string> excluded_vars(fetch_var_ids_.begin(), fetch_var_ids_.end());
+  for (auto& src2dst : reuse_vars_map_) {
+    excluded_vars.insert(src2dst.first);
+    excluded_vars.insert(src2dst.second);
+  }
+  std::unordered_set<std::string> written_vars;
+  for (auto step = 0; step < instructions.size(); ++step) {
+    const auto& instr = instructions.at(step);
+    for (const auto& args : instr->GetInArgs()) {
+      for (const auto& var_name : args) {
+        if (instr->pre_run || !written_vars.count(var_name)) {
+          excluded_vars.insert(var_name);
+        }
+      }
+    }
+    for (const auto& args : instr->GetOutArgs()) {
+      for (const auto& var_name : args) {
+        if (instr->pre_run || utils::Startswith(var_name, "kernel_pack")) {
+          excluded_vars.insert(var_name);
+        }
+        written_vars.insert(var_name);
+      }
+    }
+  }
+
+  StaticMemoryPlanner planner;
+  for (auto& var2first : variable_first_used) {
+    const auto& var_name = var2first.first;
+    if (excluded_vars.count(var_name)) continue;
+    auto* var = scope_->FindVar(var_name);
+    if (!var) continue;
+    auto& tensor    = absl::get<Tensor>(*var);
+    uint64_t nbytes = (static_cast<uint64_t>(tensor->shape().numel()) * tensor->type().bits() + 7) / 8;
+    if (nbytes == 0) continue;
+    planner.AddVariable(var_name, nbytes, var2first.second, variable_last_used.at(var_name));
+  }
+  *plan = planner.Plan();
+  if (plan->offsets.empty()) {
+    return nullptr;
+  }
+  VLOG(3) << "Statically planned " << plan->offsets.size() << " variables into a workspace of "
+          << plan->workspace_size << " bytes, while the naive sum is " << plan->naive_size << " bytes";
+
+  auto workspace = std::make_shared<Buffer>(target_);
+  workspace->Resize(plan->alignment, plan->workspace_size);
+  auto* base = workspace->data()->memory;
+  CHECK(base) << "Failed to allocate the workspace of " << plan->workspace_size << " bytes";
+  for (auto& var2offset : plan->offsets) {
+    auto& tensor  = absl::get<Tensor>(*scope_->FindVar(var2offset.first));
+    uint64_t size = (static_cast<uint64_t>(tensor->shape().numel()) * tensor->type().bits() + 7) / 8;
+    tensor->get_buffer()->BindExternalMemory(base + var2offset.second, size);
+    planned_vars->insert(var2offset.first);
+    VLOG(4) << "Variable(" << var2offset.first << ") is planned at offset " << var2offset.second;
+  }
+  return workspace;
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   for (auto& i : node->inlinks_in_order()) {
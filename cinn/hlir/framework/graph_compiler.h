@@ -18,6 +18,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -27,9 +28,12 @@
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/macros.h"
+#include "cinn/hlir/framework/execution_context.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/memory_planner.h"
 #include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/framework/parallel_executor.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
@@ -51,9 +55,29 @@ class Program {
    */
   Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs);
 
+  /**
+   * Run the pre-run instructions computing the constants once, e.g. packing the weights. The instructions whose
+   * outputs are prepacked in the scope from the inputs of the same data version, by this program or another one built
+   * on the scope, are skipped, so calling it again after the weights are written through Tensor::mutable_data or
+   * rebound packs them again. The version is the buffer and its generation, see Scope::GetDataVersion, so checking
+   * it does not read the data.
+   */
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
 
-  void Export(const std::vector<std::string>& persistent_vars, const std::string& filename);
+  /**
+   * Export the program into a file loaded by the tiny runtime. The outputs of the pre-run instructions, e.g. the
+   * prepacked weights, are exported as the weights too, so it should be called after PreRun, and the pre-run
+   * instructions are not exported, neither are the variables only accessed by them. The weights prepacked into the
+   * formats depending on the CPU can not be exported, see FLAGS_cinn_machine_specific_prepack.
+   * @param persistent_vars The variables whose data are exported as the weights.
+   * @param filename The path of the file.
+   * @param library_path The shared library containing the compiled functions, which is embedded into the file
+   * to make it deployable alone, e.g. built from the object of GraphCompiler::ExportObject by `cc -shared`.
+   * The functions are looked up in the loading process if it is empty.
+   */
+  void Export(const std::vector<std::string>& persistent_vars,
+              const std::string& filename,
+              const std::string& library_path = "");
 
   /**
    * Execute the program -- that is running all the instructions inside it.
@@ -64,6 +88,22 @@ class Program {
 
   void ExecuteTest(int repeat_);
 
+  /**
+   * Create a context to execute this program in, the compiled code and persistent variables are shared
+   * among contexts, while the intermediate variables and the given inputs are private to each context.
+   * It should be called after PreRun, and the contexts should not outlive this program.
+   * @param input_names The variables fed by each request. They must be listed, since the variables neither listed
+   * nor written by the instructions are shared by all the contexts.
+   */
+  std::unique_ptr<ExecutionContext> CreateExecutionContext(const std::vector<std::string>& input_names) const;
+
+  /**
+   * Execute the program in the given context, it is safe to call it from multiple threads with different contexts.
+   * @param name2podargs The arguments of the instructions, the arguments bound to the context are used if it is null.
+   */
+  void Execute(ExecutionContext* context,
+               const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) const;
+
   /**
    * Get the number of instructions.
    */
@@ -72,13 +112,35 @@ class Program {
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
+  /**
+   * Hold the workspace where the statically planned variables reside.
+   */
+  void SetWorkspace(const std::shared_ptr<Buffer>& workspace) { workspace_ = workspace; }
+
+  /**
+   * Set the variables prepacked into the formats depending on the CPU, which are refused by Export.
+   */
+  void SetMachineSpecificVars(const std::unordered_set<std::string>& vars) { machine_specific_vars_ = vars; }
+
  private:
+  // Whether the instructions can be executed by the ParallelExecutor
+  bool ParallelExecutable() const;
+
+  // Get the ParallelExecutor running with the given concurrency, create it if not exists.
+  ParallelExecutor* GetParallelExecutor(int concurrency);
+
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
+  // the workspace shared by intermediate variables, the buffers of them are slices of it
+  std::shared_ptr<Buffer> workspace_;
+  // the variables only valid on the CPU computing them
+  std::unordered_set<std::string> machine_specific_vars_;
   // prerun instructions
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  // run instrs_ in parallel according to their dependencies
+  std::unique_ptr<ParallelExecutor> parallel_executor_;
 };
 
 /**
@@ -91,6 +153,8 @@ class GraphCompiler final {
 
   struct CompilationResult {
     std::unique_ptr<Program> runtime_program;
+    // the result of static memory planning, which is empty if with_static_memory_plan is disabled
+    MemoryPlan memory_plan;
   };
 
   struct CompileOptions {
@@ -98,6 +162,9 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // pack intermediate variables into one pre-allocated workspace according to their lifetimes,
+    // it is exclusive with with_buffer_handle_instruction_inserted
+    bool with_static_memory_plan = false;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::vector<Node*>> groups;
@@ -113,6 +180,8 @@ class GraphCompiler final {
   CompilationResult Build(const CompileOptions& options,
                           std::unordered_set<std::string>&& fetch_var_ids = {},
                           void* stream                                    = nullptr);
+  // Export the object of the compiled kernels, which run on the CPUs of all the levels in FLAGS_cinn_x86_isa_levels
+  // if it is set, otherwise only on the CPUs like the host.
   void ExportObject(const std::string& path) { compiler_->ExportObject(path); }
 
   std::unique_ptr<Program> Build(const std::string& code = "");
@@ -123,6 +192,10 @@ class GraphCompiler final {
 
   const std::shared_ptr<Scope>& GetScope() const { return scope_; }
 
+  const std::shared_ptr<Graph>& GetGraph() const { return graph_; }
+
+  const Target& GetTarget() const { return target_; }
+
   std::vector<std::vector<ir::LoweredFunc>> FusedGraphToLoweredFunc(
       const std::vector<std::vector<hlir::framework::Node*>>& graph);
 
@@ -139,7 +212,7 @@ class GraphCompiler final {
 
   // append a unique number at the end of the function name to distinguish
   // different functions from graphs whose structures are same
-  const std::string& GetOrGenFullFuncName(const std::string& prefix);
+  std::string GetOrGenFullFuncName(const std::string& prefix);
 
   // TODO(haozech) add implementation
   std::vector<std::string> OpGetInputNames(const Node* node) const;
@@ -167,6 +240,14 @@ class GraphCompiler final {
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // assign the intermediate variables, which are produced and consumed only inside one execution,
+  // to offsets of a single workspace so that variables with disjoint lifetimes share memory.
+  // The buffers of the planned variables are bound to the returned workspace and their names
+  // are collected into planned_vars.
+  std::shared_ptr<Buffer> PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                           MemoryPlan* plan,
+                                           std::unordered_set<std::string>* planned_vars);
+
  private:
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_func);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
@@ -181,6 +262,8 @@ class GraphCompiler final {
   std::unordered_set<std::string> fetch_var_ids_;
 
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
+  // guard prefix2full_namemap_ when the groups are lowered in parallel
+  std::mutex name_mu_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
 
@@ -14,14 +14,20 @@
 
 #include "cinn/hlir/framework/graph_compiler.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
 
+DECLARE_int32(cinn_parallel_compile_thread);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -114,6 +120,81 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestStaticMemoryPlan) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1, 64, 56, 56}, "A");
+  auto b = builder.CreateInput(Float(32), {1, 64, 56, 56}, "B");
+
+  auto c      = builder.ElementwiseAdd(a, b);
+  auto d      = builder.Relu(c);
+  auto e      = builder.ElementwiseMul(d, a);
+  auto f      = builder.Relu(e);
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_static_memory_plan    = true;
+  auto result                        = gc.Build(options, {f->id});
+
+  // c, d and e are intermediates, and c can share memory with e
+  const auto& plan = result.memory_plan;
+  ASSERT_EQ(plan.offsets.size(), 3UL);
+  EXPECT_EQ(plan.offsets.count(f->id), 0UL);
+  EXPECT_LT(plan.workspace_size, plan.naive_size);
+  EXPECT_EQ(plan.offsets.at(c->id), plan.offsets.at(e->id));
+
+  auto a_data = scope->GetTensor(std::string(a.id()))->mutable_data<float>(target);
+  auto b_data = scope->GetTensor(std::string(b.id()))->mutable_data<float>(target);
+  for (int i = 0; i < 64 * 56 * 56; ++i) {
+    a_data[i] = static_cast<float>(i % 7) - 3.0f;
+    b_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  ASSERT_NO_THROW(result.runtime_program->Execute());
+
+  auto f_data = scope->GetTensor(f->id)->data<float>();
+  for (int i = 0; i < 64 * 56 * 56; ++i) {
+    float expected = std::max(std::max(a_data[i] + b_data[i], 0.0f) * a_data[i], 0.0f);
+    ASSERT_FLOAT_EQ(f_data[i], expected);
+  }
+}
+
+TEST(GraphCompilerTest, TestParallelCompile) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {64, 128}, "A");
+  auto b = builder.CreateInput(Float(32), {64, 128}, "B");
+  // independent branches make a module with several functions
+  std::vector<frontend::Variable> branches;
+  for (int i = 0; i < 8; ++i) {
+    branches.push_back(builder.Relu(i % 2 ? builder.ElementwiseAdd(a, b) : builder.ElementwiseMul(a, b)));
+  }
+  auto out    = builder.Sum(branches);
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  FLAGS_cinn_parallel_compile_thread = 4;
+  GraphCompiler gc(target, scope, graph);
+  auto program                       = gc.Build();
+  FLAGS_cinn_parallel_compile_thread = 1;
+
+  auto a_data = scope->GetTensor(std::string(a.id()))->mutable_data<float>(target);
+  auto b_data = scope->GetTensor(std::string(b.id()))->mutable_data<float>(target);
+  for (int i = 0; i < 64 * 128; ++i) {
+    a_data[i] = static_cast<float>(i % 7) - 3.0f;
+    b_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  ASSERT_NO_THROW(program->Execute());
+
+  auto out_data = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < 64 * 128; ++i) {
+    float expected = 4 * std::max(a_data[i] + b_data[i], 0.0f) + 4 * std::max(a_data[i] * b_data[i], 0.0f);
+    ASSERT_FLOAT_EQ(out_data[i], expected);
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -26,8 +26,13 @@ namespace hlir {
 namespace framework {
 
 void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
-  int cache_size = size();
-  args_cached_.resize(cache_size);
+  args_cached_ = BuildArgs(*scope_, name2podargs);
+}
+
+std::vector<std::vector<cinn_pod_value_t>> Instruction::BuildArgs(
+    const Scope& scope, const std::map<std::string, cinn_pod_value_t>* name2podargs) const {
+  int cache_size = fn_.size();
+  std::vector<std::vector<cinn_pod_value_t>> args(cache_size);
 
   for (int i = 0; i < cache_size; ++i) {
     common::ArgsBuilder builder;
@@ -49,7 +54,7 @@ void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>*
       }
     } else {
       for (const auto& arg : all_args) {
-        auto* var = scope_->FindVar(arg);
+        auto* var = scope.FindVar(arg);
         CHECK(var) << "Argument [" << arg << "] not found in the scope";
 
         // TODO(Superjomn) Support other types.
@@ -58,7 +63,20 @@ void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>*
       }
     }
 
-    args_cached_[i] = builder.Build();
+    args[i] = builder.Build();
+  }
+  return args;
+}
+
+void Instruction::RunWithArgs(const std::vector<std::vector<cinn_pod_value_t>>& args) const {
+  utils::RecordEvent record_run(function_name_, utils::EventType::kInstruction);
+  CHECK(finalized_flag_) << "Instruction must be finalized before run";
+  if (function_name_ == "no_run") return;
+  CHECK_EQ(args.size(), fn_.size()) << "The arguments do not match the functions of " << function_name_;
+  for (int i = 0; i < fn_.size(); ++i) {
+    CHECK(fn_[i]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
+    utils::RecordEvent record_kernel(fn_names_[i], utils::EventType::kKernel);
+    fn_[i](const_cast<cinn_pod_value_t*>(args[i].data()), args[i].size());
   }
 }
 
@@ -76,7 +94,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
                       bool dryrun,
                       void* stream,
                       bool use_cache) {
-  utils::RecordEvent record_run(function_name_);
+  utils::RecordEvent record_run(function_name_, utils::EventType::kInstruction);
   CHECK(finalized_flag_) << "Instruction must be finalized before run";
   if (function_name_ == "no_run") {
     VLOG(2) << "skip instruction";
@@ -194,6 +212,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     auto& pod_args = args_cached_[i];
     CHECK(it_fn) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
     if (!dryrun) {
+      utils::RecordEvent record_kernel(fn_names_[i], utils::EventType::kKernel);
       it_fn(pod_args.data(), pod_args.size());
     }
     i++;
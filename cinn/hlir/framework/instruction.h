@@ -68,6 +68,20 @@ class Instruction {
   void Finalize();
 
   void UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>* name2podargs);
+
+  /**
+   * Build the arguments of each function from \p scope, or from \p name2podargs if it is not null.
+   */
+  std::vector<std::vector<cinn_pod_value_t>> BuildArgs(
+      const Scope& scope, const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) const;
+
+  /**
+   * Run the functions with \p args built by BuildArgs. It does not touch any state of this Instruction,
+   * so it can be called from multiple threads at the same time with different arguments.
+   * Note that the library calls dispatched by function name in Run, such as cublas_gemm, are not supported.
+   */
+  void RunWithArgs(const std::vector<std::vector<cinn_pod_value_t>>& args) const;
+
   /**
    * Run the Instruction.
    */
@@ -112,6 +126,8 @@ class Instruction {
 
   int size() { return fn_.size(); }
 
+  const std::string& function_name() const { return function_name_; }
+
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   std::vector<std::string> GetFnNames() { return fn_names_; }
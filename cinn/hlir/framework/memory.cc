@@ -14,6 +14,10 @@
 
 #include "cinn/hlir/framework/memory.h"
 
+#include <gflags/gflags.h>
+
+#include "cinn/hlir/framework/caching_memory.h"
+
 #ifdef CINN_WITH_CUDA
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -21,6 +25,8 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DECLARE_bool(cinn_use_caching_allocator);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -56,8 +62,13 @@ class CudaMemoryMng : public MemoryInterface {
 }  // namespace
 
 MemoryManager::MemoryManager() {
-  Register(Target::Arch::Unk, new X86MemoryMng);
-  Register(Target::Arch::X86, new X86MemoryMng);
+  if (FLAGS_cinn_use_caching_allocator) {
+    Register(Target::Arch::Unk, new CachingMemoryMng);
+    Register(Target::Arch::X86, new CachingMemoryMng);
+  } else {
+    Register(Target::Arch::Unk, new X86MemoryMng);
+    Register(Target::Arch::X86, new X86MemoryMng);
+  }
 #ifdef CINN_WITH_CUDA
   Register(Target::Arch::NVGPU, new CudaMemoryMng);
 #endif
@@ -0,0 +1,105 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+StaticMemoryPlanner::StaticMemoryPlanner(uint64_t alignment) : alignment_(alignment) {
+  CHECK_GT(alignment_, 0UL);
+  CHECK_EQ(alignment_ & (alignment_ - 1), 0UL) << "The alignment should be a power of 2, but got " << alignment_;
+}
+
+void StaticMemoryPlanner::AddVariable(const std::string& name, uint64_t nbytes, int first_use, int last_use) {
+  CHECK_LE(first_use, last_use) << "Invalid lifetime of variable [" << name << "]";
+  variables_.push_back({name, nbytes, first_use, last_use});
+}
+
+MemoryPlan StaticMemoryPlanner::Plan() const {
+  MemoryPlan plan;
+  plan.alignment = alignment_;
+
+  // place the larger variables first, the earlier one goes first if sizes are equal
+  std::vector<const Lifetime*> order;
+  order.reserve(variables_.size());
+  for (auto& var : variables_) {
+    order.push_back(&var);
+    plan.naive_size += AlignUp(var.nbytes);
+  }
+  std::stable_sort(order.begin(), order.end(), [](const Lifetime* a, const Lifetime* b) {
+    if (a->nbytes != b->nbytes) return a->nbytes > b->nbytes;
+    return a->first_use < b->first_use;
+  });
+
+  // the placed variables, each one is (offset, aligned size, lifetime)
+  struct Placement {
+    uint64_t offset;
+    uint64_t nbytes;
+    const Lifetime* var;
+  };
+  std::vector<Placement> placed;
+  placed.reserve(order.size());
+
+  for (auto* var : order) {
+    uint64_t nbytes = AlignUp(var->nbytes);
+    // collect the placed variables alive at the same time, ordered by offset
+    std::vector<const Placement*> conflicts;
+    for (auto& p : placed) {
+      if (p.var->first_use <= var->last_use && var->first_use <= p.var->last_use) {
+        conflicts.push_back(&p);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const Placement* a, const Placement* b) {
+      return a->offset < b->offset;
+    });
+
+    // find the smallest gap between conflicting variables that can hold this one,
+    // or append it after the last conflicting variable if no such gap exists
+    uint64_t best_offset = std::numeric_limits<uint64_t>::max();
+    uint64_t best_gap    = std::numeric_limits<uint64_t>::max();
+    uint64_t cursor      = 0;
+    for (auto* p : conflicts) {
+      if (p->offset > cursor) {
+        uint64_t gap = p->offset - cursor;
+        if (gap >= nbytes && gap < best_gap) {
+          best_gap    = gap;
+          best_offset = cursor;
+        }
+      }
+      cursor = std::max(cursor, p->offset + p->nbytes);
+    }
+    if (best_offset == std::numeric_limits<uint64_t>::max()) {
+      best_offset = cursor;
+    }
+
+    placed.push_back({best_offset, nbytes, var});
+    plan.offsets[var->name] = best_offset;
+    plan.workspace_size     = std::max(plan.workspace_size, best_offset + nbytes);
+  }
+
+  VLOG(3) << "Static memory plan of " << variables_.size() << " variables: planned peak " << plan.workspace_size
+          << " bytes, naive sum " << plan.naive_size << " bytes";
+  return plan;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
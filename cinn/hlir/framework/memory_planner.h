@@ -0,0 +1,77 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The result of static memory planning: every planned variable is assigned an offset inside
+ * one workspace, whose total size is `workspace_size`.
+ */
+struct MemoryPlan {
+  // offset in bytes of each variable from the beginning of the workspace
+  std::unordered_map<std::string, uint64_t> offsets;
+  // the planned peak memory, that is the size of the workspace
+  uint64_t workspace_size = 0;
+  // the memory needed if every variable owns a separate buffer
+  uint64_t naive_size = 0;
+  // the alignment of each offset and the workspace itself
+  uint64_t alignment = 0;
+};
+
+/**
+ * StaticMemoryPlanner packs variables with known lifetimes into a single workspace so that
+ * variables whose lifetimes are disjoint can share the same memory.
+ *
+ * The lifetime of a variable is a closed interval [first_use, last_use] of instruction steps.
+ * Planning is the classic greedy-by-size offset assignment: variables are placed from the largest
+ * to the smallest, and each one is put into the best-fit gap left by the already placed variables
+ * whose lifetimes overlap with it.
+ */
+class StaticMemoryPlanner {
+ public:
+  explicit StaticMemoryPlanner(uint64_t alignment = 64);
+
+  //! Add a variable of \p nbytes which lives from step \p first_use to \p last_use (both inclusive).
+  void AddVariable(const std::string& name, uint64_t nbytes, int first_use, int last_use);
+
+  MemoryPlan Plan() const;
+
+  size_t size() const { return variables_.size(); }
+
+ private:
+  struct Lifetime {
+    std::string name;
+    uint64_t nbytes;
+    int first_use;
+    int last_use;
+  };
+
+  uint64_t AlignUp(uint64_t nbytes) const { return (nbytes + alignment_ - 1) / alignment_ * alignment_; }
+
+  uint64_t alignment_;
+  std::vector<Lifetime> variables_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
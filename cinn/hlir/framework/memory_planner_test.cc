@@ -0,0 +1,77 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(StaticMemoryPlanner, DisjointLifetimesShareMemory) {
+  StaticMemoryPlanner planner(64);
+  // a chain: a -> b -> c -> d, where only neighbours are alive at the same time
+  planner.AddVariable("a", 1000, 0, 1);
+  planner.AddVariable("b", 1000, 1, 2);
+  planner.AddVariable("c", 1000, 2, 3);
+  planner.AddVariable("d", 1000, 3, 4);
+  auto plan = planner.Plan();
+
+  ASSERT_EQ(plan.offsets.size(), 4UL);
+  EXPECT_EQ(plan.naive_size, 4UL * 1024);
+  EXPECT_EQ(plan.workspace_size, 2UL * 1024);
+  EXPECT_NE(plan.offsets.at("a"), plan.offsets.at("b"));
+  EXPECT_NE(plan.offsets.at("b"), plan.offsets.at("c"));
+  EXPECT_EQ(plan.offsets.at("a"), plan.offsets.at("c"));
+  EXPECT_EQ(plan.offsets.at("b"), plan.offsets.at("d"));
+}
+
+TEST(StaticMemoryPlanner, BestFitGap) {
+  StaticMemoryPlanner planner(64);
+  planner.AddVariable("large", 4096, 0, 2);
+  planner.AddVariable("medium", 2048, 0, 4);
+  planner.AddVariable("small", 1024, 3, 4);
+  auto plan = planner.Plan();
+
+  // 'small' reuses the memory of 'large' after it dies
+  EXPECT_EQ(plan.offsets.at("large"), 0UL);
+  EXPECT_EQ(plan.offsets.at("medium"), 4096UL);
+  EXPECT_EQ(plan.offsets.at("small"), 0UL);
+  EXPECT_EQ(plan.workspace_size, 4096UL + 2048);
+}
+
+TEST(StaticMemoryPlanner, OverlappedLifetimesNeverAlias) {
+  StaticMemoryPlanner planner(32);
+  for (int i = 0; i < 16; ++i) {
+    planner.AddVariable("var_" + std::to_string(i), 100 + 37 * i, i % 5, i % 5 + i % 3);
+  }
+  auto plan = planner.Plan();
+  ASSERT_EQ(plan.offsets.size(), 16UL);
+  EXPECT_LE(plan.workspace_size, plan.naive_size);
+  for (int i = 0; i < 16; ++i) {
+    for (int j = i + 1; j < 16; ++j) {
+      bool time_overlap = i % 5 <= j % 5 + j % 3 && j % 5 <= i % 5 + i % 3;
+      if (!time_overlap) continue;
+      size_t off_i = plan.offsets.at("var_" + std::to_string(i));
+      size_t off_j = plan.offsets.at("var_" + std::to_string(j));
+      EXPECT_TRUE(off_i + 100 + 37 * i <= off_j || off_j + 100 + 37 * j <= off_i) << i << " vs " << j;
+      EXPECT_EQ(off_i % 32, 0UL);
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -106,14 +106,19 @@ const std::vector<common::Shared<common::GraphEdge>>& Node::outlinks_in_order(bo
   return outlinks_in_order_;
 }
 
-NodeData* InsertGraphOpNodeAfter(
-    common::Graph* graph, Node* insert_node, NodeData* input_nodedata, Node* out_node, int pos) {
+NodeData* InsertGraphOpNodeAfter(common::Graph* graph,
+                                 Node* insert_node,
+                                 NodeData* input_nodedata,
+                                 Node* out_node,
+                                 int pos,
+                                 const std::string& out_id) {
   CHECK(graph);
   CHECK(insert_node);
   CHECK(input_nodedata);
   input_nodedata->Controls(insert_node);
   std::shared_ptr<Node> node_ptr(insert_node);
-  auto* out_nodedata = new NodeData(node_ptr, 0, 0, common::UniqName(insert_node->id() + "_out"));
+  auto* out_nodedata =
+      new NodeData(node_ptr, 0, 0, out_id.empty() ? common::UniqName(insert_node->id() + "_out") : out_id);
   insert_node->Controls(out_nodedata);
   std::vector<common::GraphNode*> old_sources;
   auto input_links = out_node->inlinks_in_order(true);
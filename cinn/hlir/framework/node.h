@@ -202,9 +202,18 @@ class NodeData : public common::GraphNode {
   bool is_const_ = false;
 };
 
-// insert op_node after input_data
-NodeData *InsertGraphOpNodeAfter(
-    common::Graph *graph, Node *insert_node, NodeData *input_nodedata, Node *dst_node, int pos);
+// insert op_node after input_data, the output is named out_id if not empty
+NodeData *InsertGraphOpNodeAfter(common::Graph *graph,
+                                 Node *insert_node,
+                                 NodeData *input_nodedata,
+                                 Node *dst_node,
+                                 int pos,
+                                 const std::string &out_id = "");
+// the name of a constant transformed into a packed format, which is the same in all the graphs, so that the packed
+// data is found in the scope shared by them
+inline std::string PrepackedVarName(const std::string &var, const std::string &format) {
+  return var + "_prepacked_" + format;
+}
 // insert op_node before out_data
 NodeData *InsertGraphOpNodeBefore(
     common::Graph *graph, Node *insert_node, Node *input_node, NodeData *dst_data, int pos);
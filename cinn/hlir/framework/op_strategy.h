@@ -39,6 +39,27 @@ using StrategyFunction = std::function<std::shared_ptr<OpStrategy>(const NodeAtt
 using InferShapeFunction =
     std::function<std::vector<std::vector<int>>(const std::vector<std::vector<int>>&, const AttrMapType&)>;
 
+//! The packed format of a constant input of an operator, into which the input is transformed once before running.
+struct WeightPrepack {
+  //! The name of the format, which names the packed variable together with the input.
+  std::string format;
+  //! The operator transforming the input into the packed format and its attributes.
+  std::string op_type;
+  AttrMapType attrs;
+  //! The attributes updated on the consumer to read the packed input.
+  AttrMapType consumer_attrs;
+  //! Whether the format depends on the CPU, e.g. the internal format of MKL, then the packed input is not exported.
+  bool machine_specific = false;
+};
+
+/**
+ * Declare the packed format of a constant input, registered as the "WeightPrepack" attribute of an operator.
+ * The arguments are the attributes of the node, the index and shape of the input, and the target.
+ * @return Whether the input is packed, the format is filled into the last argument if true.
+ */
+using WeightPrepackFunction =
+    std::function<bool(const NodeAttr&, int, const std::vector<int>&, const common::Target&, WeightPrepack*)>;
+
 //! Operator implementation that includes compute and schedule function.
 class OpImpl : public common::Object {
  public:
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/parallel_executor.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <utility>
+
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+InstructionDependencies InstructionDependencies::Build(
+    const std::vector<std::unique_ptr<Instruction>>& instrs,
+    const std::function<std::string(const std::string&)>& resource_of) {
+  auto get_resource = [&resource_of](const std::string& name) { return resource_of ? resource_of(name) : name; };
+
+  InstructionDependencies deps;
+  deps.successors.resize(instrs.size());
+  deps.num_predecessors.resize(instrs.size(), 0);
+
+  absl::flat_hash_map<std::string, int> last_writer;
+  absl::flat_hash_map<std::string, std::vector<int>> readers_after_write;
+  for (int i = 0; i < instrs.size(); ++i) {
+    std::set<std::string> reads, writes;
+    for (const auto& args : instrs[i]->GetInArgs()) {
+      for (const auto& name : args) {
+        reads.insert(get_resource(name));
+      }
+    }
+    for (const auto& args : instrs[i]->GetOutArgs()) {
+      for (const auto& name : args) {
+        writes.insert(get_resource(name));
+      }
+    }
+
+    std::set<int> predecessors;
+    for (const auto& res : reads) {
+      auto it = last_writer.find(res);
+      if (it != last_writer.end()) predecessors.insert(it->second);
+    }
+    for (const auto& res : writes) {
+      auto it = last_writer.find(res);
+      if (it != last_writer.end()) predecessors.insert(it->second);
+      for (int reader : readers_after_write[res]) {
+        if (reader != i) predecessors.insert(reader);
+      }
+    }
+    for (int pred : predecessors) {
+      deps.successors[pred].push_back(i);
+    }
+    deps.num_predecessors[i] = predecessors.size();
+
+    for (const auto& res : reads) {
+      readers_after_write[res].push_back(i);
+    }
+    for (const auto& res : writes) {
+      last_writer[res] = i;
+      readers_after_write[res].clear();
+    }
+  }
+  return deps;
+}
+
+ParallelExecutor::ParallelExecutor(const std::vector<std::unique_ptr<Instruction>>* instrs,
+                                   InstructionDependencies dependencies,
+                                   int concurrency)
+    : instrs_(instrs), dependencies_(std::move(dependencies)) {
+  CHECK(instrs_);
+  CHECK_EQ(instrs_->size(), dependencies_.successors.size());
+  CHECK_GT(concurrency, 0);
+  int intra_op_concurrency = std::max(1, max_concurrency() / concurrency);
+  VLOG(3) << "ParallelExecutor runs " << instrs_->size() << " instructions with inter-op concurrency " << concurrency
+          << " and intra-op concurrency " << intra_op_concurrency;
+  pool_.reset(new utils::ThreadPool(
+      concurrency, [intra_op_concurrency](int) { cinn_backend_set_thread_concurrency(intra_op_concurrency); }));
+}
+
+void ParallelExecutor::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+  std::vector<std::atomic<int>> remaining(instrs_->size());
+  for (int i = 0; i < instrs_->size(); ++i) {
+    remaining[i] = dependencies_.num_predecessors[i];
+  }
+
+  std::function<void(int)> run_instr = [&](int i) {
+    instrs_->at(i)->Run(name2podargs, false, stream, use_cache);
+    for (int succ : dependencies_.successors[i]) {
+      if (--remaining[succ] == 0) {
+        pool_->Submit([&run_instr, succ]() { run_instr(succ); });
+      }
+    }
+  };
+
+  for (int i = 0; i < instrs_->size(); ++i) {
+    if (dependencies_.num_predecessors[i] == 0) {
+      pool_->Submit([&run_instr, i]() { run_instr(i); });
+    }
+  }
+  pool_->Wait();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/utils/thread_pool.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The dependencies between instructions deduced from the variables they read and write.
+ * An instruction depends on the last writer of each variable it reads(RAW), and the last writer and
+ * the readers after it of each variable it writes(WAW and WAR).
+ */
+struct InstructionDependencies {
+  // successors[i] are the instructions that can only start after the i-th instruction finished
+  std::vector<std::vector<int>> successors;
+  // the number of instructions the i-th instruction depends on
+  std::vector<int> num_predecessors;
+
+  /**
+   * Build the dependencies of instructions.
+   * @param instrs The instructions in the serial execution order.
+   * @param resource_of Map a variable name to the name of the memory it resides in, variables sharing
+   * the same memory must be mapped to the same name. The variable name itself is used if it is null.
+   */
+  static InstructionDependencies Build(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                                       const std::function<std::string(const std::string&)>& resource_of = nullptr);
+};
+
+/**
+ * ParallelExecutor runs the instructions of a Program on a work-stealing thread pool, an instruction is
+ * dispatched as soon as all the instructions it depends on finished, so independent instructions, such
+ * as the branches of Inception-style blocks, run at the same time.
+ *
+ * Each instruction still runs on exactly one thread, and the intra-op parallelism inside it is limited
+ * to max_concurrency() / concurrency threads to avoid oversubscribing the cores.
+ */
+class ParallelExecutor {
+ public:
+  /**
+   * Constructor.
+   * @param instrs The instructions to execute, which should outlive this executor.
+   * @param dependencies The dependencies between the instructions.
+   * @param concurrency The number of instructions allowed to run at the same time.
+   */
+  ParallelExecutor(const std::vector<std::unique_ptr<Instruction>>* instrs,
+                   InstructionDependencies dependencies,
+                   int concurrency);
+
+  void Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+
+  int concurrency() const { return pool_->num_threads(); }
+
+ private:
+  const std::vector<std::unique_ptr<Instruction>>* instrs_;
+  InstructionDependencies dependencies_;
+  std::unique_ptr<utils::ThreadPool> pool_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/parallel_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// out = in + 1, the arguments are (in, out)
+static void AddOne(void* args, int num_args) {
+  auto* pod_args = static_cast<cinn_pod_value_t*>(args);
+  auto* in       = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[0])->memory);
+  auto* out      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[1])->memory);
+  for (int i = 0; i < 1024; ++i) {
+    out[i] = in[i] + 1.f;
+  }
+}
+
+// out = lhs + rhs, the arguments are (lhs, rhs, out)
+static void Add(void* args, int num_args) {
+  auto* pod_args = static_cast<cinn_pod_value_t*>(args);
+  auto* lhs      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[0])->memory);
+  auto* rhs      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[1])->memory);
+  auto* out      = reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(pod_args[2])->memory);
+  for (int i = 0; i < 1024; ++i) {
+    out[i] = lhs[i] + rhs[i];
+  }
+}
+
+std::unique_ptr<Instruction> MakeInstruction(Scope* scope,
+                                             const std::vector<std::string>& in_args,
+                                             const std::vector<std::string>& out_args,
+                                             lower_func_ptr_t fn) {
+  auto instr = std::make_unique<Instruction>(common::DefaultHostTarget(), scope, in_args, out_args, "test");
+  instr->SetLoweredFunc(fn, "test");
+  instr->Finalize();
+  return instr;
+}
+
+// A -> (B, C) -> D -> E, and E overwrites the input of B
+std::vector<std::unique_ptr<Instruction>> BuildDiamond(Scope* scope) {
+  for (auto& name : std::vector<std::string>({"A", "B", "C", "D", "E"})) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape{{1024}});
+    auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+    std::fill(data, data + 1024, 0.f);
+  }
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  instrs.emplace_back(MakeInstruction(scope, {"A"}, {"B"}, AddOne));
+  instrs.emplace_back(MakeInstruction(scope, {"A"}, {"C"}, AddOne));
+  instrs.emplace_back(MakeInstruction(scope, {"B", "C"}, {"D"}, Add));
+  instrs.emplace_back(MakeInstruction(scope, {"D"}, {"A"}, AddOne));
+  return instrs;
+}
+
+TEST(InstructionDependencies, Diamond) {
+  Scope scope;
+  auto instrs = BuildDiamond(&scope);
+  auto deps   = InstructionDependencies::Build(instrs);
+
+  EXPECT_EQ(deps.num_predecessors, std::vector<int>({0, 0, 2, 3}));
+  EXPECT_EQ(deps.successors[0], std::vector<int>({2, 3}));
+  EXPECT_EQ(deps.successors[1], std::vector<int>({2, 3}));
+  EXPECT_EQ(deps.successors[2], std::vector<int>({3}));
+  EXPECT_TRUE(deps.successors[3].empty());
+}
+
+TEST(InstructionDependencies, SharedResource) {
+  Scope scope;
+  auto instrs = BuildDiamond(&scope);
+  // B and C share the same memory, so the two branches can not run at the same time
+  auto deps = InstructionDependencies::Build(instrs, [](const std::string& name) { return name == "C" ? "B" : name; });
+  EXPECT_EQ(deps.num_predecessors, std::vector<int>({0, 1, 1, 3}));
+}
+
+TEST(ParallelExecutor, Diamond) {
+  Scope scope;
+  auto instrs = BuildDiamond(&scope);
+  ParallelExecutor executor(&instrs, InstructionDependencies::Build(instrs), 2);
+  for (int round = 1; round <= 10; ++round) {
+    executor.Run(nullptr, nullptr, true);
+    // A(k+1) = 2 * A(k) + 3
+    auto* a = scope.GetTensor("A")->data<float>();
+    auto* d = scope.GetTensor("D")->data<float>();
+    float expected_a = 0.f;
+    for (int i = 0; i < round; ++i) expected_a = 2 * expected_a + 3;
+    EXPECT_EQ(a[0], expected_a);
+    EXPECT_EQ(a[1023], expected_a);
+    EXPECT_EQ(d[512], expected_a - 1);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -15,6 +15,7 @@
 #include "cinn/hlir/framework/pass.h"
 
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace hlir {
@@ -37,6 +38,7 @@ void ApplyPasses(Graph* g, const std::vector<std::string>& passes) {
         CHECK(!pass_dep) << "And the attribute is provided by pass [" << pass_dep->name << "].";
       }
     }
+    utils::RecordEvent record_pass("GraphPass " + r->name, utils::EventType::kCompilePhase);
     r->body(g);
   }
 }
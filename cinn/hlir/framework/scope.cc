@@ -23,6 +23,7 @@ namespace framework {
 void Scope::EraseVar(const std::string& name) {
   CHECK(data_.count(name)) << "Variable(" << name << ") not found";
   data_.erase(name);
+  prepacked_.erase(name);
 }
 
 Variable* Scope::FindVar(const std::string& name) const {
@@ -46,6 +47,31 @@ std::vector<absl::string_view> Scope::var_names() const {
   return names;
 }
 
+void Scope::MarkPrepacked(const std::string& name, const DataVersion& source_version) {
+  CHECK(data_.count(name)) << "Variable(" << name << ") not found";
+  prepacked_[name] = source_version;
+}
+
+bool Scope::IsPrepacked(const std::string& name) const {
+  if (!prepacked_.count(name)) return false;
+  auto* var = FindVar(name);
+  return var && absl::get<Tensor>(*var)->buffer()->memory;
+}
+
+bool Scope::IsPrepacked(const std::string& name, const DataVersion& source_version) const {
+  auto it = prepacked_.find(name);
+  return it != prepacked_.end() && it->second == source_version && IsPrepacked(name);
+}
+
+Scope::DataVersion Scope::GetDataVersion(const std::vector<std::string>& names) const {
+  DataVersion version;
+  for (auto& name : names) {
+    auto buffer = GetTensor(name)->get_buffer();
+    version.emplace_back(buffer.get(), buffer->generation());
+  }
+  return version;
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
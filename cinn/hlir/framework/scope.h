@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/macros.h"
@@ -52,10 +53,32 @@ class Scope {
   //! Get variable names.
   std::vector<absl::string_view> var_names() const;
 
+  //! The version of the data of some variables, which is the buffer of each variable and the generation of its data.
+  using DataVersion = std::vector<std::pair<const Buffer*, uint64_t>>;
+
+  /**
+   * Mark a variable computed from the constants before running, e.g. a weight transformed into a packed format, with
+   * the version of the data of the constants, so that the programs on this scope reuse its data instead of computing
+   * it again until the constants are written through Tensor::mutable_data or bound to other buffers. The mark is
+   * removed with the variable.
+   */
+  void MarkPrepacked(const std::string& name, const DataVersion& source_version);
+
+  //! Whether the variable is marked as prepacked and holds the data.
+  bool IsPrepacked(const std::string& name) const;
+
+  //! Whether the variable holds the data prepacked from the constants of the version.
+  bool IsPrepacked(const std::string& name, const DataVersion& source_version) const;
+
+  //! The version of the data of the variables.
+  DataVersion GetDataVersion(const std::vector<std::string>& names) const;
+
   Scope() = default;
 
  private:
   absl::flat_hash_map<std::string, std::unique_ptr<Variable>> data_;
+  //! The prepacked variables and the versions of their constants.
+  absl::flat_hash_map<std::string, DataVersion> prepacked_;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Scope);
 };
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -40,6 +42,29 @@ TEST(ScopeTest, TestEraseVar) {
   ASSERT_DEATH(scope.EraseVar("key"), "");
 }
 
+TEST(ScopeTest, Prepacked) {
+  Scope scope;
+  auto target = common::DefaultHostTarget();
+  for (auto& name : {"weight", "packed"}) {
+    auto tensor = absl::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape{{4}});
+    tensor->mutable_data<float>(target);
+  }
+  auto version = scope.GetDataVersion({"weight"});
+  scope.MarkPrepacked("packed", version);
+  EXPECT_TRUE(scope.IsPrepacked("packed", version));
+  // reading the weight keeps its version
+  EXPECT_EQ(scope.GetDataVersion({"weight"}), version);
+  EXPECT_TRUE(scope.IsPrepacked("packed", scope.GetDataVersion({"weight"})));
+
+  // writing or rebinding the weight changes its version
+  scope.GetTensor("weight")->mutable_data<float>(target)[0] = 1.f;
+  EXPECT_FALSE(scope.IsPrepacked("packed", scope.GetDataVersion({"weight"})));
+  scope.MarkPrepacked("packed", scope.GetDataVersion({"weight"}));
+  scope.GetTensor("weight")->set_buffer(std::make_shared<Buffer>(target));
+  EXPECT_FALSE(scope.IsPrepacked("packed", scope.GetDataVersion({"weight"})));
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -63,10 +63,11 @@ class _Tensor_ : public Object {
 
   inline void* mutable_data(const Target& target, const Type& type) {
     set_type(type);
+    buffer_->NewGeneration();
     if (target == common::DefaultHostTarget()) {
-      buffer_->ResizeLazy(1024, (shape_.numel() * type.bits() + 7) / 8, target);
+      buffer_->ResizeLazy(1024, (static_cast<uint64_t>(shape_.numel()) * type.bits() + 7) / 8, target);
     } else {
-      buffer_->ResizeLazy((shape_.numel() * type.bits() + 7) / 8, target);
+      buffer_->ResizeLazy((static_cast<uint64_t>(shape_.numel()) * type.bits() + 7) / 8, target);
     }
     return reinterpret_cast<void*>(buffer_->data()->memory);
   }
@@ -74,10 +75,11 @@ class _Tensor_ : public Object {
   template <typename T>
   inline T* mutable_data(const Target& target) {
     set_type(type_of<T>());
+    buffer_->NewGeneration();
     if (target == common::DefaultHostTarget()) {
-      buffer_->ResizeLazy(1024, shape_.numel() * sizeof(T), target);
+      buffer_->ResizeLazy(1024, static_cast<uint64_t>(shape_.numel()) * sizeof(T), target);
     } else {
-      buffer_->ResizeLazy(shape_.numel() * sizeof(T), target);
+      buffer_->ResizeLazy(static_cast<uint64_t>(shape_.numel()) * sizeof(T), target);
     }
     return reinterpret_cast<T*>(buffer_->data()->memory);
   }
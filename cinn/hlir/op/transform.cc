@@ -22,6 +22,7 @@
 #include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/runtime/cpu/fused_gemm.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
@@ -923,6 +924,257 @@ std::vector<Type> InferDtypeForCublasGemm(const std::vector<Type> &inputs_type,
   return {inputs_type[0]};
 }
 
+std::shared_ptr<OpStrategy> StrategyForCpuGemm(const framework::NodeAttr &attrs,
+                                               const std::vector<ir::Tensor> &inputs,
+                                               const std::vector<Type> &out_type,
+                                               const std::vector<std::vector<int>> &output_shapes,
+                                               const Target &target) {
+  framework::CINNCompute gemm_compute([attrs, target](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input `args` of cpu_gemm is empty! Please check.";
+    auto &attr_store       = attrs.attr_store;
+    bool trans_a           = false;
+    bool trans_b           = false;
+    float alpha            = 1.f;
+    float beta             = 1.f;
+    bool has_bias          = false;
+    bool has_residual      = false;
+    std::string activation = "";
+    // the shape of B if it has been packed by cpu_gemm_pack_b
+    std::vector<int> packed_b_shape;
+    if (attr_store.count("trans_a")) {
+      trans_a = absl::get<bool>(attr_store.at("trans_a"));
+    }
+    if (attr_store.count("trans_b")) {
+      trans_b = absl::get<bool>(attr_store.at("trans_b"));
+    }
+    if (attr_store.count("alpha")) {
+      alpha = absl::get<float>(attr_store.at("alpha"));
+    }
+    if (attr_store.count("beta")) {
+      beta = absl::get<float>(attr_store.at("beta"));
+    }
+    if (attr_store.count("has_bias")) {
+      has_bias = absl::get<bool>(attr_store.at("has_bias"));
+    }
+    if (attr_store.count("has_residual")) {
+      has_residual = absl::get<bool>(attr_store.at("has_residual"));
+    }
+    if (attr_store.count("activation")) {
+      activation = absl::get<std::string>(attr_store.at("activation"));
+    }
+    if (attr_store.count("packed_b_shape")) {
+      packed_b_shape = absl::get<std::vector<int>>(attr_store.at("packed_b_shape"));
+    }
+
+    CINNValuePack input_args = args[0];
+    CHECK_EQ(input_args.size(), 2U + has_bias + has_residual)
+        << "The input number of cpu_gemm does not match its attrs has_bias and has_residual.";
+    std::vector<ir::Tensor> input_tensors;
+    for (int i = 0; i < input_args.size(); ++i) {
+      Expr input = input_args[i];
+      CHECK(input.as_tensor());
+      input_tensors.push_back(input.as_tensor_ref());
+    }
+    ir::Tensor bias     = has_bias ? input_tensors[2] : ir::Tensor();
+    ir::Tensor residual = has_residual ? input_tensors.back() : ir::Tensor();
+
+    auto stages = CreateStages(input_tensors);
+    std::vector<ir::Tensor> out;
+    if (packed_b_shape.empty()) {
+      out = pe::FusedGemmCPU(input_tensors[0],
+                             input_tensors[1],
+                             bias,
+                             residual,
+                             trans_a,
+                             trans_b,
+                             alpha,
+                             beta,
+                             activation,
+                             UniqName("cpu_gemm_output"),
+                             target);
+    } else {
+      CHECK_EQ(packed_b_shape.size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+      out = pe::FusedGemmPackedCPU(input_tensors[0],
+                                   input_tensors[1],
+                                   bias,
+                                   residual,
+                                   trans_a,
+                                   Expr(trans_b ? packed_b_shape[0] : packed_b_shape[1]),
+                                   alpha,
+                                   beta,
+                                   activation,
+                                   UniqName("cpu_gemm_output"),
+                                   target);
+    }
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule gemm_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input `args` is empty! Please check again.";
+    CINNValuePack arg_pack = args[0];
+    // the output and the extern call, nothing to schedule
+    CHECK_EQ(arg_pack.size(), 3UL) << "Expected 3 values in args[0] for gemm_schedule.";
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(target.arch == Target::Arch::X86) << "cpu_gemm only supports the X86 target.";
+  strategy->AddImpl(gemm_compute, gemm_schedule, "strategy.cpu_gemm.x86", 1);
+
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForCpuGemm(const std::vector<std::vector<int>> &input_shapes,
+                                          const framework::AttrMapType &attrs) {
+  bool trans_a      = false;
+  bool trans_b      = false;
+  bool has_bias     = false;
+  bool has_residual = false;
+  if (attrs.count("trans_a")) {
+    trans_a = absl::get<bool>(attrs.at("trans_a"));
+  }
+  if (attrs.count("trans_b")) {
+    trans_b = absl::get<bool>(attrs.at("trans_b"));
+  }
+  if (attrs.count("has_bias")) {
+    has_bias = absl::get<bool>(attrs.at("has_bias"));
+  }
+  if (attrs.count("has_residual")) {
+    has_residual = absl::get<bool>(attrs.at("has_residual"));
+  }
+  CHECK_EQ(input_shapes.size(), 2U + has_bias + has_residual)
+      << "The input number of cpu_gemm does not match its attrs has_bias and has_residual.";
+  // the packed B is checked by the shape it is packed from
+  shape_t b_shape = input_shapes[1];
+  if (attrs.count("packed_b_shape")) {
+    b_shape = absl::get<std::vector<int>>(attrs.at("packed_b_shape"));
+  }
+  CHECK_EQ(input_shapes[0].size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+  CHECK_EQ(b_shape.size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+  int K = trans_a ? input_shapes[0][0] : input_shapes[0][1];
+  CHECK_EQ(K, trans_b ? b_shape[1] : b_shape[0]) << "matrix multiplication requires x_width to be same with y_height";
+  shape_t out_shape = {trans_a ? input_shapes[0][1] : input_shapes[0][0], trans_b ? b_shape[0] : b_shape[1]};
+  if (has_bias) {
+    auto &bias_shape = input_shapes[2];
+    CHECK(bias_shape == out_shape || bias_shape == shape_t{out_shape[1]} || bias_shape == shape_t{1, out_shape[1]})
+        << "The bias of cpu_gemm should be [N], [1, N] or [M, N].";
+  }
+  if (has_residual) {
+    CHECK(input_shapes.back() == out_shape) << "The residual of cpu_gemm should be [M, N].";
+  }
+  // the second output is the extern call
+  return {out_shape, {1}};
+}
+
+std::vector<Type> InferDtypeForCpuGemm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForCpuGemm(const std::vector<framework::shape_t> &input_shapes,
+                                                            const std::vector<std::string> &input_layouts,
+                                                            const framework::NodeAttr &attrs,
+                                                            const Target &target) {
+  return {{"", ""}, input_layouts};
+}
+
+bool PrepackForCpuGemm(const framework::NodeAttr &attrs,
+                       int input_index,
+                       const std::vector<int> &input_shape,
+                       const Target &target,
+                       framework::WeightPrepack *prepack) {
+  CHECK(prepack);
+  if (input_index == 1) {
+    // the constant B is packed into the format of the product, instead of being packed on every run
+    CHECK_EQ(input_shape.size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+    bool trans_b = false;
+    if (attrs.attr_store.count("trans_b")) {
+      trans_b = absl::get<bool>(attrs.attr_store.at("trans_b"));
+    }
+    prepack->format                           = trans_b ? "gemm_packed_trans" : "gemm_packed";
+    prepack->op_type                          = "cpu_gemm_pack_b";
+    prepack->attrs["trans_b"]                 = trans_b;
+    prepack->consumer_attrs["packed_b_shape"] = input_shape;
+#ifdef CINN_WITH_MKL_CBLAS
+    // the internal format of MKL depends on the CPU
+    prepack->machine_specific = true;
+#endif
+    return true;
+  }
+  // the transposed constant A is transposed back before running, so that the product reads it by rows
+  if (input_index != 0 || !attrs.attr_store.count("trans_a") || !absl::get<bool>(attrs.attr_store.at("trans_a"))) {
+    return false;
+  }
+  CHECK_EQ(input_shape.size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+  prepack->format                    = "transposed";
+  prepack->op_type                   = "transpose";
+  prepack->attrs["axis"]             = std::vector<int>{1, 0};
+  prepack->consumer_attrs["trans_a"] = false;
+  return true;
+}
+
+std::shared_ptr<OpStrategy> StrategyForCpuGemmPackB(const framework::NodeAttr &attrs,
+                                                    const std::vector<ir::Tensor> &inputs,
+                                                    const std::vector<Type> &out_type,
+                                                    const std::vector<std::vector<int>> &output_shapes,
+                                                    const Target &target) {
+  framework::CINNCompute pack_b_compute([attrs, target](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input `args` of cpu_gemm_pack_b is empty! Please check.";
+    bool trans_b = false;
+    if (attrs.attr_store.count("trans_b")) {
+      trans_b = absl::get<bool>(attrs.attr_store.at("trans_b"));
+    }
+    CINNValuePack input_args = args[0];
+    CHECK_EQ(input_args.size(), 1U) << "The input number of cpu_gemm_pack_b should be 1.";
+    Expr B = input_args[0];
+    CHECK(B.as_tensor());
+
+    auto stages = CreateStages({B.as_tensor_ref()});
+    auto out    = pe::FusedGemmPackBCPU(B.as_tensor_ref(), trans_b, UniqName("cpu_gemm_pack_b_output"), target);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule pack_b_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input `args` is empty! Please check again.";
+    CINNValuePack arg_pack = args[0];
+    // the output and the extern call, nothing to schedule
+    CHECK_EQ(arg_pack.size(), 3UL) << "Expected 3 values in args[0] for pack_b_schedule.";
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(target.arch == Target::Arch::X86) << "cpu_gemm_pack_b only supports the X86 target.";
+  strategy->AddImpl(pack_b_compute, pack_b_schedule, "strategy.cpu_gemm_pack_b.x86", 1);
+
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForCpuGemmPackB(const std::vector<std::vector<int>> &input_shapes,
+                                               const framework::AttrMapType &attrs) {
+  CHECK_EQ(input_shapes.size(), 1U) << "The input number of cpu_gemm_pack_b should be 1.";
+  CHECK_EQ(input_shapes[0].size(), 2U) << "cpu_gemm only supports the two-dim matrix multiply";
+  bool trans_b = false;
+  if (attrs.count("trans_b")) {
+    trans_b = absl::get<bool>(attrs.at("trans_b"));
+  }
+  int K = trans_b ? input_shapes[0][1] : input_shapes[0][0];
+  int N = trans_b ? input_shapes[0][0] : input_shapes[0][1];
+  // the second output is the extern call
+  return {{cinn_cpu_fused_gemm_packed_b_size(N, K)}, {1}};
+}
+
 std::shared_ptr<OpStrategy> StrategyForLayoutTransform(const framework::NodeAttr &attrs,
                                                        const std::vector<ir::Tensor> &inputs,
                                                        const std::vector<Type> &out_type,
@@ -1983,6 +2235,32 @@ CINN_REGISTER_HELPER(transform_ops) {
       .set_support_level(4);
 #endif
 
+  CINN_REGISTER_OP(cpu_gemm)
+      .describe(
+          "This operator computes act(alpha * op(A) * op(B) + beta * bias) + residual on CPU in one call, the bias and "
+          "residual are optional.")
+      .set_num_inputs(4)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCpuGemm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCpuGemm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCpuGemm))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForCpuGemm))
+      .set_attr<cinn::hlir::framework::WeightPrepackFunction>("WeightPrepack", cinn::hlir::op::PrepackForCpuGemm)
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(cpu_gemm_pack_b)
+      .describe(
+          "This operator packs op(B) of cpu_gemm into the format of its product, so that a constant B is packed once. "
+          "The format depends on the CPU if CINN is built with MKL.")
+      .set_num_inputs(1)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCpuGemmPackB)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCpuGemmPackB))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCpuGemm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(layout_transform)
       .describe("This operator is used to transform op's layouts")
       .set_num_inputs(1)
@@ -47,14 +47,16 @@ std::tuple<Node*, NodeData*> InsertLayoutTransformNodeAfter(Graph* graph,
                                                             int pos,
                                                             const std::string& src_layout,
                                                             const std::string& dst_layout,
-                                                            const std::string& name) {
+                                                            const std::string& name,
+                                                            const std::string& out_id = "") {
   CHECK(graph);
   CHECK(input_data);
   std::string op_type                           = "layout_transform";
   auto trans_node                               = new Node(Operator::Get(op_type), op_type, name);
   trans_node->attrs.attr_store["src_layout"]    = src_layout;
   trans_node->attrs.attr_store["dst_layout"]    = dst_layout;
-  auto output_data                              = InsertGraphOpNodeAfter(graph, trans_node, input_data, dst_node, pos);
+  auto output_data                              = InsertGraphOpNodeAfter(
+      graph, trans_node, input_data, dst_node, pos, out_id);
   trans_node->attrs.attr_store["input_layouts"] = {src_layout};
   trans_node->attrs.attr_store["out_layouts"]   = {dst_layout};
   return std::make_tuple(trans_node, output_data);
@@ -301,6 +303,12 @@ void AlterLayoutPass(Graph* graph) {
             // insert weight layout_transform
             auto weight_data = weight_node->safe_as<NodeData>();
             CHECK(weight_data);
+            // the constant weight transformed is named by its layout, so that it is packed once in the shared scope
+            std::string weight_out_id;
+            if (weight_data->is_const() &&
+                !graph->RetrieveNode(framework::PrepackedVarName(weight_data->id(), dst_kernel_layout))) {
+              weight_out_id = framework::PrepackedVarName(weight_data->id(), dst_kernel_layout);
+            }
             NodeData* output_data;
             std::tie(weight_trans_node, output_data) =
                 InsertLayoutTransformNodeAfter(graph,
@@ -309,7 +317,8 @@ void AlterLayoutPass(Graph* graph) {
                                                1,
                                                src_kernel_layout,
                                                dst_kernel_layout,
-                                               common::UniqName(node->op()->name + "_weight_layout_tranform"));
+                                               common::UniqName(node->op()->name + "_weight_layout_tranform"),
+                                               weight_out_id);
             UpdateInferInfos(weight_trans_node,
                              {weight_shape},
                              {weight_type},
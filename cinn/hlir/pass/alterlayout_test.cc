@@ -15,7 +15,9 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
 
+#include "absl/strings/match.h"
 #include "cinn/cinn.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph.h"
@@ -460,5 +462,59 @@ TEST(conv_mul_conv, conv_mul_conv) {
   runtime_program->Execute();
 }
 
+TEST(conv, const_weight_packed_once) {
+  Placeholder A(Float(32), {1, 3, 56, 56}, "A");
+  Placeholder B(Float(32), {64, 3, 3, 3}, "B", true);
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["data_format"] = std::string("NCHW");
+  auto c               = program.conv2d(A, B, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+
+  // the layout_transform of the constant weight runs before the programs built on the same scope
+  std::shared_ptr<Scope> scope;
+  auto build_program = [&]() {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+    hlir::framework::ApplyPass(graph.get(), "InferShape");
+    hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+    hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+    scope = BuildScope(target, graph, scope);
+    hlir::framework::GraphCompiler gc(target, scope, graph);
+    return gc.Build();
+  };
+  auto runtime_program = build_program();
+  ASSERT_EQ(runtime_program->GetPreRunInstructions().size(), 1);
+  std::string packed_name;
+  for (auto& name : scope->var_names()) {
+    if (absl::StartsWith(name, hlir::framework::PrepackedVarName("B", "OIHW"))) {
+      packed_name = std::string(name);
+    }
+  }
+  ASSERT_FALSE(packed_name.empty());
+
+  SetRandData(scope->GetTensor("A"), target);
+  SetRandData(scope->GetTensor("B"), target);
+  runtime_program->PreRun();
+  ASSERT_TRUE(scope->IsPrepacked(packed_name));
+  runtime_program->Execute();
+
+  // the weight is not packed again for the second program, which keeps a mark not computed from it
+  auto packed      = scope->GetTensor(packed_name);
+  auto* packed_mem = packed->buffer()->memory;
+  packed->mutable_data<float>(target)[0] = -1.f;
+
+  auto runtime_program2 = build_program();
+  runtime_program2->PreRun();
+  ASSERT_EQ(scope->GetTensor(packed_name)->buffer()->memory, packed_mem);
+  ASSERT_EQ(scope->GetTensor(packed_name)->data<float>()[0], -1.f);
+}
+
 }  // namespace frontend
 }  // namespace cinn
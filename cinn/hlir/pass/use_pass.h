@@ -20,6 +20,7 @@ CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
 CINN_USE_REGISTER(AlterLayout)
 CINN_USE_REGISTER(ConstPropagate)
+CINN_USE_REGISTER(WeightPrepack)
 
 CINN_USE_REGISTER(OpFusionPass)
 CINN_USE_REGISTER(FusionMergePass)
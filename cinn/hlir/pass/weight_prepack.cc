@@ -0,0 +1,159 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_set>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_machine_specific_prepack);
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+using framework::WeightPrepack;
+using framework::WeightPrepackFunction;
+
+using InferShapeFunc = std::function<std::vector<framework::shape_t>(const std::vector<framework::shape_t>&,
+                                                                    const framework::AttrMapType&)>;
+using InferTypeFunc  = std::function<std::vector<Type>(const std::vector<Type>&, const framework::AttrMapType&)>;
+
+namespace {
+
+// Replace the pos-th input of the node and keep the order of the others
+void ReplaceInput(Node* node, int pos, NodeData* new_input) {
+  std::vector<common::GraphNode*> sources;
+  for (auto& link : node->inlinks_in_order(true)) {
+    sources.push_back(link->source());
+  }
+  for (auto* source : sources) {
+    source->UnLinkSingleTo(node);
+  }
+  for (int i = 0; i < sources.size(); ++i) {
+    if (i == pos) {
+      new_input->LinkTo(node);
+    } else {
+      sources[i]->LinkTo(node);
+    }
+  }
+}
+
+}  // namespace
+
+void WeightPrepackPass(Graph* graph) {
+  auto& op_prepack    = Operator::GetAttrs<WeightPrepackFunction>("WeightPrepack");
+  auto& op_infershape = Operator::GetAttrs<InferShapeFunc>("infershape");
+  auto& op_inferdtype = Operator::GetAttrs<InferTypeFunc>("inferdtype");
+  auto& shape_dict    = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
+  auto& type_dict     = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+
+  auto store_nodes = std::get<0>(graph->topological_order());
+  for (auto& graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || !op_prepack.Find(node->op()) || !op_prepack[node->op()]) {
+      continue;
+    }
+    // copy the links, which are changed by the insertion
+    auto inlinks = node->inlinks_in_order(true);
+    for (int i = 0; i < inlinks.size(); ++i) {
+      auto* weight = inlinks[i]->source()->safe_as<NodeData>();
+      CHECK(weight);
+      if (!weight->is_const()) {
+        continue;
+      }
+      CHECK(shape_dict.count(weight->id())) << weight->id() << " finds no infershape";
+      CHECK(type_dict.count(weight->id())) << weight->id() << " finds no infertype";
+      WeightPrepack prepack;
+      if (!op_prepack[node->op()](node->attrs, i, shape_dict.at(weight->id()), graph->target_, &prepack) ||
+          (prepack.machine_specific && !FLAGS_cinn_machine_specific_prepack)) {
+        continue;
+      }
+
+      std::string packed_id = framework::PrepackedVarName(weight->id(), prepack.format);
+      auto* packed          = graph->RetrieveNode(packed_id);
+      if (packed) {
+        // the weight has been packed into the same format for another consumer
+        CHECK(packed->safe_as<NodeData>()) << packed_id << " is not a variable";
+        ReplaceInput(node, i, packed->safe_as<NodeData>());
+      } else {
+        auto* pack_node = new Node(
+            Operator::Get(prepack.op_type), prepack.op_type, common::UniqName(prepack.op_type + "_prepack"));
+        pack_node->attrs.attr_store            = prepack.attrs;
+        pack_node->attrs.attr_store["pre_run"] = true;
+        auto* packed_data = framework::InsertGraphOpNodeAfter(graph, pack_node, weight, node, i, packed_id);
+        packed_data->set_const(true);
+
+        CHECK(op_infershape[pack_node->op()]) << "find no InferShape function for op " << prepack.op_type;
+        CHECK(op_inferdtype[pack_node->op()]) << "find no InferDtype function for op " << prepack.op_type;
+        auto out_shapes = op_infershape[pack_node->op()]({shape_dict.at(weight->id())}, pack_node->attrs.attr_store);
+        auto out_types  = op_inferdtype[pack_node->op()]({type_dict.at(weight->id())}, pack_node->attrs.attr_store);
+        CHECK(!out_shapes.empty()) << "The packing op " << prepack.op_type << " has no output";
+        CHECK_EQ(out_shapes.size(), out_types.size()) << "The packing op " << prepack.op_type
+                                                      << " infers different numbers of shapes and dtypes";
+        shape_dict[packed_id] = out_shapes[0];
+        type_dict[packed_id]  = out_types[0];
+        // the first output is the packed one, the others are kept as the outputs of the op, e.g. the extern call
+        for (int k = 1; k < out_shapes.size(); ++k) {
+          std::string out_id = packed_id + "_" + std::to_string(k);
+          auto* out_data     = new NodeData(packed_data->source_node, k, 0, out_id, true);
+          pack_node->LinkTo(out_data);
+          graph->RegisterNode(out_id, out_data);
+          shape_dict[out_id] = out_shapes[k];
+          type_dict[out_id]  = out_types[k];
+        }
+      }
+      if (prepack.machine_specific) {
+        // recorded for Program::Export, which can not export them
+        if (!graph->HasAttr("machine_specific_vars")) {
+          graph->attrs["machine_specific_vars"] = std::make_shared<absl::any>(std::unordered_set<std::string>());
+        }
+        graph->GetMutableAttrs<std::unordered_set<std::string>>("machine_specific_vars").insert(packed_id);
+      }
+      for (auto& attr : prepack.consumer_attrs) {
+        node->attrs.attr_store[attr.first] = attr.second;
+      }
+      VLOG(3) << "Prepack " << weight->id() << " of " << node->id() << " into " << packed_id << ": "
+              << utils::Join(shape_dict.at(packed_id), ", ");
+    }
+  }
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(WeightPrepack) {
+  CINN_REGISTER_PASS(WeightPrepack)
+      .describe(
+          "This pass transforms the constant inputs into the packed formats declared by the \"WeightPrepack\" attrs of "
+          "their consumers, e.g. packing the constant B of cpu_gemm, by the operators marked with the "
+          "attr[\"pre_run\"], which run once before the program.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::WeightPrepackPass);
+  return true;
+}
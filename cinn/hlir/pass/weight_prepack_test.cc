@@ -0,0 +1,128 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::Graph;
+using hlir::framework::GraphCompiler;
+using hlir::framework::Scope;
+
+void SetRandData(const hlir::framework::Tensor& tensor, Target target) {
+  auto* data = tensor->mutable_data<float>(target);
+  for (size_t j = 0; j < tensor->shape().numel(); j++) {
+    data[j] = (rand() * 1.f) / RAND_MAX;  // All random data
+  }
+}
+
+std::unique_ptr<hlir::framework::Program> BuildProgram(Program* program,
+                                                       const Target& target,
+                                                       std::shared_ptr<Scope>* scope) {
+  auto graph = std::make_shared<Graph>(*program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "WeightPrepack");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  *scope = hlir::framework::BuildScope(target, graph, *scope);
+
+  GraphCompiler gc(target, *scope, graph);
+  return gc.Build();
+}
+
+TEST(WeightPrepack, cpu_gemm_trans_b) {
+  const int M = 8, N = 7, K = 6;
+  Placeholder A(Float(32), {M, K}, "A");
+  Placeholder B(Float(32), {N, K}, "B", true);
+
+  Program program;
+  Instruction instr("cpu_gemm", {A, B});
+  instr.SetAttr("trans_a", false);
+  instr.SetAttr("trans_b", true);
+  instr.SetAttr("alpha", 1.f);
+  instr.SetAttr("beta", 1.f);
+  instr.SetAttr("activation", std::string(""));
+  instr.SetAttr("has_bias", false);
+  instr.SetAttr("has_residual", false);
+  program.AppendInstruction(instr);
+  auto out = instr.GetOutput(0);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+
+  std::shared_ptr<Scope> scope;
+  auto runtime_program = BuildProgram(&program, target, &scope);
+  // B is packed before running, and cpu_gemm reads the packed B
+  ASSERT_EQ(runtime_program->GetPreRunInstructions().size(), 1);
+  ASSERT_EQ(runtime_program->GetRunInstructions().size(), 1);
+  std::string packed_name = hlir::framework::PrepackedVarName("B", "gemm_packed_trans");
+  ASSERT_NE(scope->FindVar(packed_name), nullptr);
+
+  // the packed format is internal to MKL if CINN is built with it, so only the output is checked
+  auto check_output = [&](hlir::framework::Program* prog) {
+    prog->Execute();
+    auto* a_data   = scope->GetTensor("A")->data<float>();
+    auto* b_data   = scope->GetTensor("B")->data<float>();
+    auto* out_data = scope->GetTensor(out->id)->data<float>();
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        float expected = 0.f;
+        for (int k = 0; k < K; ++k) {
+          expected += a_data[i * K + k] * b_data[j * K + k];
+        }
+        ASSERT_NEAR(out_data[i * N + j], expected, 1e-5f);
+      }
+    }
+  };
+
+  SetRandData(scope->GetTensor("A"), target);
+  SetRandData(scope->GetTensor("B"), target);
+  runtime_program->PreRun();
+  ASSERT_TRUE(scope->IsPrepacked(packed_name));
+  check_output(runtime_program.get());
+
+  // the program built on the same scope again reuses the packed B while B keeps its data, which is checked by a mark
+  // not computed from B
+  auto packed      = scope->GetTensor(packed_name);
+  auto* packed_mem = packed->buffer()->memory;
+  packed->mutable_data<float>(target)[0] = -1.f;
+
+  auto runtime_program2 = BuildProgram(&program, target, &scope);
+  runtime_program2->PreRun();
+  ASSERT_EQ(scope->GetTensor(packed_name)->buffer()->memory, packed_mem);
+  ASSERT_EQ(scope->GetTensor(packed_name)->data<float>()[0], -1.f);
+
+  // B is packed again once it changes, by either program
+  for (auto* prog : {runtime_program2.get(), runtime_program.get()}) {
+    SetRandData(scope->GetTensor("B"), target);
+    prog->PreRun();
+    check_output(prog);
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
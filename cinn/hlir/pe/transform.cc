@@ -15,6 +15,7 @@
 #include "cinn/hlir/pe/transform.h"
 
 #include <algorithm>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/cas.h"
@@ -25,6 +26,7 @@
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
 #include "cinn/lang/compute.h"
+#include "cinn/runtime/cpu/fused_gemm.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
@@ -404,6 +406,167 @@ std::vector<Tensor> MatmulMKL(const Tensor& A,
   return {out, call};
 }
 
+namespace {
+
+// The cinn_gemm_bias_kind_t of the bias of the fused gemm
+int FusedGemmBiasKind(const Tensor& bias) {
+  if (!bias.defined()) {
+    return cinn_gemm_bias_none;
+  }
+  CHECK(bias->shape.size() == 1U || bias->shape.size() == 2U)
+      << "the bias of the fused gemm should be [N], [1, N] or [M, N], but its dim is " << bias->shape.size();
+  bool is_row = bias->shape.size() == 1U || is_zero(bias->shape[0] - Expr(1));
+  return is_row ? cinn_gemm_bias_row : cinn_gemm_bias_full;
+}
+
+// The cinn_gemm_activation_t of the activation of the fused gemm
+int FusedGemmActivation(const std::string& activation) {
+  static const std::unordered_map<std::string, int> activation_kinds = {{"", cinn_gemm_activation_none},
+                                                                        {"relu", cinn_gemm_activation_relu},
+                                                                        {"sigmoid", cinn_gemm_activation_sigmoid},
+                                                                        {"tanh", cinn_gemm_activation_tanh},
+                                                                        {"gelu", cinn_gemm_activation_gelu}};
+  CHECK(activation_kinds.count(activation)) << "Unsupported activation of the fused gemm: " << activation;
+  return activation_kinds.at(activation);
+}
+
+}  // namespace
+
+std::vector<Tensor> FusedGemmCPU(const Tensor& A,
+                                 const Tensor& B,
+                                 const Tensor& bias,
+                                 const Tensor& residual,
+                                 bool trans_a,
+                                 bool trans_b,
+                                 float alpha,
+                                 float beta,
+                                 const std::string& activation,
+                                 const std::string& name,
+                                 const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "the fused gemm should be used in the cpu environment";
+  std::vector<Expr> shape_A = A->shape;
+  std::vector<Expr> shape_B = B->shape;
+  CHECK_EQ(shape_A.size(), 2U) << "tensor_A's dim should be 2 while current dim is " << shape_A.size();
+  CHECK_EQ(shape_B.size(), 2U) << "tensor_B's dim should be 2 while current dim is " << shape_B.size();
+
+  Expr x_width  = trans_a ? shape_A[0] : shape_A[1];
+  Expr y_height = trans_b ? shape_B[1] : shape_B[0];
+  Expr M        = trans_a ? shape_A[1] : shape_A[0];
+  Expr N        = trans_b ? shape_B[0] : shape_B[1];
+  CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+
+  int bias_kind       = FusedGemmBiasKind(bias);
+  int activation_kind = FusedGemmActivation(activation);
+
+  // the absent bias and residual are passed as A and ignored by the callee
+  ir::Tensor call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_fused_gemm_fp32",
+                                {
+                                    Expr(alpha),                            // alpha
+                                    M,                                      // M
+                                    N,                                      // N
+                                    x_width,                                // K
+                                    common::make_bool(trans_a),             // ta
+                                    common::make_bool(trans_b),             // tb
+                                    shape_A.back(),                         // lda
+                                    shape_B.back(),                         // ldb
+                                    N,                                      // ldc
+                                    Expr(beta),                             // beta
+                                    Expr(bias_kind),                        // bias_kind
+                                    Expr(activation_kind),                  // activation
+                                    common::make_bool(residual.defined()),  // has_residual
+                                    A,                                      // A
+                                    B,                                      // B
+                                    bias.defined() ? bias : A,              // bias
+                                    residual.defined() ? residual : A,      // residual
+                                });
+      },
+      name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(A->type());
+  return {out, call};
+}
+
+std::vector<Tensor> FusedGemmPackBCPU(const Tensor& B,
+                                      bool trans_b,
+                                      const std::string& name,
+                                      const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "the fused gemm should be used in the cpu environment";
+  std::vector<Expr> shape_B = B->shape;
+  CHECK_EQ(shape_B.size(), 2U) << "tensor_B's dim should be 2 while current dim is " << shape_B.size();
+  Expr K = trans_b ? shape_B[1] : shape_B[0];
+  Expr N = trans_b ? shape_B[0] : shape_B[1];
+
+  ir::Tensor call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_fused_gemm_pack_b_fp32",
+                                {
+                                    N,                           // N
+                                    K,                           // K
+                                    common::make_bool(trans_b),  // tb
+                                    shape_B.back(),              // ldb
+                                    B,                           // B
+                                });
+      },
+      name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(B->type());
+  return {out, call};
+}
+
+std::vector<Tensor> FusedGemmPackedCPU(const Tensor& A,
+                                       const Tensor& packed_B,
+                                       const Tensor& bias,
+                                       const Tensor& residual,
+                                       bool trans_a,
+                                       const Expr& N,
+                                       float alpha,
+                                       float beta,
+                                       const std::string& activation,
+                                       const std::string& name,
+                                       const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "the fused gemm should be used in the cpu environment";
+  std::vector<Expr> shape_A = A->shape;
+  CHECK_EQ(shape_A.size(), 2U) << "tensor_A's dim should be 2 while current dim is " << shape_A.size();
+  CHECK_EQ(packed_B->shape.size(), 1U) << "the packed B should be one-dim";
+
+  Expr K              = trans_a ? shape_A[0] : shape_A[1];
+  Expr M              = trans_a ? shape_A[1] : shape_A[0];
+  int bias_kind       = FusedGemmBiasKind(bias);
+  int activation_kind = FusedGemmActivation(activation);
+
+  // the absent bias and residual are passed as A and ignored by the callee
+  ir::Tensor call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_fused_gemm_packed_fp32",
+                                {
+                                    Expr(alpha),                            // alpha
+                                    M,                                      // M
+                                    N,                                      // N
+                                    K,                                      // K
+                                    common::make_bool(trans_a),             // ta
+                                    shape_A.back(),                         // lda
+                                    N,                                      // ldc
+                                    Expr(beta),                             // beta
+                                    Expr(bias_kind),                        // bias_kind
+                                    Expr(activation_kind),                  // activation
+                                    common::make_bool(residual.defined()),  // has_residual
+                                    A,                                      // A
+                                    packed_B,                               // packed_B
+                                    bias.defined() ? bias : A,              // bias
+                                    residual.defined() ? residual : A,      // residual
+                                });
+      },
+      name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(A->type());
+  return {out, call};
+}
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target) {
   int split_base   = GetBasicFactor(type, target);
   int split_factor = 1;
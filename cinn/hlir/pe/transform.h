@@ -81,6 +81,72 @@ std::vector<ir::Tensor> MatmulMKL(const ir::Tensor& A,
                                   const std::string& name      = UniqName("T_Transform_MatmulMKL_out"),
                                   const common::Target& target = common::DefaultHostTarget());
 
+/**
+ * @brief PE that calls the GEMM with a fused epilogue on CPU: act(alpha * op(A) * op(B) + beta * bias) + residual
+ *
+ * @param A The first input tensor, [M, K]
+ * @param B The second input tensor, [K, N]
+ * @param bias The bias of shape [N] or [1, N] broadcast to the rows, or [M, N], no bias is added if it is undefined
+ * @param residual The tensor of shape [M, N] added after the activation, nothing is added if it is undefined
+ * @param trans_a whether A is transposed
+ * @param trans_b whether B is transposed
+ * @param alpha The scale of the product
+ * @param beta The scale of the bias
+ * @param activation The activation applied after the bias, one of "", "relu", "sigmoid", "tanh" and "gelu"
+ * @param name The name of the operation
+ * @param target
+ *
+ * @return the output tensors
+ */
+std::vector<ir::Tensor> FusedGemmCPU(const ir::Tensor& A,
+                                     const ir::Tensor& B,
+                                     const ir::Tensor& bias,
+                                     const ir::Tensor& residual,
+                                     bool trans_a,
+                                     bool trans_b,
+                                     float alpha,
+                                     float beta,
+                                     const std::string& activation,
+                                     const std::string& name      = UniqName("T_Transform_FusedGemmCPU_out"),
+                                     const common::Target& target = common::DefaultHostTarget());
+
+/**
+ * @brief PE that packs op(B) of the fused gemm on CPU once, into the format read by FusedGemmPackedCPU. The format
+ * depends on the CPU if CINN is built with MKL.
+ *
+ * @param B The matrix to pack, [K, N]
+ * @param trans_b whether B is transposed
+ * @param name The name of the operation
+ * @param target
+ *
+ * @return the packed B of shape [cinn_cpu_fused_gemm_packed_b_size(N, K)] and the extern call
+ */
+std::vector<ir::Tensor> FusedGemmPackBCPU(const ir::Tensor& B,
+                                          bool trans_b,
+                                          const std::string& name      = UniqName("T_Transform_FusedGemmPackBCPU_out"),
+                                          const common::Target& target = common::DefaultHostTarget());
+
+/**
+ * @brief PE that calls the GEMM with a fused epilogue on CPU, the same as FusedGemmCPU except that op(B) has been
+ * packed by FusedGemmPackBCPU.
+ *
+ * @param packed_B The packed op(B)
+ * @param N The number of the columns in op(B)
+ *
+ * @return the output tensors
+ */
+std::vector<ir::Tensor> FusedGemmPackedCPU(const ir::Tensor& A,
+                                           const ir::Tensor& packed_B,
+                                           const ir::Tensor& bias,
+                                           const ir::Tensor& residual,
+                                           bool trans_a,
+                                           const Expr& N,
+                                           float alpha,
+                                           float beta,
+                                           const std::string& activation,
+                                           const std::string& name      = UniqName("T_Transform_FusedGemmPacked_out"),
+                                           const common::Target& target = common::DefaultHostTarget());
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target);
 
 /**
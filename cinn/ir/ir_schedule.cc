@@ -18,9 +18,11 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/cas.h"
@@ -229,7 +231,70 @@ std::vector<int> ValidateFactors(const std::vector<int>& factors, int total_exte
   }
 }
 
+// Refer a block by its name, or a loop by the first block under it and the loop's index in the loops of that block.
+// An empty block name is returned if no block under the loop has the loop in its loops, which fails to replay.
+ScheduleDesc::ExprRef MakeExprRef(const ScheduleHelper& helper, const Expr& expr) {
+  ScheduleDesc::ExprRef ref;
+  if (expr.As<ir::ScheduleBlockRealize>()) {
+    ref.block_name = expr.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+    return ref;
+  }
+  CHECK(expr.As<ir::For>()) << "Only the blocks and loops can be recorded, but got:\n" << expr;
+  std::vector<Expr> blocks;
+  ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+    if (x->As<ir::ScheduleBlockRealize>() && !x->As<ir::ScheduleBlockRealize>()->iter_values.empty()) {
+      blocks.push_back(*x);
+    }
+    return false;
+  });
+  for (const Expr& block : blocks) {
+    std::vector<Expr> loops = helper.GetLoops(block);
+    auto it                 = std::find(loops.begin(), loops.end(), expr);
+    if (it != loops.end()) {
+      ref.block_name = block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+      ref.loop_index = it - loops.begin();
+      return ref;
+    }
+  }
+  VLOG(3) << "The loop can not be referred by the blocks under it:\n" << expr;
+  ref.loop_index = 0;
+  return ref;
+}
+
+/**
+ * Record the application of a primitive into the trace of IRSchedule. The inputs are referred on construction
+ * before the AST is changed, and the step is recorded on Commit after the primitive succeeds. Nothing is
+ * recorded for the primitives called by another primitive, or if the trace is not enabled, in which case the
+ * inputs are not referred either.
+ */
+class TraceRecorder {
+ public:
+  TraceRecorder(IRSchedule* schedule, const std::string& type, const std::vector<Expr>& inputs)
+      : schedule_(schedule), record_(schedule->trace_depth_++ == 0 && schedule->trace_enabled_) {
+    if (!record_) return;
+    step_.type = type;
+    for (const Expr& input : inputs) {
+      step_.inputs.emplace_back(MakeExprRef(schedule_->helper_, input));
+    }
+  }
+
+  ~TraceRecorder() { --schedule_->trace_depth_; }
+
+  void Commit(std::map<std::string, ScheduleDesc::Attr> attrs = {}) {
+    if (!record_) return;
+    step_.attrs = std::move(attrs);
+    schedule_->trace_.Append(std::move(step_));
+  }
+
+ private:
+  IRSchedule* schedule_;
+  // whether the trace is enabled and the primitive is the outermost one
+  bool record_;
+  ScheduleDesc::Step step_;
+};
+
 std::vector<Expr> IRSchedule::Split(const Expr& loop, const std::vector<int>& factors) {
+  TraceRecorder recorder(this, "Split", {loop});
   CHECK(loop.As<ir::For>()) << "Expr param of Split must be For node! Please check.";
   auto* for_node = loop.As<ir::For>();
   CHECK(common::is_zero(for_node->min)) << "The For node must start with 0! Please check.";
@@ -259,6 +324,7 @@ std::vector<Expr> IRSchedule::Split(const Expr& loop, const std::vector<int>& fa
     splited_loops[i] = new_node;
   }
   helper_.Replace(loop, new_node);
+  recorder.Commit({{"factors", factors}});
   return splited_loops;
 }
 
@@ -272,6 +338,7 @@ std::vector<Expr> IRSchedule::Split(const std::string& block_name, int loop_inde
 }
 
 Expr IRSchedule::Fuse(const std::vector<Expr>& loops) {
+  TraceRecorder recorder(this, "Fuse", loops);
   std::vector<const ir::For*> for_nodes;
   std::vector<Var> loop_vars;
   CHECK(!loops.empty()) << "The loops param of Fuse should not be empty! Please check.";
@@ -317,6 +384,7 @@ Expr IRSchedule::Fuse(const std::vector<Expr>& loops) {
   Expr new_stmt =
       For::Make(fused_var, Expr(0), fused_extent, for_nodes[0]->for_type(), for_nodes[0]->device_api, fused_body);
   helper_.Replace(loops[0], new_stmt);
+  recorder.Commit();
   return new_stmt;
 }
 
@@ -351,6 +419,7 @@ Expr IRSchedule::Fuse(const Expr& block, const std::vector<int>& loops_index) {
 }
 
 void IRSchedule::MutateForType(const Expr& loop, ForType for_type, int factor) {
+  TraceRecorder recorder(this, "MutateForType", {loop});
   auto* for_node = loop.As<ir::For>();
   CHECK(for_node) << "loop param must be For node! Please check.";
   CHECK(for_node->is_serial()) << "loop is not serial, current forloop type is "
@@ -367,18 +436,30 @@ void IRSchedule::MutateForType(const Expr& loop, ForType for_type, int factor) {
     new_for_node->set_bind_info(bind_info);
   }
   helper_.Replace(loop, loop_copy);
+  recorder.Commit({{"for_type", static_cast<int>(for_type)}, {"factor", factor}});
 }
 
-void IRSchedule::Parallel(const Expr& loop) { MutateForType(loop, ForType::Parallel); }
+void IRSchedule::Parallel(const Expr& loop) {
+  TraceRecorder recorder(this, "Parallel", {loop});
+  MutateForType(loop, ForType::Parallel);
+  recorder.Commit();
+}
 
 void IRSchedule::Vectorize(const Expr& loop, int factor) {
+  TraceRecorder recorder(this, "Vectorize", {loop});
   CHECK_GT(factor, 0) << "vectorize factor should be more than 0";
   MutateForType(loop, ForType::Vectorized, factor);
+  recorder.Commit({{"factor", factor}});
 }
 
-void IRSchedule::Unroll(const Expr& loop) { MutateForType(loop, ForType::Unrolled); }
+void IRSchedule::Unroll(const Expr& loop) {
+  TraceRecorder recorder(this, "Unroll", {loop});
+  MutateForType(loop, ForType::Unrolled);
+  recorder.Commit();
+}
 
 void IRSchedule::Bind(const Expr& loop, const std::string& thread_axis) {
+  TraceRecorder recorder(this, "Bind", {loop});
   static std::set<std::string> thread_axes = {
       "blockIdx.x", "blockIdx.y", "blockIdx.z", "threadIdx.x", "threadIdx.y", "threadIdx.z"};
   CHECK(thread_axes.count(thread_axis)) << "thread_axis " << thread_axis << " is not supported";
@@ -388,6 +469,7 @@ void IRSchedule::Bind(const Expr& loop, const std::string& thread_axis) {
   } else {
     MutateForType(loop, ForType::GPUThread, offset);
   }
+  recorder.Commit({{"thread_axis", thread_axis}});
 }
 
 // check whether or not have the var with the same name
@@ -745,13 +827,16 @@ void CHECKRfactorValidation(const Expr& rf_loop, int rf_axis) {
 }
 
 Expr IRSchedule::Rfactor(const Expr& rf_loop, int rf_axis) {
+  TraceRecorder recorder(this, "Rfactor", {rf_loop});
   CHECKRfactorValidation(rf_loop, rf_axis);
   // get root ScheduleBlockRealize
   Expr root = GetRootBlock(rf_loop);
   // create all stmts after rfactor transformation
   RfCreater rf_create(root, rf_loop, rf_axis);
   // return new created rfactor tensor
-  return rf_create.CreateRfAllStmts();
+  Expr rf_tensor = rf_create.CreateRfAllStmts();
+  recorder.Commit({{"rf_axis", rf_axis}});
+  return rf_tensor;
 }
 
 /**
@@ -890,6 +975,8 @@ struct CacheBlockInfo {
   int loc_pos;
   /*! \brief The cache_read/cache_write stage to be inserted. */
   Expr cache_block;
+  /*! \brief The tensor initializing the cache of a reduction, undefined if the cached block is not a reduction. */
+  Tensor reduce_init_tensor;
 };
 
 /**
@@ -938,6 +1025,21 @@ Tensor MakeCacheTensor(const Tensor& tensor, const std::string& memory_type) {
   return cache_tensor;
 }
 
+/**
+ * Make the tensor initializing a reduction's cache tensor, which shares the buffer of the cache tensor
+ * like the init tensor of the original reduction shares the buffer of the original tensor.
+ * @param cache_tensor The cache tensor of the reduction.
+ * @param return The init tensor of the cache tensor.
+ */
+Tensor MakeCacheReduceInitTensor(const Tensor& cache_tensor) {
+  auto init_tensor = lang::Compute(
+      cache_tensor->shape,
+      [=](const std::vector<Expr>& dims) { return cache_tensor(dims); },
+      GenReduceInitTensorNameOf(cache_tensor->name));
+  init_tensor->Bind(cache_tensor->buffer);
+  return init_tensor;
+}
+
 /**
  * Make a the cache tensor's block.
  * @param buffer_region The accessed region of cache tensor.
@@ -975,9 +1077,10 @@ Expr MakeCacheBlock(const std::vector<std::pair<Expr, Expr>>& buffer_region,
   for (int i = 0; i < axis_vars.size(); ++i) {
     optim::ReplaceVarWithExpr(&body, axis_vars[i], block_vars[i]);
   }
+  // the block is named after the cache tensor rather than a unique name, so the name does not depend on the
+  // names generated before and replaying the schedule refers to the same blocks
   Expr block = ir::ScheduleBlockRealize::Make(
-      iter_values,
-      ir::ScheduleBlock::Make(block_vars, {}, {}, common::UniqName(new_tensor->name), Block::Make({body})));
+      iter_values, ir::ScheduleBlock::Make(block_vars, {}, {}, new_tensor->name, Block::Make({body})));
   Expr new_body = block;
   for (int i = (int)loop_vars.size() - 1; i >= 0; i--) {
     new_body = For::Make(loop_vars[i],
@@ -1057,12 +1160,19 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
   }
 
   void Visit(const ir::ScheduleBlock* expr, Expr* op) override {
+    bool is_cached_block = false;
     if (op->As<ScheduleBlock>()->name == info_->write_tensor->name) {
       op->As<ScheduleBlock>()->name = info_->read_tensor->name;
+      is_cached_block               = !mutate_cache_block;
     } else if (op->As<ScheduleBlock>()->name == info_->read_tensor->name) {
       op->As<ScheduleBlock>()->name = info_->write_tensor->name;
+    } else if (info_->reduce_init_tensor.defined() &&
+               op->As<ScheduleBlock>()->name == GenReduceInitTensorNameOf(info_->write_tensor->name)) {
+      op->As<ScheduleBlock>()->name = info_->reduce_init_tensor->name;
     }
+    in_cached_block_ = is_cached_block;
     IRMutator::Visit(expr, op);
+    in_cached_block_ = false;
   }
 
   void Visit(const ir::Load* expr, Expr* op) override {
@@ -1071,6 +1181,10 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
       op->As<Load>()->tensor = Expr(info_->read_tensor);
     } else if (op->As<Load>()->tensor == Expr(info_->read_tensor) && mutate_cache_block) {
       op->As<Load>()->tensor = Expr(info_->write_tensor);
+    } else if (op->As<Load>()->tensor == Expr(info_->write_tensor) && in_cached_block_ &&
+               info_->reduce_init_tensor.defined()) {
+      // the reduction accumulates into the cache tensor
+      op->As<Load>()->tensor = Expr(info_->read_tensor);
     }
   }
 
@@ -1080,6 +1194,10 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
       op->As<Store>()->tensor = Expr(info_->read_tensor);
     } else if (op->As<Store>()->tensor == Expr(info_->read_tensor) && mutate_cache_block) {
       op->As<Store>()->tensor = Expr(info_->write_tensor);
+    } else if (info_->reduce_init_tensor.defined() && op->As<Store>()->tensor.as_tensor() &&
+               op->As<Store>()->tensor.as_tensor()->name == GenReduceInitTensorNameOf(info_->write_tensor->name)) {
+      // the cache tensor is initialized instead of the original tensor, which is only written back
+      op->As<Store>()->tensor = Expr(info_->reduce_init_tensor);
     }
   }
 
@@ -1090,6 +1208,8 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
   CacheBlockInfo* info_;
   /*! \brief Are we mutating the cache tensor's block */
   bool mutate_cache_block{true};
+  /*! \brief Are we mutating the block whose output is cached */
+  bool in_cached_block_{false};
 };
 
 //! Visit all ScheduleBlock and change its body to ir::Block if it is not.
@@ -1151,6 +1271,7 @@ DeviceAPI IRSchedule::GetDeviceAPI() const {
 }
 
 Expr IRSchedule::CacheRead(const Expr& block, int read_tensor_index, const std::string& memory_type) {
+  TraceRecorder recorder(this, "CacheRead", {block});
   CHECK(block.As<ScheduleBlockRealize>());
   auto root = GetRootBlock(block);
   ChangeBodyToBlock::Change(&root);
@@ -1168,10 +1289,12 @@ Expr IRSchedule::CacheRead(const Expr& block, int read_tensor_index, const std::
   auto new_root = CacheReadRewriter::Rewrite(root, &info);
   helper_.Replace(root.As<ScheduleBlockRealize>()->schedule_block.As<ScheduleBlock>()->body,
                   new_root.As<ScheduleBlockRealize>()->schedule_block.As<ScheduleBlock>()->body);
+  recorder.Commit({{"read_buffer_index", read_tensor_index}, {"memory_type", memory_type}});
   return new_block;
 }
 
 Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std::string& memory_type) {
+  TraceRecorder recorder(this, "CacheWrite", {block});
   CHECK(block.As<ScheduleBlockRealize>());
   auto root = GetRootBlock(block);
   ChangeBodyToBlock::Change(&root);
@@ -1183,6 +1306,12 @@ Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std
   info.read_tensor         = MakeCacheTensor(write_tensor, memory_type);
   info.write_tensor        = write_tensor;
   info.alloc               = info.read_tensor;
+  for (const Var& iter_var : block.As<ScheduleBlockRealize>()->schedule_block.As<ScheduleBlock>()->iter_vars) {
+    if (iter_var->is_reduce_axis) {
+      info.reduce_init_tensor = MakeCacheReduceInitTensor(info.read_tensor);
+      break;
+    }
+  }
   auto write_buffer_region = CalculateTensorRegions(block, tensor_indices, info.write_tensor, root);
   auto new_block           = MakeCacheBlock(write_buffer_region, &info, memory_type, this->GetDeviceAPI());
   FindInsertionPoint(root, &info, true);
@@ -1198,6 +1327,7 @@ Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std
 
   CHECK_EQ(find_cache_block.size(), 1U);
 
+  recorder.Commit({{"write_buffer_index", write_buffer_index}, {"memory_type", memory_type}});
   return *find_cache_block.begin();
 }
 
@@ -1392,6 +1522,7 @@ Expr ConstructNewLoopChain(const std::vector<Expr>& chain,
 
 void IRSchedule::Reorder(const std::vector<Expr>& loops) {
   if (loops.size() <= 1) return;
+  TraceRecorder recorder(this, "Reorder", loops);
   std::set<Expr, CompExpr> loop_set = CollectLoopsToSet(loops);
   auto boundary                     = GetBoundaryOfReorderRange(loop_set);
   Expr top                          = boundary.first;
@@ -1401,6 +1532,7 @@ void IRSchedule::Reorder(const std::vector<Expr>& loops) {
 
   Expr new_loop = ConstructNewLoopChain(chain, loops, loop_set, if_nodes);
   helper_.Replace(top, new_loop);
+  recorder.Commit();
 }
 
 void IRSchedule::Reorder(const std::string& block_name, const std::vector<int>& loops_index) {
@@ -1638,6 +1770,7 @@ struct LeafBlockRemovalPlan : public ir::IRMutator<> {
 };
 
 void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type) {
+  TraceRecorder recorder(this, "SetBuffer", {block});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   auto find_tensor = ir::CollectIRNodesWithoutTensor(block, [&](const Expr* x) { return x->As<ir::Store>(); });
   CHECK(!find_tensor.empty()) << "Didn't find Store in block!";
@@ -1654,11 +1787,13 @@ void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type) {
       t.as_tensor_ref()->Bind(tensor.as_tensor_ref()->buffer);
     }
   }
+  recorder.Commit({{"memory_type", memory_type}});
 }
 
 void IRSchedule::MergeExprs() {
   auto exprs = this->GetModule().GetExprs();
   if (exprs.size() == 1U) return;
+  TraceRecorder recorder(this, "MergeExprs", {});
   CHECK(exprs[0].As<ir::Block>());
   CHECK_EQ(exprs[0].As<ir::Block>()->stmts.size(), 1U);
   CHECK(exprs[0].As<ir::Block>()->stmts[0].As<ir::ScheduleBlockRealize>());
@@ -1684,6 +1819,7 @@ void IRSchedule::MergeExprs() {
   LOG(INFO) << "After merging, exprs[0] is : " << exprs[0];
   exprs.erase(exprs.begin() + 1, exprs.end());
   this->SetExprs(exprs);
+  recorder.Commit();
 }
 
 /*!
@@ -1816,6 +1952,7 @@ std::vector<std::pair<Expr, Expr>> CalculateRequiredRegions(const Expr& block,
 }
 
 void IRSchedule::ComputeAt(const Expr& block, const Expr& loop) {
+  TraceRecorder recorder(this, "ComputeAt", {block, loop});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(loop.As<ir::For>());
   Expr root      = this->GetRootBlock(block);
@@ -1830,10 +1967,12 @@ void IRSchedule::ComputeAt(const Expr& block, const Expr& loop) {
   reconstructor.MakeNewLoop(iter_doms);
   helper_.Replace(reconstructor.source_expr, reconstructor.target_expr);
   helper_.Replace(reconstructor.loop_, reconstructor.new_loop_);
+  recorder.Commit();
   return;
 }
 
 void IRSchedule::SimpleComputeAt(const Expr& block, const Expr& loop) {
+  TraceRecorder recorder(this, "SimpleComputeAt", {block, loop});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(loop.As<ir::For>());
   std::vector<Expr> block_loops = this->GetLoops(block);
@@ -1857,6 +1996,7 @@ void IRSchedule::SimpleComputeAt(const Expr& block, const Expr& loop) {
   remove_plan(&root);
   helper_.Replace(source_expr, target_expr);
   helper_.Replace(loop, new_loop);
+  recorder.Commit();
   return;
 }
 
@@ -2013,6 +2153,7 @@ Expr CheckComputeInlineValidationAndGetStore(const Expr& schedule_block, const E
 }
 
 void IRSchedule::ComputeInline(const Expr& schedule_block) {
+  TraceRecorder recorder(this, "ComputeInline", {schedule_block});
   CHECK(schedule_block.As<ir::ScheduleBlockRealize>());
   Expr root  = this->GetRootBlock(schedule_block);
   Expr store = CheckComputeInlineValidationAndGetStore(schedule_block, root);
@@ -2022,6 +2163,7 @@ void IRSchedule::ComputeInline(const Expr& schedule_block) {
   LeafBlockRemovalPlan remove_plan(schedule_block, &inliner.src_stmt, &inliner.tgt_stmt);
   remove_plan(&root);
   inliner(&root);
+  recorder.Commit();
   return;
 }
 
@@ -2136,6 +2278,7 @@ void IRSchedule::CopyTransformAndLoopInfo(const std::string& block_name, const s
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const Expr& block, const Expr& block_target) {
+  TraceRecorder recorder(this, "CopyTransformAndLoopInfo", {block, block_target});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(block_target.As<ir::ScheduleBlockRealize>());
   auto exprs = this->GetModule().GetExprs();
@@ -2233,6 +2376,7 @@ void IRSchedule::CopyTransformAndLoopInfo(const Expr& block, const Expr& block_t
   std::vector<Expr> all_loops = this->GetLoops(block);
   CHECK(!all_loops.empty());
   helper_.Replace(all_loops[0], res);
+  recorder.Commit();
 }
 
 }  // namespace ir
@@ -20,6 +20,7 @@
 
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/schedule_desc.h"
 #include "cinn/ir/tensor.h"
 
 namespace cinn {
@@ -209,6 +210,7 @@ class IRSchedule {
 
   /**
    * \brief Find a buffer that is being written, and create its cache.
+   * If the block is a reduction, it accumulates into the cache, and its init block initializes the cache.
    * @param block Block that writes the buffer.
    * @param write_buffer_index Index of the buffer being written in block.
    * @param memory_type String that indicates the buffer's storage scope.
@@ -335,8 +337,22 @@ class IRSchedule {
 
   void MergeExprs();
 
+  //! Record the schedule primitives applied from now on into the trace, it is disabled by default.
+  void EnableTrace(bool enable = true) { trace_enabled_ = enable; }
+
+  bool IsTraceEnabled() const { return trace_enabled_; }
+
+  //! Get the trace of the schedule primitives applied, which can be replayed on the original exprs.
+  const ScheduleDesc& GetTraceDesc() const { return trace_; }
+
  private:
+  friend class TraceRecorder;
+
   ScheduleHelper helper_;
+  // only the outermost primitive is recorded into the trace, since some primitives are implemented by the others
+  ScheduleDesc trace_;
+  bool trace_enabled_{false};
+  int trace_depth_{0};
 };
 
 void SetCudaAxisInfo(Expr* lowered_func);
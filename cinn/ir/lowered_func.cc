@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -247,6 +248,34 @@ std::vector<Expr> _LoweredFunc_::CudaAliasVarExprs() const {
   return res;
 }
 
+void _LoweredFunc_::PrepareTempBufsFromBody() {
+  std::set<std::string> buffer_names;
+  for (auto& arg : args) {
+    if (arg.is_buffer()) buffer_names.insert(arg.name());
+  }
+  for (auto& temp_buf : temp_bufs) {
+    buffer_names.insert(temp_buf->name);
+  }
+
+  std::set<Expr> store_exprs = ir::CollectIRNodes(body, [](const Expr* expr) {
+    return expr->As<ir::Store>() && expr->As<ir::Store>()->tensor.as_tensor() &&
+           expr->As<ir::Store>()->tensor.as_tensor_ref()->buffer.defined();
+  });
+  // sort the new buffers by their names to keep the order deterministic
+  std::map<std::string, Buffer> new_bufs;
+  for (auto& store_expr : store_exprs) {
+    const Buffer& buffer = store_expr.As<ir::Store>()->tensor.as_tensor_ref()->buffer;
+    if (!buffer_names.count(buffer->name)) {
+      new_bufs.emplace(buffer->name, buffer);
+    }
+  }
+  for (auto& item : new_bufs) {
+    VLOG(3) << "Add temporary buffer " << item.first << " written by the body of " << name;
+    temp_bufs.push_back(item.second);
+  }
+  PrepareBufferCastExprs();
+}
+
 void _LoweredFunc_::PrepareArgumentExprs() {
   // Seems a CINN func.
   if (args.front().is_var() && args.front().var_arg()->type() == type_of<cinn_pod_value_t*>()) return;
@@ -178,6 +178,9 @@ struct _LoweredFunc_ : ExprNode<_LoweredFunc_> {
   std::vector<Expr> CudaAliasVarExprs() const;
   void PrepareBufferCastExprs();
   void PrepareCudaAxisInfoFromBody();
+  //! Add the buffers written by the body but neither passed as arguments nor in `temp_bufs`, such as the cache
+  //! buffers created by the schedule primitives, to `temp_bufs`, and prepare the buffer cast expressions again.
+  void PrepareTempBufsFromBody();
 
  private:
   void CheckValid() const;
@@ -0,0 +1,204 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/schedule_desc.h"
+
+#include <glog/logging.h>
+
+#include <functional>
+#include <unordered_map>
+
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+using Step = ScheduleDesc::Step;
+
+template <typename T>
+const T& GetAttr(const Step& step, const std::string& name) {
+  auto it = step.attrs.find(name);
+  CHECK(it != step.attrs.end()) << "Attribute " << name << " of step " << step.type << " is not found";
+  const T* value = absl::get_if<T>(&it->second);
+  CHECK(value) << "Attribute " << name << " of step " << step.type << " is of a wrong type";
+  return *value;
+}
+
+Expr ResolveExprRef(const IRSchedule& schedule, const ScheduleDesc::ExprRef& ref) {
+  CHECK(!ref.block_name.empty()) << "The step refers a loop that can not be referred by any block, so it can not "
+                                    "be replayed";
+  if (ref.loop_index < 0) {
+    return schedule.GetBlock(ref.block_name);
+  }
+  std::vector<Expr> loops = schedule.GetLoops(ref.block_name);
+  CHECK_LT(ref.loop_index, static_cast<int>(loops.size()))
+      << "Block " << ref.block_name << " has only " << loops.size() << " loops";
+  return loops[ref.loop_index];
+}
+
+// Apply a step with its inputs resolved on the schedule
+using StepApplier = std::function<void(IRSchedule*, const std::vector<Expr>&, const Step&)>;
+
+const std::unordered_map<std::string, StepApplier>& GetStepAppliers() {
+  static const std::unordered_map<std::string, StepApplier> appliers = {
+      {"Split",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->Split(inputs.at(0), GetAttr<std::vector<int>>(step, "factors"));
+       }},
+      {"Fuse", [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->Fuse(inputs); }},
+      {"ComputeAt",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->ComputeAt(inputs.at(0), inputs.at(1));
+       }},
+      {"SimpleComputeAt",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->SimpleComputeAt(inputs.at(0), inputs.at(1));
+       }},
+      {"CacheRead",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->CacheRead(
+             inputs.at(0), GetAttr<int>(step, "read_buffer_index"), GetAttr<std::string>(step, "memory_type"));
+       }},
+      {"CacheWrite",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->CacheWrite(
+             inputs.at(0), GetAttr<int>(step, "write_buffer_index"), GetAttr<std::string>(step, "memory_type"));
+       }},
+      {"SetBuffer",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         Expr block = inputs.at(0);
+         sch->SetBuffer(block, GetAttr<std::string>(step, "memory_type"));
+       }},
+      {"Reorder", [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->Reorder(inputs); }},
+      {"MutateForType",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->MutateForType(
+             inputs.at(0), static_cast<ForType>(GetAttr<int>(step, "for_type")), GetAttr<int>(step, "factor"));
+       }},
+      {"Parallel",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->Parallel(inputs.at(0)); }},
+      {"Vectorize",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->Vectorize(inputs.at(0), GetAttr<int>(step, "factor"));
+       }},
+      {"Unroll",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->Unroll(inputs.at(0)); }},
+      {"ComputeInline",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->ComputeInline(inputs.at(0)); }},
+      {"Bind",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->Bind(inputs.at(0), GetAttr<std::string>(step, "thread_axis"));
+       }},
+      {"CopyTransformAndLoopInfo",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->CopyTransformAndLoopInfo(inputs.at(0), inputs.at(1));
+       }},
+      {"Rfactor",
+       [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) {
+         sch->Rfactor(inputs.at(0), GetAttr<int>(step, "rf_axis"));
+       }},
+      {"MergeExprs", [](IRSchedule* sch, const std::vector<Expr>& inputs, const Step& step) { sch->MergeExprs(); }},
+  };
+  return appliers;
+}
+
+}  // namespace
+
+ScheduleDesc::ScheduleDesc(const proto::ScheduleDesc& desc) {
+  for (const auto& step_proto : desc.steps()) {
+    Step step;
+    step.type = step_proto.type();
+    for (const auto& ref_proto : step_proto.inputs()) {
+      ExprRef ref;
+      ref.block_name = ref_proto.block_name();
+      ref.loop_index = ref_proto.loop_index();
+      step.inputs.emplace_back(std::move(ref));
+    }
+    for (const auto& item : step_proto.attrs()) {
+      const auto& attr = item.second;
+      switch (attr.value_case()) {
+        case proto::ScheduleDesc::Attr::kB:
+          step.attrs[item.first] = attr.b();
+          break;
+        case proto::ScheduleDesc::Attr::kI:
+          step.attrs[item.first] = static_cast<int>(attr.i());
+          break;
+        case proto::ScheduleDesc::Attr::kF:
+          step.attrs[item.first] = attr.f();
+          break;
+        case proto::ScheduleDesc::Attr::kS:
+          step.attrs[item.first] = attr.s();
+          break;
+        case proto::ScheduleDesc::Attr::kInts:
+          step.attrs[item.first] = std::vector<int>(attr.ints().values().begin(), attr.ints().values().end());
+          break;
+        default:
+          LOG(FATAL) << "Attribute " << item.first << " of step " << step.type << " has no value";
+      }
+    }
+    steps_.emplace_back(std::move(step));
+  }
+}
+
+proto::ScheduleDesc ScheduleDesc::ToProto() const {
+  proto::ScheduleDesc desc;
+  for (const Step& step : steps_) {
+    auto* step_proto = desc.add_steps();
+    step_proto->set_type(step.type);
+    for (const ExprRef& ref : step.inputs) {
+      auto* ref_proto = step_proto->add_inputs();
+      ref_proto->set_block_name(ref.block_name);
+      ref_proto->set_loop_index(ref.loop_index);
+    }
+    auto* attrs_proto = step_proto->mutable_attrs();
+    for (const auto& item : step.attrs) {
+      auto& attr = (*attrs_proto)[item.first];
+      if (auto* v = absl::get_if<bool>(&item.second)) {
+        attr.set_b(*v);
+      } else if (auto* v = absl::get_if<int>(&item.second)) {
+        attr.set_i(*v);
+      } else if (auto* v = absl::get_if<float>(&item.second)) {
+        attr.set_f(*v);
+      } else if (auto* v = absl::get_if<std::string>(&item.second)) {
+        attr.set_s(*v);
+      } else if (auto* v = absl::get_if<std::vector<int>>(&item.second)) {
+        auto* ints = attr.mutable_ints();
+        for (int value : *v) {
+          ints->add_values(value);
+        }
+      }
+    }
+  }
+  return desc;
+}
+
+void ScheduleDesc::Replay(IRSchedule* schedule) const {
+  const auto& appliers = GetStepAppliers();
+  for (const Step& step : steps_) {
+    auto it = appliers.find(step.type);
+    CHECK(it != appliers.end()) << "Unknown schedule primitive " << step.type << " in ScheduleDesc";
+    // the inputs are resolved before the step is applied, as they were recorded
+    std::vector<Expr> inputs;
+    for (const ExprRef& ref : step.inputs) {
+      inputs.emplace_back(ResolveExprRef(*schedule, ref));
+    }
+    VLOG(4) << "Replay schedule primitive " << step.type;
+    it->second(schedule, inputs, step);
+  }
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/types/variant.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/ir/schedule_desc.pb.h"
+
+namespace cinn {
+namespace ir {
+
+class IRSchedule;
+
+/**
+ * The trace of the schedule primitives applied by an IRSchedule, which is an ordered list of steps.
+ *
+ * Each step records the name of the primitive, the blocks and loops it is applied to and its decisions,
+ * such as the factors of Split. A block is referred by its name and a loop by the name of a block under it
+ * and its index in the loops of that block, so the trace can be replayed on the freshly lowered exprs the
+ * original schedule started from, and it can be mutated by changing the decisions of the steps.
+ */
+class ScheduleDesc {
+ public:
+  struct ExprRef {
+    std::string block_name;
+    // the index in IRSchedule::GetLoops(block_name), -1 if the block itself is referred
+    int loop_index = -1;
+  };
+
+  using Attr = absl::variant<bool, int, float, std::string, std::vector<int>>;
+
+  struct Step {
+    std::string type;
+    std::vector<ExprRef> inputs;
+    std::map<std::string, Attr> attrs;
+  };
+
+  ScheduleDesc() = default;
+
+  explicit ScheduleDesc(const proto::ScheduleDesc& desc);
+
+  proto::ScheduleDesc ToProto() const;
+
+  void Append(Step step) { steps_.emplace_back(std::move(step)); }
+
+  const std::vector<Step>& Steps() const { return steps_; }
+
+  //! The steps whose decisions can be mutated before replaying.
+  std::vector<Step>* MutableSteps() { return &steps_; }
+
+  size_t Size() const { return steps_.size(); }
+
+  bool Empty() const { return steps_.empty(); }
+
+  void Clear() { steps_.clear(); }
+
+  /**
+   * \brief Apply the steps on the schedule in order, which are recorded into the trace of the schedule if it is
+   * enabled.
+   * @param schedule The schedule of the exprs the trace started from.
+   */
+  void Replay(IRSchedule* schedule) const;
+
+ private:
+  std::vector<Step> steps_;
+};
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/schedule_desc.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/lower.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace ir {
+
+// lower B[i, j, k] = A[i, j, k] + 1, the names are the same every time it is lowered
+ModuleExpr LowerAddOne() {
+  Context::Global().ResetNameId();
+  Expr M(32);
+  Expr N(32);
+  Expr P(16);
+
+  Placeholder<float> A("A", {M, N, P});
+  auto B = Compute(
+      {M, N, P}, [&](Var i, Var j, Var k) { return A(i, j, k) + Expr(1.f); }, "B");
+  auto stages = CreateStages({A, B});
+  auto funcs =
+      lang::LowerVec("test_schedule_desc", stages, {A, B}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+
+  std::vector<Expr> exprs;
+  for (auto& func : funcs) {
+    exprs.push_back(func->body);
+  }
+  return ModuleExpr(exprs);
+}
+
+TEST(ScheduleDesc, RecordAndReplay) {
+  IRSchedule ir_sch(LowerAddOne());
+  ir_sch.EnableTrace();
+  ir_sch.Split("B", 0, {4, -1});
+  auto loops = ir_sch.GetLoops("B");
+  ir_sch.Reorder({loops[1], loops[0]});
+  ir_sch.Vectorize(ir_sch.GetLoops("B").back(), 16);
+
+  // the primitives called by the others are not recorded
+  const ScheduleDesc& trace = ir_sch.GetTraceDesc();
+  ASSERT_EQ(trace.Size(), 3UL);
+  EXPECT_EQ(trace.Steps()[0].type, "Split");
+  EXPECT_EQ(trace.Steps()[0].inputs[0].block_name, "B");
+  EXPECT_EQ(trace.Steps()[0].inputs[0].loop_index, 0);
+  EXPECT_EQ(trace.Steps()[1].type, "Reorder");
+  EXPECT_EQ(trace.Steps()[2].type, "Vectorize");
+
+  // replay the trace restored from proto on the freshly lowered exprs
+  ScheduleDesc restored(trace.ToProto());
+  IRSchedule replayed_sch(LowerAddOne());
+  replayed_sch.EnableTrace();
+  restored.Replay(&replayed_sch);
+
+  EXPECT_EQ(replayed_sch.GetTraceDesc().Size(), trace.Size());
+  EXPECT_EQ(utils::GetStreamCnt(replayed_sch.GetModule().GetExprs().at(0)),
+            utils::GetStreamCnt(ir_sch.GetModule().GetExprs().at(0)));
+}
+
+TEST(ScheduleDesc, MutateDecisions) {
+  IRSchedule ir_sch(LowerAddOne());
+  ir_sch.EnableTrace();
+  ir_sch.Split("B", 0, {4, -1});
+
+  ScheduleDesc trace = ir_sch.GetTraceDesc();
+  ASSERT_EQ(trace.Size(), 1UL);
+  (*trace.MutableSteps())[0].attrs["factors"] = std::vector<int>({8, -1});
+
+  IRSchedule mutated_sch(LowerAddOne());
+  trace.Replay(&mutated_sch);
+  auto loops = mutated_sch.GetLoops("B");
+  ASSERT_EQ(loops.size(), 4UL);
+  EXPECT_EQ(GetLoopExtent(loops[0]), 8);
+  EXPECT_EQ(GetLoopExtent(loops[1]), 4);
+}
+
+TEST(ScheduleDesc, TraceDisabled) {
+  IRSchedule ir_sch(LowerAddOne());
+  ir_sch.Split("B", 0, {4, -1});
+  EXPECT_FALSE(ir_sch.IsTraceEnabled());
+  EXPECT_TRUE(ir_sch.GetTraceDesc().Empty());
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,361 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/structural_hash.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "cinn/ir/buffer.h"
+#include "cinn/ir/intrinsic_ops.h"
+#include "cinn/ir/lowered_func.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+// the tokens marking the structure, they are far from the small integers of the node types and the indices
+constexpr uint64_t kUndefined = 0xcafe0001;
+constexpr uint64_t kListBegin = 0xcafe0002;
+
+/**
+ * Serialize exprs into a canonical sequence of integers. The names of the variables and of the tensors,
+ * buffers and schedule blocks are replaced by the order they first appear in, each kind numbered separately
+ * except that the tensors, buffers and blocks share one numbering since a block is named after its tensor.
+ */
+class CanonicalSerializer {
+ public:
+  void Serialize(const Expr& expr) {
+    if (!expr.defined()) {
+      Emit(kUndefined);
+      return;
+    }
+    const IrNode* node = expr.ptr();
+    // a shared node is serialized the same as its first appearance, since the names in it are numbered then
+    auto it = memo_.find(node);
+    if (it != memo_.end()) {
+      for (size_t i = it->second.first; i < it->second.second; ++i) {
+        tokens_.push_back(tokens_[i]);
+      }
+      return;
+    }
+    size_t begin = tokens_.size();
+    SerializeNode(expr);
+    memo_[node] = std::make_pair(begin, tokens_.size());
+  }
+
+  void SerializeList(const std::vector<Expr>& exprs) {
+    Emit(kListBegin);
+    Emit(exprs.size());
+    for (auto& expr : exprs) {
+      Serialize(expr);
+    }
+  }
+
+  const std::vector<uint64_t>& tokens() const { return tokens_; }
+
+ private:
+  void Emit(uint64_t token) { tokens_.push_back(token); }
+
+  void EmitString(const std::string& str) {
+    Emit(str.size());
+    for (size_t i = 0; i < str.size(); i += sizeof(uint64_t)) {
+      uint64_t chunk = 0;
+      std::memcpy(&chunk, str.data() + i, std::min(sizeof(uint64_t), str.size() - i));
+      Emit(chunk);
+    }
+  }
+
+  void EmitType(const Type& type) {
+    Emit(static_cast<uint64_t>(type.type()));
+    Emit(type.bits());
+    Emit(type.lanes());
+    Emit(static_cast<uint64_t>(type.cpp_type()));
+    if (type.is_customized_type()) {
+      EmitString(type.customized_type());
+    }
+  }
+
+  void EmitName(const std::string& name, absl::flat_hash_map<std::string, uint64_t>* numbering) {
+    Emit(numbering->try_emplace(name, numbering->size()).first->second);
+  }
+
+  void EmitAttrs(const std::map<std::string, attr_t>& attrs) {
+    Emit(attrs.size());
+    for (auto& item : attrs) {
+      EmitString(item.first);
+      Emit(item.second.index());
+      if (auto* v = absl::get_if<int>(&item.second)) {
+        Emit(static_cast<int64_t>(*v));
+      } else if (auto* v = absl::get_if<float>(&item.second)) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, v, sizeof(bits));
+        Emit(bits);
+      } else if (auto* v = absl::get_if<bool>(&item.second)) {
+        Emit(*v);
+      } else if (auto* v = absl::get_if<std::string>(&item.second)) {
+        EmitString(*v);
+      }
+    }
+  }
+
+  void SerializeVar(const Var& var) {
+    if (!var.defined()) {
+      Emit(kUndefined);
+      return;
+    }
+    Serialize(Expr(var));
+  }
+
+  void SerializeVars(const std::vector<Var>& vars) {
+    Emit(kListBegin);
+    Emit(vars.size());
+    for (auto& var : vars) {
+      SerializeVar(var);
+    }
+  }
+
+  void SerializeForBase(const ForBase& node) {
+    Emit(static_cast<uint64_t>(node.for_type()));
+    Emit(node.vectorize_info().level);
+    Emit(node.vectorize_info().factor);
+    Emit(static_cast<uint64_t>(node.bind_info().for_type));
+    Emit(node.bind_info().offset);
+    Emit(static_cast<uint64_t>(node.bind_info().device));
+  }
+
+  void SerializeNode(const Expr& expr) {
+    Emit(static_cast<uint64_t>(expr.node_type()));
+    EmitType(expr.type());
+    switch (expr.node_type()) {
+      case IrNodeTy::IntImm:
+        Emit(expr.As<IntImm>()->value);
+        break;
+      case IrNodeTy::UIntImm:
+        Emit(expr.As<UIntImm>()->value);
+        break;
+      case IrNodeTy::FloatImm: {
+        double value = expr.As<FloatImm>()->value;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Emit(bits);
+        break;
+      }
+      case IrNodeTy::StringImm:
+        EmitString(expr.As<StringImm>()->value);
+        break;
+      case IrNodeTy::_Var_: {
+        auto* node = expr.As<_Var_>();
+        EmitName(node->name, &var_numbering_);
+        Emit(node->is_reduce_axis);
+        break;
+      }
+      case IrNodeTy::_Tensor_: {
+        auto* node = expr.As<_Tensor_>();
+        EmitName(node->name, &object_numbering_);
+        SerializeList(node->shape);
+        break;
+      }
+      case IrNodeTy::_Buffer_: {
+        auto* node = expr.As<_Buffer_>();
+        EmitName(node->name, &object_numbering_);
+        EmitType(node->dtype);
+        Emit(static_cast<uint64_t>(node->memory_type));
+        break;
+      }
+      case IrNodeTy::_BufferRange_: {
+        auto* node = expr.As<_BufferRange_>();
+        Serialize(node->buffer);
+        SerializeVars(node->ranges);
+        break;
+      }
+      case IrNodeTy::For: {
+        auto* node = expr.As<For>();
+        SerializeVar(node->loop_var);
+        SerializeForBase(*node);
+        Emit(static_cast<uint64_t>(node->device_api));
+        Serialize(node->min);
+        Serialize(node->extent);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::PolyFor: {
+        auto* node = expr.As<PolyFor>();
+        SerializeVar(node->iterator);
+        SerializeForBase(*node);
+        Emit(static_cast<uint64_t>(node->device_api));
+        Serialize(node->init);
+        Serialize(node->condition);
+        Serialize(node->inc);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::ScheduleBlock: {
+        auto* node = expr.As<ScheduleBlock>();
+        EmitName(node->name, &object_numbering_);
+        SerializeVars(node->iter_vars);
+        SerializeList(node->read_buffers);
+        SerializeList(node->write_buffers);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::ScheduleBlockRealize: {
+        auto* node = expr.As<ScheduleBlockRealize>();
+        SerializeList(node->iter_values);
+        Serialize(node->schedule_block);
+        break;
+      }
+      case IrNodeTy::Call: {
+        auto* node = expr.As<Call>();
+        EmitString(node->name);
+        Emit(static_cast<uint64_t>(node->call_type));
+        Emit(node->value_index);
+        SerializeList(node->read_args);
+        SerializeList(node->write_args);
+        EmitAttrs(node->attrs);
+        break;
+      }
+      case IrNodeTy::PrimitiveNode: {
+        auto* node = expr.As<PrimitiveNode>();
+        EmitString(node->name);
+        Emit(node->arguments.size());
+        for (auto& args : node->arguments) {
+          SerializeList(args);
+        }
+        EmitAttrs(node->attrs);
+        break;
+      }
+      case IrNodeTy::Let: {
+        auto* node = expr.As<Let>();
+        Serialize(node->symbol);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::Alloc: {
+        auto* node = expr.As<Alloc>();
+        Serialize(node->destination);
+        SerializeList(node->extents);
+        Serialize(node->condition);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::Free:
+        Serialize(expr.As<Free>()->destination);
+        break;
+      case IrNodeTy::Reduce: {
+        auto* node = expr.As<Reduce>();
+        Emit(static_cast<uint64_t>(node->reduce_type));
+        Serialize(node->init);
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::Ramp: {
+        auto* node = expr.As<Ramp>();
+        Emit(node->lanes);
+        Serialize(node->base);
+        Serialize(node->stride);
+        break;
+      }
+      case IrNodeTy::Broadcast: {
+        auto* node = expr.As<Broadcast>();
+        Emit(node->lanes);
+        Serialize(node->value);
+        break;
+      }
+      case IrNodeTy::_LoweredFunc_: {
+        auto* node = expr.As<_LoweredFunc_>();
+        Emit(node->args.size());
+        Serialize(node->body);
+        break;
+      }
+      case IrNodeTy::IntrinsicOp:
+        Emit(static_cast<uint64_t>(expr.As<IntrinsicOp>()->getKind()));
+        SerializeFields(expr);
+        break;
+      default:
+        // the operators, Cast, Select, IfThenElse, Block, Load, Store and the other nodes with only expr fields
+        SerializeFields(expr);
+    }
+  }
+
+  void SerializeFields(const Expr& expr) {
+    const IrNode* node              = expr.ptr();
+    std::vector<const Expr*> fields = node->expr_fields();
+    if (fields.empty()) {
+      SerializeList(node->operands);
+      return;
+    }
+    Emit(kListBegin);
+    Emit(fields.size());
+    for (auto* field : fields) {
+      Serialize(*field);
+    }
+  }
+
+  std::vector<uint64_t> tokens_;
+  // the range of tokens of each serialized node
+  absl::flat_hash_map<const IrNode*, std::pair<size_t, size_t>> memo_;
+  absl::flat_hash_map<std::string, uint64_t> var_numbering_;
+  absl::flat_hash_map<std::string, uint64_t> object_numbering_;
+};
+
+// FNV-1a over the bytes of the tokens, which is stable across processes
+uint64_t HashTokens(const std::vector<uint64_t>& tokens) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint64_t token : tokens) {
+    for (int i = 0; i < 8; ++i) {
+      hash ^= (token >> (i * 8)) & 0xff;
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+uint64_t StructuralHash(const Expr& expr) {
+  CanonicalSerializer serializer;
+  serializer.Serialize(expr);
+  return HashTokens(serializer.tokens());
+}
+
+uint64_t StructuralHash(const std::vector<Expr>& exprs) {
+  CanonicalSerializer serializer;
+  serializer.SerializeList(exprs);
+  return HashTokens(serializer.tokens());
+}
+
+bool StructuralEqual(const Expr& lhs, const Expr& rhs) {
+  CanonicalSerializer lhs_serializer, rhs_serializer;
+  lhs_serializer.Serialize(lhs);
+  rhs_serializer.Serialize(rhs);
+  return lhs_serializer.tokens() == rhs_serializer.tokens();
+}
+
+bool StructuralEqual(const std::vector<Expr>& lhs, const std::vector<Expr>& rhs) {
+  CanonicalSerializer lhs_serializer, rhs_serializer;
+  lhs_serializer.SerializeList(lhs);
+  rhs_serializer.SerializeList(rhs);
+  return lhs_serializer.tokens() == rhs_serializer.tokens();
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,43 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * Structural hash and equality of exprs, which are invariant to the naming.
+ *
+ * The exprs are serialized into a canonical form, where the variables, tensors, buffers and schedule blocks
+ * are replaced by the order they first appear in, so two exprs are equal if they only differ in the names
+ * consistently. The compute bodies of the tensors are not included. The canonical form of a node shared by
+ * several parents is memoized and serialized only once per call. The hash is stable across processes.
+ */
+uint64_t StructuralHash(const Expr& expr);
+
+//! The hash of a list of exprs, such as the exprs of a ModuleExpr, the names are numbered across the exprs.
+uint64_t StructuralHash(const std::vector<Expr>& exprs);
+
+bool StructuralEqual(const Expr& lhs, const Expr& rhs);
+
+bool StructuralEqual(const std::vector<Expr>& lhs, const std::vector<Expr>& rhs);
+
+}  // namespace ir
+}  // namespace cinn
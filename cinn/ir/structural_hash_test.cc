@@ -0,0 +1,77 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/structural_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace ir {
+
+// for (loop_var, 0, extent) { C[loop_var] = A[loop_var] + B[loop_var] }
+Expr MakeAddLoop(const std::string& loop_var_name, const std::string& output_name, int extent, ForType for_type) {
+  Placeholder<float> A("A", std::vector<int>{{extent}});
+  Placeholder<float> B("B", std::vector<int>{{extent}});
+  Placeholder<float> C(output_name, std::vector<int>{{extent}});
+  Var loop_var(loop_var_name);
+
+  Expr body = Store::Make(
+      Tensor(C),
+      Add::Make(Load::Make(Tensor(A), {Expr(loop_var)}), Load::Make(Tensor(B), {Expr(loop_var)})),
+      {Expr(loop_var)});
+  return For::Make(
+      loop_var, common::make_const(0), common::make_const(extent), for_type, DeviceAPI::UNK, Block::Make({body}));
+}
+
+TEST(StructuralHash, InvariantToNaming) {
+  Expr expr         = MakeAddLoop("i", "C", 16, ForType::Serial);
+  Expr renamed_expr = MakeAddLoop("j", "D", 16, ForType::Serial);
+
+  EXPECT_EQ(StructuralHash(expr), StructuralHash(optim::IRCopy(expr)));
+  EXPECT_TRUE(StructuralEqual(expr, optim::IRCopy(expr)));
+  EXPECT_EQ(StructuralHash(expr), StructuralHash(renamed_expr));
+  EXPECT_TRUE(StructuralEqual(expr, renamed_expr));
+}
+
+TEST(StructuralHash, DistinguishStructures) {
+  Expr expr = MakeAddLoop("i", "C", 16, ForType::Serial);
+
+  Expr other_extent = MakeAddLoop("i", "C", 32, ForType::Serial);
+  EXPECT_NE(StructuralHash(expr), StructuralHash(other_extent));
+  EXPECT_FALSE(StructuralEqual(expr, other_extent));
+
+  Expr other_for_type = MakeAddLoop("i", "C", 16, ForType::Parallel);
+  EXPECT_NE(StructuralHash(expr), StructuralHash(other_for_type));
+  EXPECT_FALSE(StructuralEqual(expr, other_for_type));
+
+  // the output is one of the inputs, which is different from writing a new tensor
+  Expr in_place = MakeAddLoop("i", "A", 16, ForType::Serial);
+  EXPECT_NE(StructuralHash(expr), StructuralHash(in_place));
+  EXPECT_FALSE(StructuralEqual(expr, in_place));
+
+  // the names are numbered across the exprs of a list
+  Expr another = MakeAddLoop("j", "D", 16, ForType::Serial);
+  EXPECT_TRUE(StructuralEqual(std::vector<Expr>({expr, another}), std::vector<Expr>({another, expr})));
+  EXPECT_FALSE(StructuralEqual(std::vector<Expr>({expr, expr}), std::vector<Expr>({expr, another})));
+}
+
+}  // namespace ir
+}  // namespace cinn
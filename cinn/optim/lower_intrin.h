@@ -26,7 +26,7 @@ static const std::set<std::string> kIntrinsicCalls{
     {"exp",         "exp2",       "sqrt",        "log",         "log2",        "log10", "floor",
      "ceil",        "round",      "trunc",       "cos",         "cosh",        "tan",   "tanh",
      "sin",         "sinh",       "fabs",        "isnan",       "isfinite",    "isinf", "left_shift",
-     "right_shift", "bitwise_or", "bitwise_and", "bitwise_xor", "bitwise_not", "fma",   "rsqrt"}};
+     "right_shift", "bitwise_or", "bitwise_and", "bitwise_xor", "bitwise_not", "fma",   "rsqrt", "erf"}};
 
 /**
  * Map the Call nodes to llvm intrinsic.
@@ -655,11 +655,33 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
         return;
       }
 
-      const int factor  = forloop->vectorize_info().factor;
+      const int factor = forloop->vectorize_info().factor;
+      // peel the iterations that can not fill a whole vector into a serial epilogue, so the vectorized
+      // loop never accesses beyond the extent
+      Expr tail_forloop;
+      if (node->extent.As<IntImm>() && node->extent.as_int32() % factor != 0) {
+        int main_extent = node->extent.as_int32() / factor * factor;
+        tail_forloop    = PeelTailForLoop(node, main_extent);
+        if (main_extent == 0) {
+          *expr = tail_forloop;
+          var_intervals.erase(loopvar_name);
+          return;
+        }
+        node->extent = make_const(node->extent->type(), main_extent);
+        var_intervals.erase(loopvar_name);
+        var_intervals.emplace(loopvar_name, common::CasInterval{0, main_extent - 1});
+      }
+      auto append_tail = [&] {
+        if (tail_forloop.defined()) {
+          *expr = Block::Make({*expr, tail_forloop});
+        }
+      };
+
       auto _new_forloop = SplitForLoop(node, factor);
       if (!_new_forloop.defined()) {
         IRMutator<>::Visit(&node->body, &node->body);
         var_intervals.erase(forloop->loop_var->name);
+        append_tail();
         return;
       }
 
@@ -674,6 +696,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       if (!extent_int) {
         IRMutator<>::Visit(&node->body, &node->body);
         var_intervals.erase(forloop->loop_var->name);
+        append_tail();
         return;
       }
 
@@ -710,6 +733,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       } else {
         node->body = new_forloop->body;
       }
+      append_tail();
     } else {
       IRMutator::Visit(forloop, expr);
     }
@@ -781,6 +805,21 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! Create a serial forloop over the iterations of \p forloop from \p begin to its constant extent.
+  //! @return The new forloop.
+  Expr PeelTailForLoop(For *forloop, int begin) {
+    Var tail_iterator(common::UniqName(forloop->loop_var->name + "_tail"), forloop->loop_var->type());
+    Expr tail_body = IRCopy(forloop->body);
+    optim::IrReplace(
+        &tail_body, forloop->loop_var, Expr(tail_iterator) + make_const(forloop->loop_var->type(), begin));
+    return For::Make(tail_iterator,
+                     make_const(forloop->extent->type(), 0),
+                     make_const(forloop->extent->type(), forloop->extent.as_int32() - begin),
+                     ForType::Serial,
+                     forloop->device_api,
+                     tail_body);
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
@@ -64,6 +64,7 @@ TEST(Vectorize, replace_var) {
 
   CodeGenC codegen(target);
   codegen.SetInlineBuiltinCodes(false);
+  // the 496 leading iterations are vectorized and the left 4 ones are computed in a serial epilogue
   auto out        = codegen.Compile(builder.Build(), CodeGenC::OutputKind::CImpl);
   auto target_out = R"ROC(
 #include <cinn_runtime.h>
@@ -79,9 +80,12 @@ void matmul(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
-    for (int32_t j = 0; j < 32; j += 1) {
+    for (int32_t j = 0; j < 31; j += 1) {
       C[StackVec<16,int32_t>::Ramp(((500 * i) + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,((500 * i) + (16 * j))) * StackedVec<float,16>::Load(B,((500 * i) + (16 * j))));
     };
+    for (int32_t j_tail = 0; j_tail < 4; j_tail += 1) {
+      C[(496 + ((500 * i) + j_tail))] = (A[(496 + ((500 * i) + j_tail))] * B[(496 + ((500 * i) + j_tail))]);
+    };
   };
   cinn_buffer_free((void*)(0), _C);
 }
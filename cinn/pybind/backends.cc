@@ -35,10 +35,18 @@ namespace {
 void BindExecutionEngine(py::module *);
 
 void BindExecutionEngine(py::module *m) {
+  py::enum_<cinn_x86_isa_level_t> isa_level(*m, "X86ISALevel");
+  isa_level.value("SSE4_2", cinn_x86_isa_sse4_2)
+      .value("AVX2", cinn_x86_isa_avx2)
+      .value("AVX512", cinn_x86_isa_avx512)
+      .export_values();
+
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("enable_fast_math", &ExecutionOptions::enable_fast_math)
+      .def_readwrite("isa_levels", &ExecutionOptions::isa_levels);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
@@ -52,7 +60,8 @@ void BindExecutionEngine(py::module *m) {
   engine.def_static("create", &ExecutionEngine::Create, py::arg("options") = ExecutionOptions())
       .def(py::init(&ExecutionEngine::Create), py::arg("options") = ExecutionOptions())
       .def("lookup", lookup)
-      .def("link", &ExecutionEngine::Link);
+      .def("link", &ExecutionEngine::Link)
+      .def("export_object", &ExecutionEngine::ExportObject);
 
   {
     auto lookup = [](Compiler &self, absl::string_view name) {
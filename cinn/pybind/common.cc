@@ -65,9 +65,12 @@ void BindTarget(py::module *m) {
       .def(py::init<>())
       .def(py::init<Target::OS, Target::Arch, Target::Bit, const std::vector<Target::Feature> &>())
       .def("defined", &Target::defined)
+      .def("has_feature", &Target::has_feature)
       .def("runtime_arch", &Target::runtime_arch);
 
-  m->def("DefaultHostTarget", &common::DefaultHostTarget).def("DefaultNVGPUTarget", &common::DefaultNVGPUTarget);
+  m->def("DefaultHostTarget", &common::DefaultHostTarget)
+      .def("DefaultNVGPUTarget", &common::DefaultNVGPUTarget)
+      .def("DetectedHostTarget", &common::DetectedHostTarget);
 
   py::enum_<Target::OS> os(target, "OS");
   os.value("Unk", Target::OS::Unk).value("Linux", Target::OS::Linux).value("Windows", Target::OS::Windows);
@@ -82,7 +85,11 @@ void BindTarget(py::module *m) {
   bit.value("Unk", Target::Bit::Unk).value("k32", Target::Bit::k32).value("k64", Target::Bit::k64);
 
   py::enum_<Target::Feature> feature(target, "Feature");
-  feature.value("JIT", Target::Feature::JIT).value("Debug", Target::Feature::Debug);
+  feature.value("JIT", Target::Feature::JIT)
+      .value("Debug", Target::Feature::Debug)
+      .value("SSE4_2", Target::Feature::SSE4_2)
+      .value("AVX2", Target::Feature::AVX2)
+      .value("AVX512", Target::Feature::AVX512);
 
   m->def("is_compiled_with_cuda", IsCompiledWithCUDA);
   m->def("is_compiled_with_cudnn", IsCompiledWithCUDNN);
@@ -164,6 +164,14 @@ extern void* cinn_buffer_get_data_const_handle(const struct cinn_buffer_t* buf);
 //! Create a new default cinn_buffer.
 extern cinn_buffer_t* cinn_buffer_new_default(int target, uint64_t memory_size, int align = 32);
 
+//! The x86 instruction set levels the CPU kernels can be compiled for, a higher level includes the lower ones.
+typedef enum cinn_x86_isa_level_t {
+  cinn_x86_isa_unk    = -1,  //! Not even SSE4.2 is supported.
+  cinn_x86_isa_sse4_2 = 0,   //! SSE4.2
+  cinn_x86_isa_avx2   = 1,   //! AVX2 and FMA
+  cinn_x86_isa_avx512 = 2,   //! AVX-512 F, CD, BW, DQ and VL
+} cinn_x86_isa_level_t;
+
 //! The raw representation of a buffer,used in the generated code/lib.
 #define CINN_BUFFER_MAX_DIMS 8
 typedef struct cinn_buffer_t {
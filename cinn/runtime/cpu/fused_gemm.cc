@@ -0,0 +1,441 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/fused_gemm.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/backends/llvm/runtime_symbol_registry.h"
+#include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/parallel_thread_pool.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+#include "cinn/runtime/intrinsic.h"
+
+#ifdef CINN_WITH_MKL_CBLAS
+#include <mkl_cblas.h>
+#include <mkl_service.h>
+#endif
+
+namespace {
+
+// The rows of C in a block are computed and then go through the epilogue together. A block is about the size of L2,
+// and smaller if needed to give every thread a block.
+constexpr int kBlockBytes   = 256 * 1024;
+constexpr int kMinBlockRows = 16;
+// the number of rows of C updated together by each row of B in the fallback product
+constexpr int kRowTile = 4;
+
+struct FusedGemmArgs {
+  int M;
+  int N;
+  int K;
+  bool ta;
+  int lda;
+  int ldc;
+  float alpha;
+  float beta;
+  int bias_kind;
+  int activation;
+  const float* A;
+  // op(B) packed once for all the blocks
+  const float* packed_B;
+  const float* bias;
+  const float* residual;
+  float* C;
+  int block_rows;
+  int num_blocks;
+};
+
+#ifdef CINN_WITH_MKL_CBLAS
+inline CBLAS_TRANSPOSE ToCblasTranspose(bool trans) { return trans ? CblasTrans : CblasNoTrans; }
+
+// MKL takes the rows of op(A) to pack B as well, but the packed B depends only on N and K, and is shared by the
+// products of any rows
+constexpr int kPackRows = kMinBlockRows;
+
+int PackedBSize(int N, int K) {
+  size_t bytes = cblas_sgemm_pack_get_size(CblasBMatrix, kPackRows, N, K);
+  return static_cast<int>((bytes + sizeof(float) - 1) / sizeof(float));
+}
+
+float* AllocPackedB(int N, int K) { return cblas_sgemm_alloc(CblasBMatrix, kPackRows, N, K); }
+
+void FreePackedB(float* packed) { cblas_sgemm_free(packed); }
+
+// Pack op(B) into the internal format of MKL
+void PackB(int N, int K, bool tb, int ldb, const float* B, float* packed) {
+  cblas_sgemm_pack(CblasRowMajor, CblasBMatrix, ToCblasTranspose(tb), kPackRows, N, K, 1.f, B, ldb, packed);
+}
+
+void ProductRowBlock(const FusedGemmArgs& args, int begin, int end) {
+  const float* A = args.ta ? args.A + begin : args.A + static_cast<int64_t>(begin) * args.lda;
+  // the blocks are already spread over the workers, and MKL only detects the nested OpenMP regions but not the
+  // workers of the thread pool, so each product is limited to the calling thread
+  int mkl_threads = mkl_set_num_threads_local(1);
+  cblas_sgemm_compute(CblasRowMajor,
+                      ToCblasTranspose(args.ta),
+                      CblasPacked,
+                      end - begin,
+                      args.N,
+                      args.K,
+                      A,
+                      args.lda,
+                      args.packed_B,
+                      args.N,
+                      0.f,
+                      args.C + static_cast<int64_t>(begin) * args.ldc,
+                      args.ldc);
+  mkl_set_num_threads_local(mkl_threads);
+}
+#else
+int PackedBSize(int N, int K) { return N * K; }
+
+float* AllocPackedB(int N, int K) { return new float[static_cast<int64_t>(K) * N]; }
+
+void FreePackedB(float* packed) { delete[] packed; }
+
+// Pack op(B) into a K x N row-major matrix, whose rows are contiguous in the innermost loop of the product
+void PackB(int N, int K, bool tb, int ldb, const float* B, float* packed) {
+  for (int k = 0; k < K; ++k) {
+    float* row = packed + static_cast<int64_t>(k) * N;
+    for (int j = 0; j < N; ++j) {
+      row[j] = tb ? B[static_cast<int64_t>(j) * ldb + k] : B[static_cast<int64_t>(k) * ldb + j];
+    }
+  }
+}
+
+inline float ElementOfA(const FusedGemmArgs& args, int i, int k) {
+  return args.ta ? args.A[static_cast<int64_t>(k) * args.lda + i] : args.A[static_cast<int64_t>(i) * args.lda + k];
+}
+
+void ProductRowBlock(const FusedGemmArgs& args, int begin, int end) {
+  const int N = args.N;
+  // each row of B is loaded once for kRowTile rows of C, and the innermost loop over the columns is vectorized
+  for (int i0 = begin; i0 < end; i0 += kRowTile) {
+    int rows = std::min(kRowTile, end - i0);
+    float* c[kRowTile];
+    for (int r = 0; r < rows; ++r) {
+      c[r] = args.C + static_cast<int64_t>(i0 + r) * args.ldc;
+      std::fill(c[r], c[r] + N, 0.f);
+    }
+    for (int k = 0; k < args.K; ++k) {
+      const float* b = args.packed_B + static_cast<int64_t>(k) * N;
+      for (int r = 0; r < rows; ++r) {
+        float a    = ElementOfA(args, i0 + r, k);
+        float* c_r = c[r];
+        for (int j = 0; j < N; ++j) {
+          c_r[j] += a * b[j];
+        }
+      }
+    }
+  }
+}
+#endif
+
+template <int kActivation>
+inline float Activate(float x) {
+  switch (kActivation) {
+    case cinn_gemm_activation_relu:
+      return x > 0.f ? x : 0.f;
+    case cinn_gemm_activation_sigmoid:
+      return 1.f / (1.f + expf(-x));
+    case cinn_gemm_activation_tanh:
+      return tanhf(x);
+    case cinn_gemm_activation_gelu:
+      return 0.5f * x * (1.f + erff(x * 0.70710678118654752f));
+    default:
+      return x;
+  }
+}
+
+template <int kActivation>
+void EpilogueRowBlock(const FusedGemmArgs& args, int begin, int end) {
+  const int N = args.N;
+  for (int i = begin; i < end; ++i) {
+    float* c          = args.C + static_cast<int64_t>(i) * args.ldc;
+    const float* bias = nullptr;
+    if (args.bias_kind == cinn_gemm_bias_row) {
+      bias = args.bias;
+    } else if (args.bias_kind == cinn_gemm_bias_full) {
+      bias = args.bias + static_cast<int64_t>(i) * N;
+    }
+    const float* residual = args.residual ? args.residual + static_cast<int64_t>(i) * N : nullptr;
+    for (int j = 0; j < N; ++j) {
+      float value = args.alpha * c[j];
+      if (bias) {
+        value += args.beta * bias[j];
+      }
+      value = Activate<kActivation>(value);
+      if (residual) {
+        value += residual[j];
+      }
+      c[j] = value;
+    }
+  }
+}
+
+void EpilogueRowBlock(const FusedGemmArgs& args, int begin, int end) {
+  switch (args.activation) {
+    case cinn_gemm_activation_none:
+      EpilogueRowBlock<cinn_gemm_activation_none>(args, begin, end);
+      break;
+    case cinn_gemm_activation_relu:
+      EpilogueRowBlock<cinn_gemm_activation_relu>(args, begin, end);
+      break;
+    case cinn_gemm_activation_sigmoid:
+      EpilogueRowBlock<cinn_gemm_activation_sigmoid>(args, begin, end);
+      break;
+    case cinn_gemm_activation_tanh:
+      EpilogueRowBlock<cinn_gemm_activation_tanh>(args, begin, end);
+      break;
+    case cinn_gemm_activation_gelu:
+      EpilogueRowBlock<cinn_gemm_activation_gelu>(args, begin, end);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported activation of the fused gemm: " << args.activation;
+  }
+}
+
+// The task computes the blocks of task_id, task_id + num_task, ..., each of which goes through the epilogue right
+// after its product
+int FusedGemmTask(int task_id, int num_task, void* datas) {
+  const auto& args = *static_cast<FusedGemmArgs*>(datas);
+  for (int block = task_id; block < args.num_blocks; block += num_task) {
+    int begin = block * args.block_rows;
+    int end   = std::min(args.M, begin + args.block_rows);
+    ProductRowBlock(args, begin, end);
+    EpilogueRowBlock(args, begin, end);
+  }
+  return 0;
+}
+
+// Launch the tasks on the backend registered as the parallel_launch intrinsic, which the JIT kernels run on too,
+// so the kernels of a graph share one set of workers
+int ParallelLaunch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  static auto* launch = reinterpret_cast<int (*)(FCINNParallelLambda, void*, int)>(
+      cinn::backends::RuntimeSymbolRegistry::Global().Lookup(cinn::runtime::intrinsic::parallel_launch));
+  return launch ? launch(flambda, datas, num_task) : cinn_backend_thread_pool_launch(flambda, datas, num_task);
+}
+
+FusedGemmArgs MakeFusedGemmArgs(float alpha,
+                                int M,
+                                int N,
+                                int K,
+                                bool ta,
+                                int lda,
+                                int ldc,
+                                float beta,
+                                int bias_kind,
+                                int activation,
+                                bool has_residual,
+                                cinn_buffer_t* A,
+                                cinn_buffer_t* bias,
+                                cinn_buffer_t* residual,
+                                cinn_buffer_t* C) {
+  FusedGemmArgs args;
+  args.M          = M;
+  args.N          = N;
+  args.K          = K;
+  args.ta         = ta;
+  args.lda        = lda;
+  args.ldc        = ldc;
+  args.alpha      = alpha;
+  args.beta       = beta;
+  args.bias_kind  = bias_kind;
+  args.activation = activation;
+  args.A          = reinterpret_cast<float*>(A->memory);
+  args.bias       = bias_kind == cinn_gemm_bias_none ? nullptr : reinterpret_cast<float*>(bias->memory);
+  args.residual   = has_residual ? reinterpret_cast<float*>(residual->memory) : nullptr;
+  args.C          = reinterpret_cast<float*>(C->memory);
+  return args;
+}
+
+// Split the rows of C into blocks and compute them in parallel with the packed B
+void LaunchFusedGemm(FusedGemmArgs* args) {
+  int num_workers  = cinn_backend_thread_concurrency();
+  int l2_rows      = kBlockBytes / static_cast<int>(sizeof(float) * args->N);
+  args->block_rows = std::max(kMinBlockRows, std::min(l2_rows, (args->M + num_workers - 1) / num_workers));
+  args->num_blocks = (args->M + args->block_rows - 1) / args->block_rows;
+  int num_task     = std::min(args->num_blocks, num_workers);
+  if (num_task > 1) {
+    ParallelLaunch(FusedGemmTask, args, num_task);
+  } else {
+    FusedGemmTask(0, 1, args);
+  }
+}
+
+}  // namespace
+
+void cinn_cpu_fused_gemm_fp32(float alpha,
+                              int M,
+                              int N,
+                              int K,
+                              bool ta,
+                              bool tb,
+                              int lda,
+                              int ldb,
+                              int ldc,
+                              float beta,
+                              int bias_kind,
+                              int activation,
+                              bool has_residual,
+                              cinn_buffer_t* A,
+                              cinn_buffer_t* B,
+                              cinn_buffer_t* bias,
+                              cinn_buffer_t* residual,
+                              cinn_buffer_t* C) {
+  if (M <= 0 || N <= 0) {
+    return;
+  }
+  auto args = MakeFusedGemmArgs(
+      alpha, M, N, K, ta, lda, ldc, beta, bias_kind, activation, has_residual, A, bias, residual, C);
+  float* packed_B = AllocPackedB(N, K);
+  PackB(N, K, tb, ldb, reinterpret_cast<float*>(B->memory), packed_B);
+  args.packed_B = packed_B;
+  LaunchFusedGemm(&args);
+  FreePackedB(packed_B);
+}
+
+int cinn_cpu_fused_gemm_packed_b_size(int N, int K) { return PackedBSize(N, K); }
+
+void cinn_cpu_fused_gemm_pack_b_fp32(int N, int K, bool tb, int ldb, cinn_buffer_t* B, cinn_buffer_t* packed_B) {
+  if (N <= 0 || K <= 0) {
+    return;
+  }
+  PackB(N, K, tb, ldb, reinterpret_cast<float*>(B->memory), reinterpret_cast<float*>(packed_B->memory));
+}
+
+void cinn_cpu_fused_gemm_packed_fp32(float alpha,
+                                     int M,
+                                     int N,
+                                     int K,
+                                     bool ta,
+                                     int lda,
+                                     int ldc,
+                                     float beta,
+                                     int bias_kind,
+                                     int activation,
+                                     bool has_residual,
+                                     cinn_buffer_t* A,
+                                     cinn_buffer_t* packed_B,
+                                     cinn_buffer_t* bias,
+                                     cinn_buffer_t* residual,
+                                     cinn_buffer_t* C) {
+  if (M <= 0 || N <= 0) {
+    return;
+  }
+  auto args = MakeFusedGemmArgs(
+      alpha, M, N, K, ta, lda, ldc, beta, bias_kind, activation, has_residual, A, bias, residual, C);
+  args.packed_B = reinterpret_cast<float*>(packed_B->memory);
+  LaunchFusedGemm(&args);
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_fused_gemm) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_fused_gemm = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 17UL) << "Wrong number of arguments passed in";
+    auto M = common::AutoSimplify(args[1]);
+    auto N = common::AutoSimplify(args[2]);
+    std::vector<Expr> shape;
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_fused_gemm_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<int>()              // bias_kind
+      .AddInputType<int>()              // activation
+      .AddInputType<bool>()             // has_residual
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddInputType<cinn_buffer_t*>()   // bias
+      .AddInputType<cinn_buffer_t*>()   // residual
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_fused_gemm)
+      .End();
+
+  FunctionProto::shape_inference_t inference_shape_pack_b = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 5UL) << "Wrong number of arguments passed in";
+    auto N = common::AutoSimplify(args[0]);
+    auto K = common::AutoSimplify(args[1]);
+    CHECK(N.is_constant() && K.is_constant()) << "The packed B of the fused gemm requires the constant N and K";
+    return std::vector<Expr>{Expr(cinn_cpu_fused_gemm_packed_b_size(N.as_int32(), K.as_int32()))};
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_fused_gemm_pack_b_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // ldb
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // packed_B
+      .SetShapeInference(inference_shape_pack_b)
+      .End();
+
+  FunctionProto::shape_inference_t inference_shape_fused_gemm_packed = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 15UL) << "Wrong number of arguments passed in";
+    auto M = common::AutoSimplify(args[1]);
+    auto N = common::AutoSimplify(args[2]);
+    std::vector<Expr> shape;
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_fused_gemm_packed_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<int>()              // bias_kind
+      .AddInputType<int>()              // activation
+      .AddInputType<bool>()             // has_residual
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // packed_B
+      .AddInputType<cinn_buffer_t*>()   // bias
+      .AddInputType<cinn_buffer_t*>()   // residual
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_fused_gemm_packed)
+      .End();
+
+  return true;
+}
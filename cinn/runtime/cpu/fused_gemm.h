@@ -0,0 +1,125 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file defines the C API of the GEMM with a fused epilogue on CPU.
+#include "cinn/runtime/cinn_runtime.h"
+
+extern "C" {
+
+//! The kind of the bias added in the epilogue of cinn_cpu_fused_gemm_fp32.
+typedef enum cinn_gemm_bias_kind_t {
+  cinn_gemm_bias_none = 0,
+  //! a vector of N elements broadcast to every row
+  cinn_gemm_bias_row = 1,
+  //! a matrix of M x N elements
+  cinn_gemm_bias_full = 2,
+} cinn_gemm_bias_kind_t;
+
+//! The activation applied in the epilogue of cinn_cpu_fused_gemm_fp32.
+typedef enum cinn_gemm_activation_t {
+  cinn_gemm_activation_none    = 0,
+  cinn_gemm_activation_relu    = 1,
+  cinn_gemm_activation_sigmoid = 2,
+  cinn_gemm_activation_tanh    = 3,
+  //! the exact gelu by erf
+  cinn_gemm_activation_gelu = 4,
+} cinn_gemm_activation_t;
+
+/**
+ * \brief Compute C = act(alpha * op(A) * op(B) + beta * bias) + residual in one pass over C.
+ * The rows of C are computed block by block, and the epilogue is applied to each block right after its product, while
+ * the block is still in cache, so the output is written to memory only once. op(B) is packed on each call and shared by
+ * the blocks, which run in parallel on the parallel_launch backend of the JIT kernels. The product of a block is
+ * computed by a single-threaded cblas_sgemm_compute if CINN is built with MKL, otherwise by a loop vectorized over
+ * the columns. See cinn_cpu_fused_gemm_packed_fp32 to pack a constant B only once.
+ * @param alpha The scaling factor of the product of A and B
+ * @param M Number of the rows of op(A) and C
+ * @param N the number of the columns in both op(B) and C
+ * @param K the number of columns of op(A)
+ * @param ta whether to transpose A
+ * @param tb whether to transpose B
+ * @param lda The size of the first dimension of A
+ * @param ldb The size of the first dimension of B
+ * @param ldc The size of the first dimension of C
+ * @param beta The scaling factor of the bias
+ * @param bias_kind The cinn_gemm_bias_kind_t of the bias
+ * @param activation The cinn_gemm_activation_t applied after the bias
+ * @param has_residual whether to add the residual after the activation
+ * @param A The matrix A
+ * @param B The matrix B
+ * @param bias The bias, ignored if bias_kind is cinn_gemm_bias_none
+ * @param residual The M x N matrix added at last, ignored if has_residual is false
+ * @param C The output matrix
+ */
+void cinn_cpu_fused_gemm_fp32(float alpha,
+                              int M,
+                              int N,
+                              int K,
+                              bool ta,
+                              bool tb,
+                              int lda,
+                              int ldb,
+                              int ldc,
+                              float beta,
+                              int bias_kind,
+                              int activation,
+                              bool has_residual,
+                              cinn_buffer_t* A,
+                              cinn_buffer_t* B,
+                              cinn_buffer_t* bias,
+                              cinn_buffer_t* residual,
+                              cinn_buffer_t* C);
+
+/**
+ * \brief The number of floats holding op(B) packed by cinn_cpu_fused_gemm_pack_b_fp32.
+ * @param N the number of the columns in op(B)
+ * @param K the number of the rows in op(B)
+ */
+int cinn_cpu_fused_gemm_packed_b_size(int N, int K);
+
+/**
+ * \brief Pack op(B) into the format read by cinn_cpu_fused_gemm_packed_fp32, so a constant B is packed only once.
+ * The format is the internal one of MKL if CINN is built with MKL, which depends on the CPU and the version of MKL,
+ * so the packed B should not be saved, otherwise it is a K x N row-major matrix.
+ * @param N the number of the columns in op(B)
+ * @param K the number of the rows in op(B)
+ * @param tb whether to transpose B
+ * @param ldb The size of the first dimension of B
+ * @param B The matrix B
+ * @param packed_B The output of cinn_cpu_fused_gemm_packed_b_size(N, K) floats
+ */
+void cinn_cpu_fused_gemm_pack_b_fp32(int N, int K, bool tb, int ldb, cinn_buffer_t* B, cinn_buffer_t* packed_B);
+
+/**
+ * \brief The same as cinn_cpu_fused_gemm_fp32, except that op(B) has been packed by cinn_cpu_fused_gemm_pack_b_fp32.
+ */
+void cinn_cpu_fused_gemm_packed_fp32(float alpha,
+                                     int M,
+                                     int N,
+                                     int K,
+                                     bool ta,
+                                     int lda,
+                                     int ldc,
+                                     float beta,
+                                     int bias_kind,
+                                     int activation,
+                                     bool has_residual,
+                                     cinn_buffer_t* A,
+                                     cinn_buffer_t* packed_B,
+                                     cinn_buffer_t* bias,
+                                     cinn_buffer_t* residual,
+                                     cinn_buffer_t* C);
+
+}  // extern "C"
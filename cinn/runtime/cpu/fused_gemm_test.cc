@@ -0,0 +1,158 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/fused_gemm.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/common/test_helper.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+struct FusedGemmCase {
+  bool ta;
+  bool tb;
+  int bias_kind;
+  int activation;
+  bool has_residual;
+  // whether B is packed by cinn_cpu_fused_gemm_pack_b_fp32 in advance
+  bool packed_b = false;
+};
+
+float Activate(float x, int activation) {
+  switch (activation) {
+    case cinn_gemm_activation_relu:
+      return std::max(x, 0.f);
+    case cinn_gemm_activation_sigmoid:
+      return 1.f / (1.f + std::exp(-x));
+    case cinn_gemm_activation_tanh:
+      return std::tanh(x);
+    case cinn_gemm_activation_gelu:
+      return 0.5f * x * (1.f + std::erf(x / std::sqrt(2.f)));
+    default:
+      return x;
+  }
+}
+
+void TestFusedGemm(const FusedGemmCase& c) {
+  // N is large enough that the rows of C are split into several blocks
+  const int M = 150, N = 1024, K = 32;
+  const float alpha = 0.5f, beta = 2.f;
+  std::vector<int> a_shape    = c.ta ? std::vector<int>{K, M} : std::vector<int>{M, K};
+  std::vector<int> b_shape    = c.tb ? std::vector<int>{N, K} : std::vector<int>{K, N};
+  std::vector<int> bias_shape = c.bias_kind == cinn_gemm_bias_row ? std::vector<int>{N} : std::vector<int>{M, N};
+  auto* A                     = common::BufferBuilder(Float(32), a_shape).set_random().Build();
+  auto* B                     = common::BufferBuilder(Float(32), b_shape).set_random().Build();
+  auto* bias                  = common::BufferBuilder(Float(32), bias_shape).set_random().Build();
+  auto* residual              = common::BufferBuilder(Float(32), {M, N}).set_random().Build();
+  auto* C                     = common::BufferBuilder(Float(32), {M, N}).set_zero().Build();
+
+  if (c.packed_b) {
+    auto* packed_B = common::BufferBuilder(Float(32), {cinn_cpu_fused_gemm_packed_b_size(N, K)}).set_zero().Build();
+    cinn_cpu_fused_gemm_pack_b_fp32(N, K, c.tb, c.tb ? K : N, B, packed_B);
+    cinn_cpu_fused_gemm_packed_fp32(alpha,
+                                    M,
+                                    N,
+                                    K,
+                                    c.ta,
+                                    c.ta ? M : K,
+                                    N,
+                                    beta,
+                                    c.bias_kind,
+                                    c.activation,
+                                    c.has_residual,
+                                    A,
+                                    packed_B,
+                                    bias,
+                                    residual,
+                                    C);
+  } else {
+    cinn_cpu_fused_gemm_fp32(alpha,
+                             M,
+                             N,
+                             K,
+                             c.ta,
+                             c.tb,
+                             c.ta ? M : K,
+                             c.tb ? K : N,
+                             N,
+                             beta,
+                             c.bias_kind,
+                             c.activation,
+                             c.has_residual,
+                             A,
+                             B,
+                             bias,
+                             residual,
+                             C);
+  }
+
+  auto* a_data   = reinterpret_cast<float*>(A->memory);
+  auto* b_data   = reinterpret_cast<float*>(B->memory);
+  auto* bias_ptr = reinterpret_cast<float*>(bias->memory);
+  auto* res_data = reinterpret_cast<float*>(residual->memory);
+  auto* c_data   = reinterpret_cast<float*>(C->memory);
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float expected = 0.f;
+      for (int k = 0; k < K; ++k) {
+        expected += (c.ta ? a_data[k * M + i] : a_data[i * K + k]) * (c.tb ? b_data[j * K + k] : b_data[k * N + j]);
+      }
+      expected *= alpha;
+      if (c.bias_kind == cinn_gemm_bias_row) {
+        expected += beta * bias_ptr[j];
+      } else if (c.bias_kind == cinn_gemm_bias_full) {
+        expected += beta * bias_ptr[i * N + j];
+      }
+      expected = Activate(expected, c.activation);
+      if (c.has_residual) {
+        expected += res_data[i * N + j];
+      }
+      float tolerance = 1e-4f * std::max(1.f, std::abs(expected));
+      ASSERT_NEAR(c_data[i * N + j], expected, tolerance) << "at (" << i << ", " << j << ")";
+    }
+  }
+}
+
+TEST(FusedGemm, bias_relu) { TestFusedGemm({false, false, cinn_gemm_bias_row, cinn_gemm_activation_relu, false}); }
+
+TEST(FusedGemm, trans_b_full_bias_gelu_residual) {
+  TestFusedGemm({false, true, cinn_gemm_bias_full, cinn_gemm_activation_gelu, true});
+}
+
+TEST(FusedGemm, trans_a_sigmoid) {
+  TestFusedGemm({true, false, cinn_gemm_bias_none, cinn_gemm_activation_sigmoid, false});
+}
+
+TEST(FusedGemm, trans_ab_bias_tanh_residual) {
+  TestFusedGemm({true, true, cinn_gemm_bias_row, cinn_gemm_activation_tanh, true});
+}
+
+TEST(FusedGemm, packed_trans_b_bias_relu) {
+  TestFusedGemm({false, true, cinn_gemm_bias_row, cinn_gemm_activation_relu, false, true});
+}
+
+TEST(FusedGemm, packed_trans_a_full_bias_residual) {
+  TestFusedGemm({true, false, cinn_gemm_bias_full, cinn_gemm_activation_none, true, true});
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -17,6 +17,10 @@
 #include <glog/logging.h>
 #include <math.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
 
@@ -53,6 +57,27 @@ inline int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num) {
 }
 
 #undef __cinn_host_find_kernel
+
+int cinn_x86_isa_level() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_2)) return cinn_x86_isa_unk;
+  // the AVX states should also be saved by the OS on context switches, which is told by XCR0
+  if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX) || !(ecx & bit_FMA)) return cinn_x86_isa_sse4_2;
+  unsigned int xcr0, xcr0_high;
+  __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+  // the XMM and YMM states
+  if ((xcr0 & 0x6) != 0x6 || __get_cpuid_max(0, nullptr) < 7) return cinn_x86_isa_sse4_2;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  if (!(ebx & bit_AVX2)) return cinn_x86_isa_sse4_2;
+  // the opmask and the ZMM states
+  const unsigned int avx512_bits = bit_AVX512F | bit_AVX512CD | bit_AVX512BW | bit_AVX512DQ | bit_AVX512VL;
+  if ((ebx & avx512_bits) != avx512_bits || (xcr0 & 0xe6) != 0xe6) return cinn_x86_isa_avx2;
+  return cinn_x86_isa_avx512;
+#else
+  return cinn_x86_isa_unk;
+#endif
+}
 }
 
 CINN_REGISTER_HELPER(host_intrinsics) {
@@ -28,4 +28,7 @@ void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out);
 inline int cinn_host_find_int(const cinn_buffer_t* buf, int size, int num);
 
 inline int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num);
+
+//! Detect the highest x86 instruction set level, one of cinn_x86_isa_level_t, supported by both the CPU and the OS.
+int cinn_x86_isa_level();
 }
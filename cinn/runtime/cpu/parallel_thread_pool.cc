@@ -0,0 +1,195 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/parallel_thread_pool.h"
+
+#include <glog/logging.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+// whether the calling thread is running a parallel lambda
+thread_local bool in_parallel_lambda = false;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+int GetEnvInt(const char* name, int default_value) {
+  const char* val = getenv(name);
+  return val == nullptr ? default_value : atoi(val);
+}
+
+void BindToCore(std::thread* thread, int core_id) {
+  int num_cores = std::thread::hardware_concurrency();
+  if (num_cores <= 0) return;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(core_id % num_cores, &cpuset);
+  int ret = pthread_setaffinity_np(thread->native_handle(), sizeof(cpu_set_t), &cpuset);
+  if (ret != 0) {
+    LOG(WARNING) << "Failed to bind a worker of ParallelThreadPool to core " << core_id << ": " << strerror(ret);
+  }
+}
+
+}  // namespace
+
+ParallelThreadPool& ParallelThreadPool::Global() {
+  static ParallelThreadPool* pool = []() {
+    const char* schedule_str = getenv("CINN_PARALLEL_SCHEDULE");
+    Schedule schedule =
+        schedule_str != nullptr && strcmp(schedule_str, "dynamic") == 0 ? Schedule::kDynamic : Schedule::kStatic;
+    return new ParallelThreadPool(max_concurrency(),
+                                  schedule,
+                                  std::max(GetEnvInt("CINN_PARALLEL_CHUNK", 1), 1),
+                                  std::max(GetEnvInt("CINN_THREAD_SPIN", 10000), 0),
+                                  GetEnvInt("CINN_THREAD_BIND", 0) == 1);
+  }();
+  return *pool;
+}
+
+ParallelThreadPool::ParallelThreadPool(
+    int num_threads, Schedule schedule, int chunk_size, int spin_count, bool bind_cores)
+    : schedule_(schedule), chunk_size_(chunk_size), spin_count_(spin_count) {
+  CHECK_GT(num_threads, 0);
+  CHECK_GT(chunk_size, 0);
+  // the calling thread is the 0-th participant, so only num_threads - 1 workers are needed
+  for (int i = 0; i < num_threads - 1; ++i) {
+    workers_.emplace_back([this, i]() { WorkerLoop(i); });
+    if (bind_cores) {
+      BindToCore(&workers_.back(), i + 1);
+    }
+  }
+}
+
+ParallelThreadPool::~ParallelThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(park_mu_);
+    stop_ = true;
+  }
+  park_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool ParallelThreadPool::RunTasks(int participant_id) {
+  if (participant_id >= num_participants_) return true;
+  in_parallel_lambda = true;
+  bool success       = true;
+  if (schedule_ == Schedule::kStatic) {
+    for (int task_id = participant_id; task_id < num_task_; task_id += num_participants_) {
+      success &= (*flambda_)(task_id, num_task_, datas_) == 0;
+    }
+  } else {
+    for (int begin = next_task_.fetch_add(chunk_size_); begin < num_task_; begin = next_task_.fetch_add(chunk_size_)) {
+      int end = std::min(begin + chunk_size_, num_task_);
+      for (int task_id = begin; task_id < end; ++task_id) {
+        success &= (*flambda_)(task_id, num_task_, datas_) == 0;
+      }
+    }
+  }
+  in_parallel_lambda = false;
+  return success;
+}
+
+void ParallelThreadPool::WorkerLoop(int worker_id) {
+  uint64_t seen_epoch = 0;
+  while (true) {
+    // spin for a while before parking
+    uint64_t epoch = epoch_.load();
+    for (int i = 0; i < spin_count_ && epoch == seen_epoch && !stop_.load(); ++i) {
+      CpuRelax();
+      epoch = epoch_.load();
+    }
+    if (epoch == seen_epoch) {
+      std::unique_lock<std::mutex> lock(park_mu_);
+      num_parked_++;
+      park_cv_.wait(lock, [this, seen_epoch]() { return stop_.load() || epoch_.load() != seen_epoch; });
+      num_parked_--;
+      if (stop_.load()) break;
+      epoch = epoch_.load();
+    }
+    seen_epoch = epoch;
+
+    // the 0-th participant is the launching thread
+    if (!RunTasks(worker_id + 1)) {
+      failed_ = true;
+    }
+    num_finished_++;
+  }
+}
+
+int ParallelThreadPool::Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  int num_threads = cinn_backend_thread_concurrency();
+  if (num_task == 0) num_task = num_threads;
+  if (num_task <= 0) return 0;
+
+  // a nested launch runs serially, the outer launch has occupied the cores
+  if (in_parallel_lambda) {
+    int ret = 0;
+    for (int task_id = 0; task_id < num_task; ++task_id) {
+      ret |= (*flambda)(task_id, num_task, datas);
+    }
+    return ret == 0 ? 0 : -1;
+  }
+
+  std::unique_lock<std::mutex> launch_lock(launch_mu_, std::try_to_lock);
+  if (!launch_lock.owns_lock()) {
+    VLOG(4) << "ParallelThreadPool is busy, fall back to OpenMP";
+    return cinn_backend_parallel_launch(flambda, datas, num_task);
+  }
+
+  flambda_          = flambda;
+  datas_            = datas;
+  num_task_         = num_task;
+  num_participants_ = std::min({num_threads, num_task, this->num_threads()});
+  next_task_        = 0;
+  failed_           = false;
+  num_finished_     = 0;
+  // publish the job, the workers observing the new epoch see all the fields above
+  epoch_++;
+  if (num_parked_.load() > 0) {
+    std::lock_guard<std::mutex> lock(park_mu_);
+    park_cv_.notify_all();
+  }
+
+  bool success = RunTasks(0);
+  // all the workers have to check in before the job can be overwritten by the next launch
+  while (num_finished_.load() < workers_.size()) {
+    CpuRelax();
+  }
+  return success && !failed_.load() ? 0 : -1;
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
+
+int cinn_backend_thread_pool_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  return cinn::runtime::cpu::ParallelThreadPool::Global().Launch(flambda, datas, num_task);
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+/**
+ * ParallelThreadPool is a persistent fork-join thread pool running the parallel lambdas generated for
+ * parallel loops, it replaces the OpenMP parallel region launched by cinn_backend_parallel_launch.
+ *
+ * The calling thread takes part in the work as the 0-th participant, and the workers spin for a while
+ * waiting for the next launch before parking, so back-to-back launches of small kernels do not pay for
+ * waking up threads. The following environment variables are read once on creation:
+ *  - CINN_NUM_THREADS/OMP_NUM_THREADS: the number of threads, the same as max_concurrency();
+ *  - CINN_THREAD_BIND: pin the i-th worker to the i-th core if it is set to 1;
+ *  - CINN_THREAD_SPIN: the number of polls a worker spins before parking, 10000 by default;
+ *  - CINN_PARALLEL_SCHEDULE: "static"(default) assigns the task i to the participant i % num_threads,
+ *    "dynamic" lets participants grab chunks of CINN_PARALLEL_CHUNK(1 by default) tasks.
+ */
+class ParallelThreadPool {
+ public:
+  enum class Schedule { kStatic, kDynamic };
+
+  static ParallelThreadPool& Global();
+
+  ParallelThreadPool(int num_threads, Schedule schedule, int chunk_size, int spin_count, bool bind_cores);
+  ~ParallelThreadPool();
+
+  /**
+   * Run flambda(task_id, num_task, datas) for each task_id in [0, num_task).
+   *
+   * A nested launch from inside a parallel lambda runs all its tasks serially on the calling thread,
+   * and a launch while the pool is busy with another thread falls back to OpenMP.
+   * @return 0 when no error is thrown, -1 when any task fails.
+   */
+  int Launch(FCINNParallelLambda flambda, void* datas, int num_task);
+
+  int num_threads() const { return workers_.size() + 1; }
+
+ private:
+  void WorkerLoop(int worker_id);
+  //! Run the tasks assigned to the participant, return false if any task fails.
+  bool RunTasks(int participant_id);
+
+  Schedule schedule_;
+  int chunk_size_;
+  int spin_count_;
+
+  std::vector<std::thread> workers_;
+  // only one launch can use the pool at the same time
+  std::mutex launch_mu_;
+
+  // the current job, written before epoch_ is increased
+  FCINNParallelLambda flambda_{nullptr};
+  void* datas_{nullptr};
+  int num_task_{0};
+  int num_participants_{0};
+  std::atomic<int> next_task_{0};
+  std::atomic<bool> failed_{false};
+
+  // increased once for every launch to wake up the workers
+  std::atomic<uint64_t> epoch_{0};
+  // the number of workers which finished the current job
+  std::atomic<int> num_finished_{0};
+
+  std::mutex park_mu_;
+  std::condition_variable park_cv_;
+  std::atomic<int> num_parked_{0};
+  std::atomic<bool> stop_{false};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ParallelThreadPool);
+};
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
+
+extern "C" {
+
+/**
+ * @brief Run a parallel lambda on the persistent ParallelThreadPool, which has the same semantic with
+ * cinn_backend_parallel_launch and is registered as the parallel_launch intrinsic unless CINN_USE_OPENMP=1.
+ */
+int cinn_backend_thread_pool_launch(FCINNParallelLambda flambda, void* datas, int num_task);
+
+}  // extern "C"
@@ -0,0 +1,94 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/parallel_thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+struct TaskRecord {
+  std::vector<std::atomic<int>> visits;
+  std::atomic<int> num_task_seen{0};
+  explicit TaskRecord(int n) : visits(n) {
+    for (auto& v : visits) v = 0;
+  }
+};
+
+static int RecordTask(int task_id, int num_task, void* datas) {
+  auto* record = static_cast<TaskRecord*>(datas);
+  record->visits[task_id]++;
+  record->num_task_seen = num_task;
+  return 0;
+}
+
+static int FailOddTask(int task_id, int num_task, void* datas) { return task_id % 2; }
+
+static int NestedLaunch(int task_id, int num_task, void* datas) {
+  auto* records = static_cast<std::vector<TaskRecord*>*>(datas);
+  return ParallelThreadPool::Global().Launch(RecordTask, records->at(task_id), 3);
+}
+
+void CheckAllTasksRunOnce(ParallelThreadPool* pool, int num_task) {
+  TaskRecord record(num_task);
+  ASSERT_EQ(pool->Launch(RecordTask, &record, num_task), 0);
+  for (int i = 0; i < num_task; ++i) {
+    EXPECT_EQ(record.visits[i].load(), 1) << "task " << i;
+  }
+  EXPECT_EQ(record.num_task_seen.load(), num_task);
+}
+
+TEST(ParallelThreadPool, Static) {
+  ParallelThreadPool pool(4, ParallelThreadPool::Schedule::kStatic, 1, 100, false);
+  EXPECT_EQ(pool.num_threads(), 4);
+  for (int round = 0; round < 100; ++round) {
+    CheckAllTasksRunOnce(&pool, 1 + round % 13);
+  }
+}
+
+TEST(ParallelThreadPool, Dynamic) {
+  ParallelThreadPool pool(4, ParallelThreadPool::Schedule::kDynamic, 3, 0, false);
+  for (int round = 0; round < 100; ++round) {
+    CheckAllTasksRunOnce(&pool, 1 + round % 29);
+  }
+}
+
+TEST(ParallelThreadPool, Failure) {
+  ParallelThreadPool pool(2, ParallelThreadPool::Schedule::kStatic, 1, 100, false);
+  EXPECT_EQ(pool.Launch(FailOddTask, nullptr, 1), 0);
+  EXPECT_EQ(pool.Launch(FailOddTask, nullptr, 4), -1);
+}
+
+TEST(ParallelThreadPool, Nested) {
+  std::vector<std::unique_ptr<TaskRecord>> records;
+  std::vector<TaskRecord*> datas;
+  for (int i = 0; i < 4; ++i) {
+    records.emplace_back(new TaskRecord(3));
+    datas.push_back(records.back().get());
+  }
+  ASSERT_EQ(cinn_backend_thread_pool_launch(NestedLaunch, &datas, 4), 0);
+  for (auto& record : records) {
+    for (auto& v : record->visits) EXPECT_EQ(v.load(), 1);
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
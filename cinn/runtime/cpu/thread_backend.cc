@@ -20,9 +20,10 @@
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/parallel_thread_pool.h"
 #include "cinn/runtime/intrinsic.h"
 
-int max_concurrency() {
+static int ReadMaxConcurrency() {
   int max_concurrency = 1;
   const char* val     = getenv("CINN_NUM_THREADS");
   if (val == nullptr) {
@@ -39,10 +40,32 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
-int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+int max_concurrency() {
+  // read the environment variables only once, it is called by every parallel launch
+  static int max_concurrency = ReadMaxConcurrency();
+  return max_concurrency;
+}
+
+namespace {
+// the limit of threads launched from the current thread, 0 means no limit
+thread_local int thread_concurrency_limit = 0;
+}  // namespace
+
+int cinn_backend_set_thread_concurrency(int num_threads) {
+  int old_limit            = thread_concurrency_limit;
+  thread_concurrency_limit = std::max(num_threads, 0);
+  return old_limit;
+}
+
+int cinn_backend_thread_concurrency() {
   int num_workers = max_concurrency();
+  if (thread_concurrency_limit > 0) num_workers = std::min(num_workers, thread_concurrency_limit);
+  return num_workers;
+}
+
+int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  int num_workers = cinn_backend_thread_concurrency();
   if (num_task == 0) num_task = num_workers;
-  omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
   {
     int thread_num = omp_get_thread_num();
@@ -55,7 +78,14 @@ CINN_REGISTER_HELPER(cinn_backend_parallel) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
   auto host_target = common::DefaultHostTarget();
-  backends::RuntimeSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_launch,
-                                                       reinterpret_cast<void*>(&cinn_backend_parallel_launch));
+  // the persistent thread pool is used unless OpenMP is required explicitly
+  const char* use_openmp = getenv("CINN_USE_OPENMP");
+  if (use_openmp != nullptr && atoi(use_openmp) == 1) {
+    backends::RuntimeSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_launch,
+                                                         reinterpret_cast<void*>(&cinn_backend_parallel_launch));
+  } else {
+    backends::RuntimeSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_launch,
+                                                         reinterpret_cast<void*>(&cinn_backend_thread_pool_launch));
+  }
   return true;
 }
@@ -44,4 +44,20 @@ typedef int (*FCINNParallelLambda)(int task_id, int num_task, void* datas);
  */
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task);
 
+/**
+ * @brief Limit the number of threads launched by cinn_backend_parallel_launch from the calling thread,
+ * so the inter-op parallelism and the intra-op parallelism do not oversubscribe the cores.
+ *
+ * @param num_threads The maximal number of threads, 0 means no limit.
+ *
+ * @return The previous limit.
+ */
+int cinn_backend_set_thread_concurrency(int num_threads);
+
+/**
+ * @brief Get the number of threads a parallel launch with num_task=0 uses from the calling thread,
+ * that is max_concurrency() restricted by the limit set by cinn_backend_set_thread_concurrency.
+ */
+int cinn_backend_thread_concurrency();
+
 }  // extern "C"
@@ -17,6 +17,9 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <thread>  // NOLINT
+
 #ifdef CINN_WITH_CUDNN
 DEFINE_bool(cinn_cudnn_deterministic,
             false,
@@ -26,6 +29,7 @@ DEFINE_bool(cinn_cudnn_deterministic,
 #endif
 
 using ::GFLAGS_NAMESPACE::BoolFromEnv;
+using ::GFLAGS_NAMESPACE::Int32FromEnv;
 using ::GFLAGS_NAMESPACE::StringFromEnv;
 
 // FLAGS to switch optimization status
@@ -45,6 +49,44 @@ DEFINE_bool(cinn_ir_schedule,
             BoolFromEnv("FLAGS_cinn_ir_schedule", false),
             "Whether use reconstructed schedule primitives.");
 
+DEFINE_bool(cinn_use_caching_allocator,
+            BoolFromEnv("FLAGS_cinn_use_caching_allocator", false),
+            "Whether cache the freed host memory in size-class bins for reuse instead of returning it to the system.");
+
+DEFINE_int32(cinn_inter_op_concurrency,
+             Int32FromEnv("FLAGS_cinn_inter_op_concurrency", 1),
+             "The number of instructions allowed to run at the same time on X86, instructions run serially if it is 1.");
+
+DEFINE_string(cinn_llvm_object_cache_dir,
+              StringFromEnv("FLAGS_cinn_llvm_object_cache_dir", ""),
+              "Specify the directory to cache the objects compiled by LLVM across processes, disabled if it is empty.");
+
+DEFINE_int32(cinn_llvm_object_cache_size_mb,
+             Int32FromEnv("FLAGS_cinn_llvm_object_cache_size_mb", 1024),
+             "The maximum total size in MB of the objects in the LLVM object cache directory.");
+
+DEFINE_bool(cinn_llvm_fast_math,
+            BoolFromEnv("FLAGS_cinn_llvm_fast_math", false),
+            "Whether compile the X86 kernels with the fast math flags, which allows the approximated math "
+            "functions and the reassociation of the float operations.");
+
+DEFINE_string(cinn_x86_isa_levels,
+              StringFromEnv("FLAGS_cinn_x86_isa_levels", ""),
+              "The comma separated x86 instruction set levels, from sse4.2, avx2 and avx512, to compile each X86 "
+              "kernel for. The kernels dispatch to the best version supported by the running CPU, so the exported "
+              "object runs on all the CPUs supporting the lowest level. Empty to compile only for the host CPU.");
+
+DEFINE_bool(cinn_machine_specific_prepack,
+            BoolFromEnv("FLAGS_cinn_machine_specific_prepack", true),
+            "Whether prepack the constant weights into the formats depending on the CPU, e.g. the B of cpu_gemm into "
+            "the internal format of MKL, which can not be exported by Program::Export. Disable it to build the "
+            "programs to export.");
+
+DEFINE_int32(cinn_parallel_compile_thread,
+             Int32FromEnv("FLAGS_cinn_parallel_compile_thread", 1),
+             "The number of threads lowering the fusion groups and compiling the LLVM module on X86, all the cores "
+             "are used if it is not greater than 0.");
+
 // FLAGS for performance analysis and accuracy debug
 DEFINE_bool(cinn_sync_run,
             BoolFromEnv("FLAGS_cinn_sync_run", false),
@@ -82,5 +124,10 @@ bool GetCinnCudnnDeterministic() {
 #endif
 }
 
+int GetCinnParallelCompileThreadNum() {
+  if (FLAGS_cinn_parallel_compile_thread > 0) return FLAGS_cinn_parallel_compile_thread;
+  return std::max<int>(std::thread::hardware_concurrency(), 1);
+}
+
 }  // namespace runtime
 }  // namespace cinn
@@ -20,5 +20,8 @@ namespace runtime {
 void SetCinnCudnnDeterministic(bool state);
 bool GetCinnCudnnDeterministic();
 
+//! The number of threads compiling a graph, all the cores are used if FLAGS_cinn_parallel_compile_thread <= 0.
+int GetCinnParallelCompileThreadNum();
+
 }  // namespace runtime
 }  // namespace cinn
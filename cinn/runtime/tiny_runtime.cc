@@ -12,41 +12,100 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "cinn/runtime/tiny_runtime.h"
+
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
-#include "cinn_runtime.h"
-
 extern "C" {
 int max_num_workers = std::thread::hardware_concurrency();
+
+typedef void (*func_t)(cinn_pod_value_t *, int);
+
 // move to standlone file
 struct param_context_t {
   int major_v;
   int minor_v;
+  // the whole file read into memory, only used by v0
   std::vector<uint8_t> buf;
   std::vector<std::vector<uint8_t>> temporary;
+  // the read-only mapping of the file, the arena of the temporaries and the embedded library, only used by v1
+  void *mapped{nullptr};
+  size_t mapped_size{0};
+  void *arena{nullptr};
+  void *library{nullptr};
+  std::vector<cinn_buffer_t> buffers;
+  std::vector<std::vector<cinn_pod_value_t>> args;
+
   std::map<std::string, cinn_pod_value_t> name2podvalue;
   std::vector<std::string> instructions;
+  // resolved on loading, the null ones are resolved again on running
+  std::vector<func_t> funcs;
   std::vector<int> inst_argc;
   std::vector<cinn_pod_value_t *> inst_argv;
+
+  ~param_context_t() {
+    if (library) dlclose(library);
+    if (arena) free(arena);
+    if (mapped) munmap(mapped, mapped_size);
+  }
 };
+}
 
-void *load_program(const char *paramfile) {
-  FILE *f = fopen(paramfile, "r");
-  fseek(f, 0, SEEK_END);
-  int fsize = ftell(f);
-  rewind(f);
-  if (fsize < 32) {
-    fclose(f);
-    return nullptr;
+namespace {
+
+func_t LookupFunction(void *library, const char *name) {
+  void *p = library ? dlsym(library, name) : nullptr;
+  if (!p) p = dlsym(RTLD_DEFAULT, name);
+  return (func_t)p;
+}
+
+// dlopen the shared library embedded in the program file through an anonymous file
+void *OpenEmbeddedLibrary(const uint8_t *data, size_t size) {
+  int fd = -1;
+  char path[64];
+#ifdef MFD_CLOEXEC
+  fd = memfd_create("cinn_program_library", MFD_CLOEXEC);
+#endif
+  bool is_temp_file = false;
+  if (fd < 0) {
+    snprintf(path, sizeof(path), "/tmp/cinn_program_library_XXXXXX");
+    fd           = mkstemp(path);
+    is_temp_file = true;
+  } else {
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+  }
+  if (fd < 0) return nullptr;
+
+  void *library  = nullptr;
+  size_t written = 0;
+  while (written < size) {
+    ssize_t ret = write(fd, data + written, size - written);
+    if (ret <= 0) break;
+    written += ret;
+  }
+  if (written == size) {
+    library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!library) fprintf(stderr, "Failed to open the library embedded in the program: %s\n", dlerror());
   }
+  close(fd);
+  if (is_temp_file) unlink(path);
+  return library;
+}
 
+void *load_program_v0(FILE *f, int fsize) {
   std::unique_ptr<param_context_t> ctx(new param_context_t{});
   int alignment = std::max(alignof(cinn_pod_value_t), alignof(cinn_buffer_t));
   ctx->buf.resize(fsize + alignment);
@@ -55,13 +114,7 @@ void *load_program(const char *paramfile) {
     buf = buf + alignment - ((uintptr_t)buf % alignment);
   }
   fread(buf, 1, fsize, f);
-  fclose(f);
 
-  if (std::string(buf, buf + 4) != "CINN") {
-    // TODO LOG fatal
-    return nullptr;
-  }
-  // TODO check param file version
   ctx->major_v = *(int *)(buf + 4);
   ctx->minor_v = *(int *)(buf + 8);
 
@@ -104,6 +157,7 @@ void *load_program(const char *paramfile) {
   for (int i = 0; i < inst_pos[1]; i++) {
     const char *inst = (const char *)(buf + inst_pos[2 + i * 3 + 0]);
     ctx->instructions.push_back(inst);
+    ctx->funcs.push_back(LookupFunction(nullptr, inst));
     int instargc = inst_pos[2 + i * 3 + 1];
     ctx->inst_argc.push_back(instargc);
     cinn_pod_value_t *argv = (cinn_pod_value_t *)(buf + inst_pos[2 + i * 3 + 2]);
@@ -118,19 +172,152 @@ void *load_program(const char *paramfile) {
   return ctx.release();
 }
 
+void *load_program_v1(int fd, size_t fsize) {
+  if (fsize < sizeof(cinn_program_header_t)) return nullptr;
+  void *mapped = mmap(nullptr, fsize, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    fprintf(stderr, "Failed to map the program file\n");
+    return nullptr;
+  }
+  std::unique_ptr<param_context_t> ctx(new param_context_t{});
+  ctx->mapped      = mapped;
+  ctx->mapped_size = fsize;
+
+  const uint8_t *base                 = (const uint8_t *)mapped;
+  const cinn_program_header_t *header = (const cinn_program_header_t *)base;
+  ctx->major_v                        = header->major_v;
+  ctx->minor_v                        = header->minor_v;
+
+  auto in_file   = [fsize](uint64_t offset, uint64_t size) { return offset <= fsize && size <= fsize - offset; };
+  auto string_at = [base, fsize](uint64_t offset) -> const char * {
+    if (offset >= fsize || !memchr(base + offset, 0, fsize - offset)) return nullptr;
+    return (const char *)(base + offset);
+  };
+  if (header->file_size != fsize || !in_file(header->vars_offset, header->num_vars * sizeof(cinn_program_var_t)) ||
+      !in_file(header->instructions_offset, header->num_instructions * sizeof(cinn_program_instruction_t)) ||
+      !in_file(header->weights_offset, header->weights_size) ||
+      !in_file(header->library_offset, header->library_size)) {
+    fprintf(stderr, "The program file is truncated or corrupted\n");
+    return nullptr;
+  }
+
+  if (header->arena_size > 0) {
+    size_t alignment = std::max<size_t>(header->arena_alignment, sizeof(void *));
+    if (posix_memalign(&ctx->arena, alignment, header->arena_size) != 0) {
+      ctx->arena = nullptr;
+      return nullptr;
+    }
+    // the temporaries start from zero like the ones allocated by the scope
+    memset(ctx->arena, 0, header->arena_size);
+  }
+
+  const cinn_program_var_t *vars = (const cinn_program_var_t *)(base + header->vars_offset);
+  ctx->buffers.resize(header->num_vars);
+  for (uint64_t i = 0; i < header->num_vars; i++) {
+    const char *name      = string_at(vars[i].name_offset);
+    cinn_buffer_t &buffer = ctx->buffers[i];
+    buffer                = vars[i].buffer;
+    uint64_t end          = vars[i].data_offset + buffer.memory_size;
+    if (vars[i].kind == cinn_program_var_persistent && end <= header->weights_size) {
+      // the weights are used in place, they are read-only
+      buffer.memory = const_cast<uint8_t *>(base + header->weights_offset + vars[i].data_offset);
+    } else if (vars[i].kind == cinn_program_var_temporary && end <= header->arena_size) {
+      buffer.memory = (uint8_t *)ctx->arena + vars[i].data_offset;
+    } else {
+      name = nullptr;
+    }
+    if (!name) {
+      fprintf(stderr, "Invalid variable %lu in the program file\n", (unsigned long)i);
+      return nullptr;
+    }
+    ctx->name2podvalue[name] = cinn_pod_value_t(&buffer);
+  }
+
+  if (header->library_size > 0) {
+    ctx->library = OpenEmbeddedLibrary(base + header->library_offset, header->library_size);
+    if (!ctx->library) return nullptr;
+  }
+
+  const cinn_program_instruction_t *instrs = (const cinn_program_instruction_t *)(base + header->instructions_offset);
+  ctx->args.resize(header->num_instructions);
+  for (uint64_t i = 0; i < header->num_instructions; i++) {
+    const char *name = string_at(instrs[i].name_offset);
+    if (!name || !in_file(instrs[i].args_offset, instrs[i].num_args * sizeof(int32_t))) {
+      fprintf(stderr, "Invalid instruction %lu in the program file\n", (unsigned long)i);
+      return nullptr;
+    }
+    const int32_t *arg_indices = (const int32_t *)(base + instrs[i].args_offset);
+    for (uint64_t j = 0; j < instrs[i].num_args; j++) {
+      if (arg_indices[j] < 0 || arg_indices[j] >= header->num_vars) {
+        fprintf(stderr, "Invalid argument of instruction %s in the program file\n", name);
+        return nullptr;
+      }
+      ctx->args[i].emplace_back(&ctx->buffers[arg_indices[j]]);
+    }
+    ctx->instructions.push_back(name);
+    ctx->funcs.push_back(LookupFunction(ctx->library, name));
+    ctx->inst_argc.push_back(instrs[i].num_args);
+    ctx->inst_argv.push_back(ctx->args[i].data());
+  }
+  return ctx.release();
+}
+
+}  // namespace
+
+extern "C" {
+
+void *load_program(const char *paramfile) {
+  int fd = open(paramfile, O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < 32) {
+    close(fd);
+    return nullptr;
+  }
+
+  char magic[4];
+  int32_t major_v = -1;
+  if (pread(fd, magic, 4, 0) != 4 || pread(fd, &major_v, 4, 4) != 4 || std::string(magic, magic + 4) != "CINN") {
+    fprintf(stderr, "%s is not a CINN program file\n", paramfile);
+    close(fd);
+    return nullptr;
+  }
+
+  void *ctx = nullptr;
+  if (major_v == 0) {
+    FILE *f = fdopen(fd, "r");
+    ctx     = load_program_v0(f, st.st_size);
+    fclose(f);
+    return ctx;
+  }
+  if (major_v == CINN_PROGRAM_MAJOR_VERSION) {
+    ctx = load_program_v1(fd, st.st_size);
+  } else {
+    fprintf(stderr,
+            "The version %d of the program file %s is not supported, the latest version is %d\n",
+            major_v,
+            paramfile,
+            CINN_PROGRAM_MAJOR_VERSION);
+  }
+  close(fd);
+  return ctx;
+}
+
+void destroy_program(void *ctx) { delete (param_context_t *)ctx; }
+
 int set_maxconcurrency(int c) {
   int old_c       = max_num_workers;
   max_num_workers = c;
   return old_c;
 }
 
-typedef void (*func_t)(cinn_pod_value_t *, int);
 void run_program(void *ctx) {
   param_context_t *pc = (param_context_t *)ctx;
   for (int i = 0; i < pc->instructions.size(); i++) {
-    const char *sym = pc->instructions[i].c_str();
-    void *p         = dlsym(RTLD_DEFAULT, sym);
-    func_t f        = (func_t)p;
+    func_t f = pc->funcs[i];
+    if (!f) {
+      f = pc->funcs[i] = LookupFunction(pc->library, pc->instructions[i].c_str());
+    }
     f(pc->inst_argv[i], pc->inst_argc[i]);
   }
 }
@@ -0,0 +1,110 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+/**
+ * \file tiny_runtime.h
+ * The standalone runtime to load and run the programs exported by Program::Export.
+ */
+
+#include <stdint.h>
+
+#include "cinn/runtime/cinn_runtime.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The layout of the v1 program file, all the offsets are in bytes from the beginning of the file:
+ *  - cinn_program_header_t;
+ *  - the variables, an array of cinn_program_var_t;
+ *  - the instructions, an array of cinn_program_instruction_t;
+ *  - the strings and the argument indices referenced by the variables and instructions;
+ *  - the weights section, aligned to page_size, where each persistent variable resides at its data_offset;
+ *  - the optional shared library containing the compiled functions, aligned to page_size.
+ * The loader maps the file read-only, so the weights are used in place and shared among processes, while the
+ * temporary variables are placed at their data_offset in one arena of arena_size bytes.
+ */
+#define CINN_PROGRAM_MAGIC "CINN"
+#define CINN_PROGRAM_MAJOR_VERSION 1
+#define CINN_PROGRAM_MINOR_VERSION 0
+#define CINN_PROGRAM_PAGE_SIZE 4096
+
+typedef enum cinn_program_var_kind_t {
+  //! Resides in the weights section of the file.
+  cinn_program_var_persistent = 0,
+  //! Resides in the arena allocated on loading.
+  cinn_program_var_temporary = 1,
+} cinn_program_var_kind_t;
+
+typedef struct cinn_program_header_t {
+  char magic[4];
+  int32_t major_v;
+  int32_t minor_v;
+  int32_t page_size;
+  uint64_t file_size;
+  uint64_t num_vars;
+  uint64_t vars_offset;
+  uint64_t num_instructions;
+  uint64_t instructions_offset;
+  uint64_t weights_offset;
+  uint64_t weights_size;
+  uint64_t arena_size;
+  uint64_t arena_alignment;
+  //! Zero if no library is embedded, then the functions are looked up in the process.
+  uint64_t library_offset;
+  uint64_t library_size;
+} cinn_program_header_t;
+
+typedef struct cinn_program_var_t {
+  //! The offset of the null-terminated name.
+  uint64_t name_offset;
+  //! One of cinn_program_var_kind_t.
+  uint64_t kind;
+  //! The offset of the data in the weights section or the arena.
+  uint64_t data_offset;
+  //! The buffer, whose memory is set by the loader.
+  cinn_buffer_t buffer;
+} cinn_program_var_t;
+
+typedef struct cinn_program_instruction_t {
+  //! The offset of the null-terminated function name.
+  uint64_t name_offset;
+  //! The offset of the int32 indices of the argument variables.
+  uint64_t args_offset;
+  uint64_t num_args;
+} cinn_program_instruction_t;
+
+/**
+ * Load a program exported by Program::Export, both v0 and v1 files are supported.
+ * @return The context of the program, or null if the file is invalid.
+ */
+void* load_program(const char* paramfile);
+
+//! Run all the instructions of a program.
+void run_program(void* ctx);
+
+//! Get the argument of a variable in the program, null if not exists.
+cinn_pod_value_t* get_pod_value(void* ctx, const char* tname);
+
+//! Release a program and all the memory it holds.
+void destroy_program(void* ctx);
+
+//! Set the max number of threads used by the parallel loops, return the previous one.
+int set_maxconcurrency(int c);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
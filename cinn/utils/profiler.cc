@@ -14,6 +14,22 @@
 
 #include "cinn/utils/profiler.h"
 
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <utility>
+
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
 #endif
@@ -27,6 +43,268 @@
 namespace cinn {
 namespace utils {
 
+namespace {
+
+struct ThreadEventBuffer {
+  explicit ThreadEventBuffer(int thread_id, int capacity) : thread_id(thread_id), capacity(capacity) {}
+
+  void Push(HostEvent&& event) {
+    std::lock_guard<std::mutex> lock(mu);
+    if (events.size() < capacity) {
+      events.emplace_back(std::move(event));
+    } else {
+      events[next] = std::move(event);
+    }
+    next = (next + 1) % capacity;
+  }
+
+  void Reset(int new_capacity) {
+    std::lock_guard<std::mutex> lock(mu);
+    events.clear();
+    next     = 0;
+    capacity = new_capacity;
+  }
+
+  std::mutex mu;
+  const int thread_id;
+  size_t capacity;
+  // the ring buffer, next is the slot to be written
+  std::vector<HostEvent> events;
+  size_t next{0};
+};
+
+// the buffers are shared with the registry, so the events survive the exit of their threads
+struct EventBufferRegistry {
+  static EventBufferRegistry& Global() {
+    static EventBufferRegistry* registry = new EventBufferRegistry;
+    return *registry;
+  }
+
+  ThreadEventBuffer* GetThreadBuffer() {
+    thread_local std::shared_ptr<ThreadEventBuffer> buffer;
+    if (!buffer) {
+      std::lock_guard<std::mutex> lock(mu);
+      buffer = std::make_shared<ThreadEventBuffer>(next_thread_id++, capacity);
+      buffers.push_back(buffer);
+    }
+    return buffer.get();
+  }
+
+  std::mutex mu;
+  int capacity{1 << 16};
+  int next_thread_id{0};
+  std::vector<std::shared_ptr<ThreadEventBuffer>> buffers;
+};
+
+thread_local int event_depth = 0;
+
+struct RangeRecord {
+  std::string name;
+  int64_t start_ns;
+  int depth;
+};
+// the ranges opened by ProfilerRangePush on the current thread
+thread_local std::vector<RangeRecord> range_stack;
+
+double NsToMs(int64_t ns) { return ns / 1e6; }
+
+// the nearest-rank percentile of the sorted durations
+int64_t Percentile(const std::vector<int64_t>& sorted, double p) {
+  int rank = static_cast<int>(std::ceil(p * sorted.size()));
+  return sorted[std::max(rank, 1) - 1];
+}
+
+std::string EscapeJson(const std::string& str) {
+  std::string res;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        res += "\\\"";
+        break;
+      case '\\':
+        res += "\\\\";
+        break;
+      case '\n':
+        res += "\\n";
+        break;
+      case '\t':
+        res += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          res += buf;
+        } else {
+          res += c;
+        }
+    }
+  }
+  return res;
+}
+
+}  // namespace
+
+std::string EventTypeToString(EventType type) {
+  switch (type) {
+    case EventType::kOrdinary:
+      return "ordinary";
+    case EventType::kInstruction:
+      return "instruction";
+    case EventType::kKernel:
+      return "kernel";
+    case EventType::kCompilePhase:
+      return "compile";
+  }
+  return "unknown";
+}
+
+std::atomic<bool> HostProfiler::enabled_{false};
+
+void HostProfiler::Enable(int events_per_thread) {
+  CHECK_GT(events_per_thread, 0);
+  auto& registry = EventBufferRegistry::Global();
+  {
+    std::lock_guard<std::mutex> lock(registry.mu);
+    if (registry.capacity != events_per_thread) {
+      registry.capacity = events_per_thread;
+      for (auto& buffer : registry.buffers) {
+        buffer->Reset(events_per_thread);
+      }
+    }
+  }
+  enabled_.store(true);
+}
+
+void HostProfiler::Disable() { enabled_.store(false); }
+
+void HostProfiler::Clear() {
+  auto& registry = EventBufferRegistry::Global();
+  std::lock_guard<std::mutex> lock(registry.mu);
+  // the buffers only referenced by the registry belong to the exited threads
+  registry.buffers.erase(
+      std::remove_if(registry.buffers.begin(),
+                     registry.buffers.end(),
+                     [](const std::shared_ptr<ThreadEventBuffer>& buffer) { return buffer.use_count() == 1; }),
+      registry.buffers.end());
+  for (auto& buffer : registry.buffers) {
+    buffer->Reset(registry.capacity);
+  }
+}
+
+int64_t HostProfiler::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int HostProfiler::PushDepth() { return event_depth++; }
+
+void HostProfiler::Record(std::string&& name, EventType type, int64_t start_ns, int depth) {
+  int64_t end_ns = NowNs();
+  event_depth--;
+  // the events ended after the profiler is disabled are dropped
+  if (!IsEnabled()) return;
+  auto* buffer = EventBufferRegistry::Global().GetThreadBuffer();
+  buffer->Push(HostEvent{std::move(name), type, start_ns, end_ns, buffer->thread_id, depth});
+}
+
+std::vector<HostEvent> HostProfiler::GetEvents() {
+  std::vector<HostEvent> events;
+  auto& registry = EventBufferRegistry::Global();
+  std::lock_guard<std::mutex> lock(registry.mu);
+  for (auto& buffer : registry.buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mu);
+    events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+  }
+  std::stable_sort(events.begin(), events.end(), [](const HostEvent& a, const HostEvent& b) {
+    return a.start_ns != b.start_ns ? a.start_ns < b.start_ns : a.depth < b.depth;
+  });
+  return events;
+}
+
+std::vector<HostEventStatistic> HostProfiler::GetStatistics() {
+  std::map<std::pair<EventType, std::string>, std::vector<int64_t>> durations;
+  for (auto& event : GetEvents()) {
+    durations[{event.type, event.name}].push_back(event.end_ns - event.start_ns);
+  }
+
+  std::vector<HostEventStatistic> statistics;
+  for (auto& item : durations) {
+    auto& sorted = item.second;
+    std::sort(sorted.begin(), sorted.end());
+    HostEventStatistic stat;
+    stat.type     = item.first.first;
+    stat.name     = item.first.second;
+    stat.count    = sorted.size();
+    stat.total_ms = NsToMs(std::accumulate(sorted.begin(), sorted.end(), int64_t(0)));
+    stat.min_ms   = NsToMs(sorted.front());
+    stat.max_ms   = NsToMs(sorted.back());
+    stat.p50_ms   = NsToMs(Percentile(sorted, 0.5));
+    stat.p99_ms   = NsToMs(Percentile(sorted, 0.99));
+    statistics.push_back(stat);
+  }
+  std::stable_sort(statistics.begin(), statistics.end(), [](const HostEventStatistic& a, const HostEventStatistic& b) {
+    return a.total_ms > b.total_ms;
+  });
+  return statistics;
+}
+
+std::string HostProfiler::Report(const EventType* type) {
+  std::ostringstream os;
+  os << std::left << std::setw(12) << "Type" << std::setw(48) << "Name" << std::right << std::setw(10) << "Calls"
+     << std::setw(14) << "Total(ms)" << std::setw(12) << "Avg(ms)" << std::setw(12) << "Min(ms)" << std::setw(12)
+     << "Max(ms)" << std::setw(12) << "P50(ms)" << std::setw(12) << "P99(ms)"
+     << "\n";
+  os << std::fixed << std::setprecision(4);
+  for (auto& stat : GetStatistics()) {
+    if (type && stat.type != *type) continue;
+    std::string name = stat.name.size() > 46 ? stat.name.substr(0, 43) + "..." : stat.name;
+    os << std::left << std::setw(12) << EventTypeToString(stat.type) << std::setw(48) << name << std::right
+       << std::setw(10) << stat.count << std::setw(14) << stat.total_ms << std::setw(12) << stat.total_ms / stat.count
+       << std::setw(12) << stat.min_ms << std::setw(12) << stat.max_ms << std::setw(12) << stat.p50_ms
+       << std::setw(12) << stat.p99_ms << "\n";
+  }
+  return os.str();
+}
+
+bool HostProfiler::ExportChromeTrace(const std::string& path) {
+  auto events = GetEvents();
+  std::ofstream os(path);
+  if (!os.is_open()) {
+    LOG(ERROR) << "Failed to open " << path << " to export the chrome trace";
+    return false;
+  }
+
+  // the timestamps are in microseconds, starting from the first event
+  int64_t base_ns = events.empty() ? 0 : events.front().start_ns;
+  std::set<int> thread_ids;
+  os << "{\"traceEvents\":[";
+  os << std::fixed << std::setprecision(3);
+  bool first = true;
+  for (auto& event : events) {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\"" << EventTypeToString(event.type)
+       << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread_id << ",\"ts\":" << (event.start_ns - base_ns) / 1e3
+       << ",\"dur\":" << (event.end_ns - event.start_ns) / 1e3 << "}";
+    thread_ids.insert(event.thread_id);
+  }
+  for (int tid : thread_ids) {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"name\":\"thread " << tid
+       << "\"}}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  os.close();
+  if (os.fail()) {
+    LOG(ERROR) << "Failed to write the chrome trace to " << path;
+    return false;
+  }
+  VLOG(1) << "Export " << events.size() << " events to the chrome trace " << path;
+  return true;
+}
+
 void SynchronizeAllDevice() {
 #ifdef CINN_WITH_CUDA
   int current_device_id;
@@ -58,12 +336,25 @@ void ProfilerRangePush(const std::string& name) {
 #ifdef CINN_WITH_NVTX
   nvtxRangePushA(name.c_str());
 #endif
+  if (HostProfiler::IsEnabled()) {
+    int depth = HostProfiler::PushDepth();
+    range_stack.push_back(RangeRecord{name, HostProfiler::NowNs(), depth});
+  } else {
+    // keep the pushes and pops paired when the profiler is switched during a range
+    range_stack.push_back(RangeRecord{"", -1, 0});
+  }
 }
 
 void ProfilerRangePop() {
 #ifdef CINN_WITH_NVTX
   nvtxRangePop();
 #endif
+  if (range_stack.empty()) return;
+  auto range = std::move(range_stack.back());
+  range_stack.pop_back();
+  if (range.start_ns >= 0) {
+    HostProfiler::Record(std::move(range.name), EventType::kOrdinary, range.start_ns, range.depth);
+  }
 }
 
 }  // namespace utils
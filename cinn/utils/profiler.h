@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
@@ -23,18 +26,119 @@
 namespace cinn {
 namespace utils {
 
+enum class EventType {
+  kOrdinary,
+  // the whole run of an Instruction, including preparing the arguments
+  kInstruction,
+  // a single compiled function called by an Instruction
+  kKernel,
+  // a phase of the compilation, such as passes, lowering and code generation
+  kCompilePhase,
+};
+
+std::string EventTypeToString(EventType type);
+
+struct HostEvent {
+  std::string name;
+  EventType type;
+  // nanoseconds on the steady clock
+  int64_t start_ns;
+  int64_t end_ns;
+  // the id assigned to the recording thread by the profiler, starts from 0
+  int thread_id;
+  // the number of events enclosing this event on the same thread
+  int depth;
+};
+
+struct HostEventStatistic {
+  std::string name;
+  EventType type;
+  int64_t count;
+  double total_ms;
+  double min_ms;
+  double max_ms;
+  double p50_ms;
+  double p99_ms;
+};
+
+/**
+ * HostProfiler records the events on CPU, it is disabled by default and the RecordEvents cost only a
+ * relaxed atomic load when it is off.
+ *
+ * Each thread records its events into its own ring buffer, the oldest events are overwritten once the
+ * buffer is full, so a long running service can keep the profiler on and only look at the latest events.
+ */
+class HostProfiler {
+ public:
+  /**
+   * Start recording.
+   * @param events_per_thread The capacity of the ring buffer of each thread, the buffers created before
+   * are resized and cleared if the capacity changes.
+   */
+  static void Enable(int events_per_thread = 1 << 16);
+  static void Disable();
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  //! Drop all the recorded events.
+  static void Clear();
+
+  //! The recorded events of all the threads sorted by the start time.
+  static std::vector<HostEvent> GetEvents();
+
+  //! Aggregate the recorded events by the type and name, sorted by the total time in descending order.
+  static std::vector<HostEventStatistic> GetStatistics();
+
+  //! A table of the statistics for printing, only the events of the given type are listed if it is set.
+  static std::string Report(const EventType* type = nullptr);
+
+  /**
+   * Write the recorded events in the Chrome trace event format, which can be opened with
+   * chrome://tracing or Perfetto.
+   * @return Whether the file is written successfully.
+   */
+  static bool ExportChromeTrace(const std::string& path);
+
+  // used by RecordEvent, which pushes the event only if the profiler is enabled
+  static int64_t NowNs();
+  static int PushDepth();
+  static void Record(std::string&& name, EventType type, int64_t start_ns, int depth);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+/**
+ * A scoped event recorded by both the HostProfiler and NVTX, it covers the lifetime of the object.
+ */
 class RecordEvent {
  public:
-  RecordEvent(const std::string& name) {
+  RecordEvent(const std::string& name, EventType type = EventType::kOrdinary) {
 #ifdef CINN_WITH_NVTX
     nvtxRangePushA(name.c_str());
 #endif
+    if (HostProfiler::IsEnabled()) {
+      recording_ = true;
+      name_      = name;
+      type_      = type;
+      depth_     = HostProfiler::PushDepth();
+      start_ns_  = HostProfiler::NowNs();
+    }
   }
   ~RecordEvent() {
 #ifdef CINN_WITH_NVTX
     nvtxRangePop();
 #endif
+    if (recording_) {
+      HostProfiler::Record(std::move(name_), type_, start_ns_, depth_);
+    }
   }
+
+ private:
+  bool recording_{false};
+  std::string name_;
+  EventType type_{EventType::kOrdinary};
+  int depth_{0};
+  int64_t start_ns_{0};
 };
 
 void SynchronizeAllDevice();
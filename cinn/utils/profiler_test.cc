@@ -0,0 +1,118 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+TEST(HostProfiler, DisabledByDefault) {
+  HostProfiler::Clear();
+  { RecordEvent event("not_recorded"); }
+  EXPECT_TRUE(HostProfiler::GetEvents().empty());
+}
+
+TEST(HostProfiler, NestedEvents) {
+  HostProfiler::Clear();
+  HostProfiler::Enable();
+  {
+    RecordEvent outer("outer", EventType::kInstruction);
+    for (int i = 0; i < 3; ++i) {
+      RecordEvent inner("inner", EventType::kKernel);
+    }
+    ProfilerRangePush("range");
+    ProfilerRangePop();
+  }
+  HostProfiler::Disable();
+
+  auto events = HostProfiler::GetEvents();
+  ASSERT_EQ(events.size(), 5UL);
+  EXPECT_EQ(events[0].name, "outer");
+  EXPECT_EQ(events[0].depth, 0);
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_EQ(events[i].depth, 1);
+    EXPECT_GE(events[i].start_ns, events[0].start_ns);
+    EXPECT_LE(events[i].end_ns, events[0].end_ns);
+  }
+
+  auto statistics = HostProfiler::GetStatistics();
+  ASSERT_EQ(statistics.size(), 3UL);
+  EXPECT_EQ(statistics[0].name, "outer");
+  for (auto& stat : statistics) {
+    if (stat.name == "inner") {
+      EXPECT_EQ(stat.type, EventType::kKernel);
+      EXPECT_EQ(stat.count, 3);
+      EXPECT_LE(stat.min_ms, stat.p50_ms);
+      EXPECT_LE(stat.p50_ms, stat.p99_ms);
+      EXPECT_LE(stat.p99_ms, stat.max_ms);
+    }
+  }
+  EventType kernel = EventType::kKernel;
+  auto report      = HostProfiler::Report(&kernel);
+  EXPECT_NE(report.find("inner"), std::string::npos);
+  EXPECT_EQ(report.find("outer"), std::string::npos);
+}
+
+TEST(HostProfiler, RingBufferPerThread) {
+  HostProfiler::Clear();
+  HostProfiler::Enable(8);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 20; ++i) {
+        RecordEvent event("event_" + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  HostProfiler::Disable();
+
+  // only the latest 8 events of each thread are kept
+  auto events = HostProfiler::GetEvents();
+  EXPECT_EQ(events.size(), 32UL);
+  for (auto& event : events) {
+    EXPECT_GE(std::stoi(event.name.substr(6)), 12);
+  }
+  HostProfiler::Enable();
+  HostProfiler::Disable();
+}
+
+TEST(HostProfiler, ExportChromeTrace) {
+  HostProfiler::Clear();
+  HostProfiler::Enable();
+  { RecordEvent event("op\"quoted\"", EventType::kCompilePhase); }
+  HostProfiler::Disable();
+
+  std::string path = "./profiler_test_trace.json";
+  ASSERT_TRUE(HostProfiler::ExportChromeTrace(path));
+  std::ifstream is(path);
+  std::stringstream content;
+  content << is.rdbuf();
+  auto json = content.str();
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"op\\\"quoted\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"cat\":\"compile\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+  std::remove(path.c_str());
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,119 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/thread_pool.h"
+
+#include <glog/logging.h>
+
+namespace cinn {
+namespace utils {
+
+namespace {
+// the pool and the worker id of the calling thread
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local int current_worker_id          = -1;
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads, const std::function<void(int)>& on_worker_start) {
+  CHECK_GT(num_threads, 0) << "The number of threads should be positive";
+  for (int i = 0; i < num_threads; ++i) {
+    queues_.emplace_back(new TaskQueue);
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this, i, on_worker_start]() { WorkerLoop(i, on_worker_start); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  task_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::CurrentWorkerId() { return current_worker_id; }
+
+void ThreadPool::Submit(Task task) {
+  int queue_id = current_pool == this ? current_worker_id : next_queue_++ % queues_.size();
+  unfinished_++;
+  {
+    // increase under the lock so a worker checking pending_ before sleeping will not miss it
+    std::lock_guard<std::mutex> lock(mu_);
+    pending_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_id]->mu);
+    queues_[queue_id]->tasks.push_back(std::move(task));
+  }
+  task_cv_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  CHECK(current_pool != this) << "Can not wait for the pool inside its worker";
+  std::unique_lock<std::mutex> lock(mu_);
+  done_cv_.wait(lock, [this]() { return unfinished_.load() == 0; });
+}
+
+bool ThreadPool::PopLocal(int worker_id, Task* task) {
+  auto& queue = *queues_[worker_id];
+  std::lock_guard<std::mutex> lock(queue.mu);
+  if (queue.tasks.empty()) return false;
+  *task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::Steal(int worker_id, Task* task) {
+  for (int i = 1; i < queues_.size(); ++i) {
+    auto& queue = *queues_[(worker_id + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    if (queue.tasks.empty()) continue;
+    *task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int worker_id, const std::function<void(int)>& on_worker_start) {
+  current_pool      = this;
+  current_worker_id = worker_id;
+  if (on_worker_start) {
+    on_worker_start(worker_id);
+  }
+
+  while (true) {
+    Task task;
+    if (PopLocal(worker_id, &task) || Steal(worker_id, &task)) {
+      pending_--;
+      task();
+      if (--unfinished_ == 0) {
+        std::lock_guard<std::mutex> lock(mu_);
+        done_cv_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mu_);
+    task_cv_.wait(lock, [this]() { return stop_ || pending_.load() > 0; });
+    if (stop_ && pending_.load() == 0) break;
+  }
+}
+
+}  // namespace utils
+}  // namespace cinn
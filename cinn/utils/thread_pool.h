@@ -0,0 +1,85 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A work-stealing thread pool.
+ *
+ * Each worker owns a task deque. A task submitted from a worker is pushed into the deque of that
+ * worker and the worker pops tasks from the back of its own deque (LIFO, good for locality), while
+ * idle workers steal tasks from the front of the others' deques. Tasks submitted from a thread
+ * outside the pool are distributed among workers in round-robin.
+ */
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * Constructor.
+   * @param num_threads The number of worker threads.
+   * @param on_worker_start The function called at the beginning of each worker with its worker id,
+   * which can be used to set thread-local states such as the intra-op concurrency.
+   */
+  explicit ThreadPool(int num_threads, const std::function<void(int)>& on_worker_start = nullptr);
+  ~ThreadPool();
+
+  void Submit(Task task);
+
+  //! Block until all the submitted tasks finished.
+  void Wait();
+
+  int num_threads() const { return workers_.size(); }
+
+  //! The id of the worker running the calling thread in any ThreadPool, -1 if not a worker.
+  static int CurrentWorkerId();
+
+ private:
+  struct TaskQueue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(int worker_id, const std::function<void(int)>& on_worker_start);
+  bool PopLocal(int worker_id, Task* task);
+  bool Steal(int worker_id, Task* task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mu_;
+  std::condition_variable task_cv_;
+  std::condition_variable done_cv_;
+  // number of tasks submitted but not started
+  std::atomic<int> pending_{0};
+  // number of tasks submitted but not finished
+  std::atomic<int> unfinished_{0};
+  std::atomic<unsigned> next_queue_{0};
+  bool stop_{false};
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,53 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+namespace cinn {
+namespace utils {
+
+TEST(ThreadPool, RunAllTasks) {
+  ThreadPool pool(4);
+  std::atomic<int> sum{0};
+  for (int i = 1; i <= 1000; ++i) {
+    pool.Submit([&sum, i]() { sum += i; });
+  }
+  pool.Wait();
+  EXPECT_EQ(sum.load(), 500500);
+  EXPECT_EQ(ThreadPool::CurrentWorkerId(), -1);
+}
+
+TEST(ThreadPool, NestedSubmit) {
+  std::atomic<int> started{0};
+  ThreadPool pool(3, [&started](int worker_id) { started++; });
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.Submit([&pool, &count]() {
+      EXPECT_GE(ThreadPool::CurrentWorkerId(), 0);
+      for (int j = 0; j < 10; ++j) {
+        pool.Submit([&count]() { count++; });
+      }
+    });
+  }
+  pool.Wait();
+  EXPECT_EQ(count.load(), 100);
+  EXPECT_EQ(started.load(), 3);
+}
+
+}  // namespace utils
+}  // namespace cinn
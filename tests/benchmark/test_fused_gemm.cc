@@ -0,0 +1,125 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Graph;
+using hlir::framework::GraphCompiler;
+using hlir::framework::Scope;
+
+struct GemmProgram {
+  frontend::Program program;
+  std::vector<std::string> input_ids;
+  std::string output_id;
+};
+
+// matmul -> elementwise_add(bias) -> relu -> elementwise_add(residual), which GemmRewriter fuses into a cpu_gemm
+GemmProgram BuildGemmProgram(int M, int K, int N) {
+  frontend::NetBuilder builder("fused_gemm");
+  auto a        = builder.CreateInput(Float(32), {M, K}, "A");
+  auto b        = builder.CreateInput(Float(32), {K, N}, "B");
+  auto bias     = builder.CreateInput(Float(32), {N}, "Bias");
+  auto residual = builder.CreateInput(Float(32), {M, N}, "Residual");
+  auto out      = builder.Add(builder.Relu(builder.Add(builder.Matmul(a, b), bias)), residual);
+
+  GemmProgram gemm;
+  gemm.program = builder.Build();
+  for (auto& input : {a, b, bias, residual}) {
+    gemm.input_ids.emplace_back(input.id());
+  }
+  gemm.output_id = out->id;
+  return gemm;
+}
+
+std::unique_ptr<hlir::framework::Program> BuildRuntimeProgram(GemmProgram gemm,
+                                                              const std::vector<std::string>& passes,
+                                                              const Target& target,
+                                                              std::shared_ptr<Scope>* scope) {
+  std::unordered_set<std::string> fetch_ids{gemm.output_id};
+  frontend::ProgramPass::Apply(&gemm.program, fetch_ids, target, passes);
+  auto graph = std::make_shared<Graph>(gemm.program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  *scope = hlir::framework::BuildScope(target, graph);
+
+  for (auto& input_id : gemm.input_ids) {
+    auto tensor = (*scope)->GetTensor(input_id);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (int i = 0; i < tensor->shape().numel(); ++i) {
+      data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+    }
+  }
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  GraphCompiler gc(target, *scope, graph);
+  return gc.Build(options, std::move(fetch_ids)).runtime_program;
+}
+
+// the average latency of an execution in milliseconds
+float BenchmarkExecute(hlir::framework::Program* program, int repeat) {
+  for (int i = 0; i < 5; ++i) {
+    program->Execute();
+  }
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; ++i) {
+    program->Execute();
+  }
+  return timer.Stop() / repeat;
+}
+
+TEST(FusedGemm, CompareWithUnfused) {
+  auto target = common::DefaultHostTarget();
+  for (auto& shape : std::vector<std::vector<int>>{{128, 512, 512}, {1024, 256, 256}, {4096, 64, 64}}) {
+    int M = shape[0], K = shape[1], N = shape[2];
+    auto gemm = BuildGemmProgram(M, K, N);
+
+    std::shared_ptr<Scope> unfused_scope;
+    auto unfused     = BuildRuntimeProgram(gemm, {"Decomposer"}, target, &unfused_scope);
+    float unfused_ms = BenchmarkExecute(unfused.get(), 20);
+
+    std::shared_ptr<Scope> fused_scope;
+    auto fused     = BuildRuntimeProgram(gemm, {"Decomposer", "GemmRewriter"}, target, &fused_scope);
+    float fused_ms = BenchmarkExecute(fused.get(), 20);
+    LOG(INFO) << "matmul + bias + relu + residual of M=" << M << ", K=" << K << ", N=" << N
+              << ", unfused: " << unfused_ms << " ms, fused: " << fused_ms << " ms, speedup: " << unfused_ms / fused_ms;
+
+    auto expected = unfused_scope->GetTensor(gemm.output_id);
+    auto result   = fused_scope->GetTensor(gemm.output_id);
+    for (int i = 0; i < M * N; ++i) {
+      ASSERT_NEAR(result->data<float>()[i], expected->data<float>()[i], 1e-3f) << "at " << i;
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
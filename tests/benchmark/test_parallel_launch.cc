@@ -0,0 +1,66 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "cinn/runtime/cpu/parallel_thread_pool.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+// A small elementwise kernel: each task scales its slice of the data.
+static int ScaleSlice(int task_id, int num_task, void* datas) {
+  auto* data = static_cast<std::vector<float>*>(datas);
+  int step   = (data->size() + num_task - 1) / num_task;
+  int end    = std::min<int>((task_id + 1) * step, data->size());
+  for (int i = task_id * step; i < end; ++i) {
+    (*data)[i] *= 1.0001f;
+  }
+  return 0;
+}
+
+using LaunchFn = int (*)(FCINNParallelLambda, void*, int);
+
+// the average latency of a launch in microseconds
+float MeasureLaunchLatency(LaunchFn launch, std::vector<float>* data, int repeat) {
+  for (int i = 0; i < 100; ++i) {
+    launch(ScaleSlice, data, 0);
+  }
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; ++i) {
+    launch(ScaleSlice, data, 0);
+  }
+  return timer.Stop() * 1000 / repeat;
+}
+
+TEST(ParallelLaunch, Latency) {
+  const int repeat = 10000;
+  for (int size : {0, 1024, 64 * 1024}) {
+    std::vector<float> data(size, 1.f);
+    float omp_latency  = MeasureLaunchLatency(cinn_backend_parallel_launch, &data, repeat);
+    float pool_latency = MeasureLaunchLatency(cinn_backend_thread_pool_launch, &data, repeat);
+    LOG(INFO) << "Parallel launch of " << size << " elements with " << max_concurrency()
+              << " threads, OpenMP: " << omp_latency << " us, ParallelThreadPool: " << pool_latency << " us";
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
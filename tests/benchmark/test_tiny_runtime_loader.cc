@@ -0,0 +1,305 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/runtime/tiny_runtime.h"
+
+DECLARE_string(cinn_x86_isa_levels);
+DECLARE_bool(cinn_machine_specific_prepack);
+
+namespace cinn {
+namespace tests {
+
+uint64_t AlignUp(uint64_t size, uint64_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+// Write a v1 program file of num_weights weights and one temporary, the i-th weight is filled with i.
+std::string WriteProgram(const std::string& path, int num_weights, int weight_size, int major_v) {
+  int num_vars = num_weights + 1;
+  cinn_program_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CINN_PROGRAM_MAGIC, 4);
+  header.major_v             = major_v;
+  header.minor_v             = CINN_PROGRAM_MINOR_VERSION;
+  header.page_size           = CINN_PROGRAM_PAGE_SIZE;
+  header.num_vars            = num_vars;
+  header.vars_offset         = AlignUp(sizeof(header), 16);
+  header.instructions_offset = AlignUp(header.vars_offset + num_vars * sizeof(cinn_program_var_t), 16);
+
+  std::string blob(header.instructions_offset, '\0');
+  std::vector<cinn_program_var_t> vars(num_vars);
+  for (int i = 0; i < num_vars; ++i) {
+    std::string name    = "var_" + std::to_string(i);
+    vars[i].name_offset = blob.size();
+    blob.append(name.c_str(), name.size() + 1);
+    vars[i].buffer.memory_size = weight_size;
+    vars[i].kind               = i < num_weights ? cinn_program_var_persistent : cinn_program_var_temporary;
+  }
+
+  blob.resize(AlignUp(blob.size(), CINN_PROGRAM_PAGE_SIZE), '\0');
+  header.weights_offset = blob.size();
+  for (int i = 0; i < num_weights; ++i) {
+    vars[i].data_offset = blob.size() - header.weights_offset;
+    blob.append(weight_size, static_cast<char>(i));
+  }
+  header.weights_size    = blob.size() - header.weights_offset;
+  header.arena_size      = weight_size;
+  header.arena_alignment = 64;
+  header.file_size       = blob.size();
+  memcpy(&blob[0], &header, sizeof(header));
+  memcpy(&blob[header.vars_offset], vars.data(), vars.size() * sizeof(cinn_program_var_t));
+
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs.write(blob.data(), blob.size());
+  return path;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(TinyRuntimeLoader, VersionCheck) {
+  auto path = WriteProgram("/tmp/cinn_tiny_runtime_v2_" + std::to_string(getpid()), 1, 64, 2);
+  EXPECT_EQ(load_program(path.c_str()), nullptr);
+  unlink(path.c_str());
+}
+
+TEST(TinyRuntimeLoader, LoadLatency) {
+  const int num_weights = 64;
+  const int weight_size = 4 << 20;
+  auto path =
+      WriteProgram("/tmp/cinn_tiny_runtime_v1_" + std::to_string(getpid()), num_weights, weight_size, 1);
+
+  // the baseline reads the whole file into memory like the v0 loader
+  auto start = std::chrono::steady_clock::now();
+  std::ifstream ifs(path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  double read_ms = ElapsedMs(start);
+
+  start         = std::chrono::steady_clock::now();
+  void* program = load_program(path.c_str());
+  double map_ms = ElapsedMs(start);
+  ASSERT_NE(program, nullptr);
+
+  for (int i : {0, num_weights / 2, num_weights - 1}) {
+    auto* buffer = static_cast<cinn_buffer_t*>(*get_pod_value(program, ("var_" + std::to_string(i)).c_str()));
+    ASSERT_EQ(buffer->memory[0], static_cast<uint8_t>(i));
+    ASSERT_EQ(buffer->memory[weight_size - 1], static_cast<uint8_t>(i));
+  }
+  // the temporary is writable
+  auto temporary_name = "var_" + std::to_string(num_weights);
+  auto* temporary     = static_cast<cinn_buffer_t*>(*get_pod_value(program, temporary_name.c_str()));
+  memset(temporary->memory, 0, weight_size);
+
+  LOG(INFO) << "Load a program of " << content.size() / (1 << 20) << "MB, reading: " << read_ms
+            << " ms, mapping: " << map_ms << " ms";
+  destroy_program(program);
+  unlink(path.c_str());
+}
+
+// Build the shared library embedded into the exported program from the object of the compiled functions.
+std::string BuildLibrary(hlir::framework::GraphCompiler* gc, const std::string& prefix) {
+  std::string object_path  = prefix + ".o";
+  std::string library_path = prefix + ".so";
+  gc->ExportObject(object_path);
+  std::string command = "cc -shared -o " + library_path + " " + object_path;
+  CHECK_EQ(system(command.c_str()), 0) << "Failed to build the library: " << command;
+  unlink(object_path.c_str());
+  return library_path;
+}
+
+float* GetBufferData(void* program, const std::string& name) {
+  auto* pod_value = get_pod_value(program, name.c_str());
+  CHECK(pod_value) << name << " is not in the loaded program";
+  return reinterpret_cast<float*>(static_cast<cinn_buffer_t*>(*pod_value)->memory);
+}
+
+// Export the program of the elementwise ops with its library, then load and run it by the tiny runtime
+void CheckExportAndRun(const std::string& name) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(common::Float(32), {32, 64}, "A");
+  auto w = builder.CreateInput(common::Float(32), {32, 64}, "W");
+  auto c = builder.Relu(builder.ElementwiseAdd(a, w));
+  auto d = builder.ElementwiseMul(c, a);
+  auto e = builder.Relu(builder.ElementwiseAdd(d, w));
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(builder.Build(), target);
+  auto scope  = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  const int numel = 32 * 64;
+  auto* a_data    = scope->GetTensor(std::string(a.id()))->mutable_data<float>(target);
+  auto* w_data    = scope->GetTensor(std::string(w.id()))->mutable_data<float>(target);
+  for (int i = 0; i < numel; ++i) {
+    a_data[i] = static_cast<float>(i % 7) - 3.0f;
+    w_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  program->Execute();
+  auto* expected = scope->GetTensor(e->id)->data<float>();
+
+  std::string prefix = "/tmp/cinn_tiny_runtime_" + name + "_" + std::to_string(getpid());
+  auto library_path  = BuildLibrary(&gc, prefix);
+  program->Export({std::string(w.id())}, prefix + ".cinn", library_path);
+  unlink(library_path.c_str());
+
+  void* loaded = load_program((prefix + ".cinn").c_str());
+  ASSERT_NE(loaded, nullptr);
+  // the weight is mapped from the file, and the input is fed into the arena
+  ASSERT_EQ(memcmp(GetBufferData(loaded, std::string(w.id())), w_data, numel * sizeof(float)), 0);
+  std::copy(a_data, a_data + numel, GetBufferData(loaded, std::string(a.id())));
+  run_program(loaded);
+  auto* out = GetBufferData(loaded, e->id);
+  for (int i = 0; i < numel; ++i) {
+    ASSERT_FLOAT_EQ(out[i], expected[i]);
+  }
+  destroy_program(loaded);
+  unlink((prefix + ".cinn").c_str());
+}
+
+TEST(TinyRuntimeLoader, ExportAndRun) { CheckExportAndRun("export"); }
+
+TEST(TinyRuntimeLoader, MultiVersionExportAndRun) {
+  // the dispatchers of the multi-versioned kernels resolve nothing from the CINN runtime when loaded
+  std::string isa_levels    = FLAGS_cinn_x86_isa_levels;
+  FLAGS_cinn_x86_isa_levels = "sse4.2,avx2,avx512";
+  CheckExportAndRun("multi_version");
+  FLAGS_cinn_x86_isa_levels = isa_levels;
+}
+
+// Export the cpu_gemm of a constant B, which is exported packed if it is prepacked
+void CheckExportConstantGemm(bool prepacked) {
+  const int M = 16, N = 24, K = 32;
+  frontend::Placeholder A(Float(32), {M, K}, "A");
+  frontend::Placeholder B(Float(32), {N, K}, "B", true);
+  frontend::Program program;
+  frontend::Instruction instr("cpu_gemm", {A, B});
+  instr.SetAttr("trans_a", false);
+  instr.SetAttr("trans_b", true);
+  instr.SetAttr("alpha", 1.f);
+  instr.SetAttr("beta", 1.f);
+  instr.SetAttr("activation", std::string(""));
+  instr.SetAttr("has_bias", false);
+  instr.SetAttr("has_residual", false);
+  program.AppendInstruction(instr);
+  auto out = instr.GetOutput(0);
+  program.SetInputs({A, B});
+  program.Validate();
+
+  // B is packed by the pre-run instruction, which is not exported
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "WeightPrepack");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program    = gc.Build();
+  std::string packed_name = hlir::framework::PrepackedVarName("B", "gemm_packed_trans");
+  ASSERT_EQ(scope->FindVar(packed_name) != nullptr, prepacked);
+
+  auto* a_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto* b_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < M * K; ++i) {
+    a_data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  for (int i = 0; i < N * K; ++i) {
+    b_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+  auto* expected = scope->GetTensor(out->id)->data<float>();
+
+  std::string prefix = "/tmp/cinn_tiny_runtime_prepacked_" + std::to_string(getpid());
+  auto library_path  = BuildLibrary(&gc, prefix);
+  runtime_program->Export(prepacked ? std::vector<std::string>() : std::vector<std::string>{"B"},
+                          prefix + ".cinn",
+                          library_path);
+  unlink(library_path.c_str());
+
+  // the packed B is exported as a weight, while B read only by the packing takes no space
+  std::ifstream ifs(prefix + ".cinn", std::ios::binary);
+  std::string file((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ASSERT_GE(file.size(), sizeof(cinn_program_header_t));
+  auto* header = reinterpret_cast<const cinn_program_header_t*>(file.data());
+  auto* vars   = reinterpret_cast<const cinn_program_var_t*>(file.data() + header->vars_offset);
+  int num_checked = 0;
+  for (int i = 0; i < header->num_vars; ++i) {
+    std::string name = file.c_str() + vars[i].name_offset;
+    if (name == packed_name) {
+      EXPECT_EQ(vars[i].kind, cinn_program_var_persistent);
+      EXPECT_EQ(vars[i].buffer.memory_size, N * K * sizeof(float));
+      ++num_checked;
+    } else if (name == "B" && prepacked) {
+      EXPECT_EQ(vars[i].kind, cinn_program_var_temporary);
+      EXPECT_EQ(vars[i].buffer.memory_size, 0);
+      EXPECT_EQ(vars[i].data_offset, 0);
+      ++num_checked;
+    } else if (name == "B") {
+      EXPECT_EQ(vars[i].kind, cinn_program_var_persistent);
+      ++num_checked;
+    }
+  }
+  ASSERT_EQ(num_checked, prepacked ? 2 : 1);
+
+  void* loaded = load_program((prefix + ".cinn").c_str());
+  ASSERT_NE(loaded, nullptr);
+  if (prepacked) {
+    auto* packed = scope->GetTensor(packed_name)->data<float>();
+    ASSERT_EQ(memcmp(GetBufferData(loaded, packed_name), packed, N * K * sizeof(float)), 0);
+  }
+  std::copy(a_data, a_data + M * K, GetBufferData(loaded, "A"));
+  run_program(loaded);
+  auto* result = GetBufferData(loaded, out->id);
+  for (int i = 0; i < M * N; ++i) {
+    ASSERT_FLOAT_EQ(result[i], expected[i]);
+  }
+  destroy_program(loaded);
+  unlink((prefix + ".cinn").c_str());
+}
+
+TEST(TinyRuntimeLoader, ExportPrepackedWeight) {
+#ifdef CINN_WITH_MKL_CBLAS
+  // the B packed by MKL depends on the CPU and can not be exported, so it is exported unpacked
+  bool machine_specific_prepack       = FLAGS_cinn_machine_specific_prepack;
+  FLAGS_cinn_machine_specific_prepack = false;
+  CheckExportConstantGemm(false);
+  FLAGS_cinn_machine_specific_prepack = machine_specific_prepack;
+#else
+  CheckExportConstantGemm(true);
+#endif
+}
+
+}  // namespace tests
+}  // namespace cinn